@@ -82,6 +82,17 @@ void MAVLinkChartController::setRangeXIndex(quint32 index)
     updateXRange();
 }
 
+void MAVLinkChartController::setPlotWidth(int width)
+{
+    width = qMax(1, width);
+    if (width == _plotWidth) {
+        return;
+    }
+
+    _plotWidth = width;
+    emit plotWidthChanged();
+}
+
 void MAVLinkChartController::updateXRange()
 {
     if (_rangeXIndex >= static_cast<quint32>(_inspectorController->timeScaleSt().count())) {
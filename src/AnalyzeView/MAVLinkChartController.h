@@ -39,6 +39,7 @@ class MAVLinkChartController : public QObject
     Q_PROPERTY(qreal        rangeYMax   READ rangeYMax                              NOTIFY rangeYMaxChanged)
     Q_PROPERTY(quint32      rangeYIndex READ rangeYIndex    WRITE setRangeYIndex    NOTIFY rangeYIndexChanged)
     Q_PROPERTY(quint32      rangeXIndex READ rangeXIndex    WRITE setRangeXIndex    NOTIFY rangeXIndexChanged)
+    Q_PROPERTY(int          plotWidth   READ plotWidth      WRITE setPlotWidth      NOTIFY plotWidthChanged)
 
 
 public:
@@ -58,9 +59,11 @@ class MAVLinkChartController : public QObject
     quint32 rangeXIndex() const { return _rangeXIndex; }
     quint32 rangeYIndex() const { return _rangeYIndex; }
     int chartIndex() const { return _chartIndex; }
+    int plotWidth() const { return _plotWidth; }
 
     void setRangeXIndex(quint32 index);
     void setRangeYIndex(quint32 index);
+    void setPlotWidth(int width);
     void updateXRange();
     void updateYRange();
 
@@ -72,6 +75,7 @@ class MAVLinkChartController : public QObject
     void rangeYMaxChanged();
     void rangeYIndexChanged();
     void rangeXIndexChanged();
+    void plotWidthChanged();
 
 private slots:
     void _refreshSeries();
@@ -87,6 +91,7 @@ private slots:
     qreal _rangeYMax = 1;
     quint32 _rangeXIndex = 0;   ///< 5 Seconds
     quint32 _rangeYIndex = 0;   ///< Auto Range
+    int _plotWidth = 1000;      ///< Pixel width of the plot area, series are decimated down to this
     QVariantList _chartFields;
 
     static constexpr int kUpdateFrequency = 1000 / 15;  ///< 15Hz
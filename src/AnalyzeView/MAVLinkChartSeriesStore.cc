@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkChartSeriesStore.h"
+
+#include <QtCore/QtMath>
+
+MAVLinkChartSeriesStore::MAVLinkChartSeriesStore(int capacity)
+    : _capacity(qMax(1, capacity))
+{
+    _timestamps.resize(_capacity);
+    _values.resize(_capacity);
+}
+
+void MAVLinkChartSeriesStore::clear()
+{
+    _head = 0;
+    _count = 0;
+}
+
+void MAVLinkChartSeriesStore::append(qreal timestamp, qreal value)
+{
+    int index;
+    if (_count < _capacity) {
+        index = _physicalIndex(_count);
+        _count++;
+    } else {
+        index = _head;
+        _head = (_head + 1) % _capacity;
+    }
+
+    _timestamps[index] = timestamp;
+    _values[index] = value;
+}
+
+bool MAVLinkChartSeriesStore::valueRange(qreal &min, qreal &max) const
+{
+    if (_count == 0) {
+        return false;
+    }
+
+    // Physical order doesn't matter here, walk the stored part of the column directly
+    const qreal *const values = _values.constData();
+    min = values[0];
+    max = values[0];
+    for (int i = 1; i < _count; i++) {
+        min = qMin(min, values[i]);
+        max = qMax(max, values[i]);
+    }
+
+    return true;
+}
+
+int MAVLinkChartSeriesStore::_lowerBound(qreal timestamp) const
+{
+    int first = 0;
+    int length = _count;
+    while (length > 0) {
+        const int half = length / 2;
+        if (this->timestamp(first + half) < timestamp) {
+            first += half + 1;
+            length -= half + 1;
+        } else {
+            length = half;
+        }
+    }
+
+    return first;
+}
+
+void MAVLinkChartSeriesStore::decimate(qreal xMin, qreal xMax, int pixelWidth, QList<QPointF> &points) const
+{
+    points.clear();
+    if ((_count == 0) || (xMax <= xMin)) {
+        return;
+    }
+
+    // Include the neighbouring sample on each side of the window
+    const int first = qMax(0, _lowerBound(xMin) - 1);
+    const int last = qMin(_count, _lowerBound(xMax) + 1);
+    const int visible = last - first;
+    if (visible <= 0) {
+        return;
+    }
+
+    const int columns = qMax(1, pixelWidth);
+    if (visible <= (2 * columns)) {
+        points.reserve(visible);
+        for (int i = first; i < last; i++) {
+            points.append(QPointF(timestamp(i), value(i)));
+        }
+        return;
+    }
+
+    points.reserve(2 * (columns + 2));
+    const qreal columnWidth = (xMax - xMin) / columns;
+
+    int i = first;
+    while (i < last) {
+        // All samples falling into the same pixel column as sample i
+        const int column = qFloor((timestamp(i) - xMin) / columnWidth);
+        int minIndex = i;
+        int maxIndex = i;
+        for (i++; (i < last) && (qFloor((timestamp(i) - xMin) / columnWidth) == column); i++) {
+            if (value(i) < value(minIndex)) {
+                minIndex = i;
+            }
+            if (value(i) > value(maxIndex)) {
+                maxIndex = i;
+            }
+        }
+
+        // Emit in time order so the line doesn't double back
+        const int firstIndex = qMin(minIndex, maxIndex);
+        const int secondIndex = qMax(minIndex, maxIndex);
+        points.append(QPointF(timestamp(firstIndex), value(firstIndex)));
+        if (secondIndex != firstIndex) {
+            points.append(QPointF(timestamp(secondIndex), value(secondIndex)));
+        }
+    }
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+
+/// Fixed capacity time series of a charted field, stored as a ring of separate timestamp and value columns.
+/// Once full the oldest samples are overwritten, nothing is allocated after construction.
+/// Timestamps are expected to be non-decreasing.
+class MAVLinkChartSeriesStore
+{
+public:
+    explicit MAVLinkChartSeriesStore(int capacity = kDefaultCapacity);
+
+    int capacity() const { return _capacity; }
+    int count() const { return _count; }
+    bool isEmpty() const { return (_count == 0); }
+    void clear();
+
+    void append(qreal timestamp, qreal value);
+
+    /// Samples in time order, 0 is the oldest
+    qreal timestamp(int index) const { return _timestamps[_physicalIndex(index)]; }
+    qreal value(int index) const { return _values[_physicalIndex(index)]; }
+
+    /// Minimum and maximum of all stored values
+    ///     @return false: Store is empty
+    bool valueRange(qreal &min, qreal &max) const;
+
+    /// Replaces points with the samples inside [xMin, xMax], plus the samples on either side so the line
+    /// runs to the edges of the plot. If there are more samples than fit into pixelWidth columns, each
+    /// column is reduced to its minimum and maximum sample which keeps the outline of the plot intact.
+    /// points keeps its allocation between calls.
+    void decimate(qreal xMin, qreal xMax, int pixelWidth, QList<QPointF> &points) const;
+
+    static constexpr int kDefaultCapacity = 100 * 60;   ///< 1 minute at 100Hz
+
+private:
+    int _physicalIndex(int index) const { return (_head + index) % _capacity; }
+
+    /// Index of the first sample with a timestamp not less than timestamp, count() if none
+    int _lowerBound(qreal timestamp) const;
+
+    const int _capacity;
+    int _head = 0;      ///< Physical index of the oldest sample
+    int _count = 0;
+    QList<qreal> _timestamps;
+    QList<qreal> _values;
+};
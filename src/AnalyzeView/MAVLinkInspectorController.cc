@@ -43,6 +43,7 @@ MAVLinkInspectorController::Range_st::Range_st(const QString &label_, qreal rang
 MAVLinkInspectorController::MAVLinkInspectorController(QObject *parent)
     : QObject(parent)
     , _updateFrequencyTimer(new QTimer(this))
+    , _refreshMessagesTimer(new QTimer(this))
     , _systems(new QmlObjectListModel(this))
 {
     // qCDebug(MAVLinkInspectorControllerLog) << Q_FUNC_INFO << this;
@@ -60,6 +61,11 @@ MAVLinkInspectorController::MAVLinkInspectorController(QObject *parent)
     _updateFrequencyTimer->setSingleShot(false);
     _updateFrequencyTimer->start();
 
+    (void) connect(_refreshMessagesTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshMessages);
+    _refreshMessagesTimer->setInterval(kRefreshMessagesMSecs);
+    _refreshMessagesTimer->setSingleShot(false);
+    _refreshMessagesTimer->start();
+
     _timeScaleSt.append(new TimeScale_st(tr("5 Sec"),   5 * 1000));
     _timeScaleSt.append(new TimeScale_st(tr("10 Sec"), 10 * 1000));
     _timeScaleSt.append(new TimeScale_st(tr("30 Sec"), 30 * 1000));
@@ -155,6 +161,23 @@ void MAVLinkInspectorController::_refreshFrequency()
     }
 }
 
+void MAVLinkInspectorController::_refreshMessages()
+{
+    for (int i = 0; i < _systems->count(); i++) {
+        QGCMAVLinkSystem *const system = qobject_cast<QGCMAVLinkSystem*>(_systems->get(i));
+        if (!system) {
+            continue;
+        }
+
+        for (int j = 0; j < system->messages()->count(); j++) {
+            QGCMAVLinkMessage *const msg = qobject_cast<QGCMAVLinkMessage*>(system->messages()->get(j));
+            if (msg) {
+                msg->refresh();
+            }
+        }
+    }
+}
+
 void MAVLinkInspectorController::_vehicleAdded(Vehicle *vehicle)
 {
     QGCMAVLinkSystem *sys = _findVehicle(static_cast<uint8_t>(vehicle->id()));
@@ -24,18 +24,32 @@ QGCMAVLinkMessage::QGCMAVLinkMessage(const mavlink_message_t &message, QObject *
 {
     qCDebug(MAVLinkMessageLog) << this;
 
-    const mavlink_message_info_t *const msgInfo = mavlink_get_message_info(&message);
-    if (!msgInfo) {
+    _msgInfo = mavlink_get_message_info(&message);
+    if (!_msgInfo) {
         qCWarning(MAVLinkMessageLog) << QStringLiteral("QGCMAVLinkMessage NULL msgInfo msgid(%1)").arg(message.msgid);
         return;
     }
 
-    _name = QString(msgInfo->name);
+    _name = QString(_msgInfo->name);
     qCDebug(MAVLinkMessageLog) << "New Message:" << _name;
+}
 
-    for (unsigned int i = 0; i < msgInfo->num_fields; ++i) {
+QGCMAVLinkMessage::~QGCMAVLinkMessage()
+{
+    _fields->clearAndDeleteContents();
+
+    qCDebug(MAVLinkMessageLog) << this;
+}
+
+void QGCMAVLinkMessage::_createFields()
+{
+    if (!_msgInfo || (_fields->count() > 0)) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < _msgInfo->num_fields; ++i) {
         QString type = QStringLiteral("?");
-        switch (msgInfo->fields[i].type) {
+        switch (_msgInfo->fields[i].type) {
             case MAVLINK_TYPE_CHAR:     type = QString("char");     break;
             case MAVLINK_TYPE_UINT8_T:  type = QString("uint8_t");  break;
             case MAVLINK_TYPE_INT8_T:   type = QString("int8_t");   break;
@@ -49,30 +63,26 @@ QGCMAVLinkMessage::QGCMAVLinkMessage(const mavlink_message_t &message, QObject *
             case MAVLINK_TYPE_INT64_T:  type = QString("int64_t");  break;
         }
 
-        QGCMAVLinkMessageField *const field = new QGCMAVLinkMessageField(msgInfo->fields[i].name, type, this);
+        QGCMAVLinkMessageField *const field = new QGCMAVLinkMessageField(_msgInfo->fields[i].name, type, this);
+        if (_msgInfo->fields[i].type == MAVLINK_TYPE_CHAR) {
+            field->setSelectable(false);
+        }
         _fields->append(field);
     }
 }
 
-QGCMAVLinkMessage::~QGCMAVLinkMessage()
-{
-    _fields->clearAndDeleteContents();
-
-    qCDebug(MAVLinkMessageLog) << this;
-}
-
 void QGCMAVLinkMessage::updateFieldSelection()
 {
-    bool sel = false;
-
+    _chartedFields.clear();
     for (int i = 0; i < _fields->count(); ++i) {
-        const QGCMAVLinkMessageField *const field = qobject_cast<const QGCMAVLinkMessageField*>(_fields->get(i));
+        QGCMAVLinkMessageField *const field = qobject_cast<QGCMAVLinkMessageField*>(_fields->get(i));
         if (field && field->selected()) {
-            sel = true;
-            break;
+            _chartedFields.append({ &_msgInfo->fields[i], field });
         }
     }
 
+    const bool sel = !_chartedFields.isEmpty();
+
     if (sel != _fieldSelected) {
         _fieldSelected = sel;
         emit fieldSelectedChanged();
@@ -94,7 +104,10 @@ void QGCMAVLinkMessage::setSelected(bool sel)
 {
     if (sel != _selected) {
         _selected = sel;
-        _updateFields();
+        if (_selected) {
+            _createFields();
+            _updateFields();
+        }
         emit selectedChanged();
     }
 }
@@ -111,17 +124,83 @@ void QGCMAVLinkMessage::update(const mavlink_message_t &message)
 {
     _count++;
     _message = message;
+    _fieldsDirty = true;
+
+    const uint8_t *const payload = reinterpret_cast<const uint8_t*>(&_message.payload64[0]);
+    for (const ChartedField &chartedField : std::as_const(_chartedFields)) {
+        chartedField.field->appendSample(_fieldSample(*chartedField.info, payload));
+    }
+}
+
+void QGCMAVLinkMessage::refresh()
+{
+    if (_count != _refreshedCount) {
+        _refreshedCount = _count;
+        emit countChanged();
+    }
 
-    if (_selected || _fieldSelected) {
-        // Don't update field info unless selected to reduce perf hit of message processing
+    if (_fieldsDirty && (_selected || _fieldSelected)) {
         _updateFields();
     }
-    emit countChanged();
+}
+
+qreal QGCMAVLinkMessage::_fieldSample(const mavlink_field_info_t &info, const uint8_t *payload)
+{
+    const uint8_t *const data = payload + info.wire_offset;
+    switch (info.type) {
+    case MAVLINK_TYPE_UINT8_T:
+        return static_cast<qreal>(*data);
+    case MAVLINK_TYPE_INT8_T:
+        return static_cast<qreal>(*reinterpret_cast<const int8_t*>(data));
+    case MAVLINK_TYPE_UINT16_T: {
+        uint16_t n;
+        (void) memcpy(&n, data, sizeof(n));
+        return static_cast<qreal>(n);
+    }
+    case MAVLINK_TYPE_INT16_T: {
+        int16_t n;
+        (void) memcpy(&n, data, sizeof(n));
+        return static_cast<qreal>(n);
+    }
+    case MAVLINK_TYPE_UINT32_T: {
+        uint32_t n;
+        (void) memcpy(&n, data, sizeof(n));
+        return static_cast<qreal>(n);
+    }
+    case MAVLINK_TYPE_INT32_T: {
+        int32_t n;
+        (void) memcpy(&n, data, sizeof(n));
+        return static_cast<qreal>(n);
+    }
+    case MAVLINK_TYPE_FLOAT: {
+        float f;
+        (void) memcpy(&f, data, sizeof(f));
+        return static_cast<qreal>(f);
+    }
+    case MAVLINK_TYPE_DOUBLE: {
+        double d;
+        (void) memcpy(&d, data, sizeof(d));
+        return static_cast<qreal>(d);
+    }
+    case MAVLINK_TYPE_UINT64_T: {
+        uint64_t n;
+        (void) memcpy(&n, data, sizeof(n));
+        return static_cast<qreal>(n);
+    }
+    case MAVLINK_TYPE_INT64_T: {
+        int64_t n;
+        (void) memcpy(&n, data, sizeof(n));
+        return static_cast<qreal>(n);
+    }
+    case MAVLINK_TYPE_CHAR:
+    default:
+        return 0;
+    }
 }
 
 void QGCMAVLinkMessage::_updateFields()
 {
-    const mavlink_message_info_t *msgInfo = mavlink_get_message_info(&_message);
+    const mavlink_message_info_t *const msgInfo = _msgInfo;
     if (!msgInfo) {
         qCWarning(MAVLinkMessageLog) << "QGCMAVLinkMessage::update NULL msgInfo msgid" << _message.msgid;
         return;
@@ -132,6 +211,8 @@ void QGCMAVLinkMessage::_updateFields()
         return;
     }
 
+    _fieldsDirty = false;
+
     uint8_t *const msg = reinterpret_cast<uint8_t*>(&_message.payload64[0]);
     for (unsigned int i = 0; i < msgInfo->num_fields; ++i) {
         QGCMAVLinkMessageField *const field = qobject_cast<QGCMAVLinkMessageField*>(_fields->get(static_cast<int>(i)));
@@ -145,16 +226,15 @@ void QGCMAVLinkMessage::_updateFields()
 
         switch (msgInfo->fields[i].type) {
         case MAVLINK_TYPE_CHAR:
-            field->setSelectable(false);
             if (array_length > 0) {
                 char *const str = reinterpret_cast<char*>(msg + offset);
                 str[array_length - 1] = '\0';
                 const QString v(str);
-                field->updateValue(v, 0);
+                field->setValue(v);
             } else {
                 char b = *(reinterpret_cast<char*>(msg + offset));
                 const QString v(b);
-                field->updateValue(v, 0);
+                field->setValue(v);
             }
             break;
         case MAVLINK_TYPE_UINT8_T:
@@ -166,10 +246,10 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 const uint8_t u = *(msg + offset);
-                field->updateValue(QString::number(u), static_cast<qreal>(u));
+                field->setValue(QString::number(u));
             }
             break;
         case MAVLINK_TYPE_INT8_T:
@@ -181,10 +261,10 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 const int8_t n = *(reinterpret_cast<int8_t*>(msg + offset));
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->setValue(QString::number(n));
             }
             break;
         case MAVLINK_TYPE_UINT16_T:
@@ -197,11 +277,11 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 uint16_t n = 0;
                 (void) memcpy(&n, msg + offset, sizeof(uint16_t));
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->setValue(QString::number(n));
             }
             break;
         case MAVLINK_TYPE_INT16_T:
@@ -214,11 +294,11 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 int16_t n;
                 memcpy(&n, msg + offset, sizeof(int16_t));
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->setValue(QString::number(n));
             }
             break;
         case MAVLINK_TYPE_UINT32_T:
@@ -231,15 +311,15 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 uint32_t n;
                 (void) memcpy(&n, msg + offset, sizeof(uint32_t));
                 if (_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                     const QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n), QTimeZone::utc());
-                    field->updateValue(d.toString("HH:mm:ss"), static_cast<qreal>(n));
+                    field->setValue(d.toString("HH:mm:ss"));
                 } else {
-                    field->updateValue(QString::number(n), static_cast<qreal>(n));
+                    field->setValue(QString::number(n));
                 }
             }
             break;
@@ -253,11 +333,11 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 int32_t n;
                 (void) memcpy(&n, msg + offset, sizeof(int32_t));
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->setValue(QString::number(n));
             }
             break;
         case MAVLINK_TYPE_FLOAT:
@@ -270,11 +350,11 @@ void QGCMAVLinkMessage::_updateFields()
                    string += tmp.arg(static_cast<double>(nums[j]));
                 }
                 string += QString::number(static_cast<double>(nums[array_length - 1]));
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 float fv;
                 (void) memcpy(&fv, msg + offset, sizeof(float));
-                field->updateValue(QString::number(static_cast<double>(fv)), static_cast<qreal>(fv));
+                field->setValue(QString::number(static_cast<double>(fv)));
             }
             break;
         case MAVLINK_TYPE_DOUBLE:
@@ -287,11 +367,11 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(static_cast<double>(nums[array_length - 1]));
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 double d;
                 (void) memcpy(&d, msg + offset, sizeof(double));
-                field->updateValue(QString::number(d), static_cast<qreal>(d));
+                field->setValue(QString::number(d));
             }
             break;
         case MAVLINK_TYPE_UINT64_T:
@@ -304,15 +384,15 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 uint64_t n;
                 (void) memcpy(&n, msg + offset, sizeof(uint64_t));
                 if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                     const QDateTime d = QDateTime::fromMSecsSinceEpoch(n / 1000, QTimeZone::utc());
-                    field->updateValue(d.toString("yyyy MM dd HH:mm:ss"), static_cast<qreal>(n));
+                    field->setValue(d.toString("yyyy MM dd HH:mm:ss"));
                 } else {
-                    field->updateValue(QString::number(n), static_cast<qreal>(n));
+                    field->setValue(QString::number(n));
                 }
             }
             break;
@@ -326,11 +406,11 @@ void QGCMAVLinkMessage::_updateFields()
                     string += tmp.arg(nums[j]);
                 }
                 string += QString::number(nums[array_length - 1]);
-                field->updateValue(string, static_cast<qreal>(nums[0]));
+                field->setValue(string);
             } else {
                 int64_t n;
                 (void) memcpy(&n, msg + offset, sizeof(int64_t));
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->setValue(QString::number(n));
             }
             break;
         default:
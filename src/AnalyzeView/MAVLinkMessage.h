@@ -16,6 +16,7 @@
 
 #include "MAVLinkLib.h"
 
+class QGCMAVLinkMessageField;
 class QmlObjectListModel;
 
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkMessageLog)
@@ -53,8 +54,11 @@ class QGCMAVLinkMessage : public QObject
     bool selected() const { return _selected; }
 
     void updateFieldSelection();
+    /// Only keeps the raw message, fields are decoded by refresh. Charted fields are sampled here so the chart sees every value.
     void update(const mavlink_message_t &message);
     void updateFreq();
+    /// Called at display rate, decodes the fields if the message is being looked at
+    void refresh();
     void setSelected(bool sel);
     void setTargetRateHz(int32_t rate);
 
@@ -66,15 +70,28 @@ class QGCMAVLinkMessage : public QObject
     void selectedChanged();
 
 private:
+    struct ChartedField {
+        const mavlink_field_info_t *info;
+        QGCMAVLinkMessageField *field;
+    };
+
+    void _createFields();
     void _updateFields();
 
+    /// First element of the field as a number
+    static qreal _fieldSample(const mavlink_field_info_t &info, const uint8_t *payload);
+
     mavlink_message_t _message{};
-    QmlObjectListModel *_fields = nullptr;
+    const mavlink_message_info_t *_msgInfo = nullptr;
+    QmlObjectListModel *_fields = nullptr;              ///< Only created once the message is first selected
+    QList<ChartedField> _chartedFields;
     QString _name;
     qreal _actualRateHz = 0.0;
     int32_t _targetRateHz = 0;
     uint64_t _count = 1;
     uint64_t _lastCount = 0;
+    uint64_t _refreshedCount = 1;                       ///< Count reported by the last countChanged
+    bool _fieldsDirty = true;                           ///< _message has changed since the fields were decoded
     bool _fieldSelected = false;
     bool _selected = false;
 };
@@ -9,6 +9,7 @@
 
 #include "MAVLinkMessageField.h"
 #include "MAVLinkChartController.h"
+#include "MAVLinkChartSeriesStore.h"
 #include "MAVLinkMessage.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
@@ -42,9 +43,9 @@ void QGCMAVLinkMessageField::addSeries(MAVLinkChartController *chartController,
 
     _chartController = chartController;
     _pSeries = series;
+    _store = std::make_unique<MAVLinkChartSeriesStore>();
     emit seriesChanged();
 
-    _dataIndex = 0;
     _msg->updateFieldSelection();
 }
 
@@ -54,9 +55,10 @@ void QGCMAVLinkMessageField::delSeries()
         return;
     }
 
-    _values.clear();
+    _store.reset();
+    _seriesPoints.clear();
     QLineSeries *const lineSeries = static_cast<QLineSeries*>(_pSeries);
-    lineSeries->replace(_values);
+    lineSeries->clear();
     _pSeries = nullptr;
     _chartController = nullptr;
     emit seriesChanged();
@@ -85,44 +87,48 @@ int QGCMAVLinkMessageField::chartIndex() const
     return 0;
 }
 
-void QGCMAVLinkMessageField::updateValue(const QString &newValue, qreal v)
+void QGCMAVLinkMessageField::setValue(const QString &newValue)
 {
     if (_value != newValue) {
         _value = newValue;
         emit valueChanged();
     }
+}
 
+void QGCMAVLinkMessageField::appendSample(qreal v)
+{
     if (!_pSeries || !_chartController) {
         return;
     }
 
-    const int count = _values.count();
-    if (count < (50 * 60)) { ///< Arbitrary limit of 1 minute of data at 50Hz for now
-        const QPointF p(qgcApp()->msecsSinceBoot(), v);
-        _values.append(p);
-    } else {
-        if (_dataIndex >= count) {
-            _dataIndex = 0;
-        }
-        _values[_dataIndex].setX(qgcApp()->msecsSinceBoot());
-        _values[_dataIndex].setY(v);
-        _dataIndex++;
-    }
+    // Series are only rebuilt on the chart refresh, here the sample is just stored
+    _store->append(qgcApp()->msecsSinceBoot(), v);
+}
 
-    if (_chartController->rangeYIndex() != 0) {
+void QGCMAVLinkMessageField::updateSeries()
+{
+    if (!_pSeries || !_chartController || (_store->count() <= 1)) {
         return;
     }
 
-    qreal vmin = std::numeric_limits<qreal>::max();
-    qreal vmax = std::numeric_limits<qreal>::min();
-    for (const QPointF &point : _values) {
-        const qreal v = point.y();
-        if (vmax < v) {
-            vmax = v;
-        }
-        if (vmin > v) {
-            vmin = v;
-        }
+    if (_chartController->rangeYIndex() == 0) {
+        _updateRange();
+    }
+
+    const qreal xMin = _chartController->rangeXMin().toMSecsSinceEpoch();
+    const qreal xMax = _chartController->rangeXMax().toMSecsSinceEpoch();
+    _store->decimate(xMin, xMax, _chartController->plotWidth(), _seriesPoints);
+
+    QLineSeries *const lineSeries = static_cast<QLineSeries*>(_pSeries);
+    lineSeries->replace(_seriesPoints);
+}
+
+void QGCMAVLinkMessageField::_updateRange()
+{
+    qreal vmin = 0;
+    qreal vmax = 0;
+    if (!_store->valueRange(vmin, vmax)) {
+        return;
     }
 
     bool changed = false;
@@ -140,26 +146,3 @@ void QGCMAVLinkMessageField::updateValue(const QString &newValue, qreal v)
         _chartController->updateYRange();
     }
 }
-
-void QGCMAVLinkMessageField::updateSeries()
-{
-    const int count = _values.count();
-    if (count <= 1) {
-        return;
-    }
-
-    QList<QPointF> s;
-    s.reserve(count);
-    int idx = _dataIndex;
-    for (int i = 0; i < count; i++, idx++) {
-        if (idx >= count) {
-            idx = 0;
-        }
-
-        const QPointF p(_values[idx]);
-        s.append(p);
-    }
-
-    QLineSeries *const lineSeries = static_cast<QLineSeries*>(_pSeries);
-    lineSeries->replace(s);
-}
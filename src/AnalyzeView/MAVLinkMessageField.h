@@ -15,11 +15,14 @@
 #include <QtCore/QString>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include <memory>
+
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkMessageFieldLog)
 
 class QGCMAVLinkMessage;
 class MAVLinkChartController;
 class QAbstractSeries;
+class MAVLinkChartSeriesStore;
 
 class QGCMAVLinkMessageField : public QObject
 {
@@ -45,13 +48,15 @@ class QGCMAVLinkMessageField : public QObject
     bool selectable() const { return _selectable; }
     bool selected() const { return !!_pSeries; }
     const QAbstractSeries *series() const { return _pSeries; }
-    const QList<QPointF> *values() const { return &_values; }
+    const MAVLinkChartSeriesStore *store() const { return _store.get(); }
     qreal rangeMin() const { return _rangeMin; }
     qreal rangeMax() const { return _rangeMax; }
     int chartIndex() const;
 
     void setSelectable(bool sel);
-    void updateValue(const QString &newValue, qreal v);
+    void setValue(const QString &newValue);
+    /// Adds a sample to the chart, ignored if the field isn't charted
+    void appendSample(qreal v);
 
     void addSeries(MAVLinkChartController *chartController, QAbstractSeries *series);
     void delSeries();
@@ -63,16 +68,18 @@ class QGCMAVLinkMessageField : public QObject
     void valueChanged();
 
 private:
+    void _updateRange();
+
     QString _type;
     QString _name;
     QGCMAVLinkMessage *_msg = nullptr;
 
     QString _value;
     bool _selectable = true;
-    int _dataIndex = 0;
     qreal _rangeMin = 0;
     qreal _rangeMax = 0;
-    QList<QPointF> _values;
+    std::unique_ptr<MAVLinkChartSeriesStore> _store;    ///< Only allocated while charted
+    QList<QPointF> _seriesPoints;                       ///< Decimated points handed to the series, reused between updates
 
     QAbstractSeries *_pSeries = nullptr;
     MAVLinkChartController *_chartController = nullptr;
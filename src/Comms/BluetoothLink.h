@@ -201,6 +201,7 @@ private slots:
 
 private:
     bool _connect() override;
+    QObject *_txContext() override { return _worker; }
     void _checkPermission();
     void _handlePermissionStatus(Qt::PermissionStatus permissionStatus);
 
@@ -15,6 +15,9 @@
 #include "SettingsManager.h"
 #include "MavlinkSettings.h"
 
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtQml/QQmlEngine>
 
 QGC_LOGGING_CATEGORY(LinkInterfaceLog, "qgc.comms.linkinterface")
@@ -32,6 +35,10 @@ LinkInterface::~LinkInterface()
         qCWarning(LinkInterfaceLog) << Q_FUNC_INFO << "still have vehicle references:" << _vehicleReferenceCount;
     }
 
+    const LinkTxQueue::Stats txStats = _txQueue.stats();
+    qCDebug(LinkInterfaceLog) << "TX writes queued:" << txStats.writesQueued << "link writes:" << txStats.linkWrites
+                              << "dropped:" << txStats.writesDropped << "max depth:" << txStats.maxDepth;
+
     _config.reset();
 }
 
@@ -107,8 +114,79 @@ void LinkInterface::_freeMavlinkChannel()
 
 void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
 {
-    const QByteArray data(bytes, length);
-    (void) QMetaObject::invokeMethod(this, "_writeBytes", Qt::AutoConnection, data);
+    if (!_txQueue.tryPush(bytes, length) && !_pushTxBackpressure(bytes, length)) {
+        qCWarning(LinkInterfaceLog) << "TX queue full, write dropped:" << length << "bytes";
+        return;
+    }
+
+    // Only the first write after a flush wakes up the transport thread, the rest ride along
+    if (!_txFlushScheduled.exchange(true)) {
+        _postTxFlush(_txFlushLatencyMSecs);
+    }
+}
+
+bool LinkInterface::_pushTxBackpressure(const char *bytes, int length)
+{
+    if (length > _txQueue.maxWriteSize()) {
+        return _txQueue.push(bytes, length);
+    }
+
+    if (QThread::currentThread() == _txContext()->thread()) {
+        // Nobody else drains the queue while this thread is busy, write out what is queued right now
+        _flushTx();
+        return _txQueue.push(bytes, length);
+    }
+
+    // Make room without waiting out the flush latency
+    _postTxFlush(0);
+
+    if (QThread::currentThread() == qgcApp()->thread()) {
+        // Stalling the GUI is worse than losing a message, which the protocols above retry anyway
+        return _txQueue.push(bytes, length);
+    }
+
+    // Background producers can afford to wait for the transport thread
+    QMutexLocker lock(&_txSpaceMutex);
+    _txSpaceWaiters++;
+    const QDeadlineTimer deadline(kTxBackpressureMSecs);
+    bool pushed = _txQueue.tryPush(bytes, length);
+    while (!pushed && !deadline.hasExpired()) {
+        (void) _txSpaceWaitc.wait(&_txSpaceMutex, deadline);
+        pushed = _txQueue.tryPush(bytes, length);
+    }
+    _txSpaceWaiters--;
+
+    // The last attempt counts the write as dropped if there is still no room
+    return (pushed || _txQueue.push(bytes, length));
+}
+
+void LinkInterface::_postTxFlush(int msecs)
+{
+    if (msecs == 0) {
+        (void) QMetaObject::invokeMethod(_txContext(), [this]() { _flushTx(); }, Qt::QueuedConnection);
+    } else {
+        QTimer::singleShot(msecs, _txContext(), [this]() { _flushTx(); });
+    }
+}
+
+void LinkInterface::_flushTx()
+{
+    // Cleared first so a write queued while draining schedules another flush
+    _txFlushScheduled = false;
+
+    while (true) {
+        QByteArray data;
+        if (_txQueue.drain(data, _maxTxWriteSize) == 0) {
+            break;
+        }
+
+        if (_txSpaceWaiters > 0) {
+            QMutexLocker lock(&_txSpaceMutex);
+            _txSpaceWaitc.wakeAll();
+        }
+
+        _writeBytes(data);
+    }
 }
 
 void LinkInterface::removeVehicleReference()
@@ -10,9 +10,14 @@
 #pragma once
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include <atomic>
+
 #include "LinkConfiguration.h"
+#include "LinkTxQueue.h"
 
 class LinkManager;
 
@@ -41,7 +46,11 @@ class LinkInterface : public QObject
     bool mavlinkChannelIsSet() const;
     bool decodedFirstMavlinkPacket() const { return _decodedFirstMavlinkPacket; }
     void setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
+    /// Queues bytes for writing. Writes queued close together are coalesced into a single link write.
+    /// If the queue is full: on the transport thread the queue is written out first, the GUI thread never
+    /// waits and drops the write, other threads wait up to kTxBackpressureMSecs for the link to make room.
     void writeBytesThreadSafe(const char *bytes, int length);
+    LinkTxQueue::Stats txQueueStats() const { return _txQueue.stats(); }
     void addVehicleReference() { ++_vehicleReferenceCount; }
     void removeVehicleReference();
     bool initMavlinkSigning();
@@ -66,6 +75,16 @@ class LinkInterface : public QObject
 
     void _connectionRemoved();
 
+    /// Limits the size of coalesced writes, for links with a maximum packet size
+    void _setMaxTxWriteSize(qsizetype maxTxWriteSize) { _maxTxWriteSize = maxTxWriteSize; }
+
+    /// How long queued writes may wait for more to coalesce with, 0 writes them on the next event loop pass
+    void _setTxFlushLatency(int msecs) { _txFlushLatencyMSecs = qMax(0, msecs); }
+
+    /// Object living on the thread which owns the transport. Queued writes are drained and handed to
+    /// _writeBytes on its thread.
+    virtual QObject *_txContext() { return this; }
+
     SharedLinkConfigurationPtr _config;
 
 private slots:
@@ -73,6 +92,13 @@ private slots:
     virtual void _writeBytes(const QByteArray &bytes) = 0;
 
 private:
+    /// Drains the queue on the transport thread after msecs
+    void _postTxFlush(int msecs);
+    void _flushTx();
+    /// Called once the queue was found full
+    ///     @return false: The write was dropped
+    bool _pushTxBackpressure(const char *bytes, int length);
+
     /// connect is private since all links should be created through LinkManager::createConnectedLink calls
     virtual bool _connect() = 0;
 
@@ -80,6 +106,18 @@ private slots:
     bool _decodedFirstMavlinkPacket = false;
     int _vehicleReferenceCount = 0;
     bool _signingSignatureFailure = false;
+
+    LinkTxQueue _txQueue;
+    std::atomic_bool _txFlushScheduled{false};
+    QMutex _txSpaceMutex;
+    QWaitCondition _txSpaceWaitc;                   ///< Woken when the transport thread made room in the queue
+    std::atomic_int _txSpaceWaiters{0};
+    int _txFlushLatencyMSecs = kDefaultTxFlushLatencyMSecs;
+    qsizetype _maxTxWriteSize = kDefaultMaxTxWriteSize;
+
+    static constexpr int kDefaultTxFlushLatencyMSecs = 0;
+    static constexpr qsizetype kDefaultMaxTxWriteSize = 16 * 1024;
+    static constexpr int kTxBackpressureMSecs = 100;
 };
 
 typedef std::shared_ptr<LinkInterface> SharedLinkInterfacePtr;
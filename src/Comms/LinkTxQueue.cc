@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkTxQueue.h"
+
+#include <QtCore/QtMath>
+
+LinkTxQueue::LinkTxQueue(uint32_t capacity)
+    : _capacity(qNextPowerOfTwo(qMax(capacity, 2U) - 1))
+    , _mask(_capacity - 1)
+{
+    _slots = std::make_unique<Slot[]>(_capacity);
+    for (uint32_t i = 0; i < _capacity; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LinkTxQueue::push(const char *data, qsizetype length)
+{
+    if (!tryPush(data, length)) {
+        _writesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+bool LinkTxQueue::tryPush(const char *data, qsizetype length)
+{
+    const uint64_t slotCount = static_cast<uint64_t>(qMax(static_cast<qsizetype>(1), (length + kSlotDataSize - 1) / kSlotDataSize));
+    if (slotCount > _capacity) {
+        return false;
+    }
+
+    // Claim slotCount consecutive slots. The consumer frees slots in order, so if the last one is free all of them are.
+    uint64_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        const uint64_t lastPos = pos + slotCount - 1;
+        const uint64_t sequence = _slots[lastPos & _mask].sequence.load(std::memory_order_acquire);
+        const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(lastPos);
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + slotCount, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    for (uint64_t i = 0; i < slotCount; i++) {
+        Slot &slot = _slots[(pos + i) & _mask];
+        const qsizetype offset = static_cast<qsizetype>(i) * kSlotDataSize;
+        const qsizetype chunk = qMin(kSlotDataSize, length - offset);
+        if (chunk > 0) {
+            (void) memcpy(slot.data, data + offset, chunk);
+        }
+        slot.length = static_cast<uint16_t>(qMax(static_cast<qsizetype>(0), chunk));
+        slot.slotCount = (i == 0) ? static_cast<uint16_t>(slotCount) : 0;
+    }
+
+    for (uint64_t i = 0; i < slotCount; i++) {
+        _slots[(pos + i) & _mask].sequence.store(pos + i + 1, std::memory_order_release);
+    }
+
+    _writesQueued.fetch_add(1, std::memory_order_relaxed);
+    _bytesQueued.fetch_add(static_cast<uint64_t>(length), std::memory_order_relaxed);
+
+    return true;
+}
+
+int LinkTxQueue::drain(QByteArray &buffer, qsizetype maxSize)
+{
+    uint64_t pos = _dequeuePos.load(std::memory_order_relaxed);
+
+    const uint32_t depth = static_cast<uint32_t>(_enqueuePos.load(std::memory_order_relaxed) - pos);
+    if (depth > _maxDepth.load(std::memory_order_relaxed)) {
+        _maxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    int writes = 0;
+    while (true) {
+        const Slot &first = _slots[pos & _mask];
+        if (first.sequence.load(std::memory_order_acquire) != (pos + 1)) {
+            break;
+        }
+
+        // A write is only taken once all of its slots have been published
+        const uint64_t slotCount = first.slotCount;
+        qsizetype length = 0;
+        bool complete = true;
+        for (uint64_t i = 0; i < slotCount; i++) {
+            const Slot &slot = _slots[(pos + i) & _mask];
+            if (slot.sequence.load(std::memory_order_acquire) != (pos + i + 1)) {
+                complete = false;
+                break;
+            }
+            length += slot.length;
+        }
+
+        if (!complete || (!buffer.isEmpty() && ((buffer.size() + length) > maxSize))) {
+            break;
+        }
+
+        for (uint64_t i = 0; i < slotCount; i++) {
+            Slot &slot = _slots[(pos + i) & _mask];
+            (void) buffer.append(slot.data, slot.length);
+            slot.sequence.store(pos + i + _capacity, std::memory_order_release);
+        }
+
+        pos += slotCount;
+        writes++;
+    }
+
+    _dequeuePos.store(pos, std::memory_order_relaxed);
+    if (writes > 0) {
+        _linkWrites.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return writes;
+}
+
+LinkTxQueue::Stats LinkTxQueue::stats() const
+{
+    Stats stats;
+    stats.writesQueued = _writesQueued.load(std::memory_order_relaxed);
+    stats.writesDropped = _writesDropped.load(std::memory_order_relaxed);
+    stats.bytesQueued = _bytesQueued.load(std::memory_order_relaxed);
+    stats.linkWrites = _linkWrites.load(std::memory_order_relaxed);
+    const uint64_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+    const uint64_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+    stats.depth = (enqueuePos > dequeuePos) ? static_cast<uint32_t>(enqueuePos - dequeuePos) : 0;
+    stats.maxDepth = _maxDepth.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+
+#include <atomic>
+#include <memory>
+
+#include "MAVLinkLib.h"
+
+/// Bounded multiple producer, single consumer queue of pending link writes.
+/// Producers on any thread append whole writes without taking a lock. The consumer drains everything
+/// queued so far into a single buffer, which turns a burst of small frames into a single link write.
+/// Each write occupies one or more fixed size slots, a MAVLink frame always fits into a single slot.
+class LinkTxQueue
+{
+public:
+    struct Stats {
+        uint64_t writesQueued = 0;
+        uint64_t writesDropped = 0;     ///< Writes dropped since the queue was full
+        uint64_t bytesQueued = 0;
+        uint64_t linkWrites = 0;        ///< Coalesced writes handed to the link
+        uint32_t depth = 0;             ///< Slots currently in use
+        uint32_t maxDepth = 0;          ///< Highest depth seen by the consumer
+    };
+
+    /// @param capacity Number of slots, rounded up to a power of two
+    explicit LinkTxQueue(uint32_t capacity = kDefaultCapacity);
+
+    /// Thread safe
+    ///     @return false: Queue is full, the write was dropped
+    bool push(const char *data, qsizetype length);
+
+    /// Thread safe. Same as push, but a full queue is not counted as a dropped write since the caller retries.
+    bool tryPush(const char *data, qsizetype length);
+
+    /// Largest write which fits into an empty queue
+    qsizetype maxWriteSize() const { return static_cast<qsizetype>(_capacity) * kSlotDataSize; }
+
+    /// Consumer only. Appends queued writes to buffer in order. Stops before a write which would grow
+    /// buffer past maxSize, unless buffer is still empty. Writes are never split.
+    ///     @return Number of writes appended
+    int drain(QByteArray &buffer, qsizetype maxSize);
+
+    Stats stats() const;
+
+    static constexpr uint32_t kDefaultCapacity = 1024;
+    static constexpr qsizetype kSlotDataSize = MAVLINK_MAX_PACKET_LEN;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};
+        uint16_t length = 0;
+        uint16_t slotCount = 0;             ///< Slots used by the write, only set on its first slot
+        char data[kSlotDataSize];
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    const uint32_t _capacity;
+    const uint64_t _mask;
+
+    alignas(64) std::atomic<uint64_t> _enqueuePos{0};
+    std::atomic<uint64_t> _writesQueued{0};
+    std::atomic<uint64_t> _writesDropped{0};
+    std::atomic<uint64_t> _bytesQueued{0};
+
+    alignas(64) std::atomic<uint64_t> _dequeuePos{0};
+    std::atomic<uint64_t> _linkWrites{0};
+    std::atomic<uint32_t> _maxDepth{0};
+};
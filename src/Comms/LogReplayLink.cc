@@ -13,8 +13,8 @@
 #include "MultiVehicleManager.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFileInfo>
-#include <QtCore/QtEndian>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
@@ -102,6 +102,8 @@ void LogReplayWorker::setup()
 {
     Q_ASSERT(!_readTickTimer);
     _readTickTimer = new QTimer(this);
+    // Real time playback schedules each next read itself, max throughput only needs the first one
+    _readTickTimer->setSingleShot(true);
 
     (void) connect(_readTickTimer, &QTimer::timeout, this, &LogReplayWorker::_readNextLogEntry);
 }
@@ -131,6 +133,8 @@ void LogReplayWorker::connectToLog()
 
 void LogReplayWorker::disconnectFromLog()
 {
+    _closeLogFile();
+
     if (!isConnected()) {
         qCDebug(LogReplayLinkLog) << "Already disconnected";
         return;
@@ -142,23 +146,17 @@ void LogReplayWorker::disconnectFromLog()
     _readTickTimer->stop();
 }
 
-bool LogReplayWorker::isPlaying() const
-{
-    return (_readTickTimer && _readTickTimer->isActive());
-}
-
 void LogReplayWorker::play()
 {
     LinkManager::instance()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
     MAVLinkProtocol::instance()->suspendLogForReplay(true);
 
-    if (_logFile.atEnd()) {
+    if (_atEnd) {
         _resetPlaybackToBeginning();
     }
 
-    _playbackStartTimeMSecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch());
-    _playbackStartLogTimeUSecs = _logCurrentTimeUSecs;
-    _readTickTimer->start(1);
+    _isPlaying = true;
+    _startPlayback();
 
     emit playbackStarted();
 }
@@ -168,6 +166,7 @@ void LogReplayWorker::pause()
     LinkManager::instance()->setConnectionsAllowed();
     MAVLinkProtocol::instance()->suspendLogForReplay(false);
 
+    _isPlaying = false;
     _readTickTimer->stop();
 
     emit playbackPaused();
@@ -178,7 +177,37 @@ void LogReplayWorker::setPlaybackSpeed(qreal playbackSpeed)
     _playbackSpeed = playbackSpeed;
     _playbackStartTimeMSecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch());
     _playbackStartLogTimeUSecs = _logCurrentTimeUSecs;
-    _readTickTimer->start(1);
+    if (_isPlaying) {
+        _readTickTimer->start(1);
+    }
+}
+
+void LogReplayWorker::setMaxThroughput(bool maxThroughput)
+{
+    if (maxThroughput == _maxThroughput) {
+        return;
+    }
+
+    _maxThroughput = maxThroughput;
+    if (_isPlaying) {
+        _startPlayback();
+    }
+}
+
+void LogReplayWorker::batchConsumed()
+{
+    if (_batchMessageCounts.isEmpty()) {
+        return;
+    }
+
+    _messagesConsumed += _batchMessageCounts.dequeue();
+
+    if (_isPlaying && _maxThroughput) {
+        _signalCurrentLogTimeSecs();
+        _signalPercentComplete();
+        _signalMessagesPerSecond(false);
+        _sendBatches();
+    }
 }
 
 void LogReplayWorker::movePlayhead(qreal percentComplete)
@@ -191,39 +220,27 @@ void LogReplayWorker::movePlayhead(qreal percentComplete)
     }
 
     percentComplete = qBound(0., percentComplete, 100.);
-    const qreal percentCompleteMult = percentComplete / 100.0;
-    const qint64 newFilePos = static_cast<qint64>(percentCompleteMult * static_cast<qreal>(_logFile.size()));
-    if (!_logFile.seek(newFilePos)) {
-        emit errorOccurred(tr("Unable to seek to new position"));
-        return;
-    }
+    const quint64 targetTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((percentComplete / 100.) * _logDurationUSecs);
 
-    mavlink_message_t dummy{};
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(dummy);
+    // The index gets us within kEntryIntervalUSecs of the target, the rest is a short forward scan
+    _readRecordAt(_index.offsetForTime(targetTimeUSecs));
+    while (!_atEnd && (_nextRecord.timestampUSecs < targetTimeUSecs)) {
+        _readRecordAt(_nextRecord.nextOffset());
+    }
 
-    qreal newRelativeTimeUSecs = static_cast<qreal>(_logCurrentTimeUSecs - _logStartTimeUSecs);
-    const qreal baudRate = _logFile.size() / static_cast<qreal>(_logDurationUSecs) / 1e6;
-    const qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
-    const qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
+    if (_atEnd) {
         emit errorOccurred(tr("Unable to seek to new position"));
         return;
     }
 
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(dummy);
     _signalCurrentLogTimeSecs();
-
-    newRelativeTimeUSecs = static_cast<qreal>(_logCurrentTimeUSecs - _logStartTimeUSecs);
-    percentComplete = ((newRelativeTimeUSecs / _logDurationUSecs) * 100);
-    emit playbackPercentCompleteChanged(percentComplete);
+    _signalPercentComplete();
 }
 
 void LogReplayWorker::_resetPlaybackToBeginning()
 {
-    if (_logFile.isOpen()) {
-        if (!_logFile.reset()) {
-            qCWarning(LogReplayLinkLog) << "failed to reset log file:" << _logFile.error() << _logFile.errorString();
-        }
+    if (_logData) {
+        _readRecordAt(0);
     }
 
     _playbackStartTimeMSecs = 0;
@@ -231,24 +248,67 @@ void LogReplayWorker::_resetPlaybackToBeginning()
     _logCurrentTimeUSecs = _logStartTimeUSecs;
 }
 
+void LogReplayWorker::_startPlayback()
+{
+    _playbackStartTimeMSecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch());
+    _playbackStartLogTimeUSecs = _logCurrentTimeUSecs;
+    _messagesConsumed = 0;
+    _lastThroughputReportMSecs = 0;
+    _throughputTimer.start();
+    _readTickTimer->start(1);
+}
+
+void LogReplayWorker::_sendBatches()
+{
+    // Frames are contiguous in the log apart from the timestamps, so a batch is a handful of copies out of the mapping
+    while (!_atEnd && (_batchMessageCounts.size() < kMaxBatchesInFlight)) {
+        QByteArray batch;
+        batch.reserve(kBatchSize + MAVLINK_MAX_PACKET_LEN);
+        quint64 messageCount = 0;
+        while (!_atEnd && (batch.size() < kBatchSize)) {
+            (void) batch.append(reinterpret_cast<const char*>(_logData + _nextRecord.frameOffset), _nextRecord.frameLength);
+            messageCount++;
+            _readRecordAt(_nextRecord.nextOffset());
+        }
+
+        _batchMessageCounts.enqueue(messageCount);
+        emit batchReceived(batch);
+    }
+
+    if (_atEnd && _batchMessageCounts.isEmpty()) {
+        _playbackComplete();
+    }
+}
+
+void LogReplayWorker::_playbackComplete()
+{
+    _signalCurrentLogTimeSecs();
+    _signalPercentComplete();
+    if (_maxThroughput) {
+        _signalMessagesPerSecond(true);
+    }
+    pause();
+    emit playbackAtEnd();
+}
+
 void LogReplayWorker::_readNextLogEntry()
 {
+    if (_maxThroughput) {
+        // Paced by batchConsumed from here on
+        _sendBatches();
+        return;
+    }
+
     int timeToNextExecutionMSecs = 0;
     while (timeToNextExecutionMSecs < 3) {
-        QByteArray bytes;
-        bytes.reserve(_logFile.bytesAvailable());
-        const qint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
-        emit dataReceived(bytes);
-        emit playbackPercentCompleteChanged((static_cast<float>(_logCurrentTimeUSecs - _logStartTimeUSecs) / static_cast<float>(_logDurationUSecs)) * 100);
-
-        if (_logFile.atEnd()) {
-            pause();
-            emit playbackAtEnd();
+        emit dataReceived(QByteArray(reinterpret_cast<const char*>(_logData + _nextRecord.frameOffset), _nextRecord.frameLength));
+
+        _readRecordAt(_nextRecord.nextOffset());
+        if (_atEnd) {
+            _playbackComplete();
             return;
         }
 
-        _logCurrentTimeUSecs = nextTimeUSecs;
-
         const quint64 currentTimeMSecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch());
         const quint64 desiredPlayheadMovementTimeMSecs = ((_logCurrentTimeUSecs - _playbackStartLogTimeUSecs) / 1000) / _playbackSpeed;
         const quint64 desiredCurrentTimeMSecs = _playbackStartTimeMSecs + desiredPlayheadMovementTimeMSecs;
@@ -256,6 +316,7 @@ void LogReplayWorker::_readNextLogEntry()
     }
 
     _signalCurrentLogTimeSecs();
+    _signalPercentComplete();
 
     _readTickTimer->start(timeToNextExecutionMSecs);
 }
@@ -265,10 +326,41 @@ void LogReplayWorker::_signalCurrentLogTimeSecs()
     emit currentLogTimeSecs((_logCurrentTimeUSecs - _logStartTimeUSecs) / 1000000);
 }
 
+void LogReplayWorker::_signalPercentComplete()
+{
+    emit playbackPercentCompleteChanged((static_cast<qreal>(_logCurrentTimeUSecs - _logStartTimeUSecs) / static_cast<qreal>(_logDurationUSecs)) * 100);
+}
+
+void LogReplayWorker::_signalMessagesPerSecond(bool force)
+{
+    const qint64 elapsedMSecs = _throughputTimer.elapsed();
+    if (!force && ((elapsedMSecs - _lastThroughputReportMSecs) < kThroughputReportMSecs)) {
+        return;
+    }
+
+    _lastThroughputReportMSecs = elapsedMSecs;
+    const qreal messagesPerSecond = (elapsedMSecs > 0) ? ((_messagesConsumed * 1000.) / elapsedMSecs) : 0.;
+    emit messagesPerSecondChanged(messagesPerSecond);
+
+    if (force) {
+        qCInfo(LogReplayLinkLog) << "Replayed" << _messagesConsumed << "messages in" << elapsedMSecs << "msecs," << messagesPerSecond << "messages/sec";
+    }
+}
+
+void LogReplayWorker::_readRecordAt(qint64 offset)
+{
+    if (TelemetryLogIndex::readRecord(_logData, _logFileSize, offset, _nextRecord)) {
+        _atEnd = false;
+        _logCurrentTimeUSecs = _nextRecord.timestampUSecs;
+    } else {
+        _atEnd = true;
+    }
+}
+
 bool LogReplayWorker::_loadLogFile()
 {
     if (_logFile.isOpen()) {
-        _logFile.close();
+        _closeLogFile();
         emit errorOccurred(tr("Attempt to load new log while log being played"));
         return false;
     }
@@ -280,26 +372,28 @@ bool LogReplayWorker::_loadLogFile()
         return false;
     }
 
-    QFileInfo logFileInfo;
-    logFileInfo.setFile(logFilename);
-    _logFileSize = logFileInfo.size();
+    _logFileSize = _logFile.size();
+    if (_logFileSize > 0) {
+        _logData = _logFile.map(0, _logFileSize);
+        if (!_logData) {
+            emit errorOccurred(tr("Unable to open log file: '%1', error: %2").arg(logFilename, _logFile.errorString()));
+            _closeLogFile();
+            return false;
+        }
 
-    const quint64 startTimeUSecs = _parseTimestamp(_logFile.read(kTimestamp));
-    const quint64 endTimeUSecs = _findLastTimestamp();
-    if (endTimeUSecs <= startTimeUSecs) {
-        _logFile.close();
+        _loadIndex();
+    }
+
+    if (_index.isEmpty() || (_index.durationUSecs() == 0)) {
+        _closeLogFile();
         emit errorOccurred(tr("The log file '%1' is corrupt or empty.").arg(logFilename));
         return false;
     }
 
-    _logEndTimeUSecs = endTimeUSecs;
-    _logStartTimeUSecs = startTimeUSecs;
-    _logDurationUSecs = endTimeUSecs - startTimeUSecs;
-    _logCurrentTimeUSecs = startTimeUSecs;
-
-    if (!_logFile.reset()) {
-        qCWarning(LogReplayLinkLog) << "failed to reset log file:" << _logFile.error() << _logFile.errorString();
-    }
+    _logStartTimeUSecs = _index.startTimeUSecs();
+    _logEndTimeUSecs = _index.endTimeUSecs();
+    _logDurationUSecs = _index.durationUSecs();
+    _readRecordAt(0);
 
     const quint64 logDurationSecondsTotal = _logDurationUSecs / 1000000;
     emit logFileStats(logDurationSecondsTotal);
@@ -307,92 +401,41 @@ bool LogReplayWorker::_loadLogFile()
     return true;
 }
 
-quint64 LogReplayWorker::_parseTimestamp(const QByteArray &bytes)
+void LogReplayWorker::_loadIndex()
 {
-    const quint64 currentTimestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
-    quint64 timestamp = qFromBigEndian(*reinterpret_cast<const quint64*>(bytes.constData()));
-    if (timestamp > currentTimestamp) {
-        timestamp = qbswap(timestamp);
-    }
-
-    return timestamp;
-}
-
-quint64 LogReplayWorker::_readNextMavlinkMessage(QByteArray &bytes)
-{
-    bytes.clear();
-
-    char nextByte;
-    while (_logFile.getChar(&nextByte)) {
-        mavlink_message_t message{};
-        mavlink_status_t status{};
-        const bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &message, &status);
-
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            bytes.clear();
-        }
-        (void) bytes.append(nextByte);
-
-        if (messageFound) {
-            const QByteArray rawTime = _logFile.read(kTimestamp);
-            return _parseTimestamp(rawTime);
-        }
+    const QString indexFileName = TelemetryLogIndex::indexFileName(_logFile.fileName());
+    if (_index.load(indexFileName, _logData, _logFileSize)) {
+        qCDebug(LogReplayLinkLog) << "Loaded index" << indexFileName << "records:" << _index.recordCount();
+        return;
     }
 
-    return 0;
-}
-
-quint64 LogReplayWorker::_seekToNextMavlinkMessage(mavlink_message_t &nextMsg)
-{
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    qint64 messageStartPos = -1;
-    char nextByte;
-    while (_logFile.getChar(&nextByte)) {
-        mavlink_status_t status{};
-        const bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &nextMsg, &status);
-
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            messageStartPos = _logFile.pos() - 1;
-        }
-
-        if (messageFound && (messageStartPos != -1)) {
-            if (!_logFile.seek(messageStartPos - kTimestamp)) {
-                qCWarning(LogReplayLinkLog) << "Failed to seek next message:" << _logFile.error() << _logFile.errorString();
-                break;
-            }
+    // No usable index, build it once and keep it for next time
+    QElapsedTimer timer;
+    timer.start();
+    _index.build(_logData, _logFileSize);
+    qCDebug(LogReplayLinkLog) << "Indexed" << _index.recordCount() << "records in" << timer.elapsed() << "msecs";
 
-            const QByteArray rawTime = _logFile.read(kTimestamp);
-            return _parseTimestamp(rawTime);
-        }
+    if (!_index.isEmpty()) {
+        (void) _index.save(indexFileName);
     }
-
-    return 0;
 }
 
-quint64 LogReplayWorker::_findLastTimestamp()
+void LogReplayWorker::_closeLogFile()
 {
-    if (!_logFile.reset()) {
-        qCWarning(LogReplayLinkLog) << "failed to reset log file:" << _logFile.error() << _logFile.errorString();
+    if (_logData) {
+        (void) _logFile.unmap(_logData);
+        _logData = nullptr;
     }
 
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    quint64 lastTimestamp = 0;
-
-    while (_logFile.bytesAvailable() > kTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(kTimestamp));
-
-        bool endOfMessage = false;
-        char nextByte;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            mavlink_message_t msg{};
-            mavlink_status_t status{};
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
-        }
+    if (_logFile.isOpen()) {
+        _logFile.close();
     }
 
-    return lastTimestamp;
+    _logFileSize = 0;
+    _index.clear();
+    _nextRecord = TelemetryLogIndex::Record();
+    _atEnd = false;
+    _batchMessageCounts.clear();
 }
 
 /*===========================================================================*/
@@ -416,12 +459,14 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr &config, QObject *parent
     (void) connect(_worker, &LogReplayWorker::disconnected, this, &LogReplayLink::_onDisconnected, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::errorOccurred, this, &LogReplayLink::_onErrorOccurred, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::dataReceived, this, &LogReplayLink::_onDataReceived, Qt::QueuedConnection);
+    (void) connect(_worker, &LogReplayWorker::batchReceived, this, &LogReplayLink::_onBatchReceived, Qt::QueuedConnection);
 
     (void) connect(_worker, &LogReplayWorker::logFileStats, this, &LogReplayLink::logFileStats, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::playbackStarted, this, &LogReplayLink::playbackStarted, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::playbackPaused, this, &LogReplayLink::playbackPaused, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::playbackPercentCompleteChanged, this, &LogReplayLink::playbackPercentCompleteChanged, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::currentLogTimeSecs, this, &LogReplayLink::currentLogTimeSecs, Qt::QueuedConnection);
+    (void) connect(_worker, &LogReplayWorker::messagesPerSecondChanged, this, &LogReplayLink::messagesPerSecondChanged, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::disconnected, this, &LogReplayLink::disconnected, Qt::QueuedConnection);
 
     _workerThread->start();
@@ -460,6 +505,16 @@ void LogReplayLink::_onDataReceived(const QByteArray &data)
     emit bytesReceived(this, data);
 }
 
+void LogReplayLink::_onBatchReceived(const QByteArray &data)
+{
+    emit bytesReceived(this, data);
+
+    // Only ask for more once everything received so far has made it through MAVLinkProtocol and Vehicle
+    MAVLinkProtocol::instance()->notifyWhenReceiveDrained(this, [this]() {
+        (void) QMetaObject::invokeMethod(_worker, "batchConsumed", Qt::QueuedConnection);
+    });
+}
+
 void LogReplayLink::play()
 {
     (void) QMetaObject::invokeMethod(_worker, "play", Qt::QueuedConnection);
@@ -475,6 +530,11 @@ void LogReplayLink::setPlaybackSpeed(qreal playbackSpeed)
     (void) QMetaObject::invokeMethod(_worker, "setPlaybackSpeed", Qt::QueuedConnection, playbackSpeed);
 }
 
+void LogReplayLink::setMaxThroughput(bool maxThroughput)
+{
+    (void) QMetaObject::invokeMethod(_worker, "setMaxThroughput", Qt::QueuedConnection, maxThroughput);
+}
+
 void LogReplayLink::movePlayhead(qreal percentComplete)
 {
     (void) QMetaObject::invokeMethod(_worker, "movePlayhead", Qt::QueuedConnection, percentComplete);
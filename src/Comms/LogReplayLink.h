@@ -9,17 +9,18 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QQueue>
 #include <QtCore/QLoggingCategory>
 #include <QtQmlIntegration/QtQmlIntegration>
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "TelemetryLogIndex.h"
 
 class QTimer;
 
-typedef struct __mavlink_message mavlink_message_t;
-
 Q_DECLARE_LOGGING_CATEGORY(LogReplayLinkLog)
 
 /*===========================================================================*/
@@ -65,13 +66,20 @@ class LogReplayWorker : public QObject
     ~LogReplayWorker();
 
     bool isConnected() const { return _isConnected; }
-    bool isPlaying() const;
+    bool isPlaying() const { return _isPlaying; }
+
+    static constexpr qsizetype kBatchSize = 64 * 1024;  ///< Max throughput mode: frames sent per batch
+    static constexpr int kMaxBatchesInFlight = 4;       ///< Max throughput mode: batches sent but not yet consumed
+    static constexpr int kThroughputReportMSecs = 1000;
 
 signals:
     void connected();
     void disconnected();
     void errorOccurred(const QString &errorString);
     void dataReceived(const QByteArray &data);
+    /// Max throughput mode: batchConsumed must be called once data has been consumed
+    void batchReceived(const QByteArray &data);
+    void messagesPerSecondChanged(qreal messagesPerSecond);
     void logFileStats(uint32_t logDurationSecs);
     void playbackStarted();
     void playbackPaused();
@@ -86,25 +94,33 @@ public slots:
     void play();
     void pause();
     void setPlaybackSpeed(qreal playbackSpeed);
+    /// Max throughput mode ignores the log timestamps and plays as fast as the received data is consumed
+    void setMaxThroughput(bool maxThroughput);
     void movePlayhead(qreal percentComplete);
+    void batchConsumed();
 
 private slots:
     void _readNextLogEntry();
 
 private:
-    quint64 _parseTimestamp(const QByteArray &bytes);
-    quint64 _seekToNextMavlinkMessage(mavlink_message_t &nextMsg);
-    quint64 _findLastTimestamp();
-    quint64 _readNextMavlinkMessage(QByteArray &bytes);
     bool _loadLogFile();
+    void _loadIndex();
+    void _closeLogFile();
+    /// Reads the first record at or after offset into _nextRecord
+    void _readRecordAt(qint64 offset);
     void _resetPlaybackToBeginning();
+    void _startPlayback();
+    void _sendBatches();
+    void _playbackComplete();
     void _signalCurrentLogTimeSecs();
+    void _signalPercentComplete();
+    void _signalMessagesPerSecond(bool force);
 
     const LogReplayConfiguration *_logReplayConfig = nullptr;
     QTimer *_readTickTimer = nullptr;
 
     bool _isConnected = false;
-    uint8_t _mavlinkChannel = 0;
+    bool _isPlaying = false;
 
     quint64 _logCurrentTimeUSecs = 0;
     quint64 _logStartTimeUSecs = 0;
@@ -115,10 +131,18 @@ private slots:
     quint64 _playbackStartTimeMSecs = 0;
     quint64 _playbackStartLogTimeUSecs = 0;
 
-    QFile _logFile;
-    quint64 _logFileSize = 0;
+    bool _maxThroughput = false;
+    QQueue<quint64> _batchMessageCounts;    ///< Message count of each batch in flight
+    quint64 _messagesConsumed = 0;
+    QElapsedTimer _throughputTimer;
+    qint64 _lastThroughputReportMSecs = 0;
 
-    static constexpr size_t kTimestamp = sizeof(quint64);
+    QFile _logFile;
+    qint64 _logFileSize = 0;
+    uchar *_logData = nullptr;          ///< Log file mapped into memory
+    TelemetryLogIndex _index;
+    TelemetryLogIndex::Record _nextRecord;
+    bool _atEnd = false;
 };
 
 /*===========================================================================*/
@@ -139,6 +163,7 @@ class LogReplayLink : public LinkInterface
     void play();
     void pause();
     void setPlaybackSpeed(qreal playbackSpeed);
+    void setMaxThroughput(bool maxThroughput);
     void movePlayhead(qreal percentComplete);
 
 signals:
@@ -148,6 +173,7 @@ class LogReplayLink : public LinkInterface
     void playbackAtEnd();
     void playbackPercentCompleteChanged(qreal percentComplete);
     void currentLogTimeSecs(uint32_t secs);
+    void messagesPerSecondChanged(qreal messagesPerSecond);
 
 private slots:
     void _writeBytes(const QByteArray &bytes) override { Q_UNUSED(bytes); }
@@ -155,6 +181,7 @@ private slots:
     void _onDisconnected() { emit disconnected(); }
     void _onErrorOccurred(const QString &errorString);
     void _onDataReceived(const QByteArray &data);
+    void _onBatchReceived(const QByteArray &data);
 
 private:
     bool _connect() override;
@@ -28,6 +28,7 @@ void LogReplayLinkController::setLink(LogReplayLink *link)
     if (_link) {
         (void) disconnect(_link);
         (void) disconnect(this, &LogReplayLinkController::playbackSpeedChanged, _link, &LogReplayLink::setPlaybackSpeed);
+        (void) disconnect(this, &LogReplayLinkController::maxThroughputChanged, _link, &LogReplayLink::setMaxThroughput);
 
         _isPlaying = false;
         emit isPlayingChanged(_isPlaying);
@@ -41,6 +42,9 @@ void LogReplayLinkController::setLink(LogReplayLink *link)
         _totalTime.clear();
         emit totalTimeChanged(_totalTime);
 
+        _messagesPerSecond = 0;
+        emit messagesPerSecondChanged(_messagesPerSecond);
+
         _link = nullptr;
         emit linkChanged(_link);
     }
@@ -53,9 +57,15 @@ void LogReplayLinkController::setLink(LogReplayLink *link)
         (void) connect(_link, &LogReplayLink::playbackPaused, this, &LogReplayLinkController::_playbackPaused);
         (void) connect(_link, &LogReplayLink::playbackPercentCompleteChanged, this, &LogReplayLinkController::_playbackPercentCompleteChanged);
         (void) connect(_link, &LogReplayLink::currentLogTimeSecs, this, &LogReplayLinkController::_currentLogTimeSecs);
+        (void) connect(_link, &LogReplayLink::messagesPerSecondChanged, this, &LogReplayLinkController::_messagesPerSecondChanged);
         (void) connect(_link, &LogReplayLink::disconnected, this, &LogReplayLinkController::_linkDisconnected);
 
         (void) connect(this, &LogReplayLinkController::playbackSpeedChanged, _link, &LogReplayLink::setPlaybackSpeed);
+        (void) connect(this, &LogReplayLinkController::maxThroughputChanged, _link, &LogReplayLink::setMaxThroughput);
+
+        if (_maxThroughput) {
+            _link->setMaxThroughput(_maxThroughput);
+        }
 
         emit linkChanged(_link);
     }
@@ -116,6 +126,14 @@ void LogReplayLinkController::_playbackPercentCompleteChanged(qreal percentCompl
     }
 }
 
+void LogReplayLinkController::_messagesPerSecondChanged(qreal messagesPerSecond)
+{
+    if (messagesPerSecond != _messagesPerSecond) {
+        _messagesPerSecond = messagesPerSecond;
+        emit messagesPerSecondChanged(_messagesPerSecond);
+    }
+}
+
 void LogReplayLinkController::_currentLogTimeSecs(uint32_t secs)
 {
     if (secs != _playheadSecs) {
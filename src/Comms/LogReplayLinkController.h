@@ -26,6 +26,8 @@ class LogReplayLinkController : public QObject
     Q_PROPERTY(QString          totalTime       MEMBER  _totalTime                                  NOTIFY totalTimeChanged)
     Q_PROPERTY(QString          playheadTime    MEMBER  _playheadTime                               NOTIFY playheadTimeChanged)
     Q_PROPERTY(qreal            playbackSpeed   MEMBER  _playbackSpeed                              NOTIFY playbackSpeedChanged)
+    Q_PROPERTY(bool             maxThroughput   MEMBER  _maxThroughput                              NOTIFY maxThroughputChanged)
+    Q_PROPERTY(qreal            messagesPerSecond MEMBER _messagesPerSecond                         NOTIFY messagesPerSecondChanged)
 
 public:
     explicit LogReplayLinkController(QObject *parent = nullptr);
@@ -43,6 +45,8 @@ class LogReplayLinkController : public QObject
 signals:
     void isPlayingChanged(bool isPlaying);
     void linkChanged(LogReplayLink *link);
+    void maxThroughputChanged(bool maxThroughput);
+    void messagesPerSecondChanged(qreal messagesPerSecond);
     void percentCompleteChanged(qreal percentComplete);
     void playbackSpeedChanged(qreal playbackSpeed);
     void playheadTimeChanged(const QString &playheadTime);
@@ -52,6 +56,7 @@ private slots:
     void _currentLogTimeSecs(uint32_t secs);
     void _linkDisconnected() { setLink(nullptr); }
     void _logFileStats(uint32_t logDurationSecs);
+    void _messagesPerSecondChanged(qreal messagesPerSecond);
     void _playbackAtEnd();
     void _playbackPaused();
     void _playbackPercentCompleteChanged(qreal percentComplete);
@@ -64,6 +69,8 @@ private slots:
     qreal _percentComplete = 0;
     uint32_t _playheadSecs = 0;
     qreal _playbackSpeed = 1;
+    bool _maxThroughput = false;
+    qreal _messagesPerSecond = 0;
     QString _playheadTime;
     QString _totalTime;
     LogReplayLink *_link = nullptr;
@@ -0,0 +1,229 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkDecodeWorker.h"
+#include "LinkInterface.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(MAVLinkDecodeWorkerLog, "qgc.comms.mavlinkdecodeworker")
+
+MAVLinkDecodeWorker::MAVLinkDecodeWorker(QObject *parent)
+    : QObject(parent)
+    , _flushTimer(new QTimer(this))
+{
+    (void) qRegisterMetaType<QList<MAVLinkDecodeWorker::DecodedBatch>>("QList<MAVLinkDecodeWorker::DecodedBatch>");
+
+    _flushTimer->setSingleShot(true);
+    _flushTimer->setTimerType(Qt::PreciseTimer);
+    _flushTimer->setInterval(_batchIntervalMSecs);
+    (void) connect(_flushTimer, &QTimer::timeout, this, &MAVLinkDecodeWorker::_flush);
+
+    // The channel signing configuration belongs to the GUI thread, the parsers only use the snapshots handed over with the bytes
+    for (MAVLinkFrameParser &frameParser : _frameParsers) {
+        frameParser.setSigning(nullptr);
+    }
+
+    qCDebug(MAVLinkDecodeWorkerLog) << this;
+}
+
+MAVLinkDecodeWorker::~MAVLinkDecodeWorker()
+{
+    qCDebug(MAVLinkDecodeWorkerLog) << this;
+}
+
+void MAVLinkDecodeWorker::setBatchInterval(int msecs)
+{
+    _batchIntervalMSecs = qMax(0, msecs);
+    _flushTimer->setInterval(_batchIntervalMSecs);
+}
+
+void MAVLinkDecodeWorker::resetChannel(uint8_t mavlinkChannel)
+{
+    _totalReceiveCounter[mavlinkChannel] = 0;
+    _totalLossCounter[mavlinkChannel] = 0;
+    _runningLossPercent[mavlinkChannel] = 0.f;
+    _frameParsers[mavlinkChannel].setMavlinkChannel(mavlinkChannel);
+}
+
+MAVLinkDecodeWorker::SigningSnapshot MAVLinkDecodeWorker::signingSnapshot(uint8_t mavlinkChannel)
+{
+    SigningSnapshot snapshot;
+
+    const mavlink_status_t *const status = mavlink_get_channel_status(mavlinkChannel);
+    if (status->signing) {
+        snapshot.enabled = true;
+        snapshot.signing = *status->signing;
+    }
+
+    return snapshot;
+}
+
+void MAVLinkDecodeWorker::receiveBytes(const WeakLinkInterfacePtr &link, uint8_t mavlinkChannel, const QByteArray &data, const ForwardTargets &forwardTargets, const SigningSnapshot &signing)
+{
+    _applySigning(mavlinkChannel, signing);
+
+    QList<mavlink_message_t> frames;
+    if (_frameParsers[mavlinkChannel].parse(data, frames) == 0) {
+        return;
+    }
+
+    const SharedLinkInterfacePtr forwardingLink = _lockForwardingLink(forwardTargets.forwardingLink);
+    const SharedLinkInterfacePtr forwardingSupportLink = _lockForwardingLink(forwardTargets.forwardingSupportLink);
+
+    for (const mavlink_message_t &message : std::as_const(frames)) {
+        _updateCounters(mavlinkChannel, message);
+        _forward(forwardingLink, forwardingSupportLink, message);
+        _updateStatus(mavlinkChannel, message);
+        _batchFor(link, message.sysid).append(message);
+    }
+
+    if (_batchIntervalMSecs == 0) {
+        _flush();
+    } else if (!_flushTimer->isActive()) {
+        _flushTimer->start();
+    }
+}
+
+void MAVLinkDecodeWorker::_applySigning(uint8_t mavlinkChannel, const SigningSnapshot &signing)
+{
+    // The parser keeps its own signing state so replay protection carries on from chunk to chunk,
+    // it only starts over when the signing setup of the channel changes
+    SigningSnapshot &applied = _appliedSigning[mavlinkChannel];
+    if (signing.enabled == applied.enabled) {
+        if (!signing.enabled) {
+            return;
+        }
+        if ((signing.signing.link_id == applied.signing.link_id) &&
+                (signing.signing.accept_unsigned_callback == applied.signing.accept_unsigned_callback) &&
+                (memcmp(signing.signing.secret_key, applied.signing.secret_key, sizeof(applied.signing.secret_key)) == 0)) {
+            return;
+        }
+    }
+
+    applied = signing;
+    _frameParsers[mavlinkChannel].setSigning(signing.enabled ? &signing.signing : nullptr);
+}
+
+SharedLinkInterfacePtr MAVLinkDecodeWorker::_lockForwardingLink(const WeakLinkInterfacePtr &weakLink)
+{
+    SharedLinkInterfacePtr link = weakLink.lock();
+    if (!link) {
+        return link;
+    }
+
+    // If the GUI thread drops the link while it is locked here, the last reference must not be released
+    // on this thread. Keep one until the next delivery, which hands them back to the GUI thread.
+    const auto it = std::find(_forwardedLinks.cbegin(), _forwardedLinks.cend(), link);
+    if (it == _forwardedLinks.cend()) {
+        _forwardedLinks.append(link);
+    }
+
+    return link;
+}
+
+QList<mavlink_message_t> &MAVLinkDecodeWorker::_batchFor(const WeakLinkInterfacePtr &link, uint8_t sysid)
+{
+    for (DecodedBatch &batch : _pendingBatches) {
+        // Same control block, so the same link even if the address has been reused since
+        if ((batch.sysid == sysid) && !batch.link.owner_before(link) && !link.owner_before(batch.link)) {
+            return batch.messages;
+        }
+    }
+
+    DecodedBatch &batch = _pendingBatches.emplaceBack();
+    batch.link = link;
+    batch.sysid = sysid;
+    return batch.messages;
+}
+
+void MAVLinkDecodeWorker::flush()
+{
+    _flushTimer->stop();
+    _flush();
+}
+
+void MAVLinkDecodeWorker::_flush()
+{
+    if (!_pendingBatches.isEmpty()) {
+        const QList<DecodedBatch> batches = std::exchange(_pendingBatches, QList<DecodedBatch>());
+        emit framesDecoded(batches);
+    }
+
+    if (!_forwardedLinks.isEmpty()) {
+        // Moved into the call so no reference is left on this thread, links own thread objects and must be destroyed on the GUI thread
+        (void) QMetaObject::invokeMethod(QCoreApplication::instance(), [links = std::exchange(_forwardedLinks, QList<SharedLinkInterfacePtr>())]() {
+            Q_UNUSED(links);
+        }, Qt::QueuedConnection);
+    }
+}
+
+void MAVLinkDecodeWorker::_updateCounters(uint8_t mavlinkChannel, const mavlink_message_t &message)
+{
+    _totalReceiveCounter[mavlinkChannel]++;
+
+    uint8_t &lastSeq = _lastIndex[message.sysid][message.compid];
+
+    const QPair<uint8_t,uint8_t> key(message.sysid, message.compid);
+    uint8_t expectedSeq;
+    if (!_firstMessageSeen.contains(key)) {
+        _firstMessageSeen.insert(key);
+        expectedSeq = message.seq;
+    } else {
+        expectedSeq = lastSeq + 1;
+    }
+
+    uint64_t lostMessages;
+    if (message.seq >= expectedSeq) {
+        lostMessages = message.seq - expectedSeq;
+    } else {
+        lostMessages = static_cast<uint64_t>(message.seq) + 256ULL - expectedSeq;
+    }
+    _totalLossCounter[mavlinkChannel] += lostMessages;
+
+    lastSeq = message.seq;
+
+    const uint64_t totalSent = _totalReceiveCounter[mavlinkChannel] + _totalLossCounter[mavlinkChannel];
+    const float currentLossPercent = (static_cast<double>(_totalLossCounter[mavlinkChannel]) / totalSent) * 100.0f;
+    _runningLossPercent[mavlinkChannel] = (currentLossPercent + _runningLossPercent[mavlinkChannel]) * 0.5f;
+}
+
+void MAVLinkDecodeWorker::_updateStatus(uint8_t mavlinkChannel, const mavlink_message_t &message)
+{
+    if ((_totalReceiveCounter[mavlinkChannel] % 31) == 0) {
+        const uint64_t totalSent = _totalReceiveCounter[mavlinkChannel] + _totalLossCounter[mavlinkChannel];
+        emit messageStatus(message.sysid, totalSent, _totalReceiveCounter[mavlinkChannel], _totalLossCounter[mavlinkChannel], _runningLossPercent[mavlinkChannel]);
+    }
+}
+
+void MAVLinkDecodeWorker::_forward(const SharedLinkInterfacePtr &forwardingLink, const SharedLinkInterfacePtr &forwardingSupportLink, const mavlink_message_t &message)
+{
+    if (message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
+        return;
+    }
+
+    if (!forwardingLink && !forwardingSupportLink) {
+        return;
+    }
+
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN]{};
+    const uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
+
+    // writeBytesThreadSafe queues the write to the thread owning the link
+    if (forwardingLink) {
+        forwardingLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buf), len);
+    }
+    if (forwardingSupportLink) {
+        forwardingSupportLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buf), len);
+    }
+}
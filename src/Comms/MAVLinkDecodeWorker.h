@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+
+#include "LinkInterface.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkLib.h"
+
+class QTimer;
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkDecodeWorkerLog)
+
+/// Runs the MAVLink receive pipeline on the decode thread owned by MAVLinkProtocol.
+/// Framing, loss counting and forwarding happen here. Decoded messages are grouped per link and
+/// system id and handed back to the GUI thread at most once per batch interval.
+class MAVLinkDecodeWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Links which decoded messages are forwarded to, resolved by MAVLinkProtocol on the GUI thread.
+    /// The worker locks them while it forwards a chunk and hands the references back to the GUI thread,
+    /// so a link removed in the meantime is still destroyed on the GUI thread.
+    struct ForwardTargets {
+        WeakLinkInterfacePtr forwardingLink;
+        WeakLinkInterfacePtr forwardingSupportLink;
+    };
+
+    /// Copy of the signing setup of a channel, taken on the GUI thread which sets signing up
+    struct SigningSnapshot {
+        bool enabled = false;
+        mavlink_signing_t signing{};
+    };
+
+    /// Messages received from a single system on a single link.
+    /// The link is only locked on the GUI thread. Unlike a raw pointer it can't match a new link which was
+    /// created at the address of a removed one.
+    struct DecodedBatch {
+        WeakLinkInterfacePtr link;
+        uint8_t sysid = 0;
+        QList<mavlink_message_t> messages;
+    };
+
+    explicit MAVLinkDecodeWorker(QObject *parent = nullptr);
+    ~MAVLinkDecodeWorker();
+
+    /// Sets how often decoded batches are delivered. 0 delivers after every received chunk.
+    void setBatchInterval(int msecs);
+
+    /// Resets framing and loss counters for a newly allocated channel
+    void resetChannel(uint8_t mavlinkChannel);
+
+    /// Decodes a chunk of bytes received on link
+    void receiveBytes(const WeakLinkInterfacePtr &link, uint8_t mavlinkChannel, const QByteArray &data, const ForwardTargets &forwardTargets, const SigningSnapshot &signing);
+
+    /// Snapshot of the current signing setup of a channel, must be called on the thread which sets signing up
+    static SigningSnapshot signingSnapshot(uint8_t mavlinkChannel);
+
+    /// Delivers pending batches now instead of waiting for the batch interval
+    void flush();
+
+    static constexpr int kDefaultBatchIntervalMSecs = 10;
+
+signals:
+    void framesDecoded(const QList<MAVLinkDecodeWorker::DecodedBatch> &batches);
+    void messageStatus(int sysid, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
+
+private slots:
+    void _flush();
+
+private:
+    void _updateCounters(uint8_t mavlinkChannel, const mavlink_message_t &message);
+    void _updateStatus(uint8_t mavlinkChannel, const mavlink_message_t &message);
+    void _applySigning(uint8_t mavlinkChannel, const SigningSnapshot &signing);
+    SharedLinkInterfacePtr _lockForwardingLink(const WeakLinkInterfacePtr &weakLink);
+    static void _forward(const SharedLinkInterfacePtr &forwardingLink, const SharedLinkInterfacePtr &forwardingSupportLink, const mavlink_message_t &message);
+    QList<mavlink_message_t> &_batchFor(const WeakLinkInterfacePtr &link, uint8_t sysid);
+
+    QTimer *_flushTimer = nullptr;
+    int _batchIntervalMSecs = kDefaultBatchIntervalMSecs;
+    QList<DecodedBatch> _pendingBatches;
+    QList<SharedLinkInterfacePtr> _forwardedLinks;             ///< Released on the GUI thread with the next delivery
+
+    MAVLinkFrameParser _frameParsers[MAVLINK_COMM_NUM_BUFFERS];  ///< Per channel framing state
+    SigningSnapshot _appliedSigning[MAVLINK_COMM_NUM_BUFFERS];  ///< Signing setup the parsers currently check against
+    uint8_t _lastIndex[256][256]{};                             ///< Store the last received sequence ID for each system/component pair
+    QSet<QPair<uint8_t,uint8_t>> _firstMessageSeen;
+    uint64_t _totalReceiveCounter[MAVLINK_COMM_NUM_BUFFERS]{};  ///< The total number of successfully received messages
+    uint64_t _totalLossCounter[MAVLINK_COMM_NUM_BUFFERS]{};     ///< Total messages lost during transmission.
+    float _runningLossPercent[MAVLINK_COMM_NUM_BUFFERS]{};      ///< Loss rate
+};
@@ -0,0 +1,291 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriter.h"
+#include "MAVLinkFrameParser.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+
+QGC_LOGGING_CATEGORY(MAVLinkLogWriterLog, "qgc.comms.mavlinklogwriter")
+
+MAVLinkLogWriter::MAVLinkLogWriter(QObject *parent)
+    : QObject(parent)
+    , _file(this)
+{
+    qCDebug(MAVLinkLogWriterLog) << this;
+}
+
+MAVLinkLogWriter::~MAVLinkLogWriter()
+{
+    qCDebug(MAVLinkLogWriterLog) << this;
+}
+
+bool MAVLinkLogWriter::open(const QString &fileName)
+{
+    if (_open) {
+        return true;
+    }
+
+    // All pages are allocated up front so nothing is allocated while logging
+    _page = QByteArray(kPageSize, Qt::Uninitialized);
+    _pageUsed = 0;
+    {
+        QMutexLocker locker(&_freePagesMutex);
+        _freePages.clear();
+        for (int i = 1; i < kPageCount; i++) {
+            _freePages.append(QByteArray(kPageSize, Qt::Uninitialized));
+        }
+    }
+
+    _writeFailed = false;
+    _dropping = false;
+    _logOffset = 0;
+    _index.clear();
+    _recordsLogged = 0;
+    _recordsDropped = 0;
+    _bytesDropped = 0;
+    _pagesWritten = 0;
+    _bytesWritten = 0;
+
+    bool opened = false;
+    (void) QMetaObject::invokeMethod(this, [this, fileName]() {
+        return _openFile(fileName);
+    }, Qt::BlockingQueuedConnection, &opened);
+
+    if (!opened) {
+        _page.clear();
+        QMutexLocker locker(&_freePagesMutex);
+        _freePages.clear();
+        return false;
+    }
+
+    _epochUSecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+    _clock.start();
+    _handOffTimer.start();
+    _open = true;
+
+    return true;
+}
+
+void MAVLinkLogWriter::close()
+{
+    if (!_open) {
+        return;
+    }
+
+    _open = false;
+
+    // Pages already handed off are queued ahead of this call, so they are written first
+    QByteArray page = std::exchange(_page, QByteArray());
+    page.truncate(_pageUsed);
+    _pageUsed = 0;
+    _index.setLogSize(_logOffset);
+    (void) QMetaObject::invokeMethod(this, [this, page = std::move(page), index = std::exchange(_index, TelemetryLogIndex())]() mutable {
+        _writePage(std::move(page), false);
+        _closeFile(index);
+    }, Qt::BlockingQueuedConnection);
+
+    {
+        QMutexLocker locker(&_freePagesMutex);
+        _freePages.clear();
+    }
+
+    if (_recordsDropped > 0) {
+        qCWarning(MAVLinkLogWriterLog) << "Records dropped during log:" << _recordsDropped << "bytes:" << _bytesDropped;
+    }
+    qCDebug(MAVLinkLogWriterLog) << "Closed - records:" << _recordsLogged << "pages:" << _pagesWritten.load() << "bytes:" << _bytesWritten.load();
+}
+
+void MAVLinkLogWriter::appendMessage(const mavlink_message_t &message)
+{
+    const qsizetype maxLength = kTimestampSize + MAVLINK_MAX_PACKET_LEN;
+    uint8_t *const buf = _reserve(maxLength);
+    if (!buf) {
+        _recordDropped(kTimestampSize + MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len);
+        return;
+    }
+
+    const quint64 timestampUSecs = _timestampUSecs();
+    qToBigEndian(timestampUSecs, buf);
+    const uint16_t length = mavlink_msg_to_send_buffer(buf + kTimestampSize, &message);
+    _commit(kTimestampSize + length, timestampUSecs, true, message.msgid);
+}
+
+void MAVLinkLogWriter::appendBytes(QByteArrayView data)
+{
+    const qsizetype length = kTimestampSize + data.size();
+
+    // Only records holding a single frame are indexed, the same as when the index is built from the log
+    qsizetype frameLength = 0;
+    uint32_t msgid = 0;
+    const bool isFrame = MAVLinkFrameParser::checkFrame(reinterpret_cast<const uint8_t*>(data.data()), data.size(), frameLength, msgid) && (frameLength == data.size());
+
+    if (length > kPageSize) {
+        // Too large for a page, write it out on its own. Records must stay in order so the current page goes first.
+        if (!_open || _writeFailed || ((_pageUsed > 0) && !_handOffPage())) {
+            _recordDropped(length);
+            return;
+        }
+
+        const quint64 timestampUSecs = _timestampUSecs();
+        QByteArray record(length, Qt::Uninitialized);
+        qToBigEndian(timestampUSecs, record.data());
+        (void) memcpy(record.data() + kTimestampSize, data.data(), data.size());
+        (void) QMetaObject::invokeMethod(this, [this, record = std::move(record)]() mutable {
+            _writePage(std::move(record), false);
+        }, Qt::QueuedConnection);
+        _commit(length, timestampUSecs, isFrame, msgid);
+        // The record didn't go into the current page
+        _pageUsed = 0;
+        return;
+    }
+
+    uint8_t *const buf = _reserve(length);
+    if (!buf) {
+        _recordDropped(length);
+        return;
+    }
+
+    const quint64 timestampUSecs = _timestampUSecs();
+    qToBigEndian(timestampUSecs, buf);
+    (void) memcpy(buf + kTimestampSize, data.data(), data.size());
+    _commit(length, timestampUSecs, isFrame, msgid);
+}
+
+MAVLinkLogWriter::Stats MAVLinkLogWriter::stats() const
+{
+    Stats stats;
+    stats.recordsLogged = _recordsLogged;
+    stats.recordsDropped = _recordsDropped;
+    stats.bytesDropped = _bytesDropped;
+    stats.pagesWritten = _pagesWritten;
+    stats.bytesWritten = _bytesWritten;
+    return stats;
+}
+
+uint8_t *MAVLinkLogWriter::_reserve(qsizetype length)
+{
+    if (!_open || _writeFailed) {
+        return nullptr;
+    }
+
+    const bool fits = ((kPageSize - _pageUsed) >= length);
+    if (!fits || ((_pageUsed > 0) && _handOffTimer.hasExpired(kPageFlushIntervalMSecs))) {
+        // If no page is free the current one is kept, it may still have room for this record
+        if (!_handOffPage() && !fits) {
+            return nullptr;
+        }
+    }
+
+    return reinterpret_cast<uint8_t*>(_page.data()) + _pageUsed;
+}
+
+void MAVLinkLogWriter::_commit(qsizetype length, quint64 timestampUSecs, bool isFrame, uint32_t msgid)
+{
+    if (isFrame) {
+        _index.addRecord(_logOffset, timestampUSecs, msgid);
+    }
+
+    _pageUsed += length;
+    _logOffset += length;
+    _recordsLogged++;
+
+    if (_dropping) {
+        _dropping = false;
+        qCWarning(MAVLinkLogWriterLog) << "Log storage caught up, total records dropped:" << _recordsDropped;
+    }
+}
+
+void MAVLinkLogWriter::_recordDropped(qsizetype length)
+{
+    _recordsDropped++;
+    _bytesDropped += static_cast<uint64_t>(length);
+
+    if (!_dropping && _open && !_writeFailed) {
+        _dropping = true;
+        qCWarning(MAVLinkLogWriterLog) << "Log storage too slow, dropping records";
+    }
+}
+
+bool MAVLinkLogWriter::_handOffPage()
+{
+    QByteArray next;
+    {
+        QMutexLocker locker(&_freePagesMutex);
+        if (_freePages.isEmpty()) {
+            return false;
+        }
+        next = _freePages.takeLast();
+    }
+
+    QByteArray page = std::exchange(_page, std::move(next));
+    page.truncate(_pageUsed);
+    _pageUsed = 0;
+    _handOffTimer.restart();
+
+    (void) QMetaObject::invokeMethod(this, [this, page = std::move(page)]() mutable {
+        _writePage(std::move(page), true);
+    }, Qt::QueuedConnection);
+
+    return true;
+}
+
+quint64 MAVLinkLogWriter::_timestampUSecs() const
+{
+    // Monotonic, and cheaper than asking for the wall clock time for every record
+    return _epochUSecs + static_cast<quint64>(_clock.nsecsElapsed() / 1000);
+}
+
+bool MAVLinkLogWriter::_openFile(const QString &fileName)
+{
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(MAVLinkLogWriterLog) << "Failed to open" << fileName << _file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void MAVLinkLogWriter::_writePage(QByteArray page, bool recycle)
+{
+    if (!page.isEmpty() && _file.isOpen() && !_writeFailed) {
+        if ((_file.write(page) != page.size()) || !_file.flush()) {
+            qCWarning(MAVLinkLogWriterLog) << "Write failed" << _file.fileName() << _file.errorString();
+            _writeFailed = true;
+            emit writeFailed(_file.errorString());
+        } else {
+            _pagesWritten++;
+            _bytesWritten += static_cast<uint64_t>(page.size());
+        }
+    }
+
+    if (recycle) {
+        page.resize(kPageSize);
+        QMutexLocker locker(&_freePagesMutex);
+        _freePages.append(std::move(page));
+    }
+}
+
+void MAVLinkLogWriter::_closeFile(const TelemetryLogIndex &index)
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    _file.close();
+
+    // An index which doesn't match the file would be rejected when loading anyway
+    if (!_writeFailed && !index.isEmpty() && (_bytesWritten == static_cast<uint64_t>(_file.size()))) {
+        (void) index.save(TelemetryLogIndex::indexFileName(_file.fileName()));
+    }
+}
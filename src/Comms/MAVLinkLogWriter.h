@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <atomic>
+
+#include "MAVLinkLib.h"
+#include "TelemetryLogIndex.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkLogWriterLog)
+
+/// Writes the telemetry log on the log writer thread owned by MAVLinkProtocol.
+/// Records are serialized together with their timestamp directly into preallocated pages by the thread
+/// which opened the writer. Full pages are handed to the writer thread which writes each of them with a
+/// single sequential write. The number of pages is fixed: if storage can't keep up, records are dropped
+/// and counted instead of stalling the caller. A TelemetryLogIndex is built while writing and saved next
+/// to the log when it is closed.
+class MAVLinkLogWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        uint64_t recordsLogged = 0;     ///< Records placed into a page
+        uint64_t recordsDropped = 0;    ///< Records dropped since all pages were waiting to be written
+        uint64_t bytesDropped = 0;
+        uint64_t pagesWritten = 0;
+        uint64_t bytesWritten = 0;
+    };
+
+    explicit MAVLinkLogWriter(QObject *parent = nullptr);
+    ~MAVLinkLogWriter();
+
+    /// Opens fileName for writing, waits for the writer thread to open the file.
+    /// open, close and the append methods must all be called from the same thread.
+    bool open(const QString &fileName);
+
+    /// Writes out all pending records and closes the file, waits for the writer thread to finish
+    void close();
+
+    bool isOpen() const { return _open; }
+
+    /// Appends message prefixed with the current timestamp
+    void appendMessage(const mavlink_message_t &message);
+
+    /// Appends data prefixed with the current timestamp
+    void appendBytes(QByteArrayView data);
+
+    Stats stats() const;
+
+    static constexpr qsizetype kPageSize = 64 * 1024;
+    static constexpr int kPageCount = 32;
+    static constexpr int kPageFlushIntervalMSecs = 1000;   ///< Partially filled pages are handed off at least this often
+
+signals:
+    /// Writing to the file failed, nothing else is written until the writer is reopened.
+    /// Emitted on the writer thread.
+    void writeFailed(const QString &errorString);
+
+private:
+    /// @return Pointer to at least length bytes of free page space, nullptr if the record has to be dropped
+    uint8_t *_reserve(qsizetype length);
+    void _commit(qsizetype length, quint64 timestampUSecs, bool isFrame, uint32_t msgid);
+    void _recordDropped(qsizetype length);
+    bool _handOffPage();
+    quint64 _timestampUSecs() const;
+
+    bool _openFile(const QString &fileName);
+    void _writePage(QByteArray page, bool recycle);
+    void _closeFile(const TelemetryLogIndex &index);
+
+    // Accessed from the thread which opened the writer
+    bool _open = false;
+    QByteArray _page;
+    qsizetype _pageUsed = 0;
+    QElapsedTimer _handOffTimer;
+    QElapsedTimer _clock;
+    quint64 _epochUSecs = 0;
+    bool _dropping = false;
+    qint64 _logOffset = 0;          ///< File offset of the next record
+    TelemetryLogIndex _index;
+    uint64_t _recordsLogged = 0;
+    uint64_t _recordsDropped = 0;
+    uint64_t _bytesDropped = 0;
+
+    // Accessed from the writer thread
+    QFile _file;
+
+    // Shared
+    QMutex _freePagesMutex;
+    QList<QByteArray> _freePages;
+    std::atomic_bool _writeFailed{false};
+    std::atomic<uint64_t> _pagesWritten{0};
+    std::atomic<uint64_t> _bytesWritten{0};
+
+    static constexpr qsizetype kTimestampSize = sizeof(quint64);
+};
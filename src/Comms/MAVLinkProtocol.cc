@@ -9,10 +9,12 @@
 
 #include "MAVLinkProtocol.h"
 #include "LinkManager.h"
+#include "MAVLinkLogWriter.h"
 #include "MultiVehicleManager.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 #include "QGCTemporaryFile.h"
+#include "TelemetryLogIndex.h"
 #include "SettingsManager.h"
 #include "MavlinkSettings.h"
 #include "AppSettings.h"
@@ -22,8 +24,10 @@
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMetaType>
+#include <QtCore/QPointer>
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
 
 QGC_LOGGING_CATEGORY(MAVLinkProtocolLog, "qgc.comms.mavlinkprotocol")
 
@@ -32,13 +36,46 @@ Q_APPLICATION_STATIC(MAVLinkProtocol, _mavlinkProtocolInstance);
 MAVLinkProtocol::MAVLinkProtocol(QObject *parent)
     : QObject(parent)
     , _tempLogFile(new QGCTemporaryFile(QStringLiteral("%2.%3").arg(_tempLogFileTemplate, _logFileExtension), this))
+    , _decodeWorker(new MAVLinkDecodeWorker())
+    , _decodeThread(new QThread(this))
+    , _logWriter(new MAVLinkLogWriter())
+    , _logWriterThread(new QThread(this))
 {
+    _decodeThread->setObjectName(QStringLiteral("MAVLinkDecode"));
+    _logWriterThread->setObjectName(QStringLiteral("MAVLinkLogWriter"));
+
+    (void) _decodeWorker->moveToThread(_decodeThread);
+
+    (void) connect(_decodeThread, &QThread::finished, _decodeWorker, &QObject::deleteLater);
+    (void) connect(_decodeWorker, &MAVLinkDecodeWorker::framesDecoded, this, &MAVLinkProtocol::_framesDecoded, Qt::QueuedConnection);
+    (void) connect(_decodeWorker, &MAVLinkDecodeWorker::messageStatus, this, &MAVLinkProtocol::mavlinkMessageStatus, Qt::QueuedConnection);
+
+    _decodeThread->start();
+
+    (void) _logWriter->moveToThread(_logWriterThread);
+
+    (void) connect(_logWriterThread, &QThread::finished, _logWriter, &QObject::deleteLater);
+    (void) connect(_logWriter, &MAVLinkLogWriter::writeFailed, this, &MAVLinkProtocol::_logWriteFailed, Qt::QueuedConnection);
+
+    _logWriterThread->start();
+
     qCDebug(MAVLinkProtocolLog) << this;
 }
 
 MAVLinkProtocol::~MAVLinkProtocol()
 {
-    _closeLogFile();
+    _decodeThread->quit();
+    if (!_decodeThread->wait(1000)) {
+        qCWarning(MAVLinkProtocolLog) << "Failed to wait for MAVLink decode thread to close";
+    }
+
+    // Needs the log writer thread to still be running
+    (void) _closeLogFile();
+
+    _logWriterThread->quit();
+    if (!_logWriterThread->wait(1000)) {
+        qCWarning(MAVLinkProtocolLog) << "Failed to wait for MAVLink log writer thread to close";
+    }
 
     qCDebug(MAVLinkProtocolLog) << this;
 }
@@ -72,9 +109,9 @@ void MAVLinkProtocol::setVersion(unsigned version)
 void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
 {
     const uint8_t channel = link->mavlinkChannel();
-    _totalReceiveCounter[channel] = 0;
-    _totalLossCounter[channel] = 0;
-    _runningLossPercent[channel] = 0.f;
+    (void) QMetaObject::invokeMethod(_decodeWorker, [worker = _decodeWorker, channel]() {
+        worker->resetChannel(channel);
+    }, Qt::QueuedConnection);
 
     link->setDecodedFirstMavlinkPacket(false);
 }
@@ -83,22 +120,23 @@ void MAVLinkProtocol::logSentBytes(const LinkInterface *link, const QByteArray &
 {
     Q_UNUSED(link);
 
-    if (_logSuspendError || _logSuspendReplay || !_tempLogFile->isOpen()) {
+    if (_logSuspendError || _logSuspendReplay || !_logWriter->isOpen()) {
         return;
     }
 
-    const quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-    uint8_t bytes_time[sizeof(quint64)]{};
-    qToBigEndian(time, bytes_time);
+    // Writes coalesced by the link TX queue are split back into one record per frame, as replay expects
+    const uint8_t *const bytes = reinterpret_cast<const uint8_t*>(data.constData());
+    qsizetype offset = 0;
+    while (offset < data.size()) {
+        qsizetype frameLength = 0;
+        uint32_t msgid = 0;
+        if (!MAVLinkFrameParser::checkFrame(bytes + offset, data.size() - offset, frameLength, msgid)) {
+            _logWriter->appendBytes(QByteArrayView(data).sliced(offset));
+            break;
+        }
 
-    QByteArray logData = data;
-    QByteArray timeData = QByteArray::fromRawData(reinterpret_cast<const char*>(bytes_time), sizeof(bytes_time));
-    (void) logData.prepend(timeData);
-    if (_tempLogFile->write(logData) != logData.length()) {
-        const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile->fileName());
-        qgcApp()->showAppMessage(message, getName());
-        _stopLogging();
-        _logSuspendError = true;
+        _logWriter->appendBytes(QByteArrayView(data).sliced(offset, frameLength));
+        offset += frameLength;
     }
 }
 
@@ -110,133 +148,98 @@ void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
         return;
     }
 
-    for (const uint8_t &byte: data) {
-        const uint8_t mavlinkChannel = link->mavlinkChannel();
-        mavlink_message_t message{};
-        mavlink_status_t status{};
-
-        if (mavlink_parse_char(mavlinkChannel, byte, &message, &status) != MAVLINK_FRAMING_OK) {
-            continue;
-        }
-
-        _updateVersion(link, mavlinkChannel);
-        _updateCounters(mavlinkChannel, message);
-        if (!linkPtr->linkConfiguration()->isForwarding()) {
-            _forward(message);
-            _forwardSupport(message);
-        }
-        _logData(link, message);
-
-        if (!_updateStatus(link, linkPtr, mavlinkChannel, message)) {
-            break;
-        }
-    }
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+    const MAVLinkDecodeWorker::ForwardTargets forwardTargets = _forwardTargets(linkPtr);
+    const MAVLinkDecodeWorker::SigningSnapshot signing = MAVLinkDecodeWorker::signingSnapshot(mavlinkChannel);
+    (void) QMetaObject::invokeMethod(_decodeWorker, [worker = _decodeWorker, link = WeakLinkInterfacePtr(linkPtr), mavlinkChannel, data, forwardTargets, signing]() {
+        worker->receiveBytes(link, mavlinkChannel, data, forwardTargets, signing);
+    }, Qt::QueuedConnection);
 }
 
-void MAVLinkProtocol::_updateVersion(LinkInterface *link, uint8_t mavlinkChannel)
+void MAVLinkProtocol::notifyWhenReceiveDrained(QObject *context, const std::function<void()> &callback)
 {
-    if (link->decodedFirstMavlinkPacket()) {
-        return;
-    }
-
-    link->setDecodedFirstMavlinkPacket(true);
-    const mavlink_status_t *const mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-
-    if (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) {
-        return;
-    }
-
-    if (mavlink_get_proto_version(mavlinkChannel) == 1) {
-        qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkChannel;
-        setVersion(200);
-    }
+    // Queued behind the bytes already sent to the decode thread, and the callback is queued behind the batches they produced
+    (void) QMetaObject::invokeMethod(_decodeWorker, [this, worker = _decodeWorker, context = QPointer<QObject>(context), callback]() {
+        worker->flush();
+        (void) QMetaObject::invokeMethod(this, [context, callback]() {
+            if (context) {
+                callback();
+            }
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
 }
 
-void MAVLinkProtocol::_updateCounters(uint8_t mavlinkChannel, const mavlink_message_t &message)
+MAVLinkDecodeWorker::ForwardTargets MAVLinkProtocol::_forwardTargets(const SharedLinkInterfacePtr &linkPtr) const
 {
-    _totalReceiveCounter[mavlinkChannel]++;
-
-    uint8_t &lastSeq = _lastIndex[message.sysid][message.compid];
-
-    const QPair<uint8_t,uint8_t> key(message.sysid, message.compid);
-    uint8_t expectedSeq;
-    if (!_firstMessageSeen.contains(key)) {
-        _firstMessageSeen.insert(key);
-        expectedSeq = message.seq;
-    } else {
-        expectedSeq = lastSeq + 1;
+    MAVLinkDecodeWorker::ForwardTargets forwardTargets;
+    if (linkPtr->linkConfiguration()->isForwarding()) {
+        return forwardTargets;
     }
 
-    uint64_t lostMessages;
-    if (message.seq >= expectedSeq) {
-        lostMessages = message.seq - expectedSeq;
-    } else {
-        lostMessages = static_cast<uint64_t>(message.seq) + 256ULL - expectedSeq;
+    if (SettingsManager::instance()->mavlinkSettings()->forwardMavlink()->rawValue().toBool()) {
+        forwardTargets.forwardingLink = LinkManager::instance()->mavlinkForwardingLink();
     }
-    _totalLossCounter[mavlinkChannel] += lostMessages;
 
-    lastSeq = message.seq;
+    if (LinkManager::instance()->mavlinkSupportForwardingEnabled()) {
+        forwardTargets.forwardingSupportLink = LinkManager::instance()->mavlinkForwardingSupportLink();
+    }
 
-    const uint64_t totalSent = _totalReceiveCounter[mavlinkChannel] + _totalLossCounter[mavlinkChannel];
-    const float currentLossPercent = (static_cast<double>(_totalLossCounter[mavlinkChannel]) / totalSent) * 100.0f;
-    _runningLossPercent[mavlinkChannel] = (currentLossPercent + _runningLossPercent[mavlinkChannel]) * 0.5f;
+    return forwardTargets;
 }
 
-void MAVLinkProtocol::_forward(const mavlink_message_t &message)
+void MAVLinkProtocol::_framesDecoded(const QList<MAVLinkDecodeWorker::DecodedBatch> &batches)
 {
-    if (message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
-        return;
-    }
+    for (const MAVLinkDecodeWorker::DecodedBatch &batch : batches) {
+        const SharedLinkInterfacePtr linkPtr = batch.link.lock();
+        if (!linkPtr || !LinkManager::instance()->containsLink(linkPtr.get())) {
+            qCDebug(MAVLinkProtocolLog) << "_framesDecoded: link gone!" << batch.messages.size() << "messages arrived too late";
+            continue;
+        }
 
-    if (!SettingsManager::instance()->mavlinkSettings()->forwardMavlink()->rawValue().toBool()) {
-        return;
-    }
+        LinkInterface *const link = linkPtr.get();
+        _updateVersion(link, batch.messages.first());
 
-    SharedLinkInterfacePtr forwardingLink = LinkManager::instance()->mavlinkForwardingLink();
-    if (!forwardingLink) {
-        return;
-    }
+        bool linkRemoved = false;
+        for (const mavlink_message_t &message : batch.messages) {
+            _logData(link, message);
+            emit messageReceived(link, message);
+
+            if (linkPtr.use_count() == 1) {
+                linkRemoved = true;
+                break;
+            }
+        }
 
-    uint8_t buf[MAVLINK_MAX_PACKET_LEN]{};
-    const uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
-    (void) forwardingLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buf), len);
+        if (!linkRemoved) {
+            emit messagesReceived(link, batch.sysid, batch.messages);
+        }
+    }
 }
 
-void MAVLinkProtocol::_forwardSupport(const mavlink_message_t &message)
+void MAVLinkProtocol::_updateVersion(LinkInterface *link, const mavlink_message_t &message)
 {
-    if (message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
+    if (link->decodedFirstMavlinkPacket()) {
         return;
     }
 
-    if (!LinkManager::instance()->mavlinkSupportForwardingEnabled()) {
-        return;
-    }
+    link->setDecodedFirstMavlinkPacket(true);
 
-    SharedLinkInterfacePtr forwardingSupportLink = LinkManager::instance()->mavlinkForwardingSupportLink();
-    if (!forwardingSupportLink) {
+    if (message.magic == MAVLINK_STX_MAVLINK1) {
         return;
     }
 
-    uint8_t buf[MAVLINK_MAX_PACKET_LEN]{};
-    const uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
-    (void) forwardingSupportLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buf), len);
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+    if (mavlink_get_proto_version(mavlinkChannel) == 1) {
+        qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkChannel;
+        setVersion(200);
+    }
 }
 
 void MAVLinkProtocol::_logData(LinkInterface *link, const mavlink_message_t &message)
 {
-    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile->isOpen()) {
-        const quint64 timestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-        uint8_t buf[MAVLINK_MAX_PACKET_LEN + sizeof(timestamp)]{};
-        qToBigEndian(timestamp, buf);
-
-        const qsizetype len = mavlink_msg_to_send_buffer(buf + sizeof(timestamp), &message) + sizeof(timestamp);
-        const QByteArray log_data(reinterpret_cast<const char*>(buf), len);
-        if (_tempLogFile->write(log_data) != len) {
-            const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile->fileName());
-            qgcApp()->showAppMessage(message, getName());
-            _stopLogging();
-            _logSuspendError = true;
-        }
+    if (!_logSuspendError && !_logSuspendReplay && _logWriter->isOpen()) {
+        // Only serializes into the writer's page, the file is written on the log writer thread
+        _logWriter->appendMessage(message);
 
         if ((message.msgid == MAVLINK_MSG_ID_HEARTBEAT) && !_vehicleWasArmed) {
             if (mavlink_msg_heartbeat_get_base_mode(&message) & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
@@ -273,35 +276,33 @@ void MAVLinkProtocol::_logData(LinkInterface *link, const mavlink_message_t &mes
     }
 }
 
-bool MAVLinkProtocol::_updateStatus(LinkInterface *link, const SharedLinkInterfacePtr linkPtr, uint8_t mavlinkChannel, const mavlink_message_t &message)
+void MAVLinkProtocol::_logWriteFailed(const QString &errorString)
 {
-    if ((_totalReceiveCounter[mavlinkChannel] % 31) == 0) {
-        const uint64_t totalSent = _totalReceiveCounter[mavlinkChannel] + _totalLossCounter[mavlinkChannel];
-        emit mavlinkMessageStatus(message.sysid, totalSent, _totalReceiveCounter[mavlinkChannel], _totalLossCounter[mavlinkChannel], _runningLossPercent[mavlinkChannel]);
+    if (!_logWriter->isOpen()) {
+        return;
     }
 
-    emit messageReceived(link, message);
-
-    if (linkPtr.use_count() == 1) {
-        return false;
-    }
+    qCWarning(MAVLinkProtocolLog) << "Log write failed" << errorString;
 
-    return true;
+    const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile->fileName());
+    qgcApp()->showAppMessage(message, getName());
+    _stopLogging();
+    _logSuspendError = true;
 }
 
 bool MAVLinkProtocol::_closeLogFile()
 {
-    if (!_tempLogFile->isOpen()) {
+    if (!_logWriter->isOpen()) {
         return false;
     }
 
-    if (_tempLogFile->size() == 0) {
+    _logWriter->close();
+
+    if (_logWriter->stats().bytesWritten == 0) {
         (void) _tempLogFile->remove();
         return false;
     }
 
-    (void) _tempLogFile->flush();
-    _tempLogFile->close();
     return true;
 }
 
@@ -322,7 +323,7 @@ void MAVLinkProtocol::_startLogging()
     }
 #endif
 
-    if (_tempLogFile->isOpen()) {
+    if (_logWriter->isOpen()) {
         return;
     }
 
@@ -330,10 +331,15 @@ void MAVLinkProtocol::_startLogging()
         return;
     }
 
-    if (!_tempLogFile->open()) {
+    // The temp file only picks a unique name and creates the file, the log writer thread does the writing
+    const bool created = _tempLogFile->open();
+    _tempLogFile->close();
+    if (!created || !_logWriter->open(_tempLogFile->fileName())) {
         const QString message = QStringLiteral("Opening Flight Data file for writing failed. Unable to write to %1. Please choose a different file location.").arg(_tempLogFile->fileName());
         qgcApp()->showAppMessage(message, getName());
-        _closeLogFile();
+        if (created) {
+            (void) _tempLogFile->remove();
+        }
         _logSuspendError = true;
         return;
     }
@@ -346,7 +352,7 @@ void MAVLinkProtocol::_startLogging()
 
 void MAVLinkProtocol::_stopLogging()
 {
-    if (_tempLogFile->isOpen() && _closeLogFile()) {
+    if (_closeLogFile()) {
         auto appSettings = SettingsManager::instance()->appSettings();
         auto mavlinkSettings = SettingsManager::instance()->mavlinkSettings();
         if ((_vehicleWasArmed || mavlinkSettings->telemetrySaveNotArmed()->rawValue().toBool()) &&
@@ -354,7 +360,7 @@ void MAVLinkProtocol::_stopLogging()
                 !appSettings->disableAllPersistence()->rawValue().toBool()) {
             _saveTelemetryLog(_tempLogFile->fileName());
         } else {
-            (void) QFile::remove(_tempLogFile->fileName());
+            _removeTempLogFile(_tempLogFile->fileName());
         }
     }
 
@@ -373,7 +379,7 @@ void MAVLinkProtocol::checkForLostLogFiles()
     for (const QFileInfo &fileInfo: fileInfoList) {
         qCDebug(MAVLinkProtocolLog) << "Orphaned log file" << fileInfo.filePath();
         if (fileInfo.size() == 0) {
-            (void) QFile::remove(fileInfo.filePath());
+            _removeTempLogFile(fileInfo.filePath());
             continue;
         }
         _saveTelemetryLog(fileInfo.filePath());
@@ -390,7 +396,7 @@ void MAVLinkProtocol::deleteTempLogFiles()
 
     for (const QFileInfo &fileInfo: fileInfoList) {
         qCDebug(MAVLinkProtocolLog) << "Temp log file" << fileInfo.filePath();
-        (void) QFile::remove(fileInfo.filePath());
+        _removeTempLogFile(fileInfo.filePath());
     }
 }
 
@@ -415,7 +421,7 @@ void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile)
         if (!in.open(QIODevice::ReadOnly)) {
             const QString error = tr("Unable to save telemetry log. Error opening source '%1': '%2'.").arg(tempLogfile, in.errorString());
             qgcApp()->showAppMessage(error);
-            (void) QFile::remove(tempLogfile);
+            _removeTempLogFile(tempLogfile);
             return;
         }
 
@@ -425,7 +431,7 @@ void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile)
         if (!out.open(QIODevice::WriteOnly)) {
             const QString error = tr("Unable to save telemetry log. Error opening destination '%1': '%2'.").arg(saveFilePath, out.errorString());
             qgcApp()->showAppMessage(error);
-            (void) QFile::remove(tempLogfile);
+            _removeTempLogFile(tempLogfile);
             return;
         }
 
@@ -442,14 +448,14 @@ void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile)
                 const QString error = tr("Unable to save telemetry log. Error reading source '%1': '%2'.").arg(tempLogfile, in.errorString());
                 qgcApp()->showAppMessage(error);
                 out.cancelWriting();
-                (void) QFile::remove(tempLogfile);
+                _removeTempLogFile(tempLogfile);
                 return;
             }
             if (out.write(buffer.constData(), n) != n) {
                 const QString error = tr("Unable to save telemetry log. Error writing destination '%1': '%2'.").arg(saveFilePath, out.errorString());
                 qgcApp()->showAppMessage(error);
                 out.cancelWriting();
-                (void) QFile::remove(tempLogfile);
+                _removeTempLogFile(tempLogfile);
                 return;
             }
         }
@@ -457,7 +463,7 @@ void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile)
         if (!out.commit()) {
             const QString error = tr("Unable to finalize telemetry log '%1': '%2'.").arg(saveFilePath, out.errorString());
             qgcApp()->showAppMessage(error);
-            (void) QFile::remove(tempLogfile);
+            _removeTempLogFile(tempLogfile);
             return;
         }
 
@@ -466,9 +472,18 @@ void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile)
             QFileDevice::ReadGroup |
             QFileDevice::ReadOther;
         (void) out.setPermissions(perms);
+
+        // The index is optional, replay rebuilds it if missing
+        (void) QFile::copy(TelemetryLogIndex::indexFileName(tempLogfile), TelemetryLogIndex::indexFileName(saveFilePath));
     }
 
+    _removeTempLogFile(tempLogfile);
+}
+
+void MAVLinkProtocol::_removeTempLogFile(const QString &tempLogfile)
+{
     (void) QFile::remove(tempLogfile);
+    (void) QFile::remove(TelemetryLogIndex::indexFileName(tempLogfile));
 }
 
 bool MAVLinkProtocol::_checkTelemetrySavePath()
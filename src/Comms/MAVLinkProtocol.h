@@ -14,10 +14,15 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
+#include <functional>
+
 #include "LinkInterface.h"
+#include "MAVLinkDecodeWorker.h"
 #include "MAVLinkLib.h"
 
+class MAVLinkLogWriter;
 class QGCTemporaryFile;
+class QThread;
 
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkProtocolLog)
 
@@ -60,6 +65,11 @@ class MAVLinkProtocol : public QObject
     /// Reset the counters for all metadata for this link.
     void resetMetadataForLink(LinkInterface *link);
 
+    /// Calls callback on the GUI thread once all bytes received so far have been decoded and delivered.
+    /// Lets sources which can produce data faster than it is consumed apply backpressure.
+    ///     @param context callback is dropped if context is destroyed first
+    void notifyWhenReceiveDrained(QObject *context, const std::function<void()> &callback);
+
     /// Suspend/Restart logging during replay.
     void suspendLogForReplay(bool suspend) { _logSuspendReplay = suspend; }
 
@@ -78,10 +88,14 @@ class MAVLinkProtocol : public QObject
     /// Message received and directly copied via signal
     void messageReceived(LinkInterface *link, const mavlink_message_t &message);
 
+    /// Messages received from a single system on link since the previous batch.
+    /// Delivered at a bounded rate, after messageReceived has been emitted for each message.
+    void messagesReceived(LinkInterface *link, uint8_t sysid, const QList<mavlink_message_t> &messages);
+
     void mavlinkMessageStatus(int sysid, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
 
 public slots:
-    /// Receive bytes from a communication interface and constructs a MAVLink packet
+    /// Receive bytes from a communication interface and queues them to the decode thread
     ///     @param link The interface to read from
     void receiveBytes(LinkInterface *link, const QByteArray &data);
 
@@ -95,6 +109,8 @@ public slots:
 
 private slots:
     void _vehicleCountChanged();
+    void _framesDecoded(const QList<MAVLinkDecodeWorker::DecodedBatch> &batches);
+    void _logWriteFailed(const QString &errorString);
 
 private:
     void _logData(LinkInterface *link, const mavlink_message_t &message);
@@ -102,28 +118,25 @@ private slots:
     void _startLogging();
     void _stopLogging();
 
-    void _forward(const mavlink_message_t &message);
-    void _forwardSupport(const mavlink_message_t &message);
+    MAVLinkDecodeWorker::ForwardTargets _forwardTargets(const SharedLinkInterfacePtr &linkPtr) const;
 
-    void _updateCounters(uint8_t mavlinkChannel, const mavlink_message_t &message);
-    bool _updateStatus(LinkInterface *link, const SharedLinkInterfacePtr linkPtr, uint8_t mavlinkChannel, const mavlink_message_t &message);
-    void _updateVersion(LinkInterface *link, uint8_t mavlinkChannel);
+    void _updateVersion(LinkInterface *link, const mavlink_message_t &message);
 
     void _saveTelemetryLog(const QString &tempLogfile);
+    /// Removes a temp log together with its index
+    static void _removeTempLogFile(const QString &tempLogfile);
     bool _checkTelemetrySavePath();
 
     QGCTemporaryFile * const _tempLogFile = nullptr;
+    MAVLinkDecodeWorker *_decodeWorker = nullptr;
+    QThread *_decodeThread = nullptr;
+    MAVLinkLogWriter *_logWriter = nullptr;
+    QThread *_logWriterThread = nullptr;
 
     bool _logSuspendError = false;  ///< true: Logging suspended due to error
     bool _logSuspendReplay = false; ///< true: Logging suspended due to replay
     bool _vehicleWasArmed = false;  ///< true: Vehicle was armed during log sequence
 
-    uint8_t _lastIndex[256][256]{};                             ///< Store the last received sequence ID for each system/component pair
-    QSet<QPair<uint8_t,uint8_t>> _firstMessageSeen;
-    uint64_t _totalReceiveCounter[MAVLINK_COMM_NUM_BUFFERS]{};  ///< The total number of successfully received messages
-    uint64_t _totalLossCounter[MAVLINK_COMM_NUM_BUFFERS]{};     ///< Total messages lost during transmission.
-    float _runningLossPercent[MAVLINK_COMM_NUM_BUFFERS]{};      ///< Loss rate
-
     unsigned _currentVersion = 100;
     bool _initialized = false;
 
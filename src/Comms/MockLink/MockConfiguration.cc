@@ -25,6 +25,7 @@ MockConfiguration::MockConfiguration(const MockConfiguration *copy, QObject *par
     , _sendStatusText(copy->sendStatusText())
     , _incrementVehicleId(copy->incrementVehicleId())
     , _failureMode(copy->failureMode())
+    , _ftpCapability(copy->ftpCapability())
 {
     // qCDebug(MockConfigurationLog) << Q_FUNC_INFO << this;
 }
@@ -47,6 +48,7 @@ void MockConfiguration::copyFrom(const LinkConfiguration *source)
     setSendStatusText(mockLinkSource->sendStatusText());
     setIncrementVehicleId(mockLinkSource->incrementVehicleId());
     setFailureMode(mockLinkSource->failureMode());
+    setFtpCapability(mockLinkSource->ftpCapability());
 }
 
 void MockConfiguration::loadSettings(QSettings &settings, const QString &root)
@@ -47,6 +47,9 @@ class MockConfiguration : public LinkConfiguration
     uint16_t boardVendorId() const { return _boardVendorId; }
     uint16_t boardProductId() const { return _boardProductId; }
     void setBoardVendorProduct(uint16_t vendorId, uint16_t productId) { _boardVendorId = vendorId; _boardProductId = productId; }
+    /// true: the vehicle reports MAV_PROTOCOL_CAPABILITY_FTP, so QGC reads parameters and plans through MAVLink FTP where the firmware supports it
+    bool ftpCapability() const { return _ftpCapability; }
+    void setFtpCapability(bool ftpCapability) { _ftpCapability = ftpCapability; }
     MAV_TYPE vehicleType() const { return _vehicleType; }
     void setVehicleType(MAV_TYPE vehicleType) { _vehicleType = vehicleType; emit vehicleChanged(); }
     bool sendStatusText() const { return _sendStatusText; }
@@ -79,6 +82,7 @@ class MockConfiguration : public LinkConfiguration
     bool _incrementVehicleId = true;
     uint16_t _boardVendorId = 0;
     uint16_t _boardProductId = 0;
+    bool _ftpCapability = false;
 
     static constexpr const char *_firmwareTypeKey = "FirmwareType";
     static constexpr const char *_vehicleTypeKey = "VehicleType";
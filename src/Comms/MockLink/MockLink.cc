@@ -54,6 +54,7 @@ MockLink::MockLink(SharedLinkConfigurationPtr &config, QObject *parent)
     , _vehicleType(_mockConfig->vehicleType())
     , _sendStatusText(_mockConfig->sendStatusText())
     , _failureMode(_mockConfig->failureMode())
+    , _ftpCapability(_mockConfig->ftpCapability())
     , _vehicleSystemId(_mockConfig->incrementVehicleId() ? _nextVehicleSystemId++ : _nextVehicleSystemId)
     , _vehicleLatitude(_defaultVehicleLatitude + ((_vehicleSystemId - 128) * 0.0001))
     , _vehicleLongitude(_defaultVehicleLongitude + ((_vehicleSystemId - 128) * 0.0001))
@@ -852,6 +853,26 @@ void MockLink::_handleParamRequestList(const mavlink_message_t &msg)
     Q_ASSERT(request.target_system == _vehicleSystemId);
     Q_ASSERT(request.target_component == MAV_COMP_ID_ALL);
 
+    if (_sendParamHashCheck) {
+        mavlink_param_union_t valueUnion{};
+        valueUnion.type = MAV_PARAM_TYPE_UINT32;
+        valueUnion.param_uint32 = _paramHashCheck;
+
+        mavlink_message_t responseMsg{};
+        (void) mavlink_msg_param_value_pack_chan(
+            _vehicleSystemId,
+            _vehicleComponentId,
+            mavlinkChannel(),
+            &responseMsg,
+            "_HASH_CHECK",
+            valueUnion.param_float,
+            MAV_PARAM_TYPE_UINT32,
+            0,
+            -1
+        );
+        respondWithMavlinkMessage(responseMsg);
+    }
+
     // Start the worker routine
     _currentParamRequestListComponentIndex = 0;
     _currentParamRequestListParamIndex = 0;
@@ -868,6 +889,16 @@ void MockLink::_paramRequestListWorker()
     const int cParameters = _mapParamName2Value[componentId].count();
     const QString paramName = _mapParamName2Value[componentId].keys()[_currentParamRequestListParamIndex];
 
+    if (_paramHashCheckAcked && (componentId == _vehicleComponentId)) {
+        // The vehicle took the autopilot parameters from its cache
+        if (++_currentParamRequestListComponentIndex >= _mapParamName2Value.keys().count()) {
+            _currentParamRequestListComponentIndex = -1;
+        } else {
+            _currentParamRequestListParamIndex = 0;
+        }
+        return;
+    }
+
     if (((_failureMode == MockConfiguration::FailMissingParamOnInitialReqest) || (_failureMode == MockConfiguration::FailMissingParamOnAllRequests)) && (paramName == _failParam)) {
         qCDebug(MockLinkLog) << "Skipping param send:" << paramName;
     } else {
@@ -895,7 +926,7 @@ void MockLink::_paramRequestListWorker()
             cParameters,                                   // Total number of parameters
             _currentParamRequestListParamIndex             // Index of this parameter
         );
-        respondWithMavlinkMessage(responseMsg);
+        _respondWithParamValue(responseMsg, 0);
     }
 
     // Move to next param index
@@ -925,6 +956,11 @@ void MockLink::_handleParamSet(const mavlink_message_t &msg)
 
     qCDebug(MockLinkLog) << "_handleParamSet" << componentId << paramId << request.param_type;
 
+    if (_sendParamHashCheck && (strcmp(paramId, "_HASH_CHECK") == 0)) {
+        _paramHashCheckAcked = true;
+        return;
+    }
+
     Q_ASSERT(_mapParamName2Value.contains(componentId));
     Q_ASSERT(_mapParamName2MavParamType.contains(componentId));
     Q_ASSERT(_mapParamName2Value[componentId].contains(paramId));
@@ -1018,7 +1054,23 @@ void MockLink::_handleParamRequestRead(const mavlink_message_t &msg)
         _mapParamName2Value[componentId].count(),                  // Total number of parameters
         _mapParamName2Value[componentId].keys().indexOf(paramId)   // Index of this parameter
     );
-    respondWithMavlinkMessage(responseMsg);
+    _respondWithParamValue(responseMsg, _paramLatencyMsecs);
+}
+
+void MockLink::_respondWithParamValue(const mavlink_message_t &msg, int latencyMsecs)
+{
+    if ((_paramLossRate > 0) && (_paramLossRandom.generateDouble() < _paramLossRate)) {
+        qCDebug(MockLinkLog) << "Dropping PARAM_VALUE";
+        return;
+    }
+
+    if (latencyMsecs > 0) {
+        QTimer::singleShot(latencyMsecs, this, [this, msg]() {
+            respondWithMavlinkMessage(msg);
+        });
+    } else {
+        respondWithMavlinkMessage(msg);
+    }
 }
 
 void MockLink::emitRemoteControlChannelRawChanged(int channel, uint16_t raw)
@@ -1302,7 +1354,7 @@ void MockLink::_respondWithAutopilotVersion()
 #endif
 
     const uint8_t customVersion[8]{};
-    const uint64_t capabilities = MAV_PROTOCOL_CAPABILITY_MAVLINK2 | MAV_PROTOCOL_CAPABILITY_MISSION_FENCE | MAV_PROTOCOL_CAPABILITY_MISSION_RALLY | MAV_PROTOCOL_CAPABILITY_MISSION_INT | ((_firmwareType == MAV_AUTOPILOT_ARDUPILOTMEGA) ? MAV_PROTOCOL_CAPABILITY_TERRAIN : 0);
+    const uint64_t capabilities = MAV_PROTOCOL_CAPABILITY_MAVLINK2 | MAV_PROTOCOL_CAPABILITY_MISSION_FENCE | MAV_PROTOCOL_CAPABILITY_MISSION_RALLY | MAV_PROTOCOL_CAPABILITY_MISSION_INT | ((_firmwareType == MAV_AUTOPILOT_ARDUPILOTMEGA) ? MAV_PROTOCOL_CAPABILITY_TERRAIN : 0) | (_ftpCapability ? MAV_PROTOCOL_CAPABILITY_FTP : 0);
 
     mavlink_message_t msg{};
     (void) mavlink_msg_autopilot_version_pack_chan(
@@ -1496,7 +1548,7 @@ void MockLink::_sendStatusTextMessages()
     _sendChunkedStatusText(4, true /* missingChunks */);    // This should cause the timeout to fire
 }
 
-MockLink *MockLink::_startMockLink(MockConfiguration *mockConfig)
+MockLink *MockLink::startMockLink(MockConfiguration *mockConfig)
 {
     mockConfig->setDynamic(true);
     SharedLinkConfigurationPtr config = LinkManager::instance()->addConfiguration(mockConfig);
@@ -1517,7 +1569,7 @@ MockLink *MockLink::_startMockLinkWorker(const QString &configName, MAV_AUTOPILO
     mockConfig->setSendStatusText(sendStatusText);
     mockConfig->setFailureMode(failureMode);
 
-    return _startMockLink(mockConfig);
+    return startMockLink(mockConfig);
 }
 
 MockLink *MockLink::startPX4MockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode)
@@ -19,8 +19,11 @@
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
+#include <QtCore/QRandomGenerator>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <atomic>
+
 class MockLinkFTP;
 class MockLinkWorker;
 class QThread;
@@ -78,6 +81,19 @@ class MockLink : public LinkInterface
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
     void resetMissionItemHandler() const { _missionItemHandler->reset(); }
 
+    /// Simulates a poor link for mission reads
+    ///     @param lossRate Fraction of MISSION_ITEM_INT messages which are dropped
+    ///     @param latencyMsecs Delay before mission read requests are answered
+    void setMissionLinkQuality(double lossRate, int latencyMsecs) const { _missionItemHandler->setLinkQuality(lossRate, latencyMsecs); }
+
+    /// @return The items of the plan type in the ArduPilot mission file format, as served through MAVLink FTP
+    QByteArray missionFile(MAV_MISSION_TYPE missionType) const { return _missionItemHandler->missionFile(missionType); }
+
+    /// Counts of how mission items were read, see MockLinkMissionItemHandler
+    int missionReadRequestCount() const { return _missionItemHandler->readRequestCount(); }
+    int maxMissionReadResponsesPending() const { return _missionItemHandler->maxReadResponsesPending(); }
+    void resetMissionReadCounts() const { _missionItemHandler->resetReadCounts(); }
+
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile() const { return _logDownloadFilename; }
 
@@ -92,6 +108,17 @@ class MockLink : public LinkInterface
     };
     void setRequestMessageFailureMode(RequestMessageFailureMode_t failureMode) { _requestMessageFailureMode = failureMode; }
 
+    /// Simulates a poor link for parameter loads
+    ///     @param lossRate Fraction of PARAM_VALUE messages which are dropped
+    ///     @param latencyMsecs Delay before PARAM_REQUEST_READ is answered
+    void setParamLinkQuality(double lossRate, int latencyMsecs) { _paramLossRate = lossRate; _paramLatencyMsecs = latencyMsecs; }
+
+    /// Sends hash as _HASH_CHECK ahead of the parameter list, the way PX4 does. Once the hash is acked
+    /// the rest of the autopilot parameters are not sent. Call before the vehicle requests its parameters.
+    void setParamHashCheck(quint32 hash) { _paramHashCheck = hash; _sendParamHashCheck = true; }
+    /// true: the vehicle loaded the autopilot parameters from its cache
+    bool paramHashCheckAcked() const { return _paramHashCheckAcked; }
+
     static MockLink *startPX4MockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink *startGenericMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink *startNoInitialConnectMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
@@ -99,6 +126,8 @@ class MockLink : public LinkInterface
     static MockLink *startAPMArduPlaneMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink *startAPMArduSubMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink *startAPMArduRoverMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
+    /// Starts a MockLink for options the functions above don't cover. Takes ownership of mockConfig.
+    static MockLink *startMockLink(MockConfiguration *mockConfig);
 
     // Special commands for testing Vehicle::sendMavCommandWithHandler
     static constexpr MAV_CMD MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED = MAV_CMD_USER_1;
@@ -152,6 +181,8 @@ private slots:
     void _handleParamRequestList(const mavlink_message_t &msg);
     void _handleParamSet(const mavlink_message_t &msg);
     void _handleParamRequestRead(const mavlink_message_t &msg);
+    /// Sends a PARAM_VALUE through the simulated link quality set by setParamLinkQuality
+    void _respondWithParamValue(const mavlink_message_t &msg, int latencyMsecs);
     void _handleFTP(const mavlink_message_t &msg);
     void _handleCommandLong(const mavlink_message_t &msg);
     void _handleInProgressCommandLong(const mavlink_command_long_t &request);
@@ -198,7 +229,6 @@ private slots:
     void _moveADSBVehicle(int vehicleIndex);
 
     static MockLink *_startMockLinkWorker(const QString &configName, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, bool sendStatusText, MockConfiguration::FailureMode_t failureMode);
-    static MockLink *_startMockLink(MockConfiguration *mockConfig);
 
     /// Creates a file with random contents of the specified size.
     /// @return Fully qualified path to created file
@@ -212,6 +242,7 @@ private slots:
     const MAV_TYPE _vehicleType = MAV_TYPE_QUADROTOR;
     const bool _sendStatusText = false;
     const MockConfiguration::FailureMode_t _failureMode = MockConfiguration::FailNone;
+    const bool _ftpCapability = false;
     const uint8_t _vehicleSystemId = 0;
     const double _vehicleLatitude = 0.0;
     const double _vehicleLongitude = 0.0;
@@ -265,6 +296,14 @@ private slots:
 
     RequestMessageFailureMode_t _requestMessageFailureMode = FailRequestMessageNone;
 
+    bool _sendParamHashCheck = false;
+    quint32 _paramHashCheck = 0;
+    std::atomic<bool> _paramHashCheckAcked = false;
+
+    double _paramLossRate = 0;
+    int _paramLatencyMsecs = 0;
+    QRandomGenerator _paramLossRandom{ 1 };             ///< Fixed seed, the same messages are lost on every run
+
     QMap<MAV_CMD, int> _receivedMavCommandCountMap;
     QMap<int, QMap<QString, QVariant>> _mapParamName2Value;
     QMap<int, QMap<QString, MAV_PARAM_TYPE>> _mapParamName2MavParamType;
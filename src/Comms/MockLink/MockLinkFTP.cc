@@ -126,6 +126,9 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
         tmpFilename = QStringLiteral(":MockLink/Parameter.MetaData.json.xz");
     } else if (_BinParamFileEnabled && (path == "@PARAM/param.pck")) {
         tmpFilename = ":MockLink/Arduplane.params.ftp.bin";
+    } else if (_missionFilesEnabled && path.startsWith("@MISSION/")) {
+        tmpFilename = _createMissionTempFile(path);
+        _missionFileOpenCount++;
     }
 
     if (!tmpFilename.isEmpty()) {
@@ -440,3 +443,26 @@ QString MockLinkFTP::_createTestTempFile(int size)
 
     return tmpFile.fileName();
 }
+
+QString MockLinkFTP::_createMissionTempFile(const QString &path) const
+{
+    MAV_MISSION_TYPE missionType;
+    if (path == "@MISSION/mission.dat") {
+        missionType = MAV_MISSION_TYPE_MISSION;
+    } else if (path == "@MISSION/fence.dat") {
+        missionType = MAV_MISSION_TYPE_FENCE;
+    } else if (path == "@MISSION/rally.dat") {
+        missionType = MAV_MISSION_TYPE_RALLY;
+    } else {
+        return QString();
+    }
+
+    QGCTemporaryFile tmpFile("MockLinkFTPMission");
+
+    if (tmpFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        (void) tmpFile.write(_mockLink->missionFile(missionType));
+        tmpFile.close();
+    }
+
+    return tmpFile.fileName();
+}
@@ -14,6 +14,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
 
+#include <atomic>
+
 #include "MAVLinkFTP.h"
 
 Q_DECLARE_LOGGING_CATEGORY(MockLinkFTPLog)
@@ -38,6 +40,11 @@ class MockLinkFTP : public QObject
 
     void enableRandromDrops(bool enable) { _randomDropsEnabled = enable; }
     void enableBinParamFile(bool enable) { _BinParamFileEnabled = enable; }
+    /// Serves the mission items of the MockLink as @MISSION/mission.dat, fence.dat and rally.dat
+    void enableMissionFiles(bool enable) { _missionFilesEnabled = enable; }
+    /// @return Number of @MISSION files opened since the last resetMissionFileOpenCount
+    int missionFileOpenCount() const { return _missionFileOpenCount; }
+    void resetMissionFileOpenCount() { _missionFileOpenCount = 0; }
 
     /// By calling setErrorMode with one of these modes you can cause the server to simulate an error.
     enum ErrorMode_t {
@@ -95,6 +102,8 @@ class MockLinkFTP : public QObject
     /// bad sequence numbers when errModeBadSequence is set.
     uint16_t _nextSeqNumber(uint16_t seqNumber) const;
     static QString _createTestTempFile(int size);
+    /// @return Temp file holding the items for a @MISSION path, empty if the path is not a mission file
+    QString _createMissionTempFile(const QString &path) const;
 
     /// if request is a string, this ensures it's null-terminated
     static void ensureNullTemination(MavlinkFTP::Request *request);
@@ -104,6 +113,8 @@ class MockLinkFTP : public QObject
     MockLink *_mockLink;                        ///< MockLink to communicate through
 
     bool _BinParamFileEnabled = false;
+    bool _missionFilesEnabled = false;
+    std::atomic<int> _missionFileOpenCount = 0;
     bool _lastReplyValid = false;
     bool _randomDropsEnabled = false;
     ErrorMode_t _errMode = errModeNone;         ///< Currently set error mode, as specified by setErrorMode
@@ -13,6 +13,8 @@
 #include "MockLink.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QtEndian>
+
 QGC_LOGGING_CATEGORY(MockLinkMissionItemHandlerLog, "qgc.comms.mocklink.mocklinkmissionitemhandler")
 
 MockLinkMissionItemHandler::MockLinkMissionItemHandler(MockLink *mockLink)
@@ -156,13 +158,15 @@ void MockLinkMissionItemHandler::_handleMissionRequestList(const mavlink_message
         0
     );
 
-    _mockLink->respondWithMavlinkMessage(responseMsg);
+    _respondWithReadMessage(responseMsg, false);
 }
 
 void MockLinkMissionItemHandler::_handleMissionRequest(const mavlink_message_t &msg)
 {
     qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequest read sequence";
 
+    _readRequestCount++;
+
     mavlink_mission_request_int_t request{};
     mavlink_msg_mission_request_int_decode(&msg, &request);
 
@@ -240,7 +244,67 @@ void MockLinkMissionItemHandler::_handleMissionRequest(const mavlink_message_t &
         _requestType
     );
 
-    _mockLink->respondWithMavlinkMessage(responseMsg);
+    _respondWithReadMessage(responseMsg, true);
+}
+
+void MockLinkMissionItemHandler::_respondWithReadMessage(const mavlink_message_t &msg, bool allowDrop)
+{
+    if (allowDrop && (_lossRate > 0) && (_lossRandom.generateDouble() < _lossRate)) {
+        qCDebug(MockLinkMissionItemHandlerLog) << "Dropping read sequence response" << msg.msgid;
+        return;
+    }
+
+    if (_latencyMsecs > 0) {
+        const bool itemResponse = (msg.msgid == MAVLINK_MSG_ID_MISSION_ITEM_INT);
+        if (itemResponse) {
+            const int pending = ++_readResponsesPending;
+            _maxReadResponsesPending = qMax(_maxReadResponsesPending.load(), pending);
+        }
+        QTimer::singleShot(_latencyMsecs, this, [this, msg, itemResponse]() {
+            if (itemResponse) {
+                _readResponsesPending--;
+            }
+            _mockLink->respondWithMavlinkMessage(msg);
+        });
+    } else {
+        _mockLink->respondWithMavlinkMessage(msg);
+    }
+}
+
+QByteArray MockLinkMissionItemHandler::missionFile(MAV_MISSION_TYPE missionType) const
+{
+    const MissionItemList_t *items = nullptr;
+    switch (missionType) {
+    case MAV_MISSION_TYPE_MISSION:
+        items = &_missionItems;
+        break;
+    case MAV_MISSION_TYPE_FENCE:
+        items = &_fenceItems;
+        break;
+    case MAV_MISSION_TYPE_RALLY:
+        items = &_rallyItems;
+        break;
+    default:
+        return QByteArray();
+    }
+
+    // Header: magic, mission type, options, first sequence number, item count
+    const uint16_t header[] = {
+        qToLittleEndian<uint16_t>(0x763d),
+        qToLittleEndian<uint16_t>(missionType),
+        0,
+        0,
+        qToLittleEndian<uint16_t>(static_cast<uint16_t>(items->count()))
+    };
+
+    QByteArray bytes;
+    bytes.reserve(sizeof(header) + (items->count() * sizeof(mavlink_mission_item_int_t)));
+    (void) bytes.append(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const mavlink_mission_item_int_t &item : *items) {
+        (void) bytes.append(reinterpret_cast<const char*>(&item), sizeof(item));
+    }
+
+    return bytes;
 }
 
 void MockLinkMissionItemHandler::_handleMissionCount(const mavlink_message_t &msg)
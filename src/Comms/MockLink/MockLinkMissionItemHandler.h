@@ -9,11 +9,15 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMap>
 #include <QtCore/QObject>
+#include <QtCore/QRandomGenerator>
 #include <QtCore/QTimer>
 
+#include <atomic>
+
 #include "MAVLinkLib.h"
 
 class MockLink;
@@ -78,6 +82,21 @@ class MockLinkMissionItemHandler : public QObject
 
     void setSendHomePositionOnEmptyList(bool sendHomePositionOnEmptyList) { _sendHomePositionOnEmptyList = sendHomePositionOnEmptyList; }
 
+    /// Simulates a poor link for mission reads
+    ///     @param lossRate Fraction of MISSION_ITEM_INT read responses which are dropped
+    ///     @param latencyMsecs Delay before MISSION_REQUEST_LIST and MISSION_REQUEST_INT are answered
+    void setLinkQuality(double lossRate, int latencyMsecs) { _lossRate = lossRate; _latencyMsecs = latencyMsecs; }
+
+    /// @return Number of MISSION_REQUEST_INT received since the last resetReadCounts
+    int readRequestCount() const { return _readRequestCount; }
+    /// @return Most MISSION_ITEM_INT responses which were waiting at the same time for the simulated latency to pass.
+    ///         Only counted while a latency is set.
+    int maxReadResponsesPending() const { return _maxReadResponsesPending; }
+    void resetReadCounts() { _readRequestCount = 0; _maxReadResponsesPending = 0; }
+
+    /// @return The items of the plan type in the ArduPilot mission file format
+    QByteArray missionFile(MAV_MISSION_TYPE missionType) const;
+
 private slots:
     void _missionItemResponseTimeout();
 
@@ -89,6 +108,8 @@ private slots:
     void _handleMissionClearAll(const mavlink_message_t &msg);
     void _requestNextMissionItem(int sequenceNumber);
     void _sendAck(MAV_MISSION_RESULT ackType) const;
+    /// Sends a read sequence response through the simulated link quality set by setLinkQuality
+    void _respondWithReadMessage(const mavlink_message_t &msg, bool allowDrop);
     void _startMissionItemResponseTimer();
 
     MockLink *_mockLink = nullptr;
@@ -110,5 +131,13 @@ private slots:
     bool _failReadRequestListFirstResponse = true;
     bool _failReadRequest1FirstResponse = true;
     bool _failWriteMissionCountFirstResponse = true;
+
+    double _lossRate = 0;
+    int _latencyMsecs = 0;
+    QRandomGenerator _lossRandom{ 1 };              ///< Fixed seed, the same messages are lost on every run
+
+    std::atomic<int> _readRequestCount = 0;
+    std::atomic<int> _readResponsesPending = 0;
+    std::atomic<int> _maxReadResponsesPending = 0;
 };
 
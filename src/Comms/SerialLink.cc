@@ -472,5 +472,10 @@ void SerialLink::_onDataSent(const QByteArray &data)
 
 void SerialLink::_writeBytes(const QByteArray &data)
 {
-    (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, data));
+    // Queued writes are drained on the worker thread, see _txContext
+    if (QThread::currentThread() == _workerThread) {
+        _worker->writeData(data);
+    } else {
+        (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, data));
+    }
 }
@@ -169,6 +169,7 @@ private slots:
 private:
     bool _connect() override;
     void _writeBytes(const QByteArray &data) override;
+    QObject *_txContext() override { return _worker; }
 
     const SerialConfiguration *_serialConfig = nullptr;
     SerialWorker *_worker = nullptr;
@@ -365,7 +365,12 @@ void TCPLink::_onDataSent(const QByteArray &data)
 
 void TCPLink::_writeBytes(const QByteArray& bytes)
 {
-    (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, bytes));
+    // Queued writes are drained on the worker thread, see _txContext
+    if (QThread::currentThread() == _workerThread) {
+        _worker->writeData(bytes);
+    } else {
+        (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, bytes));
+    }
 }
 
 bool TCPLink::isSecureConnection() const
@@ -124,6 +124,7 @@ private slots:
 
 private:
     bool _connect() override;
+    QObject *_txContext() override { return _worker; }
 
     const TCPConfiguration *_tcpConfig = nullptr;
     TCPWorker *_worker = nullptr;
@@ -0,0 +1,209 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogIndex.h"
+#include "MAVLinkFrameParser.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(TelemetryLogIndexLog, "qgc.comms.telemetrylogindex")
+
+quint64 TelemetryLogIndex::parseTimestamp(const uchar *data)
+{
+    const quint64 currentTimestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+    quint64 timestamp = qFromBigEndian<quint64>(data);
+    if (timestamp > currentTimestamp) {
+        timestamp = qbswap(timestamp);
+    }
+
+    return timestamp;
+}
+
+bool TelemetryLogIndex::readRecord(const uchar *data, qint64 size, qint64 offset, Record &record)
+{
+    qint64 frameOffset = qMax(offset, static_cast<qint64>(0)) + kTimestampSize;
+    while (frameOffset < size) {
+        qsizetype frameLength = 0;
+        uint32_t msgid = 0;
+        if (MAVLinkFrameParser::checkFrame(data + frameOffset, size - frameOffset, frameLength, msgid)) {
+            record.offset = frameOffset - kTimestampSize;
+            record.timestampUSecs = parseTimestamp(data + record.offset);
+            record.frameOffset = frameOffset;
+            record.frameLength = frameLength;
+            record.msgid = msgid;
+            return true;
+        }
+
+        // Resync: the timestamp is expected right in front of the next frame start
+        const uchar *const next = std::find_if(data + frameOffset + 1, data + size, [](uchar byte) {
+            return ((byte == MAVLINK_STX) || (byte == MAVLINK_STX_MAVLINK1));
+        });
+        frameOffset = next - data;
+    }
+
+    return false;
+}
+
+void TelemetryLogIndex::clear()
+{
+    _entries.clear();
+    _messageCounts.clear();
+    _recordCount = 0;
+    _startTimeUSecs = 0;
+    _endTimeUSecs = 0;
+    _lastRecordOffset = 0;
+    _logSize = 0;
+}
+
+void TelemetryLogIndex::addRecord(qint64 offset, quint64 timestampUSecs, uint32_t msgid)
+{
+    if (_recordCount == 0) {
+        _startTimeUSecs = timestampUSecs;
+    }
+
+    // Entries are only added as time moves forward which keeps them sorted even if the log has timestamp jitter
+    if (_entries.isEmpty() || (timestampUSecs >= (_entries.constLast().timestampUSecs + kEntryIntervalUSecs))) {
+        _entries.append({ timestampUSecs, offset });
+    }
+
+    _recordCount++;
+    _endTimeUSecs = timestampUSecs;
+    _lastRecordOffset = offset;
+    _messageCounts[msgid]++;
+}
+
+void TelemetryLogIndex::build(const uchar *data, qint64 size)
+{
+    clear();
+
+    Record record;
+    qint64 offset = 0;
+    while (readRecord(data, size, offset, record)) {
+        addRecord(record.offset, record.timestampUSecs, record.msgid);
+        offset = record.nextOffset();
+    }
+
+    _logSize = size;
+
+    qCDebug(TelemetryLogIndexLog) << "Indexed records:" << _recordCount << "entries:" << _entries.size() << "message ids:" << _messageCounts.size();
+}
+
+qint64 TelemetryLogIndex::offsetForTime(quint64 timestampUSecs) const
+{
+    if (_entries.isEmpty()) {
+        return 0;
+    }
+
+    auto it = std::upper_bound(_entries.constBegin(), _entries.constEnd(), timestampUSecs, [](quint64 value, const Entry &entry) {
+        return (value < entry.timestampUSecs);
+    });
+    if (it != _entries.constBegin()) {
+        --it;
+    }
+
+    return it->offset;
+}
+
+bool TelemetryLogIndex::save(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(TelemetryLogIndexLog) << "Unable to write index" << fileName << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << kFileMagic << kFileVersion;
+    stream << _logSize << _recordCount << _startTimeUSecs << _endTimeUSecs << _lastRecordOffset;
+
+    stream << static_cast<quint32>(_entries.size());
+    for (const Entry &entry : _entries) {
+        stream << entry.timestampUSecs << entry.offset;
+    }
+
+    stream << static_cast<quint32>(_messageCounts.size());
+    for (auto it = _messageCounts.constBegin(); it != _messageCounts.constEnd(); ++it) {
+        stream << it.key() << it.value();
+    }
+
+    if ((stream.status() != QDataStream::Ok) || !file.commit()) {
+        qCDebug(TelemetryLogIndexLog) << "Unable to write index" << fileName << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool TelemetryLogIndex::load(const QString &fileName, const uchar *logData, qint64 logSize)
+{
+    clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if ((magic != kFileMagic) || (version != kFileVersion)) {
+        qCDebug(TelemetryLogIndexLog) << "Unsupported index" << fileName;
+        return false;
+    }
+
+    stream >> _logSize >> _recordCount >> _startTimeUSecs >> _endTimeUSecs >> _lastRecordOffset;
+    if ((stream.status() != QDataStream::Ok) || (_logSize != logSize)) {
+        qCDebug(TelemetryLogIndexLog) << "Index does not match log size" << fileName;
+        clear();
+        return false;
+    }
+
+    quint32 entryCount = 0;
+    stream >> entryCount;
+    for (quint32 i = 0; (i < entryCount) && (stream.status() == QDataStream::Ok); i++) {
+        Entry entry;
+        stream >> entry.timestampUSecs >> entry.offset;
+        _entries.append(entry);
+    }
+
+    quint32 histogramCount = 0;
+    stream >> histogramCount;
+    for (quint32 i = 0; (i < histogramCount) && (stream.status() == QDataStream::Ok); i++) {
+        uint32_t msgid = 0;
+        quint64 count = 0;
+        stream >> msgid >> count;
+        _messageCounts[msgid] = count;
+    }
+
+    // The first and last records must be where the index says they are
+    Record first;
+    Record last;
+    const bool valid = (stream.status() == QDataStream::Ok)
+        && (_recordCount > 0)
+        && readRecord(logData, logSize, 0, first) && (first.timestampUSecs == _startTimeUSecs)
+        && readRecord(logData, logSize, _lastRecordOffset, last) && (last.offset == _lastRecordOffset) && (last.timestampUSecs == _endTimeUSecs);
+    if (!valid) {
+        qCDebug(TelemetryLogIndexLog) << "Index does not match log" << fileName;
+        clear();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryLogIndexLog)
+
+/// Time index for a telemetry log.
+/// A telemetry log is a sequence of records, each being a big endian microsecond timestamp followed by a MAVLink frame.
+/// The index maps log time to file offsets at a fixed time interval and keeps a per message id histogram. It is stored
+/// next to the log in a sidecar file so seeking and reporting the log duration doesn't require scanning the log.
+class TelemetryLogIndex
+{
+public:
+    struct Entry {
+        quint64 timestampUSecs = 0;
+        qint64 offset = 0;
+    };
+
+    struct Record {
+        qint64 offset = 0;          ///< Offset of the timestamp
+        quint64 timestampUSecs = 0;
+        qint64 frameOffset = 0;
+        qsizetype frameLength = 0;
+        uint32_t msgid = 0;
+
+        qint64 nextOffset() const { return frameOffset + frameLength; }
+    };
+
+    /// Finds the first valid record which starts at or after offset
+    ///     @return false: No more records
+    static bool readRecord(const uchar *data, qint64 size, qint64 offset, Record &record);
+
+    /// Reads a record timestamp, coping with logs written with the wrong byte order
+    static quint64 parseTimestamp(const uchar *data);
+
+    /// @return File name of the index for logFileName
+    static QString indexFileName(const QString &logFileName) { return logFileName + QStringLiteral(".idx"); }
+
+    void clear();
+
+    /// Adds the record at offset, records must be added in file order
+    void addRecord(qint64 offset, quint64 timestampUSecs, uint32_t msgid);
+
+    /// Sets the size of the indexed log, once all records have been added
+    void setLogSize(qint64 logSize) { _logSize = logSize; }
+
+    /// Indexes the whole log
+    void build(const uchar *data, qint64 size);
+
+    /// Loads the index from fileName. Fails if the index does not match the log.
+    bool load(const QString &fileName, const uchar *logData, qint64 logSize);
+    bool save(const QString &fileName) const;
+
+    bool isEmpty() const { return (_recordCount == 0); }
+    quint64 recordCount() const { return _recordCount; }
+    quint64 startTimeUSecs() const { return _startTimeUSecs; }
+    quint64 endTimeUSecs() const { return _endTimeUSecs; }
+    quint64 durationUSecs() const { return (_endTimeUSecs - _startTimeUSecs); }
+    qint64 lastRecordOffset() const { return _lastRecordOffset; }
+    const QHash<uint32_t, quint64> &messageCounts() const { return _messageCounts; }
+
+    /// @return Offset of the last index entry at or before timestampUSecs
+    qint64 offsetForTime(quint64 timestampUSecs) const;
+
+    static constexpr quint64 kEntryIntervalUSecs = 100 * 1000;
+
+private:
+    QList<Entry> _entries;
+    QHash<uint32_t, quint64> _messageCounts;
+    quint64 _recordCount = 0;
+    quint64 _startTimeUSecs = 0;
+    quint64 _endTimeUSecs = 0;
+    qint64 _lastRecordOffset = 0;
+    qint64 _logSize = 0;
+
+    static constexpr qint64 kTimestampSize = sizeof(quint64);
+    static constexpr quint32 kFileMagic = 0x51544c49;   ///< "QTLI"
+    static constexpr quint32 kFileVersion = 1;
+};
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPBatchIO.h"
+#include "QGCLoggingCategory.h"
+#include "UDPLink.h"
+
+#include <QtNetwork/QUdpSocket>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <vector>
+#endif
+
+QGC_LOGGING_CATEGORY(UDPBatchIOLog, "qgc.comms.udpbatchio")
+
+#ifdef Q_OS_LINUX
+struct UDPBatchIO::Buffers
+{
+    explicit Buffers(int batchSize)
+        : rxMessages(batchSize)
+        , rxIovecs(batchSize)
+        , rxAddresses(batchSize)
+        , rxData(static_cast<size_t>(batchSize) * kMaxDatagramSize)
+        , txMessages(batchSize)
+        , txIovecs(batchSize)
+        , txAddresses(batchSize)
+    {}
+
+    std::vector<mmsghdr> rxMessages;
+    std::vector<iovec> rxIovecs;
+    std::vector<sockaddr_storage> rxAddresses;
+    std::vector<char> rxData;
+
+    std::vector<mmsghdr> txMessages;
+    std::vector<iovec> txIovecs;
+    std::vector<sockaddr_in> txAddresses;
+};
+#else
+struct UDPBatchIO::Buffers
+{
+    explicit Buffers(int batchSize) { Q_UNUSED(batchSize); }
+};
+#endif
+
+UDPBatchIO::UDPBatchIO(int batchSize)
+    : _batchSize(qMax(1, batchSize))
+    , _buffers(std::make_unique<Buffers>(_batchSize))
+{
+    _datagrams.resize(_batchSize);
+}
+
+UDPBatchIO::~UDPBatchIO()
+{
+    qCDebug(UDPBatchIOLog) << "receive calls:" << _stats.receiveCalls << "datagrams:" << _stats.datagramsReceived
+                           << "send calls:" << _stats.sendCalls << "datagrams:" << _stats.datagramsSent;
+}
+
+bool UDPBatchIO::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+int UDPBatchIO::receive(qintptr socketDescriptor)
+{
+#ifdef Q_OS_LINUX
+    Buffers &buffers = *_buffers;
+    for (int i = 0; i < _batchSize; i++) {
+        buffers.rxIovecs[i].iov_base = buffers.rxData.data() + (static_cast<size_t>(i) * kMaxDatagramSize);
+        buffers.rxIovecs[i].iov_len = kMaxDatagramSize;
+
+        msghdr &header = buffers.rxMessages[i].msg_hdr;
+        header = msghdr{};
+        header.msg_name = &buffers.rxAddresses[i];
+        header.msg_namelen = sizeof(sockaddr_storage);
+        header.msg_iov = &buffers.rxIovecs[i];
+        header.msg_iovlen = 1;
+        buffers.rxMessages[i].msg_len = 0;
+    }
+
+    int count;
+    do {
+        count = recvmmsg(static_cast<int>(socketDescriptor), buffers.rxMessages.data(), static_cast<unsigned>(_batchSize), MSG_DONTWAIT, nullptr);
+    } while ((count < 0) && (errno == EINTR));
+
+    _stats.receiveCalls++;
+    if (count < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        qCWarning(UDPBatchIOLog) << "recvmmsg failed:" << strerror(errno);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const mmsghdr &message = buffers.rxMessages[i];
+        Datagram &datagram = _datagrams[i];
+        datagram.data = static_cast<const char*>(buffers.rxIovecs[i].iov_base);
+        datagram.size = static_cast<qsizetype>(message.msg_len);
+
+        if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+            _stats.datagramsTruncated++;
+            qCWarning(UDPBatchIOLog) << "Datagram truncated to" << kMaxDatagramSize << "bytes";
+        }
+
+        const sockaddr_storage &address = buffers.rxAddresses[i];
+        if (address.ss_family == AF_INET) {
+            const sockaddr_in *const address4 = reinterpret_cast<const sockaddr_in*>(&address);
+            datagram.senderAddress.setAddress(ntohl(address4->sin_addr.s_addr));
+            datagram.senderPort = ntohs(address4->sin_port);
+        } else if (address.ss_family == AF_INET6) {
+            const sockaddr_in6 *const address6 = reinterpret_cast<const sockaddr_in6*>(&address);
+            datagram.senderAddress.setAddress(reinterpret_cast<const sockaddr*>(address6));
+            datagram.senderPort = ntohs(address6->sin6_port);
+        } else {
+            datagram.senderAddress.clear();
+            datagram.senderPort = 0;
+        }
+    }
+
+    _stats.datagramsReceived += static_cast<uint64_t>(count);
+
+    return count;
+#else
+    Q_UNUSED(socketDescriptor);
+    return -1;
+#endif
+}
+
+int UDPBatchIO::send(QUdpSocket &socket, QByteArrayView data, const QList<std::shared_ptr<UDPClient>> &targets)
+{
+#ifdef Q_OS_LINUX
+    const int socketDescriptor = static_cast<int>(socket.socketDescriptor());
+    Buffers &buffers = *_buffers;
+    int sentCount = 0;
+    qsizetype targetIndex = 0;
+    while (targetIndex < targets.size()) {
+        // Fill a batch, every message points at the same payload
+        unsigned batchCount = 0;
+        while ((targetIndex < targets.size()) && (batchCount < static_cast<unsigned>(_batchSize))) {
+            const UDPClient &target = *targets[targetIndex++];
+            bool isIPv4 = false;
+            const quint32 ipv4Address = target.address.toIPv4Address(&isIPv4);
+            if (!isIPv4) {
+                // Rare enough that the batch buffers only hold IPv4 addresses
+                _stats.sendCalls++;
+                if (socket.writeDatagram(data.data(), data.size(), target.address, target.port) < 0) {
+                    _stats.sendErrors++;
+                    qCWarning(UDPBatchIOLog) << "Could Not Send Data - Write Failed!" << socket.errorString();
+                } else {
+                    sentCount++;
+                }
+                continue;
+            }
+
+            sockaddr_in &address = buffers.txAddresses[batchCount];
+            address = sockaddr_in{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(target.port);
+            address.sin_addr.s_addr = htonl(ipv4Address);
+
+            buffers.txIovecs[batchCount].iov_base = const_cast<char*>(data.data());
+            buffers.txIovecs[batchCount].iov_len = static_cast<size_t>(data.size());
+
+            msghdr &header = buffers.txMessages[batchCount].msg_hdr;
+            header = msghdr{};
+            header.msg_name = &address;
+            header.msg_namelen = sizeof(sockaddr_in);
+            header.msg_iov = &buffers.txIovecs[batchCount];
+            header.msg_iovlen = 1;
+            batchCount++;
+        }
+
+        unsigned offset = 0;
+        while (offset < batchCount) {
+            const int count = sendmmsg(socketDescriptor, buffers.txMessages.data() + offset, batchCount - offset, MSG_DONTWAIT);
+            _stats.sendCalls++;
+            if (count > 0) {
+                offset += static_cast<unsigned>(count);
+                sentCount += count;
+            } else if ((count < 0) && (errno == EINTR)) {
+                continue;
+            } else if ((count < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+                // Socket buffer is full, same as a failed writeDatagram the rest is dropped
+                _stats.sendErrors += batchCount - offset;
+                qCWarning(UDPBatchIOLog) << "Could Not Send Data - Socket buffer full";
+                break;
+            } else {
+                // sendmmsg only fails if the first message fails, skip its target and carry on with the rest
+                _stats.sendErrors++;
+                qCWarning(UDPBatchIOLog) << "Could Not Send Data - Write Failed!" << strerror(errno);
+                offset++;
+            }
+        }
+    }
+
+    _stats.datagramsSent += static_cast<uint64_t>(sentCount);
+
+    return sentCount;
+#else
+    Q_UNUSED(socket); Q_UNUSED(data); Q_UNUSED(targets);
+    return 0;
+#endif
+}
@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtNetwork/QHostAddress>
+
+#include <memory>
+
+class QUdpSocket;
+struct UDPClient;
+
+Q_DECLARE_LOGGING_CATEGORY(UDPBatchIOLog)
+
+/// Batched datagram I/O on a bound UDP socket using recvmmsg/sendmmsg, which moves many datagrams per
+/// system call. All buffers are allocated up front. Only available on Linux, see isSupported.
+class UDPBatchIO
+{
+public:
+    struct Datagram {
+        const char *data = nullptr;
+        qsizetype size = 0;
+        QHostAddress senderAddress;
+        quint16 senderPort = 0;
+    };
+
+    struct Stats {
+        uint64_t receiveCalls = 0;
+        uint64_t datagramsReceived = 0;
+        uint64_t datagramsTruncated = 0;    ///< Larger than kMaxDatagramSize
+        uint64_t sendCalls = 0;
+        uint64_t datagramsSent = 0;
+        uint64_t sendErrors = 0;
+    };
+
+    explicit UDPBatchIO(int batchSize = kDefaultBatchSize);
+    ~UDPBatchIO();
+
+    static bool isSupported();
+
+    int batchSize() const { return _batchSize; }
+
+    /// Receives up to batchSize pending datagrams without blocking
+    ///     @return Number of datagrams received, 0 if none are pending, -1 on error.
+    ///             Received datagrams stay valid until the next call.
+    int receive(qintptr socketDescriptor);
+    const Datagram &datagram(int index) const { return _datagrams[index]; }
+
+    /// Sends data as a single datagram to each target without blocking. IPv4 targets are batched,
+    /// others are sent one at a time through socket.
+    ///     @return Number of targets data was sent to
+    int send(QUdpSocket &socket, QByteArrayView data, const QList<std::shared_ptr<UDPClient>> &targets);
+
+    const Stats &stats() const { return _stats; }
+
+    static constexpr int kDefaultBatchSize = 32;
+    static constexpr qsizetype kMaxDatagramSize = 8 * 1024;
+
+private:
+    struct Buffers;
+
+    const int _batchSize;
+    std::unique_ptr<Buffers> _buffers;
+    QList<Datagram> _datagrams;
+    Stats _stats;
+};
@@ -12,6 +12,7 @@
 #include "DeviceInfo.h"
 #include "QGCLoggingCategory.h"
 #include "SettingsManager.h"
+#include "UDPBatchIO.h"
 
 #include <QtCore/QMutexLocker>
 #include <QtCore/QThread>
@@ -289,6 +290,10 @@ void UDPWorker::setupSocket()
     Q_ASSERT(!_socket);
     _socket = new QUdpSocket(this);
 
+    if (UDPBatchIO::isSupported()) {
+        _batchIO = std::make_unique<UDPBatchIO>();
+    }
+
     const QList<QHostAddress> localAddresses = QNetworkInterface::allAddresses();
     _localAddresses = QSet(localAddresses.constBegin(), localAddresses.constEnd());
 
@@ -381,26 +386,27 @@ void UDPWorker::writeData(const QByteArray &data)
         return;
     }
 
+    // Manually targeted systems first, then all connected systems
+    _writeTargets.clear();
     QMutexLocker locker(&_sessionTargetsMutex);
-
-    // Send to all manually targeted systems
     for (const std::shared_ptr<UDPClient> &target : _udpConfig->targetHosts()) {
         if (!containsTarget(_sessionTargets, target->address, target->port)) {
-            if (_socket->writeDatagram(data, target->address, target->port) < 0) {
-                qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
-            }
+            _writeTargets.append(target);
         }
     }
+    _writeTargets.append(_sessionTargets);
+    locker.unlock();
 
-    // Send to all connected systems
-    for (const std::shared_ptr<UDPClient> &target: _sessionTargets) {
-        if (_socket->writeDatagram(data, target->address, target->port) < 0) {
-            qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
+    if (_batchIO) {
+        (void) _batchIO->send(*_socket, data, _writeTargets);
+    } else {
+        for (const std::shared_ptr<UDPClient> &target : std::as_const(_writeTargets)) {
+            if (_socket->writeDatagram(data, target->address, target->port) < 0) {
+                qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
+            }
         }
     }
 
-    locker.unlock();
-
     emit dataSent(data);
 }
 
@@ -439,29 +445,26 @@ void UDPWorker::_onSocketReadyRead()
     timer.start();
     bool received = false;
     while (_socket->hasPendingDatagrams()) {
+        // QUdpSocket only re-arms its read notification after one of its own reads, so each pass starts with one
         const QNetworkDatagram datagramIn = _socket->receiveDatagram();
-        if (datagramIn.isNull() || datagramIn.data().isEmpty()) {
-            continue;
+        if (!datagramIn.isNull() && !datagramIn.data().isEmpty()) {
+            _receiveDatagram(datagramIn.data(), datagramIn.senderAddress(), datagramIn.senderPort(), buffer, timer, received);
         }
 
-        (void) buffer.append(datagramIn.data());
-
-        if ((buffer.size() > BUFFER_TRIGGER_SIZE) || (timer.elapsed() > RECEIVE_TIME_LIMIT_MS)) {
-            received = true;
-            emit dataReceived(buffer);
-            buffer.clear();
-            (void) timer.restart();
+        if (!_batchIO) {
+            continue;
         }
 
-        const bool ipLocal = datagramIn.senderAddress().isLoopback() || _localAddresses.contains(datagramIn.senderAddress());
-        const QHostAddress senderAddress = ipLocal ? QHostAddress(QHostAddress::SpecialAddress::LocalHost) : datagramIn.senderAddress();
-
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!containsTarget(_sessionTargets, senderAddress, datagramIn.senderPort())) {
-            qCDebug(UDPLinkLog) << "UDP Adding target:" << senderAddress << datagramIn.senderPort();
-            _sessionTargets.append(std::make_shared<UDPClient>(senderAddress, datagramIn.senderPort()));
-        }
-        locker.unlock();
+        int count = 0;
+        do {
+            count = _batchIO->receive(_socket->socketDescriptor());
+            for (int i = 0; i < count; i++) {
+                const UDPBatchIO::Datagram &datagram = _batchIO->datagram(i);
+                if (datagram.size > 0) {
+                    _receiveDatagram(QByteArrayView(datagram.data, datagram.size), datagram.senderAddress, datagram.senderPort, buffer, timer, received);
+                }
+            }
+        } while (count == _batchIO->batchSize());
     }
 
     if (!received && buffer.isEmpty()) {
@@ -472,6 +475,27 @@ void UDPWorker::_onSocketReadyRead()
     emit dataReceived(buffer);
 }
 
+void UDPWorker::_receiveDatagram(QByteArrayView data, const QHostAddress &senderAddress, quint16 senderPort, QByteArray &buffer, QElapsedTimer &timer, bool &received)
+{
+    (void) buffer.append(data);
+
+    if ((buffer.size() > BUFFER_TRIGGER_SIZE) || (timer.elapsed() > RECEIVE_TIME_LIMIT_MS)) {
+        received = true;
+        emit dataReceived(buffer);
+        buffer.clear();
+        (void) timer.restart();
+    }
+
+    const bool ipLocal = senderAddress.isLoopback() || _localAddresses.contains(senderAddress);
+    const QHostAddress targetAddress = ipLocal ? QHostAddress(QHostAddress::SpecialAddress::LocalHost) : senderAddress;
+
+    QMutexLocker locker(&_sessionTargetsMutex);
+    if (!containsTarget(_sessionTargets, targetAddress, senderPort)) {
+        qCDebug(UDPLinkLog) << "UDP Adding target:" << targetAddress << senderPort;
+        _sessionTargets.append(std::make_shared<UDPClient>(targetAddress, senderPort));
+    }
+}
+
 void UDPWorker::_onSocketBytesWritten(qint64 bytes)
 {
     qCDebug(UDPLinkLog) << "Wrote" << bytes << "bytes";
@@ -568,6 +592,8 @@ UDPLink::UDPLink(SharedLinkConfigurationPtr &config, QObject *parent)
 
     _workerThread->setObjectName(QStringLiteral("UDP_%1").arg(_udpConfig->name()));
 
+    _setMaxTxWriteSize(kMaxDatagramSize);
+
     _worker->moveToThread(_workerThread);
 
     (void) connect(_workerThread, &QThread::started, _worker, &UDPWorker::setupSocket);
@@ -637,7 +663,12 @@ void UDPLink::_onDataSent(const QByteArray &data)
 
 void UDPLink::_writeBytes(const QByteArray& bytes)
 {
-    (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, bytes));
+    // Queued writes are drained on the worker thread, see _txContext
+    if (QThread::currentThread() == _workerThread) {
+        _worker->writeData(bytes);
+    } else {
+        (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, bytes));
+    }
 }
 
 bool UDPLink::isSecureConnection() const
@@ -10,12 +10,15 @@
 #pragma once
 
 #include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QString>
 #include <QtNetwork/QHostAddress>
 
+#include <memory>
+
 #ifdef QGC_ZEROCONF_ENABLED
 #ifdef Q_OS_WIN
 #define WIN32_LEAN_AND_MEAN
@@ -28,6 +31,7 @@
 
 class QUdpSocket;
 class QThread;
+class UDPBatchIO;
 
 Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
 
@@ -141,8 +145,13 @@ private slots:
     void _onSocketErrorOccurred(QAbstractSocket::SocketError socketError);
 
 private:
+    /// Adds a received datagram to buffer, which is emitted once it grows large enough
+    void _receiveDatagram(QByteArrayView data, const QHostAddress &senderAddress, quint16 senderPort, QByteArray &buffer, QElapsedTimer &timer, bool &received);
+
     const UDPConfiguration *_udpConfig = nullptr;
     QUdpSocket *_socket = nullptr;
+    std::unique_ptr<UDPBatchIO> _batchIO;   ///< Batched reads and writes where supported
+    QList<std::shared_ptr<UDPClient>> _writeTargets;
     QMutex _sessionTargetsMutex;
     QList<std::shared_ptr<UDPClient>> _sessionTargets;
     bool _isConnected = false;
@@ -186,7 +195,12 @@ private slots:
     void _onDataSent(const QByteArray &data);
 
 private:
+    QObject *_txContext() override { return _worker; }
+
     const UDPConfiguration *_udpConfig = nullptr;
     UDPWorker *_worker = nullptr;
     QThread *_workerThread = nullptr;
+
+    /// Coalesced frames must still fit into a single unfragmented datagram on an Ethernet MTU
+    static constexpr qsizetype kMaxDatagramSize = 1472;
 };
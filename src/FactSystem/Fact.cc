@@ -311,10 +311,15 @@ QStringList Fact::selectedBitmaskStrings() const
 }
 
 QString Fact::_variantToString(const QVariant &variant, int decimalPlaces) const
+{
+    return variantToString(type(), variant, decimalPlaces);
+}
+
+QString Fact::variantToString(FactMetaData::ValueType_t type, const QVariant &variant, int decimalPlaces)
 {
     QString valueString;
 
-    switch (type()) {
+    switch (type) {
     case FactMetaData::valueTypeFloat:
     {
         const float fValue = variant.toFloat();
@@ -169,6 +169,9 @@ class Fact : public QObject
     /// Generally this is done during parsing. But if you know what you are doing, you can.
     void setEnumInfo(const QStringList &strings, const QVariantList &values);
 
+    /// Formats a raw value of the given type the way Facts show it, for values which don't have a Fact
+    static QString variantToString(FactMetaData::ValueType_t type, const QVariant &variant, int decimalPlaces);
+
 signals:
     void bitmaskStringsChanged();
     void bitmaskValuesChanged();
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "FactGroup.h"
+#include "MAVLinkMessageDispatcher.h"
 #include "QGCLoggingCategory.h"
 
 QGC_LOGGING_CATEGORY(FactGroupLog, "qgc.factsystem.factgroup")
@@ -136,6 +137,11 @@ void FactGroup::_addFact(Fact *fact, const QString &name)
     emit factNamesChanged();
 }
 
+QList<uint32_t> FactGroup::handledMessageIds() const
+{
+    return { MAVLinkMessageDispatcher::kAnyMessageId };
+}
+
 void FactGroup::_addFactGroup(FactGroup *factGroup, const QString &name)
 {
     if (_nameToFactGroupMap.contains(name)) {
@@ -60,6 +60,10 @@ class FactGroup : public QObject
     /// Allows a FactGroup to parse incoming messages and fill in values
     virtual void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) {}
 
+    /// Message ids handleMessage should be called for, an empty list if the FactGroup does not handle messages.
+    /// The default routes all messages to handleMessage.
+    virtual QList<uint32_t> handledMessageIds() const;
+
 signals:
     void factNamesChanged();
     void factGroupNamesChanged();
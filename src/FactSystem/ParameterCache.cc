@@ -0,0 +1,280 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCache.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(ParameterCacheLog, "qgc.factsystem.parametercache")
+
+ParameterCache::ParameterCache()
+{
+    // qCDebug(ParameterCacheLog) << Q_FUNC_INFO << this;
+}
+
+ParameterCache::~ParameterCache()
+{
+    close();
+
+    // qCDebug(ParameterCacheLog) << Q_FUNC_INFO << this;
+}
+
+bool ParameterCache::_supportedType(FactMetaData::ValueType_t type)
+{
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+    case FactMetaData::valueTypeInt8:
+    case FactMetaData::valueTypeUint16:
+    case FactMetaData::valueTypeInt16:
+    case FactMetaData::valueTypeUint32:
+    case FactMetaData::valueTypeInt32:
+    case FactMetaData::valueTypeUint64:
+    case FactMetaData::valueTypeInt64:
+    case FactMetaData::valueTypeFloat:
+    case FactMetaData::valueTypeDouble:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QByteArray ParameterCache::valueBytes(FactMetaData::ValueType_t type, const QVariant &value)
+{
+    QByteArray bytes(8, '\0');
+    uchar *const data = reinterpret_cast<uchar*>(bytes.data());
+
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+        data[0] = static_cast<quint8>(value.toUInt());
+        break;
+    case FactMetaData::valueTypeInt8:
+        data[0] = static_cast<quint8>(static_cast<qint8>(value.toInt()));
+        break;
+    case FactMetaData::valueTypeUint16:
+        qToLittleEndian<quint16>(static_cast<quint16>(value.toUInt()), data);
+        break;
+    case FactMetaData::valueTypeInt16:
+        qToLittleEndian<qint16>(static_cast<qint16>(value.toInt()), data);
+        break;
+    case FactMetaData::valueTypeUint32:
+        qToLittleEndian<quint32>(value.toUInt(), data);
+        break;
+    case FactMetaData::valueTypeInt32:
+        qToLittleEndian<qint32>(value.toInt(), data);
+        break;
+    case FactMetaData::valueTypeUint64:
+        qToLittleEndian<quint64>(value.toULongLong(), data);
+        break;
+    case FactMetaData::valueTypeInt64:
+        qToLittleEndian<qint64>(value.toLongLong(), data);
+        break;
+    case FactMetaData::valueTypeFloat:
+        qToLittleEndian<float>(value.toFloat(), data);
+        break;
+    case FactMetaData::valueTypeDouble:
+        qToLittleEndian<double>(value.toDouble(), data);
+        break;
+    default:
+        return QByteArray();
+    }
+
+    bytes.truncate(static_cast<qsizetype>(FactMetaData::typeToSize(type)));
+    return bytes;
+}
+
+bool ParameterCache::write(const QString &path, quint32 hash, QList<Param> params)
+{
+    std::sort(params.begin(), params.end(), [](const Param &a, const Param &b) {
+        return (a.name < b.name);
+    });
+
+    QByteArray names;
+    QByteArray records(params.size() * kRecordSize, '\0');
+    for (qsizetype i = 0; i < params.size(); i++) {
+        const Param &param = params[i];
+        if (!_supportedType(param.type)) {
+            qCWarning(ParameterCacheLog) << "Unsupported parameter type" << param.name << param.type;
+            return false;
+        }
+
+        const QByteArray name = param.name.toLatin1();
+        uchar *const record = reinterpret_cast<uchar*>(records.data()) + (i * kRecordSize);
+        qToLittleEndian<quint32>(static_cast<quint32>(names.size()), record);
+        qToLittleEndian<quint16>(static_cast<quint16>(name.size()), record + 4);
+        record[6] = static_cast<uchar>(param.type);
+        const QByteArray value = valueBytes(param.type, param.value);
+        (void) memcpy(record + 8, value.constData(), value.size());
+        names.append(name);
+    }
+
+    QByteArray header(kHeaderSize, '\0');
+    uchar *const headerData = reinterpret_cast<uchar*>(header.data());
+    (void) memcpy(headerData, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint32>(static_cast<quint32>(params.size()), headerData + 8);
+    qToLittleEndian<quint32>(hash, headerData + 12);
+    qToLittleEndian<quint32>(static_cast<quint32>(names.size()), headerData + 16);
+
+    // Replaced in one step, a half written file is never mapped
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(ParameterCacheLog) << "Failed to open cache file for writing" << path << file.errorString();
+        return false;
+    }
+    (void) file.write(header);
+    (void) file.write(records);
+    (void) file.write(names);
+    if (!file.commit()) {
+        qCWarning(ParameterCacheLog) << "Failed to write cache file" << path << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool ParameterCache::open(const QString &path)
+{
+    close();
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    _size = _file.size();
+    if (_size >= kHeaderSize) {
+        _data = _file.map(0, _size);
+    }
+    if (!_data || (memcmp(_data, kMagic, sizeof(kMagic)) != 0)) {
+        qCWarning(ParameterCacheLog) << "Not a parameter cache" << path;
+        close();
+        return false;
+    }
+
+    _count = static_cast<int>(qFromLittleEndian<quint32>(_data + 8));
+    _hash = qFromLittleEndian<quint32>(_data + 12);
+    _namesSize = qFromLittleEndian<quint32>(_data + 16);
+
+    const qint64 namesStart = kHeaderSize + (static_cast<qint64>(_count) * kRecordSize);
+    if ((_count < 0) || ((namesStart + _namesSize) != _size)) {
+        qCWarning(ParameterCacheLog) << "Truncated parameter cache" << path;
+        close();
+        return false;
+    }
+    _names = reinterpret_cast<const char*>(_data + namesStart);
+
+    qCDebug(ParameterCacheLog) << "Opened" << path << "params:" << _count << "hash:" << _hash;
+    return true;
+}
+
+void ParameterCache::close()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+        _data = nullptr;
+    }
+    _file.close();
+
+    _size = 0;
+    _count = 0;
+    _hash = 0;
+    _names = nullptr;
+    _namesSize = 0;
+}
+
+QLatin1StringView ParameterCache::_name(int index) const
+{
+    const uchar *const record = _record(index);
+    const quint32 offset = qFromLittleEndian<quint32>(record);
+    const quint16 length = qFromLittleEndian<quint16>(record + 4);
+    if ((static_cast<quint64>(offset) + length) > _namesSize) {
+        return QLatin1StringView();
+    }
+
+    return QLatin1StringView(_names + offset, length);
+}
+
+int ParameterCache::indexOf(const QString &name) const
+{
+    int first = 0;
+    int last = _count;
+    while (first < last) {
+        const int middle = first + ((last - first) / 2);
+        const int comparison = name.compare(_name(middle));
+        if (comparison == 0) {
+            return middle;
+        } else if (comparison < 0) {
+            last = middle;
+        } else {
+            first = middle + 1;
+        }
+    }
+
+    return -1;
+}
+
+QString ParameterCache::name(int index) const
+{
+    if ((index < 0) || (index >= _count)) {
+        return QString();
+    }
+
+    return _name(index).toString();
+}
+
+FactMetaData::ValueType_t ParameterCache::type(int index) const
+{
+    if ((index < 0) || (index >= _count)) {
+        return FactMetaData::valueTypeInt32;
+    }
+
+    return static_cast<FactMetaData::ValueType_t>(_record(index)[6]);
+}
+
+QVariant ParameterCache::value(int index) const
+{
+    if ((index < 0) || (index >= _count)) {
+        return QVariant();
+    }
+
+    return valueFromBytes(type(index), _record(index) + 8);
+}
+
+QVariant ParameterCache::valueFromBytes(FactMetaData::ValueType_t type, const uchar *data)
+{
+    // Same variant types as parameters decoded from PARAM_VALUE
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+        return QVariant(static_cast<int>(data[0]));
+    case FactMetaData::valueTypeInt8:
+        return QVariant(static_cast<int>(static_cast<qint8>(data[0])));
+    case FactMetaData::valueTypeUint16:
+        return QVariant(static_cast<int>(qFromLittleEndian<quint16>(data)));
+    case FactMetaData::valueTypeInt16:
+        return QVariant(static_cast<int>(qFromLittleEndian<qint16>(data)));
+    case FactMetaData::valueTypeUint32:
+        return QVariant(qFromLittleEndian<quint32>(data));
+    case FactMetaData::valueTypeInt32:
+        return QVariant(qFromLittleEndian<qint32>(data));
+    case FactMetaData::valueTypeUint64:
+        return QVariant(qFromLittleEndian<quint64>(data));
+    case FactMetaData::valueTypeInt64:
+        return QVariant(qFromLittleEndian<qint64>(data));
+    case FactMetaData::valueTypeFloat:
+        return QVariant(qFromLittleEndian<float>(data));
+    case FactMetaData::valueTypeDouble:
+        return QVariant(qFromLittleEndian<double>(data));
+    default:
+        qCWarning(ParameterCacheLog) << "Unsupported parameter type" << type;
+        return QVariant();
+    }
+}
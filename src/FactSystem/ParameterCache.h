@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+#include "FactMetaData.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterCacheLog)
+
+/// Parameters of one component as last received from the vehicle. The file is memory mapped and
+/// has a fixed layout: a header holding the parameter set hash, a table of fixed size records
+/// sorted by name, then the names. Opening it only checks the header, values are read when asked for.
+class ParameterCache
+{
+public:
+    struct Param {
+        QString name;
+        FactMetaData::ValueType_t type = FactMetaData::valueTypeInt32;
+        QVariant value;
+    };
+
+    ParameterCache();
+    ~ParameterCache();
+
+    /// Writes the parameters in name order together with the hash the vehicle reports for them
+    static bool write(const QString &path, quint32 hash, QList<Param> params);
+
+    /// Little endian bytes of the value, as many as the type takes. Parameter set hashes are computed over these.
+    static QByteArray valueBytes(FactMetaData::ValueType_t type, const QVariant &value);
+    /// Reverse of valueBytes, data holds at least as many bytes as the type takes
+    static QVariant valueFromBytes(FactMetaData::ValueType_t type, const uchar *data);
+
+    /// @return false if the file is missing or is not a parameter cache
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return (_data != nullptr); }
+    QString path() const { return _file.fileName(); }
+
+    quint32 hash() const { return _hash; }
+    int count() const { return _count; }
+
+    /// @return -1 if the parameter is not in the cache
+    int indexOf(const QString &name) const;
+    QString name(int index) const;
+    FactMetaData::ValueType_t type(int index) const;
+    QVariant value(int index) const;
+
+private:
+    const uchar *_record(int index) const { return (_data + kHeaderSize + (static_cast<qsizetype>(index) * kRecordSize)); }
+    QLatin1StringView _name(int index) const;
+
+    static bool _supportedType(FactMetaData::ValueType_t type);
+
+    QFile _file;
+    const uchar *_data = nullptr;
+    qint64 _size = 0;
+    int _count = 0;
+    quint32 _hash = 0;
+    const char *_names = nullptr;
+    quint32 _namesSize = 0;
+
+    static constexpr char kMagic[8] = { 'Q', 'G', 'C', 'P', 'A', 'R', 'M', '1' };
+    static constexpr qsizetype kHeaderSize = 24;    ///< Magic, count, hash, size of the names
+    static constexpr qsizetype kRecordSize = 16;    ///< Name offset, name length, type, pad, 8 byte value
+};
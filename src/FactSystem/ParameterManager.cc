@@ -25,6 +25,9 @@
 #include <QtCore/QStandardPaths>
 #include <QtCore/QVariantAnimation>
 
+#include <algorithm>
+#include <iterator>
+
 QGC_LOGGING_CATEGORY(ParameterManagerLog, "qgc.factsystem.parametermanager")
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose1Log, "qgc.factsystem.parametermanager1:verbose")
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose2Log, "qgc.factsystem.parametermanager2:verbose")
@@ -51,6 +54,10 @@ ParameterManager::ParameterManager(Vehicle *vehicle)
     _waitingParamTimeoutTimer.setInterval(3000);
     (void) connect(&_waitingParamTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_waitingParamTimeout);
 
+    _indexRequestTimer.setSingleShot(true);
+    (void) connect(&_indexRequestTimer, &QTimer::timeout, this, &ParameterManager::_indexRequestTimeout);
+    _requestClock.start();
+
     // Ensure the cache directory exists
     (void) QFileInfo(QSettings().fileName()).dir().mkdir("ParamCache");
 }
@@ -218,6 +225,13 @@ void ParameterManager::_handleParamValue(int componentId, const QString &paramet
     _initialRequestTimeoutTimer.stop();
     _waitingParamTimeoutTimer.stop();
 
+    const qint64 nowMs = _requestClock.elapsed();
+    if (_requestListSentMs >= 0) {
+        // The first response to PARAM_REQUEST_LIST gives the first round trip time of the link
+        _indexRequestWindow.addRttSample(nowMs - _requestListSentMs);
+        _requestListSentMs = -1;
+    }
+
     // Update our total parameter counts
     if (!_paramCountMap.contains(componentId)) {
         _paramCountMap[componentId] = parameterCount;
@@ -248,8 +262,8 @@ void ParameterManager::_handleParamValue(int componentId, const QString &paramet
     // Remove this parameter from the waiting lists
     if (_waitingReadParamIndexMap[componentId].contains(parameterIndex)) {
         _waitingReadParamIndexMap[componentId].remove(parameterIndex);
-        (void) _indexBatchQueue.removeOne(parameterIndex);
-        _fillIndexBatchQueue(false /* waitingParamTimeout */);
+        (void) _indexRequestWindow.received(componentId, parameterIndex, nowMs);
+        (void) _fillIndexRequestWindow();
     }
 
     (void) _waitingReadParamNameMap[componentId].remove(parameterName);
@@ -265,67 +279,29 @@ void ParameterManager::_handleParamValue(int componentId, const QString &paramet
     }
 
     // Track how many parameters we are still waiting for
-    int waitingReadParamIndexCount = 0;
-    int waitingReadParamNameCount = 0;
-    int waitingWriteParamNameCount = 0;
+    const WaitingParamCounts_t waiting = _updateWaitingParamTimer();
+    const int readWaitingParamCount = waiting.readIndex + waiting.readName;
 
-    for (const int waitingComponentId: _waitingReadParamIndexMap.keys()) {
-        waitingReadParamIndexCount += _waitingReadParamIndexMap[waitingComponentId].count();
-    }
-    if (waitingReadParamIndexCount) {
-        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "waitingReadParamIndexCount:" << waitingReadParamIndexCount;
-    }
-
-    for (const int waitingComponentId: _waitingReadParamNameMap.keys()) {
-        waitingReadParamNameCount += _waitingReadParamNameMap[waitingComponentId].count();
-    }
-    if (waitingReadParamNameCount) {
-        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "waitingReadParamNameCount:" << waitingReadParamNameCount;
-    }
-
-    for (const int waitingComponentId: _waitingWriteParamNameMap.keys()) {
-        waitingWriteParamNameCount += _waitingWriteParamNameMap[waitingComponentId].count();
-    }
-    if (waitingWriteParamNameCount) {
-        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "waitingWriteParamNameCount:" << waitingWriteParamNameCount;
-    }
-
-    const int readWaitingParamCount = waitingReadParamIndexCount + waitingReadParamNameCount;
-    const int totalWaitingParamCount = readWaitingParamCount + waitingWriteParamNameCount;
-    if (totalWaitingParamCount) {
-        // More params to wait for, restart timer
-        _waitingParamTimeoutTimer.start();
-        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer: totalWaitingParamCount:" << totalWaitingParamCount;
-    } else if (!_mapCompId2FactMap.contains(_vehicle->defaultComponentId())) {
-        // Still waiting for parameters from default component
-        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer (still waiting for default component params)";
-        _waitingParamTimeoutTimer.start();
-    } else {
-        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Not restarting _waitingParamTimeoutTimer (all requests satisfied)";
+    if (waiting.readIndex && !_indexRequestsActive) {
+        // Still streaming the response to PARAM_REQUEST_LIST, request what is missing as soon as it stops
+        _indexRequestTimer.start(_indexRequestWindow.streamStallMs());
     }
 
     _updateProgressBar();
 
-    Fact *fact = nullptr;
+    const FactMetaData::ValueType_t factType = mavTypeToFactType(mavParamType);
     if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(parameterName)) {
-        fact = _mapCompId2FactMap[componentId][parameterName];
+        _mapCompId2FactMap[componentId][parameterName]->containerSetRawValue(parameterValue);
+    } else if (_setTableParam(componentId, parameterName, factType, parameterValue)) {
+        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "Stored param without fact" << parameterName;
     } else {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << parameterName;
 
-        fact = new Fact(componentId, parameterName, mavTypeToFactType(mavParamType), this);
-        FactMetaData *const factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(parameterName, fact->type());
-        fact->setMetaData(factMetaData);
-
-        _mapCompId2FactMap[componentId][parameterName] = fact;
-
-        // We need to know when the fact value changes so we can update the vehicle
-        (void) connect(fact, &Fact::containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
-
+        Fact *const fact = _addFact(componentId, parameterName, factType);
+        fact->containerSetRawValue(parameterValue);
         emit factAdded(componentId, fact);
     }
 
-    fact->containerSetRawValue(parameterValue);
-
     // Update param cache. The param cache is only used on PX4 Firmware since ArduPilot and Solo have volatile params
     // which invalidate the cache. The Solo also streams param updates in flight for things like gimbal values
     // which in turn causes a perf problem with all the param cache updates.
@@ -336,15 +312,62 @@ void ParameterManager::_handleParamValue(int componentId, const QString &paramet
         }
     }
 
-    _prevWaitingReadParamIndexCount = waitingReadParamIndexCount;
-    _prevWaitingReadParamNameCount = waitingReadParamNameCount;
-    _prevWaitingWriteParamNameCount = waitingWriteParamNameCount;
+    _setPrevWaitingParamCounts(waiting);
 
     _checkInitialLoadComplete();
 
     qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_parameterUpdate complete";
 }
 
+ParameterManager::WaitingParamCounts_t ParameterManager::_updateWaitingParamTimer()
+{
+    WaitingParamCounts_t waiting;
+
+    for (const int waitingComponentId: _waitingReadParamIndexMap.keys()) {
+        waiting.readIndex += _waitingReadParamIndexMap[waitingComponentId].count();
+    }
+    if (waiting.readIndex) {
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "waitingReadParamIndexCount:" << waiting.readIndex;
+    }
+
+    for (const int waitingComponentId: _waitingReadParamNameMap.keys()) {
+        waiting.readName += _waitingReadParamNameMap[waitingComponentId].count();
+    }
+    if (waiting.readName) {
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "waitingReadParamNameCount:" << waiting.readName;
+    }
+
+    for (const int waitingComponentId: _waitingWriteParamNameMap.keys()) {
+        waiting.writeName += _waitingWriteParamNameMap[waitingComponentId].count();
+    }
+    if (waiting.writeName) {
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "waitingWriteParamNameCount:" << waiting.writeName;
+    }
+
+    const int totalWaitingParamCount = waiting.readIndex + waiting.readName + waiting.writeName;
+    if (totalWaitingParamCount) {
+        // More params to wait for, restart timer
+        _waitingParamTimeoutTimer.start();
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer: totalWaitingParamCount:" << totalWaitingParamCount;
+    } else if (!_mapCompId2FactMap.contains(_vehicle->defaultComponentId())) {
+        // Still waiting for parameters from default component
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer (still waiting for default component params)";
+        _waitingParamTimeoutTimer.start();
+    } else {
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Not restarting _waitingParamTimeoutTimer (all requests satisfied)";
+        _waitingParamTimeoutTimer.stop();
+    }
+
+    return waiting;
+}
+
+void ParameterManager::_setPrevWaitingParamCounts(const WaitingParamCounts_t &waiting)
+{
+    _prevWaitingReadParamIndexCount = waiting.readIndex;
+    _prevWaitingReadParamNameCount = waiting.readName;
+    _prevWaitingWriteParamNameCount = waiting.writeName;
+}
+
 void ParameterManager::_factRawValueUpdateWorker(int componentId, const QString &name, FactMetaData::ValueType_t valueType, const QVariant &rawValue)
 {
     if (_waitingWriteParamNameMap.contains(componentId)) {
@@ -454,6 +477,12 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
         _initialRequestTimeoutTimer.start();
     }
 
+    if (_tryftp && _vehicle->capabilitiesKnown() && !(_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_FTP)) {
+        // There is no parameter file without FTP, don't wait for the download to fail
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Vehicle does not support FTP, using PARAM_REQUEST_LIST";
+        _tryftp = false;
+    }
+
     if (_tryftp && ((componentId == MAV_COMP_ID_ALL) || (componentId == MAV_COMP_ID_AUTOPILOT1))) {
         FTPManager *const ftpManager = _vehicle->ftpManager();
         (void) connect(ftpManager, &FTPManager::downloadComplete, this, &ParameterManager::_ftpDownloadComplete);
@@ -469,12 +498,17 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
             (void) disconnect(ftpManager, &FTPManager::downloadComplete, this, &ParameterManager::_ftpDownloadComplete);
         }
     } else {
+        // Index based requests wait for the new stream to stop
+        _indexRequestsActive = false;
+        _indexRequestTimer.stop();
+
         // Reset index wait lists
         for (int cid: _paramCountMap.keys()) {
             // Add/Update all indices to the wait list, parameter index is 0-based
             if ((componentId != MAV_COMP_ID_ALL) && (componentId != cid)) {
                 continue;
             }
+            _indexRequestWindow.cancel(cid);
             for (int waitingIndex = 0; waitingIndex < _paramCountMap[cid]; waitingIndex++) {
                 // This will add a new waiting index if needed and set the retry count for that index to 0
                 _waitingReadParamIndexMap[cid][waitingIndex] = 0;
@@ -489,6 +523,7 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
                                                  _vehicle->id(),
                                                  componentId);
         (void) _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+        _requestListSentMs = _requestClock.elapsed();
     }
 
     const QString what = (componentId == MAV_COMP_ID_ALL) ? "MAV_COMP_ID_ALL" : QString::number(componentId);
@@ -536,7 +571,7 @@ void ParameterManager::refreshParametersPrefix(int componentId, const QString &n
     componentId = _actualComponentId(componentId);
     qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "refreshParametersPrefix - name:" << namePrefix << ")";
 
-    for (const QString &paramName: _mapCompId2FactMap[componentId].keys()) {
+    for (const QString &paramName: parameterNames(componentId)) {
         if (paramName.startsWith(namePrefix)) {
             refreshParameter(componentId, paramName);
         }
@@ -548,8 +583,13 @@ bool ParameterManager::parameterExists(int componentId, const QString &paramName
     bool ret = false;
 
     componentId = _actualComponentId(componentId);
+    const QString mappedParamName = _remapParamNameToVersion(paramName);
     if (_mapCompId2FactMap.contains(componentId)) {
-        ret = _mapCompId2FactMap[componentId].contains(_remapParamNameToVersion(paramName));
+        ret = _mapCompId2FactMap[componentId].contains(mappedParamName);
+    }
+    if (!ret) {
+        const auto it = _mapCompId2ParamTable.constFind(componentId);
+        ret = ((it != _mapCompId2ParamTable.constEnd()) && (it->indexOf(mappedParamName) >= 0));
     }
 
     return ret;
@@ -560,12 +600,17 @@ Fact *ParameterManager::getParameter(int componentId, const QString &paramName)
     componentId = _actualComponentId(componentId);
 
     const QString mappedParamName = _remapParamNameToVersion(paramName);
-    if (!_mapCompId2FactMap.contains(componentId) || !_mapCompId2FactMap[componentId].contains(mappedParamName)) {
+    if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(mappedParamName)) {
+        return _mapCompId2FactMap[componentId][mappedParamName];
+    }
+
+    Fact *const fact = _createTableFact(componentId, mappedParamName);
+    if (!fact) {
         qgcApp()->reportMissingParameter(componentId, mappedParamName);
         return &_defaultFact;
     }
 
-    return _mapCompId2FactMap[componentId][mappedParamName];
+    return fact;
 }
 
 QStringList ParameterManager::parameterNames(int componentId) const
@@ -578,57 +623,123 @@ QStringList ParameterManager::parameterNames(int componentId) const
         names << paramName;
     }
 
+    // Params without a Fact yet, both lists are in name order and a param is never in both
+    const auto it = _mapCompId2ParamTable.constFind(compId);
+    if (it != _mapCompId2ParamTable.constEnd()) {
+        const QStringList tableNames = it->names();
+        if (!tableNames.isEmpty()) {
+            QStringList mergedNames;
+            mergedNames.reserve(names.size() + tableNames.size());
+            (void) std::merge(names.cbegin(), names.cend(), tableNames.cbegin(), tableNames.cend(), std::back_inserter(mergedNames));
+            names = mergedNames;
+        }
+    }
+
     return names;
 }
 
-bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
+bool ParameterManager::_fillIndexRequestWindow()
 {
-    if (!_indexBatchQueueActive) {
+    if (!_indexRequestsActive) {
         return false;
     }
 
-    constexpr int maxBatchSize = 10;
-
-    if (waitingParamTimeout) {
-        // We timed out, clear the queue and try again
-        qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to timeout";
-        _indexBatchQueue.clear();
-    } else {
-        qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to received parameter";
-    }
+    const int available = _indexRequestWindow.available();
+    const qint64 nowMs = _requestClock.elapsed();
 
-    for (const int componentId: _waitingReadParamIndexMap.keys()) {
-        if (_waitingReadParamIndexMap[componentId].count()) {
-            qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << _waitingReadParamIndexMap[componentId].count();
-            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << _waitingReadParamIndexMap[componentId];
+    // Up to a window full of the missing indices of each component, which are then requested in turns
+    QList<int> componentIds;
+    QList<QList<int>> componentIndices;
+    for (auto it = _waitingReadParamIndexMap.cbegin(); (available > 0) && (it != _waitingReadParamIndexMap.cend()); ++it) {
+        QList<int> indices;
+        for (auto indexIt = it->cbegin(); (indexIt != it->cend()) && (indices.count() < available); ++indexIt) {
+            if (!_indexRequestWindow.isInFlight(it.key(), indexIt.key())) {
+                indices.append(indexIt.key());
+            }
+        }
+        if (!indices.isEmpty()) {
+            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(it.key()) << "_waitingReadParamIndexMap count" << it->count();
+            componentIds.append(it.key());
+            componentIndices.append(indices);
         }
+    }
 
-        for (const int paramIndex: _waitingReadParamIndexMap[componentId].keys()) {
-            if (_indexBatchQueue.contains(paramIndex)) {
-                // Don't add more than once
+    int requestCount = 0;
+    bool gaveUp = false;
+    for (qsizetype turn = 0; requestCount < available; turn++) {
+        bool moreIndices = false;
+        for (qsizetype i = 0; (i < componentIds.count()) && (requestCount < available); i++) {
+            if (turn >= componentIndices[i].count()) {
                 continue;
             }
+            moreIndices = true;
 
-            if (_indexBatchQueue.count() > maxBatchSize) {
-                break;
-            }
-
-            _waitingReadParamIndexMap[componentId][paramIndex]++;   // Bump retry count
-            if (_disableAllRetries || (_waitingReadParamIndexMap[componentId][paramIndex] > _maxInitialLoadRetrySingleParam)) {
+            const int componentId = componentIds[i];
+            const int paramIndex = componentIndices[i][turn];
+            const int retryCount = ++_waitingReadParamIndexMap[componentId][paramIndex];    // Bump retry count
+            if (_disableAllRetries || (retryCount > _maxInitialLoadRetrySingleParam)) {
                 // Give up on this index
                 _failedReadParamIndexMap[componentId] << paramIndex;
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
                 (void) _waitingReadParamIndexMap[componentId].remove(paramIndex);
+                gaveUp = true;
             } else {
-                // Retry again
-                _indexBatchQueue.append(paramIndex);
+                _indexRequestWindow.sent(componentId, paramIndex, retryCount > 1, nowMs);
                 _readParameterRaw(componentId, "", paramIndex);
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
+                requestCount++;
+                qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
             }
         }
+        if (!moreIndices) {
+            break;
+        }
     }
 
-    return (!_indexBatchQueue.isEmpty());
+    if (gaveUp && (requestCount < available)) {
+        // Room was left by the indices given up on
+        return _fillIndexRequestWindow();
+    }
+
+    if (requestCount > 0) {
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Requested by index:" << requestCount << "in flight:" << _indexRequestWindow.inFlight() << "window:" << _indexRequestWindow.window() << "timeout:" << _indexRequestWindow.timeoutMs();
+    }
+
+    _startIndexRequestTimer();
+
+    return (_indexRequestWindow.inFlight() > 0);
+}
+
+void ParameterManager::_startIndexRequestTimer()
+{
+    const qint64 nextExpiryMs = _indexRequestWindow.nextExpiryMs();
+    if (nextExpiryMs < 0) {
+        _indexRequestTimer.stop();
+    } else {
+        _indexRequestTimer.start(static_cast<int>(qMax<qint64>(nextExpiryMs - _requestClock.elapsed(), 1)));
+    }
+}
+
+void ParameterManager::_indexRequestTimeout()
+{
+    if (_logReplay) {
+        return;
+    }
+
+    if (!_indexRequestsActive) {
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Initial parameter stream stopped, requesting missing parameters by index";
+        _indexRequestsActive = true;
+    }
+
+    const QList<RequestWindow::Request> expired = _indexRequestWindow.expire(_requestClock.elapsed());
+    for (const RequestWindow::Request &request: expired) {
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(request.componentId) << "Read request timed out (paramIndex:" << request.index << ")";
+    }
+
+    if (!_fillIndexRequestWindow()) {
+        // The last missing indices may have been given up on
+        _updateProgressBar();
+        _checkInitialLoadComplete();
+    }
 }
 
 void ParameterManager::_waitingParamTimeout()
@@ -639,11 +750,11 @@ void ParameterManager::_waitingParamTimeout()
 
     qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "_waitingParamTimeout";
 
-    // Now that we have timed out for possibly the first time we can activate the index batch queue
-    _indexBatchQueueActive = true;
+    // The initial stream has stopped by now, missing index based params are requested individually
+    _indexRequestsActive = true;
 
     // First check for any missing parameters from the initial index based load
-    bool paramsRequested = _fillIndexBatchQueue(true /* waitingParamTimeout */);
+    bool paramsRequested = _fillIndexRequestWindow();
     if (!paramsRequested && !_waitingForDefaultComponent && !_mapCompId2FactMap.contains(_vehicle->defaultComponentId())) {
         // Initial load is complete but we still don't have any default component params. Wait one more cycle to see if the
         // any show up.
@@ -793,20 +904,47 @@ void ParameterManager::_sendParamSetToVehicle(int componentId, const QString &pa
 
 void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
 {
-    CacheMapName2ParamTypeVal cacheMap;
+    QList<ParameterCache::Param> params;
+    uint32_t crc32_value = 0;
 
-    for (const QString &paramName: _mapCompId2FactMap[componentId].keys()) {
-        const Fact *const fact = _mapCompId2FactMap[componentId][paramName];
-        cacheMap[paramName] = ParamTypeVal(fact->type(), fact->rawValue());
+    // Params with a Fact and params still in the table, the hash is computed in name order
+    const QMap<QString, Fact*> &factMap = _mapCompId2FactMap[componentId];
+    for (auto it = factMap.constBegin(); it != factMap.constEnd(); ++it) {
+        ParameterCache::Param param;
+        param.name = it.key();
+        param.type = it.value()->type();
+        param.value = it.value()->rawValue();
+        params.append(param);
+    }
+    if (_mapCompId2ParamTable.contains(componentId)) {
+        const ParameterTable &paramTable = _mapCompId2ParamTable[componentId];
+        for (int index = 0; index < paramTable.count(); index++) {
+            ParameterCache::Param param;
+            param.name = paramTable.name(index);
+            param.type = paramTable.type(index);
+            param.value = paramTable.value(index);
+            params.append(param);
+        }
+        std::sort(params.begin(), params.end(), [](const ParameterCache::Param &a, const ParameterCache::Param &b) {
+            return (a.name < b.name);
+        });
     }
 
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    if (cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        QDataStream ds(&cacheFile);
-        ds << cacheMap;
-    } else {
-        qCWarning(ParameterManagerLog) << "Failed to open cache file for writing" << cacheFile.fileName();
+    // Volatile params are left out of the hash, the vehicle does the same
+    for (const ParameterCache::Param &param: params) {
+        const QString &name = param.name;
+        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(name, param.type)->volatileValue()) {
+            // Does not take part in CRC
+            qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
+        } else {
+            const QByteArray nameBytes = name.toLatin1();
+            const QByteArray valueBytes = ParameterCache::valueBytes(param.type, param.value);
+            crc32_value = QGC::crc32(reinterpret_cast<const uint8_t *>(nameBytes.constData()), nameBytes.size(), crc32_value);
+            crc32_value = QGC::crc32(reinterpret_cast<const uint8_t *>(valueBytes.constData()), valueBytes.size(), crc32_value);
+        }
     }
+
+    (void) ParameterCache::write(parameterCacheFile(vehicleId, componentId), crc32_value, params);
 }
 
 QDir ParameterManager::parameterCacheDir()
@@ -817,55 +955,27 @@ QDir ParameterManager::parameterCacheDir()
 
 QString ParameterManager::parameterCacheFile(int vehicleId, int componentId)
 {
-    return parameterCacheDir().filePath(QStringLiteral("%1_%2.v2").arg(vehicleId).arg(componentId));
+    return parameterCacheDir().filePath(QStringLiteral("%1_%2.v3").arg(vehicleId).arg(componentId));
 }
 
 void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, const QVariant &hashValue)
 {
     qCInfo(ParameterManagerLog) << "Attemping load from cache";
 
-    /* The datastructure of the cache table */
-    CacheMapName2ParamTypeVal cacheMap;
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    if (!cacheFile.exists()) {
+    ParameterCache cache;
+    if (!cache.open(parameterCacheFile(vehicleId, componentId))) {
         /* no local cache, just wait for them to come in*/
         return;
     }
-    (void) cacheFile.open(QIODevice::ReadOnly);
-
-    /* Deserialize the parameter cache table */
-    QDataStream ds(&cacheFile);
-    ds >> cacheMap;
-
-    /* compute the crc of the local cache to check against the remote */
-    uint32_t crc32_value = 0;
-    for (const QString &name: cacheMap.keys()) {
-        const ParamTypeVal &paramTypeVal = cacheMap[name];
-        const FactMetaData::ValueType_t factType = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
 
-        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(name, factType)->volatileValue()) {
-            // Does not take part in CRC
-            qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
-        } else {
-            const void *const vdat = paramTypeVal.second.constData();
-            const FactMetaData::ValueType_t factType = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            crc32_value = QGC::crc32(reinterpret_cast<const uint8_t *>(qPrintable(name)), name.length(),  crc32_value);
-            crc32_value = QGC::crc32(static_cast<const uint8_t *>(vdat), FactMetaData::typeToSize(factType), crc32_value);
-        }
-    }
+    /* the hash of the cached param set was computed when it was written */
+    const uint32_t crc32_value = cache.hash();
 
     /* if the two param set hashes match, just load from the disk */
     if (crc32_value == hashValue.toUInt()) {
-        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
-
-        const int count = cacheMap.count();
-        int index = 0;
-        for (const QString &name: cacheMap.keys()) {
-            const ParamTypeVal &paramTypeVal = cacheMap[name];
-            const FactMetaData::ValueType_t factType = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            const MAV_PARAM_TYPE mavParamType = factTypeToMavType(factType);
-            _handleParamValue(componentId, name, count, index++, mavParamType, paramTypeVal.second);
-        }
+        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cache.path()).absoluteFilePath());
+
+        _loadCachedParams(componentId, cache);
 
         const SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
         if (sharedLink) {
@@ -909,11 +1019,12 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, const Q
 
         ani->start(QAbstractAnimation::DeleteWhenStopped);
     } else {
-        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
+        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cache.path()).absoluteFilePath());
         if (ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
             _debugCacheCRC[componentId] = true;
-            _debugCacheMap[componentId] = cacheMap;
-            for (const QString &name: cacheMap.keys()) {
+            for (int index = 0; index < cache.count(); index++) {
+                const QString name = cache.name(index);
+                _debugCacheMap[componentId][name] = ParamTypeVal(cache.type(index), cache.value(index));
                 _debugCacheParamSeen[componentId][name] = false;
             }
             qgcApp()->showAppMessage(tr("Parameter cache CRC match failed"));
@@ -921,6 +1032,101 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, const Q
     }
 }
 
+void ParameterManager::_loadCachedParams(int componentId, const ParameterCache &cache)
+{
+    _initialRequestTimeoutTimer.stop();
+
+    if (!_paramCountMap.contains(componentId)) {
+        _paramCountMap[componentId] = cache.count();
+        _totalParamCount += cache.count();
+    }
+
+    // Every index is answered by the cache
+    _waitingReadParamIndexMap[componentId].clear();
+    _indexRequestWindow.cancel(componentId);
+    (void) _waitingReadParamNameMap[componentId];
+    (void) _waitingWriteParamNameMap[componentId];
+
+    // Params which already have a Fact take the cached value, the others go into the table
+    const QMap<QString, Fact*> &factMap = _mapCompId2FactMap[componentId];
+    _mapCompId2ParamTable[componentId].reserve(cache.count());
+    for (int index = 0; index < cache.count(); index++) {
+        const QString paramName = cache.name(index);
+        const QVariant value = cache.value(index);
+        if (factMap.contains(paramName)) {
+            factMap[paramName]->containerSetRawValue(value);
+        } else if (!_setTableParam(componentId, paramName, cache.type(index), value)) {
+            _addFact(componentId, paramName, cache.type(index))->containerSetRawValue(value);
+        }
+    }
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Loaded from cache - paramcount:" << cache.count();
+
+    // The cache was just read, there is nothing new to write back to it
+    _setPrevWaitingParamCounts(_updateWaitingParamTimer());
+
+    _updateProgressBar();
+    _checkInitialLoadComplete();
+}
+
+Fact *ParameterManager::_addFact(int componentId, const QString &paramName, FactMetaData::ValueType_t type)
+{
+    Fact *const fact = new Fact(componentId, paramName, type, this);
+    FactMetaData *const factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(paramName, fact->type());
+    fact->setMetaData(factMetaData);
+
+    _mapCompId2FactMap[componentId][paramName] = fact;
+
+    // We need to know when the fact value changes so we can update the vehicle
+    (void) connect(fact, &Fact::containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
+
+    return fact;
+}
+
+bool ParameterManager::_setTableParam(int componentId, const QString &paramName, FactMetaData::ValueType_t type, const QVariant &value)
+{
+    if (_eagerFacts) {
+        return false;
+    }
+
+    auto it = _mapCompId2ParamTable.find(componentId);
+    if (_initialLoadComplete && ((it == _mapCompId2ParamTable.end()) || (it->indexOf(paramName) < 0))) {
+        return false;
+    }
+
+    if (it == _mapCompId2ParamTable.end()) {
+        it = _mapCompId2ParamTable.insert(componentId, ParameterTable());
+    }
+    if (!it->set(paramName, type, value)) {
+        return false;
+    }
+
+    // The component has params even while none of them has a Fact
+    (void) _mapCompId2FactMap[componentId];
+
+    return true;
+}
+
+Fact *ParameterManager::_createTableFact(int componentId, const QString &paramName)
+{
+    if (!_mapCompId2ParamTable.contains(componentId)) {
+        return nullptr;
+    }
+
+    ParameterTable &paramTable = _mapCompId2ParamTable[componentId];
+    const int index = paramTable.indexOf(paramName);
+    if (index < 0) {
+        return nullptr;
+    }
+
+    // Not signalled through factAdded, the param was already known to exist
+    Fact *const fact = _addFact(componentId, paramName, paramTable.type(index));
+    fact->containerSetRawValue(paramTable.value(index));
+    paramTable.remove(index);
+
+    return fact;
+}
+
 QString ParameterManager::readParametersFromStream(QTextStream &stream)
 {
     QString missingErrors;
@@ -995,10 +1201,17 @@ void ParameterManager::writeParametersToStream(QTextStream &stream) const
     stream << "# Vehicle-Id Component-Id Name Value Type\n";
 
     for (const int componentId: _mapCompId2FactMap.keys()) {
-        for (const QString &paramName: _mapCompId2FactMap[componentId].keys()) {
-            const Fact *const fact = _mapCompId2FactMap[componentId][paramName];
+        // Params without a Fact are written straight from the table, saving doesn't create their Facts
+        const QMap<QString, Fact*> &factMap = _mapCompId2FactMap[componentId];
+        const auto tableIt = _mapCompId2ParamTable.constFind(componentId);
+        for (const QString &paramName: parameterNames(componentId)) {
+            const Fact *const fact = factMap.value(paramName);
+            const int tableIndex = (tableIt != _mapCompId2ParamTable.constEnd()) ? tableIt->indexOf(paramName) : -1;
             if (fact) {
                 stream << _vehicle->id() << "\t" << componentId << "\t" << paramName << "\t" << fact->rawValueStringFullPrecision() << "\t" << QStringLiteral("%1").arg(factTypeToMavType(fact->type())) << "\n";
+            } else if (tableIndex >= 0) {
+                const FactMetaData::ValueType_t type = tableIt->type(tableIndex);
+                stream << _vehicle->id() << "\t" << componentId << "\t" << paramName << "\t" << Fact::variantToString(type, tableIt->value(tableIndex), 18) << "\t" << QStringLiteral("%1").arg(factTypeToMavType(type)) << "\n";
             } else {
                 qCWarning(ParameterManagerLog) << "Internal error: missing fact";
             }
@@ -1476,24 +1689,15 @@ bool ParameterManager::_parseParamFile(const QString& filename)
                                                     (ptype == AP_PARAM_INT32) ? FactMetaData::valueTypeInt32 :
                                                     FactMetaData::valueTypeFloat);
 
-        Fact *fact = nullptr;
         if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(parameterName)) {
-            fact = _mapCompId2FactMap[componentId][parameterName];
-        } else {
+            _mapCompId2FactMap[componentId][parameterName]->containerSetRawValue(parameterValue);
+        } else if (!_setTableParam(componentId, parameterName, factType, parameterValue)) {
             qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << parameterName;
 
-            fact = new Fact(componentId, parameterName, factType, this);
-            FactMetaData *const factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(parameterName, fact->type());
-            fact->setMetaData(factMetaData);
-
-            _mapCompId2FactMap[componentId][parameterName] = fact;
-
-            // We need to know when the fact value changes so we can update the vehicle
-            (void) connect(fact, &Fact::containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
-
+            Fact *const fact = _addFact(componentId, parameterName, factType);
+            fact->containerSetRawValue(parameterValue);
             emit factAdded(componentId, fact);
         }
-        fact->containerSetRawValue(parameterValue);
     }
 Success:
     file.close();
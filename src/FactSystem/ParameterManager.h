@@ -10,6 +10,7 @@
 #pragma once
 
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMap>
 #include <QtCore/QObject>
@@ -20,6 +21,9 @@
 #include "Fact.h"
 #include "FactMetaData.h"
 #include "MAVLinkLib.h"
+#include "ParameterCache.h"
+#include "ParameterTable.h"
+#include "RequestWindow.h"
 
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerLog)
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose1Log)
@@ -39,6 +43,7 @@ class ParameterManager : public QObject
     Q_PROPERTY(double   loadProgress        READ loadProgress       NOTIFY loadProgressChanged)
     Q_PROPERTY(bool     pendingWrites       READ pendingWrites      NOTIFY pendingWritesChanged)        ///< true: There are still pending write updates against the vehicle
     friend class ParameterEditorController;
+    friend class ParameterManagerTest;          // Unit test
 
 public:
     ParameterManager(Vehicle *vehicle);
@@ -122,6 +127,17 @@ private slots:
     void _sendParamSetToVehicle(int componentId, const QString &paramName, FactMetaData::ValueType_t valueType, const QVariant &value) const;
     void _writeLocalParamCache(int vehicleId, int componentId);
     void _tryCacheHashLoad(int vehicleId, int componentId, const QVariant &hashValue);
+    /// Takes all parameters of the component from the cache without creating their Facts
+    void _loadCachedParams(int componentId, const ParameterCache &cache);
+    /// Creates the Fact of a parameter and hooks it up for writes to the vehicle, without a value or factAdded
+    Fact *_addFact(int componentId, const QString &paramName, FactMetaData::ValueType_t type);
+    /// Keeps the value of a parameter without a Fact in the table of its component. New parameters only go
+    /// there during the initial load, later ones are announced through factAdded which needs their Fact.
+    /// @return false if the parameter needs a Fact
+    bool _setTableParam(int componentId, const QString &paramName, FactMetaData::ValueType_t type, const QVariant &value);
+    /// Creates the Fact of a parameter held in the table and takes it out of the table
+    /// @return nullptr if the parameter is not in the table
+    Fact *_createTableFact(int componentId, const QString &paramName);
     void _loadMetaData();
     void _clearMetaData();
     /// Remap a parameter from one firmware version to another
@@ -130,11 +146,24 @@ private slots:
     void _loadOfflineEditingParams();
     QString _logVehiclePrefix(int componentId) const;
     void _setLoadProgress(double loadProgress);
-    /// Requests missing index based parameters from the vehicle.
-    ///     @param waitingParamTimeout: true: being called due to timeout, false: being called to re-fill the batch queue
-    /// return true: Parameters were requested, false: No more requests needed
-    bool _fillIndexBatchQueue(bool waitingParamTimeout);
+    /// Requests missing index based parameters from the vehicle, as many as the request window has room for.
+    /// Components take turns so all of them load at the same time.
+    /// return true: Parameters are being requested, false: No more requests needed
+    bool _fillIndexRequestWindow();
+    /// Called once the initial PARAM_REQUEST_LIST stream stops and whenever index based requests time out
+    void _indexRequestTimeout();
+    void _startIndexRequestTimer();
     void _updateProgressBar();
+    /// Number of parameters still waited for, across all components
+    struct WaitingParamCounts_t {
+        int readIndex = 0;
+        int readName = 0;
+        int writeName = 0;
+    };
+    /// Counts the parameters still waited for and restarts the wait timer while there are any
+    WaitingParamCounts_t _updateWaitingParamTimer();
+    /// Counts seen by the next update, a write to the cache follows once reads drop to zero
+    void _setPrevWaitingParamCounts(const WaitingParamCounts_t &waiting);
     void _checkInitialLoadComplete();
     void _ftpDownloadComplete(const QString &fileName, const QString &errorMsg);
     void _ftpDownloadProgress(float progress);
@@ -147,6 +176,7 @@ private slots:
     Vehicle *_vehicle = nullptr;
 
     QMap<int /* comp id */, QMap<QString /* parameter name */, Fact*>> _mapCompId2FactMap;
+    QMap<int /* comp id */, ParameterTable> _mapCompId2ParamTable;  ///< Parameters without a Fact, which is created on first use
 
     double _loadProgress = 0;                   ///< Parameter load progess, [0.0,1.0]
     bool _parametersReady = false;              ///< true: parameter load complete
@@ -178,9 +208,12 @@ private slots:
     static constexpr int _maxInitialLoadRetrySingleParam = 5;   ///< Maximum retries for initial index based load of a single param
     static constexpr int _maxReadWriteRetry = 5;                ///< Maximum retries read/write
     bool _disableAllRetries = false;                            ///< true: Don't retry any requests (used for testing)
+    static inline bool _eagerFacts = false;                     ///< true: Create every Fact on load instead of using the tables (used for testing)
 
-    bool _indexBatchQueueActive = false;    ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
-    QList<int> _indexBatchQueue;            ///< The current queue of index re-requests
+    bool _indexRequestsActive = false;              ///< true: missing index based params are being requested, false: still waiting on the initial stream
+    RequestWindow _indexRequestWindow;              ///< Index based requests waiting for a response, across all components
+    QElapsedTimer _requestClock;
+    qint64 _requestListSentMs = -1;                 ///< When PARAM_REQUEST_LIST was sent, -1 once the first response came in
 
     QMap<int, int> _paramCountMap;                              ///< Key: Component id, Value: count of parameters in this component
     QMap<int, QMap<int, int>> _waitingReadParamIndexMap;        ///< Key: Component id, Value: Map { Key: parameter index still waiting for, Value: retry count }
@@ -194,6 +227,7 @@ private slots:
 
     QTimer _initialRequestTimeoutTimer;
     QTimer _waitingParamTimeoutTimer;
+    QTimer _indexRequestTimer;      ///< Initial stream stall, then the next index based request timeout
 
     Fact _defaultFact;   ///< Used to return default fact, when parameter not found
 
@@ -0,0 +1,421 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataStore.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(ParameterMetaDataStoreLog, "qgc.factsystem.parametermetadatastore")
+
+namespace {
+    /// Interns strings, id 0 is the empty string
+    class StringTable
+    {
+    public:
+        StringTable() { (void) id(QString()); }
+
+        quint32 id(const QString &string)
+        {
+            const QByteArray bytes = string.toUtf8();
+            const auto it = _ids.constFind(bytes);
+            if (it != _ids.constEnd()) {
+                return it.value();
+            }
+
+            const quint32 newId = static_cast<quint32>(_ids.size());
+            (void) _ids.insert(bytes, newId);
+
+            QByteArray entry(8, '\0');
+            qToLittleEndian<quint32>(static_cast<quint32>(data.size()), entry.data());
+            qToLittleEndian<quint32>(static_cast<quint32>(bytes.size()), entry.data() + 4);
+            table.append(entry);
+            data.append(bytes);
+            return newId;
+        }
+
+        quint32 count() const { return static_cast<quint32>(_ids.size()); }
+
+        QByteArray table;
+        QByteArray data;
+
+    private:
+        QHash<QByteArray, quint32> _ids;
+    };
+}
+
+ParameterMetaDataStore::ParameterMetaDataStore()
+{
+    // qCDebug(ParameterMetaDataStoreLog) << Q_FUNC_INFO << this;
+}
+
+ParameterMetaDataStore::~ParameterMetaDataStore()
+{
+    close();
+
+    // qCDebug(ParameterMetaDataStoreLog) << Q_FUNC_INFO << this;
+}
+
+quint32 ParameterMetaDataStore::_hash(const QByteArray &key, quint32 seed)
+{
+    // FNV-1a with a murmur finalizer, seeds give independent hash functions
+    quint32 hash = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (const char c : key) {
+        hash ^= static_cast<uchar>(c);
+        hash *= 16777619u;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+QByteArray ParameterMetaDataStore::compile(const QList<Entry> &entries)
+{
+    // Later entries replace earlier ones with the same key
+    QList<const Entry*> unique;
+    QHash<QByteArray, qsizetype> keyIndex;
+    QList<QByteArray> keys;
+    for (const Entry &entry : entries) {
+        const QByteArray key = entry.key.toUtf8();
+        const auto it = keyIndex.constFind(key);
+        if (it != keyIndex.constEnd()) {
+            unique[it.value()] = &entry;
+        } else {
+            (void) keyIndex.insert(key, unique.size());
+            unique.append(&entry);
+            keys.append(key);
+        }
+    }
+
+    const quint32 count = static_cast<quint32>(unique.size());
+    const quint32 bucketCount = qMax(1u, count / 4);
+
+    // Hash and displace: the keys of a bucket are placed with the first seed that puts them all in free slots.
+    // Large buckets go first while most slots are free, a bucket of one key takes any free slot directly.
+    QList<QList<quint32>> buckets(bucketCount);
+    for (quint32 i = 0; i < count; i++) {
+        buckets[_hash(keys[i], 0) % bucketCount].append(i);
+    }
+    QList<quint32> bucketOrder(bucketCount);
+    for (quint32 i = 0; i < bucketCount; i++) {
+        bucketOrder[i] = i;
+    }
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&buckets](quint32 a, quint32 b) {
+        return (buckets[a].size() > buckets[b].size());
+    });
+
+    QList<quint32> seeds(bucketCount, 0);
+    QList<qint64> slots(count, -1);         ///< Entry index of each slot
+    quint32 nextFreeSlot = 0;
+    for (const quint32 bucket : bucketOrder) {
+        const QList<quint32> &members = buckets[bucket];
+        if (members.isEmpty()) {
+            break;
+        }
+
+        if (members.size() == 1) {
+            while (slots[nextFreeSlot] >= 0) {
+                nextFreeSlot++;
+            }
+            slots[nextFreeSlot] = members.first();
+            seeds[bucket] = kDirectSlot | nextFreeSlot;
+            continue;
+        }
+
+        for (quint32 seed = 1; ; seed++) {
+            if (seed >= kDirectSlot) {
+                qCWarning(ParameterMetaDataStoreLog) << "No perfect hash found";
+                return QByteArray();
+            }
+
+            QList<quint32> memberSlots;
+            bool placed = true;
+            for (const quint32 member : members) {
+                const quint32 slot = _hash(keys[member], seed) % count;
+                if ((slots[slot] >= 0) || memberSlots.contains(slot)) {
+                    placed = false;
+                    break;
+                }
+                memberSlots.append(slot);
+            }
+            if (placed) {
+                for (qsizetype i = 0; i < members.size(); i++) {
+                    slots[memberSlots[i]] = members[i];
+                }
+                seeds[bucket] = seed;
+                break;
+            }
+        }
+    }
+
+    StringTable strings;
+    QByteArray pairs;
+    QByteArray records(static_cast<qsizetype>(count) * kRecordSize, '\0');
+    quint32 pairCount = 0;
+    const auto appendPairs = [&strings, &pairs, &pairCount](const Pairs &list) {
+        for (const QPair<QString, QString> &pair : list) {
+            QByteArray bytes(8, '\0');
+            qToLittleEndian<quint32>(strings.id(pair.first), bytes.data());
+            qToLittleEndian<quint32>(strings.id(pair.second), bytes.data() + 4);
+            pairs.append(bytes);
+            pairCount++;
+        }
+    };
+
+    for (quint32 slot = 0; slot < count; slot++) {
+        const Entry &entry = *unique[slots[slot]];
+        uchar *record = reinterpret_cast<uchar*>(records.data()) + (static_cast<qsizetype>(slot) * kRecordSize);
+        qToLittleEndian<quint32>(strings.id(entry.key), record);
+        qToLittleEndian<quint32>(strings.id(entry.name), record + 4);
+        for (int field = 0; field < FieldCount; field++) {
+            qToLittleEndian<quint32>(strings.id(entry.fields[field]), record + 8 + (field * 4));
+        }
+        record += 8 + (FieldCount * 4);
+        qToLittleEndian<quint32>(entry.flags, record);
+        qToLittleEndian<quint32>(pairCount, record + 4);
+        qToLittleEndian<quint16>(static_cast<quint16>(qMin<qsizetype>(entry.values.size(), 0xffff)), record + 8);
+        qToLittleEndian<quint16>(static_cast<quint16>(qMin<qsizetype>(entry.bitmask.size(), 0xffff)), record + 10);
+        appendPairs(entry.values.mid(0, 0xffff));
+        appendPairs(entry.bitmask.mid(0, 0xffff));
+    }
+
+    QByteArray seedData(static_cast<qsizetype>(bucketCount) * 4, '\0');
+    for (quint32 i = 0; i < bucketCount; i++) {
+        qToLittleEndian<quint32>(seeds[i], seedData.data() + (i * 4));
+    }
+
+    QByteArray header(kHeaderSize, '\0');
+    (void) memcpy(header.data(), kMagic, sizeof(kMagic));
+    qToLittleEndian<quint32>(kVersion, header.data() + 8);
+    qToLittleEndian<quint32>(count, header.data() + 12);
+    qToLittleEndian<quint32>(bucketCount, header.data() + 16);
+    qToLittleEndian<quint32>(pairCount, header.data() + 20);
+    qToLittleEndian<quint32>(strings.count(), header.data() + 24);
+    qToLittleEndian<quint32>(static_cast<quint32>(strings.data.size()), header.data() + 28);
+
+    qCDebug(ParameterMetaDataStoreLog) << "Compiled params:" << count << "strings:" << strings.count() << "pairs:" << pairCount;
+
+    return (header + seedData + records + pairs + strings.table + strings.data);
+}
+
+bool ParameterMetaDataStore::save(const QString &path, const QByteArray &blob)
+{
+    (void) QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || (file.write(blob) != blob.size()) || !file.commit()) {
+        qCWarning(ParameterMetaDataStoreLog) << "Failed to save" << path << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString ParameterMetaDataStore::compiledPath(const QString &metaDataFile)
+{
+    // Files built into the application change with its version
+    const QFileInfo info(metaDataFile);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    hash.addData(QCoreApplication::applicationVersion().toUtf8());
+    hash.addData(QByteArray::number(kVersion));
+
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/QGCParamMetaDataCache");
+    return QStringLiteral("%1/%2.%3.bin").arg(cacheDir, info.completeBaseName(), QString::fromLatin1(hash.result().toHex().left(16)));
+}
+
+bool ParameterMetaDataStore::open(const QString &path)
+{
+    close();
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = _file.size();
+    const uchar *const data = (size > 0) ? _file.map(0, size) : nullptr;
+    if (!data || !_attach(data, size)) {
+        qCWarning(ParameterMetaDataStoreLog) << "Not a compiled meta data file" << path;
+        close();
+        return false;
+    }
+
+    qCDebug(ParameterMetaDataStoreLog) << "Opened" << path << "params:" << _count;
+    return true;
+}
+
+bool ParameterMetaDataStore::load(const QByteArray &blob)
+{
+    close();
+
+    _blob = blob;
+    if (!_attach(reinterpret_cast<const uchar*>(_blob.constData()), _blob.size())) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool ParameterMetaDataStore::_attach(const uchar *data, qint64 size)
+{
+    if ((size < kHeaderSize) || (memcmp(data, kMagic, sizeof(kMagic)) != 0) || (qFromLittleEndian<quint32>(data + 8) != kVersion)) {
+        return false;
+    }
+
+    _count = qFromLittleEndian<quint32>(data + 12);
+    _bucketCount = qFromLittleEndian<quint32>(data + 16);
+    _pairCount = qFromLittleEndian<quint32>(data + 20);
+    _stringCount = qFromLittleEndian<quint32>(data + 24);
+    _stringDataSize = qFromLittleEndian<quint32>(data + 28);
+
+    const qint64 seedsStart = kHeaderSize;
+    const qint64 recordsStart = seedsStart + (static_cast<qint64>(_bucketCount) * 4);
+    const qint64 pairsStart = recordsStart + (static_cast<qint64>(_count) * kRecordSize);
+    const qint64 stringsStart = pairsStart + (static_cast<qint64>(_pairCount) * 8);
+    const qint64 stringDataStart = stringsStart + (static_cast<qint64>(_stringCount) * 8);
+    if ((_bucketCount == 0) || ((stringDataStart + _stringDataSize) != size)) {
+        return false;
+    }
+
+    _data = data;
+    _size = size;
+    _seeds = data + seedsStart;
+    _records = data + recordsStart;
+    _pairs = data + pairsStart;
+    _strings = data + stringsStart;
+    _stringData = data + stringDataStart;
+    return true;
+}
+
+void ParameterMetaDataStore::close()
+{
+    if (_data && _file.isOpen()) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+    }
+    _file.close();
+    _blob.clear();
+
+    _data = nullptr;
+    _size = 0;
+    _count = 0;
+    _bucketCount = 0;
+    _pairCount = 0;
+    _stringCount = 0;
+    _stringDataSize = 0;
+    _seeds = nullptr;
+    _records = nullptr;
+    _pairs = nullptr;
+    _strings = nullptr;
+    _stringData = nullptr;
+}
+
+const uchar *ParameterMetaDataStore::_record(int index) const
+{
+    return (_records + (static_cast<qsizetype>(index) * kRecordSize));
+}
+
+QByteArray ParameterMetaDataStore::_bytes(quint32 id) const
+{
+    if (id >= _stringCount) {
+        return QByteArray();
+    }
+
+    const quint32 offset = qFromLittleEndian<quint32>(_strings + (static_cast<qsizetype>(id) * 8));
+    const quint32 length = qFromLittleEndian<quint32>(_strings + (static_cast<qsizetype>(id) * 8) + 4);
+    if ((static_cast<quint64>(offset) + length) > _stringDataSize) {
+        return QByteArray();
+    }
+
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(_stringData + offset), length);
+}
+
+int ParameterMetaDataStore::indexOf(const QString &key) const
+{
+    if (_count == 0) {
+        return -1;
+    }
+
+    const QByteArray keyBytes = key.toUtf8();
+    const quint32 seed = qFromLittleEndian<quint32>(_seeds + ((_hash(keyBytes, 0) % _bucketCount) * 4));
+    const quint32 slot = (seed & kDirectSlot) ? (seed & ~kDirectSlot) : (_hash(keyBytes, seed) % _count);
+    if (slot >= _count) {
+        return -1;
+    }
+
+    // Keys which are not in the store still land on some slot
+    if (_bytes(qFromLittleEndian<quint32>(_record(static_cast<int>(slot)))) != keyBytes) {
+        return -1;
+    }
+
+    return static_cast<int>(slot);
+}
+
+QString ParameterMetaDataStore::key(int index) const
+{
+    if ((index < 0) || (index >= count())) {
+        return QString();
+    }
+
+    return _string(qFromLittleEndian<quint32>(_record(index)));
+}
+
+ParameterMetaDataStore::Entry ParameterMetaDataStore::entry(int index) const
+{
+    Entry entry;
+    if ((index < 0) || (index >= count())) {
+        return entry;
+    }
+
+    const uchar *record = _record(index);
+    entry.key = _string(qFromLittleEndian<quint32>(record));
+    entry.name = _string(qFromLittleEndian<quint32>(record + 4));
+    for (int field = 0; field < FieldCount; field++) {
+        entry.fields[field] = _string(qFromLittleEndian<quint32>(record + 8 + (field * 4)));
+    }
+    record += 8 + (FieldCount * 4);
+    entry.flags = qFromLittleEndian<quint32>(record);
+
+    const quint32 firstPair = qFromLittleEndian<quint32>(record + 4);
+    const quint16 valueCount = qFromLittleEndian<quint16>(record + 8);
+    const quint16 bitCount = qFromLittleEndian<quint16>(record + 10);
+    if ((static_cast<quint64>(firstPair) + valueCount + bitCount) > _pairCount) {
+        return entry;
+    }
+
+    const auto readPair = [this](quint32 pair) {
+        const uchar *const data = _pairs + (static_cast<qsizetype>(pair) * 8);
+        return qMakePair(_string(qFromLittleEndian<quint32>(data)), _string(qFromLittleEndian<quint32>(data + 4)));
+    };
+    for (quint32 i = 0; i < valueCount; i++) {
+        entry.values.append(readPair(firstPair + i));
+    }
+    for (quint32 i = 0; i < bitCount; i++) {
+        entry.bitmask.append(readPair(firstPair + valueCount + i));
+    }
+
+    return entry;
+}
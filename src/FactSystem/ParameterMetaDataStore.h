@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+
+#include <array>
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterMetaDataStoreLog)
+
+/// Parameter meta data of a firmware compiled from its XML meta data file into a binary blob.
+/// The blob is compiled the first time a meta data file is used and memory mapped from then on.
+/// Strings are stored once, parameters are found through a perfect hash of their key and the
+/// text of a parameter's fields is only read when the firmware plugin builds its FactMetaData.
+class ParameterMetaDataStore
+{
+public:
+    /// Fields are kept as the text found in the meta data file, each firmware plugin converts them
+    enum Field {
+        FieldType,
+        FieldCategory,
+        FieldGroup,
+        FieldShortDescription,
+        FieldLongDescription,
+        FieldMin,
+        FieldMax,
+        FieldDefault,
+        FieldIncrement,
+        FieldUnits,
+        FieldDecimalPlaces,
+        FieldCount
+    };
+
+    enum Flag : quint32 {
+        FlagRebootRequired  = 1 << 0,
+        FlagReadOnly        = 1 << 1,
+        FlagVolatile        = 1 << 2,
+        FlagBoolean         = 1 << 3,
+    };
+
+    using Pairs = QList<QPair<QString, QString>>;
+
+    struct Entry {
+        QString key;                                ///< Unique, firmwares with several parameter sets qualify the name
+        QString name;
+        std::array<QString, FieldCount> fields;
+        quint32 flags = 0;
+        Pairs values;                               ///< Enum value, description
+        Pairs bitmask;                              ///< Bit, description
+    };
+
+    ParameterMetaDataStore();
+    ~ParameterMetaDataStore();
+
+    /// Entries with the same key replace the earlier ones
+    static QByteArray compile(const QList<Entry> &entries);
+    static bool save(const QString &path, const QByteArray &blob);
+
+    /// Location of the compiled blob of a meta data file, changes whenever the meta data file does
+    static QString compiledPath(const QString &metaDataFile);
+
+    /// Memory maps a compiled blob
+    /// @return false if the file is missing or not a compiled blob
+    bool open(const QString &path);
+    /// Uses a blob held in memory, for when it could not be saved
+    bool load(const QByteArray &blob);
+    void close();
+    bool isOpen() const { return (_data != nullptr); }
+
+    int count() const { return static_cast<int>(_count); }
+    /// @return -1 if there is no entry for the key
+    int indexOf(const QString &key) const;
+    QString key(int index) const;
+    Entry entry(int index) const;
+
+private:
+    bool _attach(const uchar *data, qint64 size);
+    const uchar *_record(int index) const;
+    QByteArray _bytes(quint32 id) const;
+    QString _string(quint32 id) const { return QString::fromUtf8(_bytes(id)); }
+
+    static quint32 _hash(const QByteArray &key, quint32 seed);
+
+    QFile _file;
+    QByteArray _blob;
+    const uchar *_data = nullptr;
+    qint64 _size = 0;
+
+    quint32 _count = 0;
+    quint32 _bucketCount = 0;
+    quint32 _pairCount = 0;
+    quint32 _stringCount = 0;
+    quint32 _stringDataSize = 0;
+    const uchar *_seeds = nullptr;
+    const uchar *_records = nullptr;
+    const uchar *_pairs = nullptr;
+    const uchar *_strings = nullptr;
+    const uchar *_stringData = nullptr;
+
+    static constexpr char kMagic[8] = { 'Q', 'G', 'C', 'P', 'M', 'E', 'T', 'A' };
+    static constexpr quint32 kVersion = 1;
+    static constexpr qsizetype kHeaderSize = 32;
+    static constexpr qsizetype kRecordSize = (4 * (2 + FieldCount)) + 12;  ///< Key, name, fields, flags, first pair, value and bit counts
+    static constexpr quint32 kDirectSlot = 0x80000000;                    ///< Seed of a bucket holding one key, the low bits are its slot
+};
@@ -0,0 +1,190 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterTable.h"
+#include "ParameterCache.h"
+#include "QGCLoggingCategory.h"
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(ParameterTableLog, "qgc.factsystem.parametertable")
+
+ParameterTable::ParameterTable()
+{
+    // qCDebug(ParameterTableLog) << Q_FUNC_INFO << this;
+}
+
+ParameterTable::~ParameterTable()
+{
+    // qCDebug(ParameterTableLog) << Q_FUNC_INFO << this;
+}
+
+void ParameterTable::reserve(int count)
+{
+    _names.reserve(static_cast<qsizetype>(count) * kNameSize);
+    _types.reserve(count);
+    _values.reserve(static_cast<qsizetype>(count) * kValueSize);
+}
+
+void ParameterTable::clear()
+{
+    _names.clear();
+    _types.clear();
+    _values.clear();
+}
+
+bool ParameterTable::_validName(const QString &name)
+{
+    if (name.isEmpty() || (name.size() > kNameSize)) {
+        return false;
+    }
+
+    for (const QChar character: name) {
+        if ((character.unicode() == 0) || (character.unicode() > 0xff)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int ParameterTable::_compare(QByteArrayView a, QByteArrayView b)
+{
+    const qsizetype common = qMin(a.size(), b.size());
+    const int comparison = (common > 0) ? memcmp(a.data(), b.data(), static_cast<size_t>(common)) : 0;
+    if (comparison != 0) {
+        return comparison;
+    }
+
+    return static_cast<int>(a.size() - b.size());
+}
+
+QByteArrayView ParameterTable::_name(int index) const
+{
+    const char *const slot = _names.constData() + (static_cast<qsizetype>(index) * kNameSize);
+    return QByteArrayView(slot, static_cast<qsizetype>(qstrnlen(slot, kNameSize)));
+}
+
+int ParameterTable::_lowerBound(QByteArrayView name) const
+{
+    int first = 0;
+    int last = count();
+    while (first < last) {
+        const int middle = first + ((last - first) / 2);
+        if (_compare(_name(middle), name) < 0) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+int ParameterTable::indexOf(const QString &name) const
+{
+    if (!_validName(name)) {
+        return -1;
+    }
+
+    const QByteArray latin1 = name.toLatin1();
+    const int index = _lowerBound(latin1);
+    if ((index < count()) && (_compare(_name(index), latin1) == 0)) {
+        return index;
+    }
+
+    return -1;
+}
+
+QString ParameterTable::name(int index) const
+{
+    if ((index < 0) || (index >= count())) {
+        return QString();
+    }
+
+    return QString::fromLatin1(_name(index));
+}
+
+FactMetaData::ValueType_t ParameterTable::type(int index) const
+{
+    if ((index < 0) || (index >= count())) {
+        return FactMetaData::valueTypeInt32;
+    }
+
+    return static_cast<FactMetaData::ValueType_t>(static_cast<quint8>(_types[index]));
+}
+
+QVariant ParameterTable::value(int index) const
+{
+    if ((index < 0) || (index >= count())) {
+        return QVariant();
+    }
+
+    return ParameterCache::valueFromBytes(type(index), reinterpret_cast<const uchar*>(_values.constData()) + (static_cast<qsizetype>(index) * kValueSize));
+}
+
+QStringList ParameterTable::names() const
+{
+    QStringList names;
+    names.reserve(count());
+    for (int index = 0; index < count(); index++) {
+        names.append(QString::fromLatin1(_name(index)));
+    }
+
+    return names;
+}
+
+bool ParameterTable::set(const QString &name, FactMetaData::ValueType_t type, const QVariant &value)
+{
+    if (!_validName(name)) {
+        return false;
+    }
+
+    const QByteArray valueBytes = ParameterCache::valueBytes(type, value);
+    if (valueBytes.isEmpty()) {
+        return false;
+    }
+
+    // Kept in name order for the binary search. Parameters stream in index order, which has nothing to do with
+    // name order, so an insert moves half of the arrays on average. Over a full load of a couple of thousand
+    // params that is still well under a millisecond, spread across the whole download.
+    const QByteArray latin1 = name.toLatin1();
+    const int index = _lowerBound(latin1);
+    if ((index >= count()) || (_compare(_name(index), latin1) != 0)) {
+        QByteArray nameSlot(kNameSize, '\0');
+        (void) memcpy(nameSlot.data(), latin1.constData(), static_cast<size_t>(latin1.size()));
+        (void) _names.insert(static_cast<qsizetype>(index) * kNameSize, nameSlot);
+        (void) _types.insert(index, static_cast<char>(type));
+        (void) _values.insert(static_cast<qsizetype>(index) * kValueSize, kValueSize, '\0');
+    } else {
+        _types[index] = static_cast<char>(type);
+    }
+
+    char *const valueSlot = _values.data() + (static_cast<qsizetype>(index) * kValueSize);
+    (void) memset(valueSlot, 0, kValueSize);
+    (void) memcpy(valueSlot, valueBytes.constData(), static_cast<size_t>(valueBytes.size()));
+
+    return true;
+}
+
+void ParameterTable::remove(int index)
+{
+    if ((index < 0) || (index >= count())) {
+        return;
+    }
+
+    (void) _names.remove(static_cast<qsizetype>(index) * kNameSize, kNameSize);
+    (void) _types.remove(index, 1);
+    (void) _values.remove(static_cast<qsizetype>(index) * kValueSize, kValueSize);
+}
+
+qsizetype ParameterTable::memoryUsage() const
+{
+    return (_names.capacity() + _types.capacity() + _values.capacity());
+}
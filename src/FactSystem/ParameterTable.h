@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+#include "FactMetaData.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterTableLog)
+
+/// Values of the parameters of one component which don't have a Fact yet. Stored as a struct of
+/// arrays in name order: a fixed size name slot, a type byte and an 8 byte value per parameter, so
+/// a parameter takes 25 bytes instead of a Fact QObject with its QVariant, name and connections.
+class ParameterTable
+{
+public:
+    ParameterTable();
+    ~ParameterTable();
+
+    int count() const { return static_cast<int>(_types.size()); }
+    bool isEmpty() const { return _types.isEmpty(); }
+    void reserve(int count);
+    void clear();
+
+    /// @return -1 if the parameter is not in the table
+    int indexOf(const QString &name) const;
+    QString name(int index) const;
+    FactMetaData::ValueType_t type(int index) const;
+    /// Same variant types as parameters decoded from PARAM_VALUE
+    QVariant value(int index) const;
+    /// All names in name order
+    QStringList names() const;
+
+    /// Adds the parameter or replaces its type and value
+    /// @return false if the name is too long or the type has no fixed size, such a parameter needs a Fact right away
+    bool set(const QString &name, FactMetaData::ValueType_t type, const QVariant &value);
+    void remove(int index);
+
+    /// Bytes allocated by the table
+    qsizetype memoryUsage() const;
+
+    static constexpr int kNameSize = 16;    ///< Length of a MAVLink param_id
+    static constexpr int kValueSize = 8;
+
+private:
+    QByteArrayView _name(int index) const;
+    /// Index of the first name which is not less than name
+    int _lowerBound(QByteArrayView name) const;
+
+    /// Param ids are latin1 and at most kNameSize long
+    static bool _validName(const QString &name);
+    static int _compare(QByteArrayView a, QByteArrayView b);
+
+    QByteArray _names;      ///< kNameSize bytes per parameter, zero padded
+    QByteArray _types;      ///< FactMetaData::ValueType_t per parameter
+    QByteArray _values;     ///< kValueSize bytes per parameter, as written by ParameterCache::valueBytes
+};
@@ -619,6 +619,20 @@ QString APMFirmwarePlugin::missionCommandOverrides(QGCMAVLink::VehicleClass_t ve
     }
 }
 
+QString APMFirmwarePlugin::missionFtpPath(MAV_MISSION_TYPE planType) const
+{
+    switch (planType) {
+    case MAV_MISSION_TYPE_MISSION:
+        return QStringLiteral("@MISSION/mission.dat");
+    case MAV_MISSION_TYPE_FENCE:
+        return QStringLiteral("@MISSION/fence.dat");
+    case MAV_MISSION_TYPE_RALLY:
+        return QStringLiteral("@MISSION/rally.dat");
+    default:
+        return QString();
+    }
+}
+
 QObject *APMFirmwarePlugin::_loadParameterMetaData(const QString &metaDataFile)
 {
     Q_UNUSED(metaDataFile);
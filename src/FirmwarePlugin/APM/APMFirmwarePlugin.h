@@ -63,6 +63,8 @@ class APMFirmwarePlugin : public FirmwarePlugin
     virtual void initializeStreamRates(Vehicle *vehicle);
     void initializeVehicle(Vehicle *vehicle) override;
     bool sendHomePositionToVehicle() const override { return true; }
+    bool supportsPipelinedMissionRead() const override { return true; }
+    QString missionFtpPath(MAV_MISSION_TYPE planType) const override;
     QString missionCommandOverrides(QGCMAVLink::VehicleClass_t vehicleClass) const override;
     QString _internalParameterMetaDataFile(const Vehicle* vehicle) const override;
     FactMetaData *_getMetaDataForFact(QObject *parameterMetaData, const QString &name, FactMetaData::ValueType_t type, MAV_TYPE vehicleType) const override;
@@ -86,6 +86,11 @@ QString APMParameterMetaData::_groupFromParameterName(const QString &name)
     return group.remove(regex); // remove any numbers from the end
 }
 
+QString APMParameterMetaData::_storeKey(const QString &category, const QString &name)
+{
+    return (category + QLatin1Char('/') + name);
+}
+
 void APMParameterMetaData::loadParameterFactMetaDataFile(const QString &metaDataFile)
 {
     if (_parameterMetaDataLoaded) {
@@ -93,6 +98,54 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString &metaData
     }
     _parameterMetaDataLoaded = true;
 
+    const QString compiledPath = ParameterMetaDataStore::compiledPath(metaDataFile);
+    if (_store.open(compiledPath)) {
+        qCDebug(APMParameterMetaDataLog) << "Loaded compiled parameter meta data:" << compiledPath;
+        return;
+    }
+
+    _parseParameterFactMetaDataFile(metaDataFile);
+    _compile(compiledPath);
+}
+
+void APMParameterMetaData::_compile(const QString &compiledPath)
+{
+    QList<ParameterMetaDataStore::Entry> entries;
+    for (auto category = _vehicleTypeToParametersMap.constBegin(); category != _vehicleTypeToParametersMap.constEnd(); ++category) {
+        for (const APMFactMetaDataRaw *const rawMetaData : category.value()) {
+            ParameterMetaDataStore::Entry entry;
+            entry.key = _storeKey(category.key(), rawMetaData->name);
+            entry.name = rawMetaData->name;
+            entry.fields[ParameterMetaDataStore::FieldCategory] = rawMetaData->category;
+            entry.fields[ParameterMetaDataStore::FieldGroup] = rawMetaData->group;
+            entry.fields[ParameterMetaDataStore::FieldShortDescription] = rawMetaData->shortDescription;
+            entry.fields[ParameterMetaDataStore::FieldLongDescription] = rawMetaData->longDescription;
+            entry.fields[ParameterMetaDataStore::FieldMin] = rawMetaData->min;
+            entry.fields[ParameterMetaDataStore::FieldMax] = rawMetaData->max;
+            entry.fields[ParameterMetaDataStore::FieldIncrement] = rawMetaData->incrementSize;
+            entry.fields[ParameterMetaDataStore::FieldUnits] = rawMetaData->units;
+            if (rawMetaData->rebootRequired) {
+                entry.flags |= ParameterMetaDataStore::FlagRebootRequired;
+            }
+            if (rawMetaData->readOnly) {
+                entry.flags |= ParameterMetaDataStore::FlagReadOnly;
+            }
+            entry.values = rawMetaData->values;
+            entry.bitmask = rawMetaData->bitmask;
+            entries.append(entry);
+        }
+        qDeleteAll(category.value());
+    }
+    _vehicleTypeToParametersMap.clear();
+
+    const QByteArray blob = ParameterMetaDataStore::compile(entries);
+    if (!ParameterMetaDataStore::save(compiledPath, blob) || !_store.open(compiledPath)) {
+        (void) _store.load(blob);
+    }
+}
+
+void APMParameterMetaData::_parseParameterFactMetaDataFile(const QString &metaDataFile)
+{
     qCDebug(APMParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
 
     QFile xmlFile(metaDataFile);
@@ -423,16 +476,15 @@ FactMetaData *APMParameterMetaData::getMetaDataForFact(const QString &name, MAV_
 {
     bool keepTrying = true;
     QString mavTypeString = _mavTypeToString(vehicleType);
-    APMFactMetaDataRaw *rawMetaData = nullptr;
+    int index = -1;
 
     // check if we have metadata for fact, use generic otherwise
     while (keepTrying) {
-        if (_vehicleTypeToParametersMap[mavTypeString].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap[mavTypeString][name];
-        } else if (_vehicleTypeToParametersMap["libraries"].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap["libraries"][name];
+        index = _store.indexOf(_storeKey(mavTypeString, name));
+        if (index < 0) {
+            index = _store.indexOf(_storeKey(QStringLiteral("libraries"), name));
         }
-        if (!rawMetaData && (mavTypeString == "Rover")) {
+        if ((index < 0) && (mavTypeString == "Rover")) {
             // Hack city: Older versions of Rover have different name
             mavTypeString = "APMrover2";
         } else {
@@ -443,67 +495,76 @@ FactMetaData *APMParameterMetaData::getMetaDataForFact(const QString &name, MAV_
     FactMetaData *const metaData = new FactMetaData(type, this);
 
     // we don't have data for this fact
-    if (!rawMetaData) {
+    if (index < 0) {
         metaData->setCategory(QStringLiteral("Advanced"));
         metaData->setGroup(_groupFromParameterName(name));
         qCDebug(APMParameterMetaDataLog) << "No metaData for" << name << "using generic metadata";
         return metaData;
     }
 
-    metaData->setName(rawMetaData->name);
-    if (!rawMetaData->category.isEmpty()) {
-        metaData->setCategory(rawMetaData->category);
+    const ParameterMetaDataStore::Entry rawMetaData = _store.entry(index);
+    const QString &category = rawMetaData.fields[ParameterMetaDataStore::FieldCategory];
+    const QString &shortDescription = rawMetaData.fields[ParameterMetaDataStore::FieldShortDescription];
+    const QString &longDescription = rawMetaData.fields[ParameterMetaDataStore::FieldLongDescription];
+    const QString &units = rawMetaData.fields[ParameterMetaDataStore::FieldUnits];
+    const QString &min = rawMetaData.fields[ParameterMetaDataStore::FieldMin];
+    const QString &max = rawMetaData.fields[ParameterMetaDataStore::FieldMax];
+    const QString &incrementSize = rawMetaData.fields[ParameterMetaDataStore::FieldIncrement];
+
+    metaData->setName(rawMetaData.name);
+    if (!category.isEmpty()) {
+        metaData->setCategory(category);
     }
-    metaData->setGroup(rawMetaData->group);
-    metaData->setVehicleRebootRequired(rawMetaData->rebootRequired);
-    metaData->setReadOnly(rawMetaData->readOnly);
+    metaData->setGroup(rawMetaData.fields[ParameterMetaDataStore::FieldGroup]);
+    metaData->setVehicleRebootRequired(rawMetaData.flags & ParameterMetaDataStore::FlagRebootRequired);
+    metaData->setReadOnly(rawMetaData.flags & ParameterMetaDataStore::FlagReadOnly);
 
-    if (!rawMetaData->shortDescription.isEmpty()) {
-        metaData->setShortDescription(rawMetaData->shortDescription);
+    if (!shortDescription.isEmpty()) {
+        metaData->setShortDescription(shortDescription);
     }
 
-    if (!rawMetaData->longDescription.isEmpty()) {
-        metaData->setLongDescription(rawMetaData->longDescription);
+    if (!longDescription.isEmpty()) {
+        metaData->setLongDescription(longDescription);
     }
 
-    if (!rawMetaData->units.isEmpty()) {
-        metaData->setRawUnits(rawMetaData->units);
+    if (!units.isEmpty()) {
+        metaData->setRawUnits(units);
     }
 
-    if (!rawMetaData->min.isEmpty()) {
+    if (!min.isEmpty()) {
         QVariant varMin;
         QString errorString;
-        if (metaData->convertAndValidateRaw(rawMetaData->min, false /* validate as well */, varMin, errorString)) {
+        if (metaData->convertAndValidateRaw(min, false /* validate as well */, varMin, errorString)) {
             metaData->setRawMin(varMin);
         } else {
             qCDebug(APMParameterMetaDataLog) << "Invalid min value, name:" << metaData->name()
                                              << "type:" << metaData->type()
-                                             << "min:" << rawMetaData->min
+                                             << "min:" << min
                                              << "error:" << errorString;
         }
     }
 
-    if (!rawMetaData->max.isEmpty()) {
+    if (!max.isEmpty()) {
         QVariant varMax;
         QString errorString;
-        if (metaData->convertAndValidateRaw(rawMetaData->max, false /* validate as well */, varMax, errorString)) {
+        if (metaData->convertAndValidateRaw(max, false /* validate as well */, varMax, errorString)) {
             metaData->setRawMax(varMax);
         } else {
             qCDebug(APMParameterMetaDataLog) << "Invalid max value, name:" << metaData->name()
                                              << "type:" << metaData->type()
-                                             << "max:" << rawMetaData->max
+                                             << "max:" << max
                                              << "error:" << errorString;
         }
     }
 
-    if (!rawMetaData->values.isEmpty()) {
+    if (!rawMetaData.values.isEmpty()) {
         QStringList enumStrings;
         QVariantList enumValues;
 
-        for (int i = 0; i < rawMetaData->values.count(); i++) {
+        for (int i = 0; i < rawMetaData.values.count(); i++) {
             QVariant enumValue;
             QString errorString;
-            const QPair<QString, QString> enumPair = rawMetaData->values[i];
+            const QPair<QString, QString> enumPair = rawMetaData.values[i];
 
             if (metaData->convertAndValidateRaw(enumPair.first, false /* validate */, enumValue, errorString)) {
                 enumValues << enumValue;
@@ -524,13 +585,13 @@ FactMetaData *APMParameterMetaData::getMetaDataForFact(const QString &name, MAV_
         }
     }
 
-    if (!rawMetaData->bitmask.isEmpty()) {
+    if (!rawMetaData.bitmask.isEmpty()) {
         QStringList bitmaskStrings;
         QVariantList bitmaskValues;
 
-        for (int i = 0; i < rawMetaData->bitmask.count(); i++) {
+        for (int i = 0; i < rawMetaData.bitmask.count(); i++) {
             QString errorString;
-            const QPair<QString, QString> bitmaskPair = rawMetaData->bitmask[i];
+            const QPair<QString, QString> bitmaskPair = rawMetaData.bitmask[i];
 
             bool ok = false;
             const unsigned int bitIndex = bitmaskPair.first.toUInt(&ok);
@@ -602,13 +663,13 @@ FactMetaData *APMParameterMetaData::getMetaDataForFact(const QString &name, MAV_
         }
     }
 
-    if (!rawMetaData->incrementSize.isEmpty()) {
+    if (!incrementSize.isEmpty()) {
         bool ok;
-        const double increment = rawMetaData->incrementSize.toDouble(&ok);
+        const double increment = incrementSize.toDouble(&ok);
         if (ok) {
             metaData->setRawIncrement(increment);
         } else {
-            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << "increment:" << rawMetaData->incrementSize;
+            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << "increment:" << incrementSize;
         }
     }
 
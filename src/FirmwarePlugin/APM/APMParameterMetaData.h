@@ -17,6 +17,7 @@
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "ParameterMetaDataStore.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataLog)
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataVerboseLog)
@@ -40,7 +41,7 @@ class APMFactMetaDataRaw : public QObject
     QString incrementSize;
     QString units;
     bool rebootRequired = false;
-    bool readOnly;
+    bool readOnly = false;
     QList<QPair<QString, QString>> values;
     QList<QPair<QString, QString>> bitmask;
 };
@@ -76,6 +77,10 @@ class APMParameterMetaData : public QObject
         Done
     };
 
+    void _parseParameterFactMetaDataFile(const QString &metaDataFile);
+    /// Moves the parsed meta data into the store and saves it for the next load
+    void _compile(const QString &compiledPath);
+    static QString _storeKey(const QString &category, const QString &name);
     static bool _skipXMLBlock(QXmlStreamReader &xml, const QString &blockName);
     bool _parseParameterAttributes(QXmlStreamReader &xml, APMFactMetaDataRaw *rawMetaData);
     static void _correctGroupMemberships(ParameterNametoFactMetaDataMap &parameterToFactMetaDataMap, QMap<QString,QStringList> &groupMembers);
@@ -84,5 +89,6 @@ class APMParameterMetaData : public QObject
 
     bool _parameterMetaDataLoaded = false; ///< true: parameter meta data already loaded
     // FIXME: metadata is vehicle type specific now
-    QMap<QString, ParameterNametoFactMetaDataMap> _vehicleTypeToParametersMap; ///< Maps from a vehicle type to paramametertoFactMeta map>
+    QMap<QString, ParameterNametoFactMetaDataMap> _vehicleTypeToParametersMap; ///< Maps from a vehicle type to paramametertoFactMeta map>, only used while parsing
+    ParameterMetaDataStore _store; ///< Keyed by vehicle type and parameter name
 };
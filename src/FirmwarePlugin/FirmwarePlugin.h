@@ -286,6 +286,14 @@ class FirmwarePlugin : public QObject
     ///     false: Do not send first item to vehicle, sequence numbers must be adjusted
     virtual bool sendHomePositionToVehicle() const { return false; }
 
+    /// Mission items may be requested out of order with several MISSION_REQUEST_INT in flight. The mavlink spec
+    /// only requires items to be requested in sequence so this must be supported by the firmware.
+    virtual bool supportsPipelinedMissionRead() const { return false; }
+
+    /// @return Path of the MAVLink FTP file holding the items of the plan type, empty if the firmware has none.
+    ///         The file is expected in the ArduPilot mission file format.
+    virtual QString missionFtpPath(MAV_MISSION_TYPE /*planType*/) const { return QString(); }
+
     /// Returns the parameter set version info pulled from inside the meta data file. -1 if not found.
     /// Note: The implementation for this must not vary by vehicle type.
     /// Important: Only CompInfoParam code should use this method
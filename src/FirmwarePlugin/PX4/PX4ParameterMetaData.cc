@@ -17,6 +17,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 #include <QtCore/QDebug>
+#include <QtCore/QSet>
 #include <QtCore/QXmlStreamReader>
 
 QGC_LOGGING_CATEGORY(PX4ParameterMetaDataLog, "PX4ParameterMetaDataLog")
@@ -86,32 +87,54 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     }
     _parameterMetaDataLoaded = true;
 
+    const QString compiledPath = ParameterMetaDataStore::compiledPath(metaDataFile);
+    if (_store.open(compiledPath)) {
+        qCDebug(PX4ParameterMetaDataLog) << "Loaded compiled parameter meta data:" << compiledPath;
+    } else {
+        QList<ParameterMetaDataStore::Entry> entries;
+        if (!_parseParameterFactMetaDataFile(metaDataFile, entries)) {
+            return;
+        }
+
+        const QByteArray blob = ParameterMetaDataStore::compile(entries);
+        if (!ParameterMetaDataStore::save(compiledPath, blob) || !_store.open(compiledPath)) {
+            (void) _store.load(blob);
+        }
+    }
+
+#ifdef GENERATE_PARAMETER_JSON
+    _generateParameterJson();
+#endif
+}
+
+bool PX4ParameterMetaData::_parseParameterFactMetaDataFile(const QString& metaDataFile, QList<ParameterMetaDataStore::Entry>& entries)
+{
     qCDebug(PX4ParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
 
     QFile xmlFile(metaDataFile);
 
     if (!xmlFile.exists()) {
         qWarning() << "Internal error: metaDataFile mission" << metaDataFile;
-        return;
+        return false;
     }
     
     if (!xmlFile.open(QIODevice::ReadOnly)) {
         qWarning() << "Internal error: Unable to open parameter file:" << metaDataFile << xmlFile.errorString();
-        return;
+        return false;
     }
     
     QXmlStreamReader xml(xmlFile.readAll());
     xmlFile.close();
     if (xml.hasError()) {
         qWarning() << "Badly formed XML" << xml.errorString();
-        return;
+        return true;
     }
     
-    QString         factGroup;
-    QString         errorString;
-    FactMetaData*   metaData = nullptr;
-    int             xmlState = XmlStateNone;
-    bool            badMetaData = true;
+    QString                         factGroup;
+    QSet<QString>                   names;
+    ParameterMetaDataStore::Entry*  metaData = nullptr;
+    int                             xmlState = XmlStateNone;
+    bool                            badMetaData = true;
     
     while (!xml.atEnd()) {
         if (xml.isStartElement()) {
@@ -120,14 +143,14 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             if (elementName == "parameters") {
                 if (xmlState != XmlStateNone) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return true;
                 }
                 xmlState = XmlStateFoundParameters;
                 
             } else if (elementName == "version") {
                 if (xmlState != XmlStateFoundParameters) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return true;
                 }
                 xmlState = XmlStateFoundVersion;
                 
@@ -136,12 +159,12 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 int intVersion = strVersion.toInt(&convertOk);
                 if (!convertOk) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return true;
                 }
                 if (intVersion <= 2) {
                     // We can't read these old files
                     qDebug() << "Parameter version stamp too old, skipping load. Found:" << intVersion << "Want: 3 File:" << metaDataFile;
-                    return;
+                    return true;
                 }
                 
             } else if (elementName == "parameter_version_major") {
@@ -153,13 +176,13 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 if (xmlState != XmlStateFoundVersion) {
                     // We didn't get a version stamp, assume older version we can't read
                     qDebug() << "Parameter version stamp not found, skipping load" << metaDataFile;
-                    return;
+                    return true;
                 }
                 xmlState = XmlStateFoundGroup;
                 
                 if (!xml.attributes().hasAttribute("name")) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return true;
                 }
                 factGroup = xml.attributes().value("name").toString();
                 qCDebug(PX4ParameterMetaDataLog) << "Found group: " << factGroup;
@@ -167,13 +190,13 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             } else if (elementName == "parameter") {
                 if (xmlState != XmlStateFoundGroup) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return true;
                 }
                 xmlState = XmlStateFoundParameter;
                 
                 if (!xml.attributes().hasAttribute("name") || !xml.attributes().hasAttribute("type")) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return true;
                 }
                 
                 QString name = xml.attributes().value("name").toString();
@@ -201,38 +224,36 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
 
                 qCDebug(PX4ParameterMetaDataLog) << "Found parameter name:" << name << " type:" << type << " default:" << strDefault;
 
-                // Convert type from string to FactMetaData::ValueType_t
+                // Make sure the type is known, the meta data is converted to it when the fact asks for it
                 bool unknownType;
-                FactMetaData::ValueType_t foundType = FactMetaData::stringToType(type, unknownType);
+                (void) FactMetaData::stringToType(type, unknownType);
                 if (unknownType) {
                     qWarning() << "Parameter meta data with bad type:" << type << " name:" << name;
-                    return;
+                    return true;
                 }
                 
-                // Now that we know type we can create meta data object and add it to the system
-                metaData = new FactMetaData(foundType, this);
-                if (_mapParameterName2FactMetaData.contains(name)) {
+                entries.append(ParameterMetaDataStore::Entry());
+                metaData = &entries.last();
+                metaData->key = name;
+                metaData->fields[ParameterMetaDataStore::FieldType] = type;
+                if (names.contains(name)) {
                     // We can't trust the meta data since we have dups
                     qCWarning(PX4ParameterMetaDataLog) << "Duplicate parameter found:" << name;
                     badMetaData = true;
-                    // Reset to default meta data
-                    _mapParameterName2FactMetaData[name] = metaData;
+                    // Reset to default meta data, the entry replaces the earlier one
                 } else {
-                    _mapParameterName2FactMetaData[name] = metaData;
-                    metaData->setName(name);
-                    metaData->setCategory(category);
-                    metaData->setGroup(factGroup);
-                    metaData->setReadOnly(readOnly);
-                    metaData->setVolatileValue(volatileValue);
-                    
-                    if (xml.attributes().hasAttribute("default") && !strDefault.isEmpty()) {
-                        QVariant varDefault;
-                        
-                        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
-                            metaData->setRawDefaultValue(varDefault);
-                        } else {
-                            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
-                        }
+                    names.insert(name);
+                    metaData->name = name;
+                    metaData->fields[ParameterMetaDataStore::FieldCategory] = category;
+                    metaData->fields[ParameterMetaDataStore::FieldGroup] = factGroup;
+                    if (readOnly) {
+                        metaData->flags |= ParameterMetaDataStore::FlagReadOnly;
+                    }
+                    if (volatileValue) {
+                        metaData->flags |= ParameterMetaDataStore::FlagVolatile;
+                    }
+                    if (xml.attributes().hasAttribute("default")) {
+                        metaData->fields[ParameterMetaDataStore::FieldDefault] = strDefault;
                     }
                 }
                 
@@ -240,7 +261,7 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 // We should be getting meta data now
                 if (xmlState != XmlStateFoundParameter) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return true;
                 }
 
                 if (!badMetaData) {
@@ -249,58 +270,39 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                             QString text = xml.readElementText();
                             text = text.replace("\n", " ");
                             qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
-                            metaData->setShortDescription(text);
+                            metaData->fields[ParameterMetaDataStore::FieldShortDescription] = text;
 
                         } else if (elementName == "long_desc") {
                             QString text = xml.readElementText();
                             text = text.replace("\n", " ");
                             qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
-                            metaData->setLongDescription(text);
+                            metaData->fields[ParameterMetaDataStore::FieldLongDescription] = text;
 
                         } else if (elementName == "min") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
-
-                            QVariant varMin;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
-                                metaData->setRawMin(varMin);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
-                            }
+                            metaData->fields[ParameterMetaDataStore::FieldMin] = text;
 
                         } else if (elementName == "max") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
-
-                            QVariant varMax;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
-                                metaData->setRawMax(varMax);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
-                            }
+                            metaData->fields[ParameterMetaDataStore::FieldMax] = text;
 
                         } else if (elementName == "unit") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
-                            metaData->setRawUnits(text);
+                            metaData->fields[ParameterMetaDataStore::FieldUnits] = text;
 
                         } else if (elementName == "decimal") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
-
-                            bool convertOk;
-                            QVariant varDecimals = QVariant(text).toUInt(&convertOk);
-                            if (convertOk) {
-                                metaData->setDecimalPlaces(varDecimals.toInt());
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
-                            }
+                            metaData->fields[ParameterMetaDataStore::FieldDecimalPlaces] = text;
 
                         } else if (elementName == "reboot_required") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
                             if (text.compare("true", Qt::CaseInsensitive) == 0) {
-                                metaData->setVehicleRebootRequired(true);
+                                metaData->flags |= ParameterMetaDataStore::FlagRebootRequired;
                             }
 
                         } else if (elementName == "values") {
@@ -311,59 +313,27 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                             QString enumString = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
                                                              << "value desc:" << enumString << "code:" << enumValueStr;
+                            metaData->values.append(qMakePair(enumValueStr, enumString));
 
-                            QVariant    enumValue;
-                            QString     errorString;
-                            if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
-                                metaData->addEnumInfo(enumString, enumValue);
-                            } else {
-                                qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
-                                                                 << " type:" << metaData->type() << " value:" << enumValueStr
-                                                                 << " error:" << errorString;
-                            }
                         } else if (elementName == "increment") {
-                            double  increment;
-                            bool    ok;
                             QString text = xml.readElementText();
-                            increment = text.toDouble(&ok);
-                            if (ok) {
-                                metaData->setRawIncrement(increment);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
-                            }
+                            metaData->fields[ParameterMetaDataStore::FieldIncrement] = text;
 
                         } else if (elementName == "boolean") {
-                            QVariant    enumValue;
-                            metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Enabled"), enumValue);
-                            metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Disabled"), enumValue);
+                            metaData->flags |= ParameterMetaDataStore::FlagBoolean;
 
                         } else if (elementName == "bitmask") {
                             // doing nothing individual bits will follow anyway. May be used for sanity checking.
 
                         } else if (elementName == "bit") {
                             bool ok = false;
-                            unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
+                            const QString bitStr = xml.attributes().value("index").toString();
+                            (void) bitStr.toUInt(&ok);
                             if (ok) {
                                 QString bitDescription = xml.readElementText();
                                 qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                                 << "index:" << bit << "description:" << bitDescription;
-
-                                if (bit < 31) {
-                                    QVariant bitmaskRawValue = 1 << bit;
-                                    QVariant bitmaskValue;
-                                    QString errorString;
-                                    if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
-                                        metaData->addBitmaskInfo(bitDescription, bitmaskValue);
-                                    } else {
-                                        qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
-                                                                         << " type:" << metaData->type() << " value:" << bitmaskValue
-                                                                         << " error:" << errorString;
-                                    }
-                                } else {
-                                    qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
-                                }
+                                                                 << "index:" << bitStr << "description:" << bitDescription;
+                                metaData->bitmask.append(qMakePair(bitStr, bitDescription));
                             }
                         } else {
                             qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
@@ -377,15 +347,6 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             QString elementName = xml.name().toString();
 
             if (elementName == "parameter") {
-                // Done loading this parameter, validate default value
-                if (metaData->defaultValueAvailable()) {
-                    QVariant var;
-
-                    if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
-                        qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
-                    }
-                }
-
                 // Reset for next parameter
                 metaData = nullptr;
                 badMetaData = false;
@@ -399,9 +360,131 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         xml.readNext();
     }
 
-#ifdef GENERATE_PARAMETER_JSON
-    _generateParameterJson();
-#endif
+    return true;
+}
+
+FactMetaData* PX4ParameterMetaData::_createMetaData(const ParameterMetaDataStore::Entry& entry)
+{
+    bool unknownType;
+    const FactMetaData::ValueType_t type = FactMetaData::stringToType(entry.fields[ParameterMetaDataStore::FieldType], unknownType);
+    FactMetaData* metaData = new FactMetaData(type, this);
+    if (entry.name.isEmpty()) {
+        // Duplicated in the meta data file, only the type is known
+        return metaData;
+    }
+
+    QString errorString;
+
+    metaData->setName(entry.name);
+    metaData->setCategory(entry.fields[ParameterMetaDataStore::FieldCategory]);
+    metaData->setGroup(entry.fields[ParameterMetaDataStore::FieldGroup]);
+    metaData->setReadOnly(entry.flags & ParameterMetaDataStore::FlagReadOnly);
+    metaData->setVolatileValue(entry.flags & ParameterMetaDataStore::FlagVolatile);
+    metaData->setVehicleRebootRequired(entry.flags & ParameterMetaDataStore::FlagRebootRequired);
+
+    const QString& strDefault = entry.fields[ParameterMetaDataStore::FieldDefault];
+    if (!strDefault.isEmpty()) {
+        QVariant varDefault;
+        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
+            metaData->setRawDefaultValue(varDefault);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << entry.name << " type:" << metaData->type() << " default:" << strDefault << " error:" << errorString;
+        }
+    }
+
+    const QString& shortDescription = entry.fields[ParameterMetaDataStore::FieldShortDescription];
+    if (!shortDescription.isEmpty()) {
+        metaData->setShortDescription(shortDescription);
+    }
+    const QString& longDescription = entry.fields[ParameterMetaDataStore::FieldLongDescription];
+    if (!longDescription.isEmpty()) {
+        metaData->setLongDescription(longDescription);
+    }
+
+    const QString& min = entry.fields[ParameterMetaDataStore::FieldMin];
+    if (!min.isEmpty()) {
+        QVariant varMin;
+        if (metaData->convertAndValidateRaw(min, false /* convertOnly */, varMin, errorString)) {
+            metaData->setRawMin(varMin);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << min << " error:" << errorString;
+        }
+    }
+
+    const QString& max = entry.fields[ParameterMetaDataStore::FieldMax];
+    if (!max.isEmpty()) {
+        QVariant varMax;
+        if (metaData->convertAndValidateRaw(max, false /* convertOnly */, varMax, errorString)) {
+            metaData->setRawMax(varMax);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << max << " error:" << errorString;
+        }
+    }
+
+    const QString& units = entry.fields[ParameterMetaDataStore::FieldUnits];
+    if (!units.isEmpty()) {
+        metaData->setRawUnits(units);
+    }
+
+    const QString& decimals = entry.fields[ParameterMetaDataStore::FieldDecimalPlaces];
+    if (!decimals.isEmpty()) {
+        bool convertOk;
+        const uint decimalPlaces = decimals.toUInt(&convertOk);
+        if (convertOk) {
+            metaData->setDecimalPlaces(static_cast<int>(decimalPlaces));
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << decimals << " error: invalid number";
+        }
+    }
+
+    if (entry.flags & ParameterMetaDataStore::FlagBoolean) {
+        QVariant enumValue;
+        metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Enabled"), enumValue);
+        metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Disabled"), enumValue);
+    }
+
+    for (const QPair<QString, QString>& value : entry.values) {
+        QVariant enumValue;
+        if (metaData->convertAndValidateRaw(value.first, false /* validate */, enumValue, errorString)) {
+            metaData->addEnumInfo(value.second, enumValue);
+        } else {
+            qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
+                                             << " type:" << metaData->type() << " value:" << value.first
+                                             << " error:" << errorString;
+        }
+    }
+
+    const QString& incrementStr = entry.fields[ParameterMetaDataStore::FieldIncrement];
+    if (!incrementStr.isEmpty()) {
+        bool ok;
+        const double increment = incrementStr.toDouble(&ok);
+        if (ok) {
+            metaData->setRawIncrement(increment);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << incrementStr;
+        }
+    }
+
+    for (const QPair<QString, QString>& bitmask : entry.bitmask) {
+        const uint bit = bitmask.first.toUInt();
+        if (bit < 31) {
+            QVariant bitmaskRawValue = 1 << bit;
+            QVariant bitmaskValue;
+            if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
+                metaData->addBitmaskInfo(bitmask.second, bitmaskValue);
+            } else {
+                qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
+                                                 << " type:" << metaData->type() << " value:" << bitmaskValue
+                                                 << " error:" << errorString;
+            }
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
+        }
+    }
+
+    return metaData;
 }
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -418,6 +501,10 @@ void PX4ParameterMetaData::_generateParameterJson()
 {
     qCDebug(PX4ParameterMetaDataLog) << "PX4ParameterMetaData::_generateParameterJson";
 
+    for (int index = 0; index < _store.count(); index++) {
+        (void) getMetaDataForFact(_store.key(index), MAV_TYPE_GENERIC, FactMetaData::valueTypeInt32);
+    }
+
     int indentLevel = 0;
     QFile jsonFile(QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).absoluteFilePath("parameter.json"));
     jsonFile.open(QFile::WriteOnly | QFile::Truncate | QFile::Text);
@@ -493,9 +580,14 @@ FactMetaData* PX4ParameterMetaData::getMetaDataForFact(const QString& name, MAV_
     Q_UNUSED(vehicleType)
 
     if (!_mapParameterName2FactMetaData.contains(name)) {
-        qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
-        FactMetaData* metaData = new FactMetaData(type, this);
-        _mapParameterName2FactMetaData[name] = metaData;
+        const int index = _store.indexOf(name);
+        if (index >= 0) {
+            _mapParameterName2FactMetaData[name] = _createMetaData(_store.entry(index));
+        } else {
+            qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
+            FactMetaData* metaData = new FactMetaData(type, this);
+            _mapParameterName2FactMetaData[name] = metaData;
+        }
     }
 
     return _mapParameterName2FactMetaData[name];
@@ -12,6 +12,7 @@
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "ParameterMetaDataStore.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QLoggingCategory>
@@ -46,6 +47,9 @@ class PX4ParameterMetaData : public QObject
         XmlStateDone
     };
 
+    /// @return false if the file could not be read
+    bool _parseParameterFactMetaDataFile(const QString& metaDataFile, QList<ParameterMetaDataStore::Entry>& entries);
+    FactMetaData* _createMetaData(const ParameterMetaDataStore::Entry& entry);
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
     static void _outputFileWarning(const QString& metaDataFile, const QString& error1, const QString& error2);
 
@@ -54,7 +58,8 @@ class PX4ParameterMetaData : public QObject
 #endif
 
     bool                                _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData
+    ParameterMetaDataStore              _store;                                     ///< Compiled meta data, keyed by parameter name
+    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData, filled from _store on first use
 
     static constexpr const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 
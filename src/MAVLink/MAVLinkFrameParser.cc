@@ -0,0 +1,253 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameParser.h"
+#include "QGCLoggingCategory.h"
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(MAVLinkFrameParserLog, "qgc.mavlink.mavlinkframeparser")
+
+MAVLinkFrameParser::MAVLinkFrameParser(uint8_t mavlinkChannel)
+    : _mavlinkChannel(mavlinkChannel)
+{
+    _pending.reserve(MAVLINK_MAX_PACKET_LEN * 2);
+}
+
+void MAVLinkFrameParser::setMavlinkChannel(uint8_t mavlinkChannel)
+{
+    _mavlinkChannel = mavlinkChannel;
+    reset();
+}
+
+void MAVLinkFrameParser::reset()
+{
+    _pending.clear();
+    _stats = Stats();
+}
+
+void MAVLinkFrameParser::setSigning(const mavlink_signing_t *signing)
+{
+    _ownSigning = true;
+    _ownSigningEnabled = (signing != nullptr);
+    _signing = signing ? *signing : mavlink_signing_t{};
+    _signingStreams = mavlink_signing_streams_t{};
+}
+
+qsizetype MAVLinkFrameParser::parse(QByteArrayView data, QList<mavlink_message_t> &frames)
+{
+    const qsizetype initialCount = frames.size();
+    const uint8_t *const bytes = reinterpret_cast<const uint8_t*>(data.data());
+    qsizetype offset = 0;
+
+    if (!_pending.isEmpty()) {
+        // Complete the frame left over from the previous chunk. A frame is never longer than
+        // MAVLINK_MAX_PACKET_LEN so that many new bytes are enough to resolve every candidate
+        // which starts inside the pending buffer.
+        const qsizetype pendingSize = _pending.size();
+        (void) _pending.append(data.first(qMin(data.size(), static_cast<qsizetype>(MAVLINK_MAX_PACKET_LEN))));
+
+        const uint8_t *const pending = reinterpret_cast<const uint8_t*>(_pending.constData());
+        const qsizetype stop = _parseBuffer(pending, _pending.size(), pendingSize, frames);
+        if (stop < pendingSize) {
+            // Still incomplete, which means all of data has been consumed into the pending buffer
+            (void) _pending.remove(0, stop);
+            return (frames.size() - initialCount);
+        }
+
+        offset = stop - pendingSize;
+        _pending.clear();
+    }
+
+    const qsizetype remaining = data.size() - offset;
+    const qsizetype stop = _parseBuffer(bytes + offset, remaining, remaining, frames);
+    if (stop < remaining) {
+        (void) _pending.append(data.sliced(offset + stop));
+    }
+
+    return (frames.size() - initialCount);
+}
+
+qsizetype MAVLinkFrameParser::_parseBuffer(const uint8_t *data, qsizetype size, qsizetype scanLimit, QList<mavlink_message_t> &frames)
+{
+    qsizetype pos = 0;
+    while (pos < scanLimit) {
+        if (!_isStx(data[pos])) {
+            const uint8_t *const stx = std::find_if(data + pos, data + scanLimit, _isStx);
+            const qsizetype next = stx - data;
+            _stats.bytesDiscarded += static_cast<uint64_t>(next - pos);
+            pos = next;
+            if (pos >= scanLimit) {
+                break;
+            }
+        }
+
+        qsizetype frameLength = 0;
+        mavlink_message_t message;
+        switch (_decodeFrame(data + pos, size - pos, frameLength, message)) {
+        case FrameResult::Ok:
+            frames.append(message);
+            pos += frameLength;
+            break;
+        case FrameResult::BadSignature:
+            pos += frameLength;
+            break;
+        case FrameResult::Invalid:
+        case FrameResult::BadCrc:
+            // Not a frame after all, resync on the next STX
+            _stats.bytesDiscarded++;
+            pos++;
+            break;
+        case FrameResult::Incomplete:
+            return pos;
+        }
+    }
+
+    return pos;
+}
+
+bool MAVLinkFrameParser::checkFrame(const uint8_t *data, qsizetype available, qsizetype &frameLength, uint32_t &msgid)
+{
+    if ((available <= 0) || !_isStx(data[0])) {
+        return false;
+    }
+
+    uint16_t crc = 0;
+    return (_checkFrame(data, available, frameLength, msgid, crc) == FrameResult::Ok);
+}
+
+MAVLinkFrameParser::FrameResult MAVLinkFrameParser::_checkFrame(const uint8_t *data, qsizetype available, qsizetype &frameLength, uint32_t &msgid, uint16_t &crc)
+{
+    const bool mavlink2 = (data[0] == MAVLINK_STX);
+    const qsizetype headerLength = mavlink2 ? MAVLINK_NUM_HEADER_BYTES : (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1);
+    if (available < headerLength) {
+        return FrameResult::Incomplete;
+    }
+
+    const uint8_t payloadLength = data[1];
+    const uint8_t incompatFlags = mavlink2 ? data[2] : 0;
+    if (incompatFlags & ~MAVLINK_IFLAG_MASK) {
+        // Same as mavlink_parse_char: drop frames using incompatible features we don't support
+        return FrameResult::Invalid;
+    }
+
+    const bool isSigned = (incompatFlags & MAVLINK_IFLAG_SIGNED);
+    frameLength = headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES + (isSigned ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+    if (available < frameLength) {
+        return FrameResult::Incomplete;
+    }
+
+    msgid = mavlink2 ? (data[7] | (data[8] << 8) | (data[9] << 16)) : data[5];
+    const mavlink_msg_entry_t *const entry = mavlink_get_msg_entry(msgid);
+
+    crc = crc_calculate(data + 1, static_cast<uint16_t>(headerLength - 1 + payloadLength));
+    crc_accumulate(entry ? entry->crc_extra : 0, &crc);
+
+    const uint8_t *const ck = data + headerLength + payloadLength;
+    if ((ck[0] != (crc & 0xFF)) || (ck[1] != (crc >> 8))) {
+        return FrameResult::BadCrc;
+    }
+
+    return FrameResult::Ok;
+}
+
+MAVLinkFrameParser::FrameResult MAVLinkFrameParser::_decodeFrame(const uint8_t *data, qsizetype available, qsizetype &frameLength, mavlink_message_t &message)
+{
+    uint32_t msgid = 0;
+    uint16_t crc = 0;
+    const FrameResult result = _checkFrame(data, available, frameLength, msgid, crc);
+    if (result == FrameResult::BadCrc) {
+        _stats.badCrc++;
+        return FrameResult::Invalid;
+    } else if (result != FrameResult::Ok) {
+        return result;
+    }
+
+    const bool mavlink2 = (data[0] == MAVLINK_STX);
+    const qsizetype headerLength = mavlink2 ? MAVLINK_NUM_HEADER_BYTES : (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1);
+    const uint8_t payloadLength = data[1];
+    const uint8_t incompatFlags = mavlink2 ? data[2] : 0;
+    const bool isSigned = (incompatFlags & MAVLINK_IFLAG_SIGNED);
+    const mavlink_msg_entry_t *const entry = mavlink_get_msg_entry(msgid);
+    const uint8_t *const ck = data + headerLength + payloadLength;
+
+    message.magic = data[0];
+    message.len = payloadLength;
+    message.incompat_flags = incompatFlags;
+    if (mavlink2) {
+        message.compat_flags = data[3];
+        message.seq = data[4];
+        message.sysid = data[5];
+        message.compid = data[6];
+    } else {
+        message.compat_flags = 0;
+        message.seq = data[2];
+        message.sysid = data[3];
+        message.compid = data[4];
+    }
+    message.msgid = msgid;
+    message.checksum = crc;
+    message.ck[0] = ck[0];
+    message.ck[1] = ck[1];
+
+    uint8_t *const payload = reinterpret_cast<uint8_t*>(message.payload64);
+    (void) memcpy(payload, data + headerLength, payloadLength);
+    // Zero-fill to cope with MAVLink 2 payload truncation, as mavlink_parse_char does
+    const uint8_t fillLength = entry ? qMax(entry->max_msg_len, payloadLength) : payloadLength;
+    (void) memset(payload + payloadLength, 0, fillLength - payloadLength);
+
+    if (isSigned) {
+        (void) memcpy(message.signature, ck + MAVLINK_NUM_CHECKSUM_BYTES, MAVLINK_SIGNATURE_BLOCK_LEN);
+    }
+
+    mavlink_status_t *const status = mavlink_get_channel_status(_mavlinkChannel);
+    if (!_checkSignature(status, message)) {
+        _stats.badSignature++;
+        status->parse_error++;
+        qCDebug(MAVLinkFrameParserLog) << "Signature check failed - channel:msgid" << _mavlinkChannel << msgid;
+        return FrameResult::BadSignature;
+    }
+
+    _updateChannelStatus(status, message);
+    _stats.framesOk++;
+
+    return FrameResult::Ok;
+}
+
+bool MAVLinkFrameParser::_checkSignature(mavlink_status_t *status, const mavlink_message_t &message)
+{
+    mavlink_signing_t *signing = status->signing;
+    mavlink_signing_streams_t *signingStreams = status->signing_streams;
+    if (_ownSigning) {
+        signing = _ownSigningEnabled ? &_signing : nullptr;
+        signingStreams = &_signingStreams;
+    }
+
+    if (!signing) {
+        return true;
+    }
+
+    if ((message.incompat_flags & MAVLINK_IFLAG_SIGNED) && mavlink_signature_check(signing, signingStreams, &message)) {
+        return true;
+    }
+
+    return (signing->accept_unsigned_callback && signing->accept_unsigned_callback(status, message.msgid));
+}
+
+void MAVLinkFrameParser::_updateChannelStatus(mavlink_status_t *status, const mavlink_message_t &message)
+{
+    // Only receive side fields are touched. The flags are shared with the send side, which may run on a
+    // different thread, use mavlink_message_t::magic to find the version of a received frame instead.
+    if (status->packet_rx_success_count == 0) {
+        status->packet_rx_drop_count = 0;
+    }
+    status->packet_rx_success_count++;
+    status->current_rx_seq = message.seq;
+    status->msg_received = MAVLINK_FRAMING_OK;
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkFrameParserLog)
+
+/// Buffer oriented MAVLink framing engine.
+/// Instead of pushing every byte through the mavlink_parse_char state machine, the parser scans a received
+/// chunk for STX markers, sizes each candidate frame from its header and validates the CRC over the whole
+/// frame at once. Bytes belonging to a frame which is split across chunks are kept until the next call.
+/// Signing is honored using the signing configuration of the associated MAVLink channel, or a copy of it
+/// handed over with setSigning when the parser runs on a different thread than the one setting signing up.
+class MAVLinkFrameParser
+{
+public:
+    struct Stats {
+        uint64_t framesOk = 0;          ///< Frames which passed CRC and signature checks
+        uint64_t badCrc = 0;            ///< Candidate frames rejected due to CRC mismatch
+        uint64_t badSignature = 0;      ///< Frames rejected by the channel signing configuration
+        uint64_t bytesDiscarded = 0;    ///< Bytes skipped while searching for the next STX
+    };
+
+    explicit MAVLinkFrameParser(uint8_t mavlinkChannel = MAVLINK_COMM_0);
+
+    uint8_t mavlinkChannel() const { return _mavlinkChannel; }
+
+    /// Sets the channel used for signing and channel status bookkeeping. Resets the parser.
+    void setMavlinkChannel(uint8_t mavlinkChannel);
+
+    /// Drops any partially received frame and clears the statistics
+    void reset();
+
+    /// Checks signatures against a copy of signing instead of the channel signing configuration.
+    /// The replay protection streams start over. nullptr turns signature checks off.
+    void setSigning(const mavlink_signing_t *signing);
+
+    /// Parses a chunk of bytes appending every complete and valid frame to frames.
+    ///     @return Number of frames appended
+    qsizetype parse(QByteArrayView data, QList<mavlink_message_t> &frames);
+
+    const Stats &stats() const { return _stats; }
+
+    /// Number of buffered bytes belonging to an incomplete frame
+    qsizetype pendingBytes() const { return _pending.size(); }
+
+    /// Checks for a complete frame with a valid CRC at the start of data. The signature is not verified.
+    ///     @param[out] frameLength Length of the frame including the signature
+    ///     @param[out] msgid Message id of the frame
+    ///     @return true: Valid frame found
+    static bool checkFrame(const uint8_t *data, qsizetype available, qsizetype &frameLength, uint32_t &msgid);
+
+private:
+    enum class FrameResult {
+        Ok,
+        Incomplete,
+        Invalid,
+        BadCrc,
+        BadSignature
+    };
+
+    /// Decodes frames starting before scanLimit, a frame may extend up to size.
+    ///     @return Offset of the first unresolved byte
+    qsizetype _parseBuffer(const uint8_t *data, qsizetype size, qsizetype scanLimit, QList<mavlink_message_t> &frames);
+    FrameResult _decodeFrame(const uint8_t *data, qsizetype available, qsizetype &frameLength, mavlink_message_t &message);
+    static FrameResult _checkFrame(const uint8_t *data, qsizetype available, qsizetype &frameLength, uint32_t &msgid, uint16_t &crc);
+    bool _checkSignature(mavlink_status_t *status, const mavlink_message_t &message);
+    static void _updateChannelStatus(mavlink_status_t *status, const mavlink_message_t &message);
+
+    static constexpr bool _isStx(uint8_t byte) { return ((byte == MAVLINK_STX) || (byte == MAVLINK_STX_MAVLINK1)); }
+
+    uint8_t _mavlinkChannel = MAVLINK_COMM_0;
+    bool _ownSigning = false;                       ///< true: check against _signing instead of the channel configuration
+    bool _ownSigningEnabled = false;
+    mavlink_signing_t _signing{};
+    mavlink_signing_streams_t _signingStreams{};
+    QByteArray _pending;    ///< Tail of the previous chunk starting at an unresolved STX
+    Stats _stats;
+};
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageDispatcher.h"
+#include "QGCLoggingCategory.h"
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(MAVLinkMessageDispatcherLog, "qgc.mavlink.mavlinkmessagedispatcher")
+
+MAVLinkMessageDispatcher::MAVLinkMessageDispatcher()
+{
+    _elapsedTimer.start();
+}
+
+void MAVLinkMessageDispatcher::subscribe(const QString &name, const QList<uint32_t> &messageIds, const Handler &handler)
+{
+    if (messageIds.isEmpty()) {
+        return;
+    }
+
+    auto subscription = std::make_unique<Subscription>();
+    subscription->stats.name = name;
+    subscription->messageIds = messageIds;
+    subscription->anyMessage = messageIds.contains(kAnyMessageId);
+    subscription->handler = handler;
+    _subscriptions.push_back(std::move(subscription));
+
+    // Cached handler lists are rebuilt on demand
+    _dispatchTable.clear();
+    _generation++;
+}
+
+const QList<qsizetype> &MAVLinkMessageDispatcher::_handlersFor(uint32_t msgid)
+{
+    auto it = _dispatchTable.find(msgid);
+    if (it == _dispatchTable.end()) {
+        QList<qsizetype> handlers;
+        for (size_t i = 0; i < _subscriptions.size(); i++) {
+            const Subscription *const subscription = _subscriptions[i].get();
+            if (subscription->anyMessage || subscription->messageIds.contains(msgid)) {
+                handlers.append(static_cast<qsizetype>(i));
+            }
+        }
+        it = _dispatchTable.insert(msgid, handlers);
+        // Inserting may rehash, which invalidates references handed out previously
+        _generation++;
+    }
+
+    return it.value();
+}
+
+bool MAVLinkMessageDispatcher::hasHandlers(uint32_t msgid)
+{
+    return !_handlersFor(msgid).isEmpty();
+}
+
+void MAVLinkMessageDispatcher::dispatch(const mavlink_message_t &message)
+{
+    // A handler may subscribe while we iterate, which rebuilds the table. New subscriptions are always
+    // appended so the handlers already called keep their position and only the lookup is repeated.
+    // The same applies to a nested dispatch of a message id which is not in the table yet.
+    const QList<qsizetype> *handlers = &_handlersFor(message.msgid);
+    uint32_t generation = _generation;
+    for (qsizetype i = 0; i < handlers->size(); i++) {
+        Subscription *const subscription = _subscriptions[handlers->at(i)].get();
+        const qint64 start = _elapsedTimer.nsecsElapsed();
+        subscription->handler(message);
+        subscription->stats.elapsedNSecs += _elapsedTimer.nsecsElapsed() - start;
+        subscription->stats.invocations++;
+
+        if (generation != _generation) {
+            handlers = &_handlersFor(message.msgid);
+            generation = _generation;
+        }
+    }
+}
+
+QList<MAVLinkMessageDispatcher::HandlerStats> MAVLinkMessageDispatcher::stats() const
+{
+    QList<HandlerStats> result;
+    result.reserve(static_cast<qsizetype>(_subscriptions.size()));
+    for (const std::unique_ptr<Subscription> &subscription : _subscriptions) {
+        result.append(subscription->stats);
+    }
+
+    return result;
+}
+
+void MAVLinkMessageDispatcher::resetStats()
+{
+    for (std::unique_ptr<Subscription> &subscription : _subscriptions) {
+        subscription->stats.invocations = 0;
+        subscription->stats.elapsedNSecs = 0;
+    }
+}
+
+void MAVLinkMessageDispatcher::logStats() const
+{
+    if (!MAVLinkMessageDispatcherLog().isDebugEnabled()) {
+        return;
+    }
+
+    QList<HandlerStats> sorted = stats();
+    std::sort(sorted.begin(), sorted.end(), [](const HandlerStats &a, const HandlerStats &b) {
+        return a.elapsedNSecs > b.elapsedNSecs;
+    });
+
+    for (const HandlerStats &handlerStats : std::as_const(sorted)) {
+        const double averageUSecs = handlerStats.invocations ? (handlerStats.elapsedNSecs / 1000.0 / handlerStats.invocations) : 0.;
+        qCDebug(MAVLinkMessageDispatcherLog) << handlerStats.name
+                                             << "invocations:" << handlerStats.invocations
+                                             << "total ms:" << (handlerStats.elapsedNSecs / 1000000.0)
+                                             << "avg us:" << averageUSecs;
+    }
+}
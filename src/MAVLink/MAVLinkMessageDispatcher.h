@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkMessageDispatcherLog)
+
+/// Routes incoming messages to the handlers which subscribed to their message id.
+/// The handler list for a message id is resolved once and cached, so dispatch is a single hash lookup
+/// followed by calls to only the interested handlers. Handlers are always called in subscription order.
+/// A handler may subscribe new handlers, these already receive the message currently being dispatched.
+class MAVLinkMessageDispatcher
+{
+public:
+    using Handler = std::function<void(const mavlink_message_t &message)>;
+
+    struct HandlerStats {
+        QString name;
+        uint64_t invocations = 0;
+        qint64 elapsedNSecs = 0;    ///< Total time spent in the handler
+    };
+
+    /// Subscribes a handler to every message
+    static constexpr uint32_t kAnyMessageId = std::numeric_limits<uint32_t>::max();
+
+    MAVLinkMessageDispatcher();
+
+    /// Subscribes a handler to the specified message ids
+    ///     @param name Used to identify the handler in the statistics
+    ///     @param messageIds Message ids to call the handler for, may contain kAnyMessageId. Nothing is subscribed for an empty list.
+    void subscribe(const QString &name, const QList<uint32_t> &messageIds, const Handler &handler);
+
+    /// Calls every handler subscribed to the id of message
+    void dispatch(const mavlink_message_t &message);
+
+    /// @return true: at least one handler is subscribed to msgid
+    bool hasHandlers(uint32_t msgid);
+
+    QList<HandlerStats> stats() const;
+    void resetStats();
+
+    /// Writes the per handler statistics to the log, busiest handler first
+    void logStats() const;
+
+private:
+    struct Subscription {
+        HandlerStats stats;
+        QList<uint32_t> messageIds;
+        bool anyMessage = false;
+        Handler handler;
+    };
+
+    const QList<qsizetype> &_handlersFor(uint32_t msgid);
+
+    std::vector<std::unique_ptr<Subscription>> _subscriptions;
+    QHash<uint32_t, QList<qsizetype>> _dispatchTable;   ///< msgid to indices into _subscriptions, built on demand
+    uint32_t _generation = 0;                           ///< Incremented whenever references into the table are invalidated
+    QElapsedTimer _elapsedTimer;
+};
@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "RequestWindow.h"
+#include "QGCLoggingCategory.h"
+
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(RequestWindowLog, "qgc.mavlink.requestwindow")
+
+RequestWindow::RequestWindow()
+{
+    // qCDebug(RequestWindowLog) << Q_FUNC_INFO << this;
+}
+
+RequestWindow::~RequestWindow()
+{
+    // qCDebug(RequestWindowLog) << Q_FUNC_INFO << this;
+}
+
+void RequestWindow::reset()
+{
+    _inFlight.clear();
+    _window = kInitialWindow;
+    _slowStart = true;
+    _recoveryUntilMs = 0;
+    _backoff = 1;
+    _rttValid = false;
+    _srttMs = 0;
+    _rttVarMs = 0;
+    _minRttMs = 0;
+    _lossRate = 0;
+}
+
+void RequestWindow::cancel(int componentId)
+{
+    for (auto it = _inFlight.begin(); it != _inFlight.end();) {
+        if (static_cast<int>(static_cast<qint32>(it.key() >> 32)) == componentId) {
+            it = _inFlight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void RequestWindow::addRttSample(qint64 rttMs)
+{
+    _updateRtt(static_cast<double>(qMax<qint64>(rttMs, 0)));
+}
+
+void RequestWindow::_updateRtt(double rttMs)
+{
+    // RFC 6298 smoothing
+    if (!_rttValid) {
+        _rttValid = true;
+        _srttMs = rttMs;
+        _rttVarMs = rttMs / 2;
+        _minRttMs = rttMs;
+    } else {
+        _rttVarMs = (0.75 * _rttVarMs) + (0.25 * std::abs(_srttMs - rttMs));
+        _srttMs = (0.875 * _srttMs) + (0.125 * rttMs);
+        _minRttMs = qMin(_minRttMs, rttMs);
+    }
+}
+
+bool RequestWindow::_congested() const
+{
+    return (_rttValid && (_srttMs > ((2 * _minRttMs) + kRttSlackMs)));
+}
+
+int RequestWindow::timeoutMs() const
+{
+    double timeout = kInitialTimeoutMs;
+    if (_rttValid) {
+        timeout = qBound<double>(kMinTimeoutMs, _srttMs + (4 * _rttVarMs), kMaxTimeoutMs);
+    }
+
+    return qMin(static_cast<int>(std::ceil(timeout)) * _backoff, kMaxTimeoutMs);
+}
+
+int RequestWindow::streamStallMs() const
+{
+    return qBound(kMinStreamStallMs, 2 * timeoutMs(), kMaxTimeoutMs);
+}
+
+void RequestWindow::sent(int componentId, int index, bool retry, qint64 nowMs)
+{
+    _inFlight[_key(componentId, index)] = { nowMs, nowMs + timeoutMs(), retry };
+}
+
+bool RequestWindow::received(int componentId, int index, qint64 nowMs)
+{
+    const auto it = _inFlight.constFind(_key(componentId, index));
+    if (it == _inFlight.constEnd()) {
+        return false;
+    }
+
+    // A response to a request which was sent more than once can't be matched to one of them
+    if (!it->retry) {
+        _updateRtt(static_cast<double>(nowMs - it->sentMs));
+    }
+    (void) _inFlight.erase(it);
+
+    // The link is alive again
+    _backoff = 1;
+    _lossRate *= (1. - kLossGain);
+
+    if (_congested()) {
+        // Requests are queueing up in the link, give back one request per round trip
+        _slowStart = false;
+        _window = qMax<double>(kMinWindow, _window - (1. / _window));
+    } else if (_slowStart) {
+        _window = qMin<double>(kMaxWindow, _window + 1);
+    } else {
+        _window = qMin<double>(kMaxWindow, _window + (1. / _window));
+    }
+
+    return true;
+}
+
+QList<RequestWindow::Request> RequestWindow::expire(qint64 nowMs)
+{
+    QList<Request> expired;
+    for (auto it = _inFlight.begin(); it != _inFlight.end();) {
+        if (it->expiryMs <= nowMs) {
+            expired.append({ static_cast<int>(static_cast<qint32>(it.key() >> 32)), static_cast<int>(static_cast<qint32>(it.key() & 0xffffffff)) });
+            it = _inFlight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (expired.isEmpty()) {
+        return expired;
+    }
+
+    for (qsizetype i = 0; i < expired.count(); i++) {
+        _lossRate = (_lossRate * (1. - kLossGain)) + kLossGain;
+    }
+    _backoff = qMin(_backoff * 2, kMaxTimeoutMs / kMinTimeoutMs);
+
+    // Loss on a link which isn't backed up is noise, loss on a link which is means the window is too large
+    if (_congested() && (nowMs >= _recoveryUntilMs)) {
+        _slowStart = false;
+        _window = qMax<double>(kMinWindow, _window / 2);
+        _recoveryUntilMs = nowMs + static_cast<qint64>(_srttMs);
+    }
+
+    qCDebug(RequestWindowLog) << "Expired:" << expired.count() << "window:" << _window << "srtt:" << _srttMs << "loss:" << _lossRate << "timeout:" << timeoutMs();
+
+    return expired;
+}
+
+qint64 RequestWindow::nextExpiryMs() const
+{
+    qint64 nextExpiry = -1;
+    for (const InFlight &request : _inFlight) {
+        if ((nextExpiry < 0) || (request.expiryMs < nextExpiry)) {
+            nextExpiry = request.expiryMs;
+        }
+    }
+
+    return nextExpiry;
+}
@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(RequestWindowLog)
+
+/// Sliding window of MAVLink requests which are waiting for their response, for example index based
+/// PARAM_REQUEST_READ or MISSION_REQUEST_INT. A request is identified by the component it was sent to
+/// and its index within the list being read. Requests to all components share the window. The round trip time of the link is measured from
+/// the responses and sets the request timeout. The window grows while the round trip time stays
+/// near its floor and shrinks when it climbs, which means requests are queueing up in the link.
+/// Requests lost while the round trip time is low are taken as link noise: they are only sent
+/// again, they don't shrink the window. All times are in msecs from a caller provided clock.
+class RequestWindow
+{
+public:
+    struct Request {
+        int componentId;
+        int index;
+    };
+
+    RequestWindow();
+    ~RequestWindow();
+
+    /// Forgets requests in flight and the link measurements
+    void reset();
+    /// Forgets the requests in flight to a component
+    void cancel(int componentId);
+
+    /// Round trip time measured outside of the window, for example from a list request to its first response
+    void addRttSample(qint64 rttMs);
+
+    void sent(int componentId, int index, bool retry, qint64 nowMs);
+    /// @return false if the request was not in flight
+    bool received(int componentId, int index, qint64 nowMs);
+    /// Removes and returns the requests which timed out
+    QList<Request> expire(qint64 nowMs);
+
+    bool isInFlight(int componentId, int index) const { return _inFlight.contains(_key(componentId, index)); }
+    int inFlight() const { return static_cast<int>(_inFlight.count()); }
+    int window() const { return static_cast<int>(_window); }
+    int available() const { return qMax(0, window() - inFlight()); }
+    /// @return -1 if there is nothing in flight
+    qint64 nextExpiryMs() const;
+
+    int timeoutMs() const;
+    /// Time without a response after which a streamed list response, such as PARAM_REQUEST_LIST, is taken to have stopped
+    int streamStallMs() const;
+    double srttMs() const { return _srttMs; }
+    double lossRate() const { return _lossRate; }
+
+    static constexpr int kInitialWindow = 4;
+    static constexpr int kMinWindow = 2;
+    static constexpr int kMaxWindow = 64;
+    static constexpr int kInitialTimeoutMs = 1000;
+    static constexpr int kMinTimeoutMs = 100;
+    static constexpr int kMaxTimeoutMs = 3000;
+    static constexpr int kMinStreamStallMs = 1000;
+
+private:
+    struct InFlight {
+        qint64 sentMs;
+        qint64 expiryMs;
+        bool retry;
+    };
+
+    static quint64 _key(int componentId, int index) { return ((static_cast<quint64>(static_cast<quint32>(componentId)) << 32) | static_cast<quint32>(index)); }
+    bool _congested() const;
+    void _updateRtt(double rttMs);
+
+    QHash<quint64, InFlight> _inFlight;
+
+    double _window = kInitialWindow;
+    bool _slowStart = true;             ///< true: window grows by one per response until the first sign of congestion
+    qint64 _recoveryUntilMs = 0;        ///< The window is shrunk for loss at most once per round trip
+    int _backoff = 1;                   ///< Timeout multiplier, doubles with each timeout and resets with the next response
+
+    bool _rttValid = false;
+    double _srttMs = 0;
+    double _rttVarMs = 0;
+    double _minRttMs = 0;
+    double _lossRate = 0;               ///< Moving average of requests which timed out
+
+    static constexpr double kRttSlackMs = 20;   ///< Jitter allowed above twice the round trip floor before the link counts as congested
+    static constexpr double kLossGain = 1. / 16.;
+};
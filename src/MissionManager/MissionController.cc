@@ -1971,10 +1971,11 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
 
     if (visualItem->isSimpleItem()) {
-        // We need to track commandChanged on simple item since recalc has special handling for takeoff command
+        // We need to track commandChanged on simple item since recalc has special handling for takeoff command.
+        // Connect to the item itself rather than its command fact so _deinitVisualItem drops the connection.
         SimpleMissionItem* simpleItem = qobject_cast<SimpleMissionItem*>(visualItem);
         if (simpleItem) {
-            connect(&simpleItem->missionItem()._commandFact, &Fact::valueChanged, this, &MissionController::_itemCommandChanged);
+            connect(simpleItem, &SimpleMissionItem::commandChanged, this, &MissionController::_itemCommandChanged);
         } else {
             qWarning() << "isSimpleItem == true, yet not SimpleMissionItem";
         }
@@ -10,11 +10,16 @@
 #include "PlanManager.h"
 #include "Vehicle.h"
 #include "FirmwarePlugin.h"
+#include "FTPManager.h"
 #include "MAVLinkProtocol.h"
 #include "QGCApplication.h"
 #include "MissionCommandTree.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtEndian>
+
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
 PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
@@ -34,6 +39,13 @@ PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
     _ackTimeoutTimer->setSingleShot(true);
 
     connect(_ackTimeoutTimer, &QTimer::timeout, this, &PlanManager::_ackTimeout);
+
+    _itemRequestTimer = new QTimer(this);
+    _itemRequestTimer->setSingleShot(true);
+
+    connect(_itemRequestTimer, &QTimer::timeout, this, &PlanManager::_missionItemRequestTimeout);
+
+    _itemRequestClock.start();
 }
 
 PlanManager::~PlanManager()
@@ -144,7 +156,101 @@ void PlanManager::loadFromVehicle(void)
     _retryCount = 0;
     _setTransactionInProgress(TransactionRead);
     _connectToMavlink();
-    _requestList();
+    if (!_startFtpRead()) {
+        _requestList();
+    }
+}
+
+/// Starts reading the plan as a single file through MAVLink FTP if the firmware supports it
+/// @return false: FTP is not available, the items must be read with the mission protocol
+bool PlanManager::_startFtpRead(void)
+{
+    const QString path = _vehicle->firmwarePlugin()->missionFtpPath(_planType);
+    if (path.isEmpty() || !_vehicle->capabilitiesKnown() || !(_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_FTP)) {
+        return false;
+    }
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_startFtpRead %1 path:").arg(_planTypeString()) << path;
+
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    connect(ftpManager, &FTPManager::downloadComplete, this, &PlanManager::_ftpDownloadComplete);
+    if (!ftpManager->download(MAV_COMP_ID_AUTOPILOT1, path, QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
+        qCDebug(PlanManagerLog) << QStringLiteral("_startFtpRead %1 FTPManager::download failed").arg(_planTypeString());
+        disconnect(ftpManager, &FTPManager::downloadComplete, this, &PlanManager::_ftpDownloadComplete);
+        return false;
+    }
+    connect(ftpManager, &FTPManager::commandProgress, this, &PlanManager::_ftpDownloadProgress);
+
+    return true;
+}
+
+void PlanManager::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
+{
+    disconnect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &PlanManager::_ftpDownloadComplete);
+    disconnect(_vehicle->ftpManager(), &FTPManager::commandProgress, this, &PlanManager::_ftpDownloadProgress);
+
+    if (_transactionInProgress != TransactionRead) {
+        return;
+    }
+
+    bool success = false;
+    if (errorMsg.isEmpty()) {
+        success = _loadMissionFile(fileName);
+        QFile::remove(fileName);
+    }
+
+    if (success) {
+        qCDebug(PlanManagerLog) << QStringLiteral("_ftpDownloadComplete %1 count:").arg(_planTypeString()) << _missionItems.count();
+        _finishTransaction(true);
+    } else {
+        // Older firmwares don't have the mission files, fall back to the mission protocol
+        qCDebug(PlanManagerLog) << QStringLiteral("_ftpDownloadComplete %1 falling back to MISSION_REQUEST_LIST").arg(_planTypeString()) << errorMsg;
+        _requestList();
+    }
+}
+
+void PlanManager::_ftpDownloadProgress(float progress)
+{
+    emit progressPctChanged(static_cast<double>(progress));
+}
+
+bool PlanManager::_loadMissionFile(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_loadMissionFile %1 open failed").arg(_planTypeString()) << file.errorString();
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+
+    // Header is magic, plan type, options, first sequence number and item count followed by the packed items
+    static constexpr qsizetype headerSize = 5 * sizeof(uint16_t);
+    static constexpr qsizetype itemSize = sizeof(mavlink_mission_item_int_t);
+    if (bytes.size() < headerSize) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_loadMissionFile %1 file too short").arg(_planTypeString()) << bytes.size();
+        return false;
+    }
+
+    const uchar* data = reinterpret_cast<const uchar*>(bytes.constData());
+    const uint16_t magic =      qFromLittleEndian<uint16_t>(data);
+    const uint16_t planType =   qFromLittleEndian<uint16_t>(data + 2);
+    const uint16_t start =      qFromLittleEndian<uint16_t>(data + 6);
+    const uint16_t itemCount =  qFromLittleEndian<uint16_t>(data + 8);
+    if ((magic != kMissionFileMagic) || (planType != _planType) || (bytes.size() != (headerSize + (itemCount * itemSize)))) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_loadMissionFile %1 bad file magic:planType:count:size").arg(_planTypeString()) << magic << planType << itemCount << bytes.size();
+        return false;
+    }
+
+    _clearMissionItems();
+    _missionItems.reserve(itemCount);
+    for (int i=0; i<itemCount; i++) {
+        mavlink_mission_item_int_t missionItem;
+        memcpy(&missionItem, data + headerSize + (i * itemSize), itemSize);
+        missionItem.seq = start + i;
+        _addReceivedMissionItem(missionItem);
+    }
+
+    return true;
 }
 
 /// Internal call to request list of mission items. May be called during a retry sequence.
@@ -155,6 +261,9 @@ void PlanManager::_requestList(void)
     _itemIndicesToRead.clear();
     _clearMissionItems();
 
+    // A MISSION_COUNT can't be matched to one of several MISSION_REQUEST_LIST so only the first one is timed
+    _requestListSentMs = _retryCount == 0 ? _itemRequestClock.elapsed() : -1;
+
     SharedLinkInterfacePtr  sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink){
         mavlink_message_t       message;
@@ -347,7 +456,20 @@ void PlanManager::_handleMissionCount(const mavlink_message_t& message)
             _itemIndicesToRead << i;
         }
         _missionItemCountToRead = missionCount.count;
-        _requestNextMissionItem();
+
+        _pipelinedRead = _vehicle->firmwarePlugin()->supportsPipelinedMissionRead();
+        if (_pipelinedRead) {
+            _itemRequestWindow.reset();
+            _itemRequestRetries.clear();
+            if (_requestListSentMs >= 0) {
+                _itemRequestWindow.addRttSample(_itemRequestClock.elapsed() - _requestListSentMs);
+            }
+            // The ack timeout is not used, each request in the window has its own
+            _expectedAck = AckMissionItem;
+            _fillMissionItemRequestWindow();
+        } else {
+            _requestNextMissionItem();
+        }
     }
 }
 
@@ -360,6 +482,12 @@ void PlanManager::_requestNextMissionItem(void)
 
     qCDebug(PlanManagerLog) << QStringLiteral("_requestNextMissionItem %1 sequenceNumber:retry").arg(_planTypeString()) << _itemIndicesToRead[0] << _retryCount;
 
+    _requestMissionItem(_itemIndicesToRead[0]);
+    _startAckTimeout(AckMissionItem);
+}
+
+void PlanManager::_requestMissionItem(int sequenceNumber)
+{
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
         mavlink_message_t       message;
@@ -370,45 +498,74 @@ void PlanManager::_requestNextMissionItem(void)
                                                   &message,
                                                   _vehicle->id(),
                                                   MAV_COMP_ID_AUTOPILOT1,
-                                                  _itemIndicesToRead[0],
+                                                  sequenceNumber,
                                                   _planType);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
-    _startAckTimeout(AckMissionItem);
 }
 
-void PlanManager::_handleMissionItem(const mavlink_message_t& message)
+/// Pipelined read: requests the items still to be read until the request window is full. Items which
+/// timed out are requested again first since they are at the front of the read list.
+void PlanManager::_fillMissionItemRequestWindow(void)
+{
+    int available = _itemRequestWindow.available();
+    const qint64 nowMs = _itemRequestClock.elapsed();
+
+    for (int i=0; (i<_itemIndicesToRead.count()) && (available > 0); i++) {
+        const int seq = _itemIndicesToRead[i];
+        if (_itemRequestWindow.isInFlight(MAV_COMP_ID_AUTOPILOT1, seq)) {
+            continue;
+        }
+
+        qCDebug(PlanManagerLog) << QStringLiteral("_fillMissionItemRequestWindow %1 sequenceNumber:retry").arg(_planTypeString()) << seq << _itemRequestRetries.value(seq);
+
+        _itemRequestWindow.sent(MAV_COMP_ID_AUTOPILOT1, seq, _itemRequestRetries.contains(seq), nowMs);
+        _requestMissionItem(seq);
+        available--;
+    }
+
+    _startMissionItemRequestTimer();
+}
+
+void PlanManager::_startMissionItemRequestTimer(void)
+{
+    const qint64 nextExpiryMs = _itemRequestWindow.nextExpiryMs();
+    if (nextExpiryMs < 0) {
+        _itemRequestTimer->stop();
+    } else {
+        _itemRequestTimer->start(static_cast<int>(qMax<qint64>(nextExpiryMs - _itemRequestClock.elapsed(), 1)));
+    }
+}
+
+void PlanManager::_missionItemRequestTimeout(void)
 {
-    MAV_CMD          command;
-    MAV_FRAME        frame;
-    MAV_MISSION_TYPE missionType;
-    double           param1;
-    double           param2;
-    double           param3;
-    double           param4;
-    double           param5;
-    double           param6;
-    double           param7;
-    bool             autoContinue;
-    bool             isCurrentItem;
-    int              seq;
+    if (!_pipelinedRead || (_transactionInProgress != TransactionRead)) {
+        return;
+    }
+
+    const QList<RequestWindow::Request> expired = _itemRequestWindow.expire(_itemRequestClock.elapsed());
+    for (const RequestWindow::Request& request : expired) {
+        const int retryCount = ++_itemRequestRetries[request.index];
+        qCDebug(PlanManagerLog) << QStringLiteral("_missionItemRequestTimeout %1 sequenceNumber:retry").arg(_planTypeString()) << request.index << retryCount;
+        if (retryCount > _maxRetryCount) {
+            _sendError(MaxRetryExceeded, tr("Mission read failed, maximum retries exceeded."));
+            _finishTransaction(false);
+            return;
+        }
+    }
+
+    _fillMissionItemRequestWindow();
+}
 
+void PlanManager::_handleMissionItem(const mavlink_message_t& message)
+{
     mavlink_mission_item_int_t missionItem;
     mavlink_msg_mission_item_int_decode(&message, &missionItem);
 
-    command =       (MAV_CMD)missionItem.command;
-    frame =         (MAV_FRAME)missionItem.frame;
-    missionType =   (MAV_MISSION_TYPE)missionItem.mission_type;
-    param1 =        missionItem.param1;
-    param2 =        missionItem.param2;
-    param3 =        missionItem.param3;
-    param4 =        missionItem.param4;
-    param5 =        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.x : (double)missionItem.x * 1e-7;
-    param6 =        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.y : (double)missionItem.y * 1e-7;
-    param7 =        (double)missionItem.z;
-    autoContinue =  missionItem.autocontinue;
-    isCurrentItem = missionItem.current;
-    seq =           missionItem.seq;
+    const MAV_CMD           command =       (MAV_CMD)missionItem.command;
+    const MAV_MISSION_TYPE  missionType =   (MAV_MISSION_TYPE)missionItem.mission_type;
+    const bool              isCurrentItem = missionItem.current;
+    const int               seq =           missionItem.seq;
 
     // Check the mission_type field. It can happen that we receive a late duplicate message for a
     // different mission_type request.
@@ -417,13 +574,6 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
        return;
     }
 
-    // We don't support editing ALT_INT frames so change on the way in.
-    if (frame == MAV_FRAME_GLOBAL_INT) {
-        frame = MAV_FRAME_GLOBAL;
-    } else if (frame == MAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-        frame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
-    }
-
     bool ardupilotHomePositionUpdate = false;
     if (!_checkForExpectedAck(AckMissionItem)) {
         if (_vehicle->apmFirmware() && seq ==  0 && _planType == MAV_MISSION_TYPE_MISSION) {
@@ -437,51 +587,83 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 seq:command:current:ardupilotHomePositionUpdate").arg(_planTypeString()) << seq << command << isCurrentItem << ardupilotHomePositionUpdate;
 
     if (ardupilotHomePositionUpdate) {
-        QGeoCoordinate newHomePosition(param5, param6, param7);
+        QGeoCoordinate newHomePosition(missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.x : (double)missionItem.x * 1e-7,
+                                       missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.y : (double)missionItem.y * 1e-7,
+                                       (double)missionItem.z);
         _vehicle->_setHomePosition(newHomePosition);
         return;
     }
 
+    if (_pipelinedRead) {
+        (void) _itemRequestWindow.received(MAV_COMP_ID_AUTOPILOT1, seq, _itemRequestClock.elapsed());
+    }
+
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
-
-        MissionItem* item = new MissionItem(seq,
-                                            command,
-                                            frame,
-                                            param1,
-                                            param2,
-                                            param3,
-                                            param4,
-                                            param5,
-                                            param6,
-                                            param7,
-                                            autoContinue,
-                                            isCurrentItem,
-                                            this);
-
-        if (item->command() == MAV_CMD_DO_JUMP && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle()) {
-            // Home is in position 0
-            item->setParam1((int)item->param1() + 1);
-        }
-
-        _missionItems.append(item);
+        _itemRequestRetries.remove(seq);
+        _addReceivedMissionItem(missionItem);
     } else {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 mission item received item index which was not requested, disregrarding:").arg(_planTypeString()) << seq;
         // We have to put the ack timeout back since it was removed above
-        _startAckTimeout(AckMissionItem);
+        if (_pipelinedRead) {
+            _expectedAck = AckMissionItem;
+        } else {
+            _startAckTimeout(AckMissionItem);
+        }
         return;
     }
 
-    emit progressPctChanged((double)seq / (double)_missionItemCountToRead);
+    emit progressPctChanged((double)_missionItems.count() / (double)_missionItemCountToRead);
 
     _retryCount = 0;
     if (_itemIndicesToRead.count() == 0) {
         _readTransactionComplete();
+    } else if (_pipelinedRead) {
+        _expectedAck = AckMissionItem;
+        _fillMissionItemRequestWindow();
     } else {
         _requestNextMissionItem();
     }
 }
 
+void PlanManager::_addReceivedMissionItem(const mavlink_mission_item_int_t& missionItem)
+{
+    MAV_FRAME frame = (MAV_FRAME)missionItem.frame;
+
+    // We don't support editing ALT_INT frames so change on the way in.
+    if (frame == MAV_FRAME_GLOBAL_INT) {
+        frame = MAV_FRAME_GLOBAL;
+    } else if (frame == MAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
+        frame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
+    }
+
+    MissionItem* item = new MissionItem(missionItem.seq,
+                                        (MAV_CMD)missionItem.command,
+                                        frame,
+                                        missionItem.param1,
+                                        missionItem.param2,
+                                        missionItem.param3,
+                                        missionItem.param4,
+                                        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.x : (double)missionItem.x * 1e-7,
+                                        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.y : (double)missionItem.y * 1e-7,
+                                        (double)missionItem.z,
+                                        missionItem.autocontinue,
+                                        missionItem.current,
+                                        this);
+
+    if (item->command() == MAV_CMD_DO_JUMP && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle()) {
+        // Home is in position 0
+        item->setParam1((int)item->param1() + 1);
+    }
+
+    // Items arrive out of order during a pipelined read, keep the list in sequence order
+    int index = _missionItems.count();
+    while (index > 0 && _missionItems[index - 1]->sequenceNumber() > item->sequenceNumber()) {
+        index--;
+    }
+    _missionItems.insert(index, item);
+}
+
 void PlanManager::_clearMissionItems(void)
 {
     _itemIndicesToRead.clear();
@@ -814,6 +996,12 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
     _itemIndicesToRead.clear();
     _itemIndicesToWrite.clear();
 
+    _pipelinedRead = false;
+    _itemRequestTimer->stop();
+    _itemRequestWindow.reset();
+    _itemRequestRetries.clear();
+    _requestListSentMs = -1;
+
     // First thing we do is clear the transaction. This way inProgesss is off when we signal transaction complete.
     TransactionType_t currentTransactionType = _transactionInProgress;
     _setTransactionInProgress(TransactionNone);
@@ -11,10 +11,13 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMap>
 
 #include "MissionItem.h"
 #include "QGCMAVLink.h"
+#include "RequestWindow.h"
 
 class Vehicle;
 
@@ -88,6 +91,9 @@ class PlanManager : public QObject
 private slots:
     void _mavlinkMessageReceived(const mavlink_message_t& message);
     void _ackTimeout(void);
+    void _missionItemRequestTimeout(void);
+    void _ftpDownloadComplete(const QString& fileName, const QString& errorMsg);
+    void _ftpDownloadProgress(float progress);
 
 protected:
     typedef enum {
@@ -114,6 +120,14 @@ private slots:
     void _handleMissionRequest(const mavlink_message_t& message);
     void _handleMissionAck(const mavlink_message_t& message);
     void _requestNextMissionItem(void);
+    void _requestMissionItem(int sequenceNumber);
+    void _fillMissionItemRequestWindow(void);
+    void _startMissionItemRequestTimer(void);
+    /// Creates the MissionItem for an item received from the vehicle and adds it in sequence order
+    void _addReceivedMissionItem(const mavlink_mission_item_int_t& missionItem);
+    bool _startFtpRead(void);
+    /// Loads the items from a file in the ArduPilot mission file format
+    bool _loadMissionFile(const QString& fileName);
     void _clearMissionItems(void);
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
     QString _ackTypeToString(AckType_t ackType);
@@ -150,6 +164,15 @@ private slots:
     int                 _currentMissionIndex;
     int                 _lastCurrentIndex;
 
+    bool                    _pipelinedRead =        false;  ///< true: Several MISSION_REQUEST_INT are in flight during the read
+    RequestWindow           _itemRequestWindow;             ///< MISSION_REQUEST_INT in flight during a pipelined read, keyed by sequence number
+    QMap<int, int>          _itemRequestRetries;            ///< Sequence number, retry count of the items which timed out
+    QTimer*                 _itemRequestTimer =     nullptr;
+    QElapsedTimer           _itemRequestClock;
+    qint64                  _requestListSentMs =    -1;     ///< -1: the MISSION_REQUEST_LIST round trip is not being timed
+
+    static constexpr uint16_t kMissionFileMagic = 0x763d;   ///< ArduPilot mission file header magic
+
 private:
     void _setTransactionInProgress(TransactionType_t type);
 };
@@ -36,13 +36,6 @@ SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, boo
     , _supportedCommandFact             (0, "Command:",             FactMetaData::valueTypeUint32)
     , _altitudeFact                     (0, "Altitude",             FactMetaData::valueTypeDouble)
     , _amslAltAboveTerrainFact          (0, "Alt above terrain",    FactMetaData::valueTypeDouble)
-    , _param1MetaData                   (FactMetaData::valueTypeDouble)
-    , _param2MetaData                   (FactMetaData::valueTypeDouble)
-    , _param3MetaData                   (FactMetaData::valueTypeDouble)
-    , _param4MetaData                   (FactMetaData::valueTypeDouble)
-    , _param5MetaData                   (FactMetaData::valueTypeDouble)
-    , _param6MetaData                   (FactMetaData::valueTypeDouble)
-    , _param7MetaData                   (FactMetaData::valueTypeDouble)
 {
     _editorQml = QStringLiteral("qrc:/qml/QGroundControl/Controls/SimpleItemEditor.qml");
 
@@ -64,13 +57,6 @@ SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, boo
     , _supportedCommandFact     (0,         "Command:",             FactMetaData::valueTypeUint32)
     , _altitudeFact             (0,         "Altitude",             FactMetaData::valueTypeDouble)
     , _amslAltAboveTerrainFact  (0,         "Alt above terrain",    FactMetaData::valueTypeDouble)
-    , _param1MetaData           (FactMetaData::valueTypeDouble)
-    , _param2MetaData           (FactMetaData::valueTypeDouble)
-    , _param3MetaData           (FactMetaData::valueTypeDouble)
-    , _param4MetaData           (FactMetaData::valueTypeDouble)
-    , _param5MetaData           (FactMetaData::valueTypeDouble)
-    , _param6MetaData           (FactMetaData::valueTypeDouble)
-    , _param7MetaData           (FactMetaData::valueTypeDouble)
 {
     _editorQml = QStringLiteral("qrc:/qml/QGroundControl/Controls/SimpleItemEditor.qml");
 
@@ -178,6 +164,7 @@ void SimpleMissionItem::_connectSignals(void)
     connect(this,                               &SimpleMissionItem::commandChanged,         this, &SimpleMissionItem::_rebuildFacts);
     connect(this,                               &SimpleMissionItem::rawEditChanged,         this, &SimpleMissionItem::_rebuildFacts);
     connect(this,                               &SimpleMissionItem::previousVTOLModeChanged,this, &SimpleMissionItem::_rebuildFacts);
+    connect(this,                               &SimpleMissionItem::isCurrentItemChanged,   this, &SimpleMissionItem::_rebuildFacts);
 
     // The following changes must signal currentVTOLModeChanged to cause a MissionController recalc
     connect(this,                               &SimpleMissionItem::commandChanged,         this, &SimpleMissionItem::_signalIfVTOLTransitionCommand);
@@ -250,24 +237,26 @@ SimpleMissionItem::~SimpleMissionItem()
 
 void SimpleMissionItem::save(QJsonArray&  missionItems)
 {
-    QList<MissionItem*> items;
+    // The main simple item is saved as is, there is no need to copy it like appendMissionItems does
+    QJsonObject saveObject;
+    _missionItem.save(saveObject);
+    if (specifiesAltitude()) {
+        saveObject[_jsonAltitudeModeKey] =          _altitudeMode;
+        saveObject[_jsonAltitudeKey] =              _altitudeFact.rawValue().toDouble();
+        saveObject[_jsonAMSLAltAboveTerrainKey] =   _amslAltAboveTerrainFact.rawValue().toDouble();
+    }
+    missionItems.append(saveObject);
 
-    appendMissionItems(items, this);
-
-    for (int i=0; i<items.count(); i++) {
-        MissionItem* item = items[i];
-        QJsonObject saveObject;
-        item->save(saveObject);
-        if (i == 0) {
-            // This is the main simple item, save the alt/terrain data
-            if (specifiesAltitude()) {
-                saveObject[_jsonAltitudeModeKey] =          _altitudeMode;
-                saveObject[_jsonAltitudeKey] =              _altitudeFact.rawValue().toDouble();
-                saveObject[_jsonAMSLAltAboveTerrainKey] =   _amslAltAboveTerrainFact.rawValue().toDouble();
-            }
-        }
-        missionItems.append(saveObject);
-        item->deleteLater();
+    QList<MissionItem*> items;
+    int seqNum = sequenceNumber() + 1;
+    _cameraSection->appendSectionItems(items, nullptr, seqNum);
+    _speedSection->appendSectionItems(items, nullptr, seqNum);
+
+    for (MissionItem* item: items) {
+        QJsonObject sectionSaveObject;
+        item->save(sectionSaveObject);
+        missionItems.append(sectionSaveObject);
+        delete item;
     }
 }
 
@@ -440,7 +429,6 @@ void SimpleMissionItem::_rebuildTextFieldFacts(void)
         }
 
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         const MissionCommandUIInfo* uiInfo = MissionCommandTree::instance()->getUIInfo(_controllerVehicle, _previousVTOLMode, command);
 
@@ -451,7 +439,7 @@ void SimpleMissionItem::_rebuildTextFieldFacts(void)
 
                 if (showUI && paramInfo && paramInfo->enumStrings().count() == 0 && !paramInfo->nanUnchanged()) {
                     Fact*               paramFact =     rgParamFacts[i-1];
-                    FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                    FactMetaData*       paramMetaData = _paramMetaData(i);
 
                     paramFact->setName(paramInfo->label());
                     paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
@@ -484,7 +472,6 @@ void SimpleMissionItem::_rebuildNaNFacts(void)
         }
 
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         const MissionCommandUIInfo* uiInfo = MissionCommandTree::instance()->getUIInfo(_controllerVehicle, _previousVTOLMode, command);
 
@@ -502,7 +489,7 @@ void SimpleMissionItem::_rebuildNaNFacts(void)
                     }
 
                     Fact*               paramFact =     rgParamFacts[i-1];
-                    FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                    FactMetaData*       paramMetaData = _paramMetaData(i);
 
                     paramFact->setName(paramInfo->label());
                     paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
@@ -572,7 +559,6 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
         _ignoreDirtyChangeSignals = true;
 
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         MAV_CMD command;
         if (_homePositionSpecialCase) {
@@ -587,7 +573,7 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
 
             if (showUI && paramInfo && paramInfo->enumStrings().count() != 0) {
                 Fact*               paramFact =     rgParamFacts[i-1];
-                FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                FactMetaData*       paramMetaData = _paramMetaData(i);
 
                 paramFact->setName(paramInfo->label());
                 paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
@@ -607,11 +593,30 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
 
 void SimpleMissionItem::_rebuildFacts(void)
 {
+    // The editor facts are only used by the item editor which only exists for the current item. Building them
+    // for every item makes large plans slow to load.
+    if (_flyView || !_isCurrentItem) {
+        _textFieldFacts.clear();
+        _nanFacts.clear();
+        _comboboxFacts.clear();
+        return;
+    }
+
     _rebuildTextFieldFacts();
     _rebuildNaNFacts();
     _rebuildComboBoxFacts();
 }
 
+FactMetaData* SimpleMissionItem::_paramMetaData(int param)
+{
+    // Once created the meta data stays, the param fact still points to it after the editor facts are cleared
+    FactMetaData*& paramMetaData = _rgParamMetaData[param-1];
+    if (!paramMetaData) {
+        paramMetaData = new FactMetaData(FactMetaData::valueTypeDouble, this);
+    }
+    return paramMetaData;
+}
+
 bool SimpleMissionItem::friendlyEditAllowed(void) const
 {
     const MissionCommandUIInfo* uiInfo = MissionCommandTree::instance()->getUIInfo(_controllerVehicle, _previousVTOLMode, static_cast<MAV_CMD>(command()));
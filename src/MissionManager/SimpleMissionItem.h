@@ -173,6 +173,7 @@ private slots:
     void _updateOptionalSections(void);
     void _rebuildNaNFacts       (void);
     void _rebuildComboBoxFacts  (void);
+    FactMetaData* _paramMetaData(int param);
 
     MissionItem     _missionItem;
     bool            _rawEdit =                  false;
@@ -201,13 +202,7 @@ private slots:
     static FactMetaData*    _latitudeMetaData;
     static FactMetaData*    _longitudeMetaData;
 
-    FactMetaData    _param1MetaData;
-    FactMetaData    _param2MetaData;
-    FactMetaData    _param3MetaData;
-    FactMetaData    _param4MetaData;
-    FactMetaData    _param5MetaData;
-    FactMetaData    _param6MetaData;
-    FactMetaData    _param7MetaData;
+    FactMetaData*   _rgParamMetaData[7] = { };  ///< Created the first time the item is edited, see _paramMetaData
 
     static constexpr const char* _jsonAltitudeModeKey =           "AltitudeMode";
     static constexpr const char* _jsonAltitudeKey =               "Altitude";
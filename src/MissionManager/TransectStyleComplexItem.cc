@@ -722,35 +722,6 @@ double TransectStyleComplexItem::_altitudeBetweenCoords(const QGeoCoordinate& fr
     return fromAlt + (altDiff * percentTowardsTo);
 }
 
-/// Determine the maximum height within the PathHeightInfo
-///     @param fromIndex First height index to consider
-///     @param fromIndex Last height index to consider
-///     @param[out] maxHeight Maximum height
-/// @return index within PathHeightInfo_t.heights which contains maximum height, -1 no height data in between from and to indices
-int TransectStyleComplexItem::_maxPathHeight(const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo, int fromIndex, int toIndex, double& maxHeight)
-{
-    maxHeight = qQNaN();
-
-    if (toIndex - fromIndex < 2) {
-        return -1;
-    }
-
-    fromIndex++;
-    toIndex--;
-
-    int maxIndex = fromIndex;
-    maxHeight = pathHeightInfo.heights[fromIndex];
-
-    for (int i=fromIndex; i<=toIndex; i++) {
-        if (pathHeightInfo.heights[i] > maxHeight) {
-            maxIndex = i;
-            maxHeight = pathHeightInfo.heights[i];
-        }
-    }
-
-    return maxIndex;
-}
-
 void TransectStyleComplexItem::_adjustForMaxRates(void)
 {
     double maxClimbRate     = _terrainAdjustMaxClimbRateFact.rawValue().toDouble();
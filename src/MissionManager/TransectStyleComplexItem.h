@@ -237,7 +237,6 @@ private slots:
     void    _adjustForMaxRates                                              (void);
     void    _adjustForTolerance                                             (void);
     double  _altitudeBetweenCoords                                          (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double percentTowardsTo);
-    int     _maxPathHeight                                                  (const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo, int fromIndex, int toIndex, double& maxHeight);
     BuildMissionItemsState_t _buildMissionItemsState                        (void) const;
 
     TerrainPolyPathQuery*       _currentTerrainPolyPathQuery        = nullptr;
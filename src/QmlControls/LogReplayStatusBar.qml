@@ -71,13 +71,26 @@ Rectangle {
                 ListElement { text: "2x";   value: 2 }
                 ListElement { text: "5x";   value: 5 }
                 ListElement { text: "10x";  value: 10 }
+                ListElement { text: "Max";  value: 0 }
             }
 
-            onActivated: (index) => { controller.playbackSpeed = model.get(currentIndex).value }
+            // A value of 0 replays as fast as the received messages can be processed
+            onActivated: (index) => {
+                var value = model.get(currentIndex).value
+                controller.maxThroughput = (value === 0)
+                if (value !== 0) {
+                    controller.playbackSpeed = value
+                }
+            }
         }
 
         QGCLabel { text: controller.playheadTime }
 
+        QGCLabel {
+            text: qsTr("%1 msgs/s").arg(controller.messagesPerSecond.toFixed(0))
+            visible: controller.maxThroughput && controller.link
+        }
+
         Slider {
             id: slider
             Layout.fillWidth: true
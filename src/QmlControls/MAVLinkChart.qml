@@ -50,6 +50,7 @@ ChartView {
         id:                     chartController
         inspectorController:    chartView.inspectorController
         chartIndex:             chartView.chartIndex
+        plotWidth:              chartView.plotArea.width
     }
 
     DateTimeAxis {
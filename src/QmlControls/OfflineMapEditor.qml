@@ -239,6 +239,7 @@ FlightMap {
                     anchors.left:   parent.left
                     anchors.right:  parent.right
                     visible:        !_defaultSet
+                    readOnly:       tileSet && tileSet.archive
                     text:           tileSet ? tileSet.name : ""
                 }
                 QGCLabel {
@@ -249,6 +250,8 @@ FlightMap {
                         if(tileSet) {
                             if(tileSet.defaultSet)
                                 return qsTr("System Wide Tile Cache");
+                            else if(tileSet.archive)
+                                return "(" + tileSet.mapTypeStr + ", " + qsTr("Archive") + ")"
                             else
                                 return "(" + tileSet.mapTypeStr + ")"
                         } else
@@ -293,6 +296,13 @@ FlightMap {
                     QGCLabel {  text: qsTr("Error Count:"); width: infoView._labelWidth; }
                     QGCLabel {  text: tileSet ? tileSet.errorCountStr : ""; horizontalAlignment: Text.AlignRight; width: infoView._valueWidth; }
                 }
+                Row {
+                    spacing:    ScreenTools.defaultFontPixelWidth
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    visible:    tileSet && !_defaultSet && tileSet.downloading && tileSet.downloadRate > 0
+                    QGCLabel {  text: qsTr("Download Rate:"); width: infoView._labelWidth; }
+                    QGCLabel {  text: tileSet ? qsTr("%1 tiles/s").arg(tileSet.downloadRate.toFixed(1)) : ""; horizontalAlignment: Text.AlignRight; width: infoView._valueWidth; }
+                }
                 //-- Default Tile Set
                 Row {
                     spacing:    ScreenTools.defaultFontPixelWidth
@@ -754,7 +764,9 @@ FlightMap {
             title:      qsTr("Confirm Delete")
             text:       tileSet.defaultSet ?
                             qsTr("This will delete all tiles INCLUDING the tile sets you have created yourself.\n\nIs this really what you want?") :
-                            qsTr("Delete %1 and all its tiles.\n\nIs this really what you want?").arg(tileSet.name)
+                            (tileSet.archive ?
+                                qsTr("Stop serving tiles from %1. The archive file is kept.\n\nIs this really what you want?").arg(tileSet.name) :
+                                qsTr("Delete %1 and all its tiles.\n\nIs this really what you want?").arg(tileSet.name))
             buttons:    Dialog.Yes | Dialog.No
 
             onAccepted: {
@@ -9,16 +9,14 @@
 
 #include "QGCCachedTileSet.h"
 
-#include <QtNetwork/QNetworkProxy>
-
 #include "ElevationMapProvider.h"
 #include "QGCApplication.h"
-#include "QGCFileDownload.h"
 #include "QGCLoggingCategory.h"
 #include "QGCMapEngine.h"
 #include "QGCMapEngineManager.h"
 #include "QGCMapTasks.h"
 #include "QGCMapUrlEngine.h"
+#include "QGCTileDownloader.h"
 #include "QGeoFileTileCacheQGC.h"
 #include "QGeoTileFetcherQGC.h"
 
@@ -60,9 +58,12 @@ void QGCCachedTileSet::createDownloadTask()
         setErrorCount(0);
         setDownloading(true);
         _noMoreTiles = false;
+        _downloadRowID = 0;
+        _rateTimer.invalidate();
+        setDownloadRate(0.);
     }
 
-    QGCGetTileDownloadListTask *task = new QGCGetTileDownloadListTask(_id, kTileBatchSize);
+    QGCGetTileDownloadListTask *task = new QGCGetTileDownloadListTask(_id, kTileBatchSize, _downloadRowID);
     (void) connect(task, &QGCGetTileDownloadListTask::tileListFetched, this, &QGCCachedTileSet::_tileListFetched);
     if (_manager) {
         (void) connect(task, &QGCMapTask::error, _manager, &QGCMapEngineManager::taskError);
@@ -92,30 +93,38 @@ void QGCCachedTileSet::resumeDownloadTask()
 void QGCCachedTileSet::cancelDownloadTask()
 {
     _cancelPending = true;
+
+    // Requests in flight still complete, what they save is off the download list for the next resume
+    if (_downloader) {
+        _downloader->clearPending();
+        if (_downloader->isIdle() && !_batchRequested) {
+            createDownloadTask();
+        }
+    }
 }
 
-void QGCCachedTileSet::_tileListFetched(const QQueue<QGCTile*> &tiles)
+void QGCCachedTileSet::_tileListFetched(const QQueue<QGCTile*> &tiles, qint64 lastRowID)
 {
     _batchRequested = false;
+    _downloadRowID = lastRowID;
     if (tiles.size() < kTileBatchSize) {
         _noMoreTiles = true;
     }
 
-    if (tiles.isEmpty()) {
-        _doneWithDownload();
+    if (_cancelPending) {
+        qDeleteAll(tiles);
+        setDownloading(false);
         return;
     }
 
-    if (!_networkManager) {
-        _networkManager = new QNetworkAccessManager(this);
-#if !defined(Q_OS_IOS) && !defined(Q_OS_ANDROID)
-        QNetworkProxy proxy = _networkManager->proxy();
-        proxy.setType(QNetworkProxy::DefaultProxy);
-        _networkManager->setProxy(proxy);
-#endif
+    if (!_downloader) {
+        _downloader = new QGCTileDownloader(this);
+        _downloader->setConcurrency(QGeoTileFetcherQGC::concurrentDownloads(_type));
+        (void) connect(_downloader, &QGCTileDownloader::tileDownloaded, this, &QGCCachedTileSet::_tileDownloaded);
+        (void) connect(_downloader, &QGCTileDownloader::tileFailed, this, &QGCCachedTileSet::_tileFailed);
     }
 
-    _tilesToDownload.append(tiles);
+    _downloader->enqueue(tiles);
     _prepareDownload();
 }
 
@@ -136,13 +145,36 @@ void QGCCachedTileSet::_doneWithDownload()
     }
 
     setDownloading(false);
+    _rateTimer.invalidate();
+    setDownloadRate(0.);
 
     emit completeChanged();
 }
 
+void QGCCachedTileSet::_updateDownloadRate()
+{
+    if (!_rateTimer.isValid()) {
+        _rateTimer.start();
+        _rateTileCount = _savedTileCount;
+        return;
+    }
+
+    const qint64 elapsed = _rateTimer.elapsed();
+    if (elapsed < kRateInterval) {
+        return;
+    }
+
+    // Smoothed over several intervals so bursts of replies don't make the rate jump around
+    const double rate = (_savedTileCount - _rateTileCount) * 1000. / elapsed;
+    setDownloadRate((_downloadRate > 0.) ? (_downloadRate + (kRateSmoothing * (rate - _downloadRate))) : rate);
+
+    (void) _rateTimer.restart();
+    _rateTileCount = _savedTileCount;
+}
+
 void QGCCachedTileSet::_prepareDownload()
 {
-    if (_tilesToDownload.isEmpty()) {
+    if (!_downloader || _downloader->isIdle()) {
         if (_noMoreTiles) {
             _doneWithDownload();
         } else if (!_batchRequested) {
@@ -151,65 +183,20 @@ void QGCCachedTileSet::_prepareDownload()
         return;
     }
 
-    for (qsizetype i = _replies.count(); i < QGeoTileFetcherQGC::concurrentDownloads(_type); i++) {
-        if (_tilesToDownload.isEmpty()) {
-            break;
-        }
-
-        QGCTile* const tile = _tilesToDownload.dequeue();
-        const int mapId = UrlFactory::getQtMapIdFromProviderType(tile->type);
-        QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(mapId, tile->x, tile->y, tile->z);
-        request.setOriginatingObject(this);
-        request.setAttribute(QNetworkRequest::User, tile->hash);
-
-        QNetworkReply* const reply = _networkManager->get(request);
-        reply->setParent(this);
-        QGCFileDownload::setIgnoreSSLErrorsIfNeeded(*reply);
-        (void) connect(reply, &QNetworkReply::finished, this, &QGCCachedTileSet::_networkReplyFinished);
-        (void) connect(reply, &QNetworkReply::errorOccurred, this, &QGCCachedTileSet::_networkReplyError);
-        (void) _replies.insert(tile->hash, reply);
-
-        delete tile;
-        if (!_batchRequested && !_noMoreTiles && (_tilesToDownload.count() < (QGeoTileFetcherQGC::concurrentDownloads(_type) * 10))) {
-            createDownloadTask();
-        }
+    // Keep the next batch listed before the queue runs dry
+    if (!_batchRequested && !_noMoreTiles && (_downloader->pendingCount() < (_downloader->concurrency() * 10))) {
+        createDownloadTask();
     }
 }
 
-void QGCCachedTileSet::_networkReplyFinished()
+void QGCCachedTileSet::_tileDownloaded(const QString &hash, const QByteArray &data)
 {
-    QNetworkReply* const reply = qobject_cast<QNetworkReply*>(QObject::sender());
-    if (!reply) {
-        qCWarning(QGCCachedTileSetLog) << "NULL Reply";
-        return;
-    }
-    reply->deleteLater();
-
-    if (reply->error() != QNetworkReply::NoError) {
-        return;
-    }
-
-    if (!reply->isOpen()) {
-        qCWarning(QGCCachedTileSetLog) << "Empty Reply";
-        return;
-    }
-
-    const QString hash = reply->request().attribute(QNetworkRequest::User).toString();
-    if (hash.isEmpty()) {
-        qCWarning(QGCCachedTileSetLog) << "Empty Hash";
-        return;
-    }
-
-    if (_replies.contains(hash)) {
-        (void) _replies.remove(hash);
-    } else {
-        qCWarning(QGCCachedTileSetLog) << "Reply not in list: " << hash;
-    }
     qCDebug(QGCCachedTileSetLog) << "Tile fetched:" << hash;
 
-    QByteArray image = reply->readAll();
+    QByteArray image = data;
     if (image.isEmpty()) {
         qCWarning(QGCCachedTileSetLog) << "Empty Image";
+        _prepareDownload();
         return;
     }
 
@@ -222,6 +209,7 @@ void QGCCachedTileSet::_networkReplyFinished()
         image = elevationProvider->serialize(image);
         if (image.isEmpty()) {
             qCWarning(QGCCachedTileSetLog) << "Failed to Serialize Terrain Tile";
+            _prepareDownload();
             return;
         }
     }
@@ -229,16 +217,13 @@ void QGCCachedTileSet::_networkReplyFinished()
     const QString format = mapProvider->getImageFormat(image);
     if (format.isEmpty()) {
         qCWarning(QGCCachedTileSetLog) << "Empty Format";
+        _prepareDownload();
         return;
     }
 
+    // Also takes the tile off the set's download list
     QGeoFileTileCacheQGC::cacheTile(type, hash, image, format, _id);
 
-    QGCUpdateTileDownloadStateTask *task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, hash);
-    if (!getQGCMapEngine()->addTask(task)) {
-        task->deleteLater();
-    }
-
     setSavedTileSize(_savedTileSize + image.size());
     setSavedTileCount(_savedTileCount + 1);
 
@@ -248,40 +233,18 @@ void QGCCachedTileSet::_networkReplyFinished()
         setUniqueTileSize(avg * _uniqueTileCount);
     }
 
+    _updateDownloadRate();
     _prepareDownload();
 }
 
-void QGCCachedTileSet::_networkReplyError(QNetworkReply::NetworkError error)
+void QGCCachedTileSet::_tileFailed(const QString &hash, const QString &errorString)
 {
-    QNetworkReply* const reply = qobject_cast<QNetworkReply*>(QObject::sender());
-    if (!reply) {
-        return;
-    }
-    qCDebug(QGCCachedTileSetLog) << "Error fetching tile" << reply->errorString();
+    qCWarning(QGCCachedTileSetLog) << "Error fetching tile" << hash << errorString;
 
+    // The tile stays on the download list, the next resume retries it
     setErrorCount(_errorCount + 1);
 
-    const QString hash = reply->request().attribute(QNetworkRequest::User).toString();
-    if (hash.isEmpty()) {
-        qCWarning(QGCCachedTileSetLog) << "Empty Hash";
-        return;
-    }
-
-    if (_replies.contains(hash)) {
-        (void) _replies.remove(hash);
-    } else {
-        qCWarning(QGCCachedTileSetLog) << "Reply not in list:" << hash;
-    }
-
-    if (error != QNetworkReply::OperationCanceledError) {
-        qCWarning(QGCCachedTileSetLog) << "Error:" << reply->errorString();
-    }
-
-    QGCUpdateTileDownloadStateTask *task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateError, hash);
-    if (!getQGCMapEngine()->addTask(task)) {
-        task->deleteLater();
-    }
-
+    _updateDownloadRate();
     _prepareDownload();
 }
 
@@ -10,18 +10,17 @@
 #pragma once
 
 #include <QtCore/QDateTime>
-#include <QtCore/QHash>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
 #include <QtCore/QString>
-#include <QtNetwork/QNetworkReply>
 
 Q_DECLARE_LOGGING_CATEGORY(QGCCachedTileSetLog)
 
 class QGCTile;
 class QGCMapEngineManager;
-class QNetworkAccessManager;
+class QGCTileDownloader;
 
 class QGCCachedTileSet : public QObject
 {
@@ -49,9 +48,11 @@ class QGCCachedTileSet : public QObject
     Q_PROPERTY(quint64      savedTileSize       READ    savedTileSize       NOTIFY savedTileSizeChanged)
     Q_PROPERTY(QString      savedTileSizeStr    READ    savedTileSizeStr    NOTIFY savedTileSizeChanged)
     Q_PROPERTY(QString      downloadStatus      READ    downloadStatus      NOTIFY savedTileSizeChanged)
+    Q_PROPERTY(double       downloadRate        READ    downloadRate        NOTIFY downloadRateChanged)
     Q_PROPERTY(QDateTime    creationDate        READ    creationDate        CONSTANT)
     Q_PROPERTY(bool         complete            READ    complete            NOTIFY completeChanged)
     Q_PROPERTY(bool         defaultSet          READ    defaultSet          CONSTANT)
+    Q_PROPERTY(bool         archive             READ    archive             CONSTANT)
     Q_PROPERTY(quint64      id                  READ    id                  CONSTANT)
     Q_PROPERTY(bool         deleting            READ    deleting            NOTIFY deletingChanged)
     Q_PROPERTY(bool         downloading         READ    downloading         NOTIFY downloadingChanged)
@@ -89,6 +90,8 @@ class QGCCachedTileSet : public QObject
     QString savedTileSizeStr() const;
 
     QString downloadStatus() const;
+    /// Sustained tiles per second of the running download
+    double downloadRate() const { return _downloadRate; }
     int minZoom() const { return _minZoom; }
     int maxZoom() const { return _maxZoom; }
     const QDateTime &creationDate() const { return _creationDate; }
@@ -96,6 +99,9 @@ class QGCCachedTileSet : public QObject
     const QString &type() const { return _type; }
     bool complete() const { return (_defaultSet || (_totalTileCount <= _savedTileCount)); }
     bool defaultSet() const { return _defaultSet; }
+    /// Served from a mounted MBTiles or PMTiles file instead of the cache database
+    bool archive() const { return !_archivePath.isEmpty(); }
+    const QString &archivePath() const { return _archivePath; }
     bool deleting() const { return _deleting; }
     bool downloading() const { return _downloading; }
     quint32 errorCount() const { return _errorCount; }
@@ -125,9 +131,11 @@ class QGCCachedTileSet : public QObject
     void setId(quint64 id) { _id = id; }
     void setType(const QString &type) { _type = type; }
     void setDefaultSet(bool def) { _defaultSet = def; }
+    void setArchivePath(const QString &path) { _archivePath = path; }
     void setDeleting(bool del) { if (del != _deleting) { _deleting = del; emit deletingChanged(); } }
     void setDownloading(bool down) { if (down != _downloading) { _downloading = down; emit downloadingChanged(); } }
     void setErrorCount(quint32 count) { if (count != _errorCount) { _errorCount = count; emit errorCountChanged(); } }
+    void setDownloadRate(double rate) { if (rate != _downloadRate) { _downloadRate = rate; emit downloadRateChanged(); } }
 
 signals:
     void deletingChanged();
@@ -140,21 +148,24 @@ class QGCCachedTileSet : public QObject
     void savedTileSizeChanged();
     void completeChanged();
     void errorCountChanged();
+    void downloadRateChanged();
     void selectedChanged();
     void nameChanged();
 
 private slots:
-    void _tileListFetched(const QQueue<QGCTile*> &tiles);
-    void _networkReplyFinished();
-    void _networkReplyError(QNetworkReply::NetworkError error);
+    void _tileListFetched(const QQueue<QGCTile*> &tiles, qint64 lastRowID);
+    void _tileDownloaded(const QString &hash, const QByteArray &data);
+    void _tileFailed(const QString &hash, const QString &errorString);
 
 private:
     void _prepareDownload();
     void _doneWithDownload();
+    void _updateDownloadRate();
 
     QString _name;
     QString _mapTypeStr;
     QString _type = QStringLiteral("Invalid");
+    QString _archivePath;
     quint64 _id = 0;
     double _topleftLat = 0.;
     double _topleftLon = 0.;
@@ -167,6 +178,10 @@ private slots:
     quint32 _savedTileCount = 0;
     quint64 _savedTileSize = 0;
     quint32 _errorCount = 0;
+    double _downloadRate = 0.;
+    quint32 _rateTileCount = 0;     ///< Saved tiles when _rateTimer was started
+    QElapsedTimer _rateTimer;
+    qint64 _downloadRowID = 0;      ///< Tiles listed up to here are downloading or saved
     int _minZoom = 3;
     int _maxZoom = 3;
     bool _defaultSet = false;
@@ -178,10 +193,10 @@ private slots:
     bool _cancelPending = false;
     QDateTime _creationDate;
 
-    QHash<QString, QNetworkReply*> _replies;
-    QQueue<QGCTile*> _tilesToDownload;
     QGCMapEngineManager *_manager = nullptr;
-    QNetworkAccessManager *_networkManager = nullptr;
+    QGCTileDownloader *_downloader = nullptr;
 
     static constexpr uint32_t kTileBatchSize = 256;
+    static constexpr qint64 kRateInterval = 1000;   ///< ms
+    static constexpr double kRateSmoothing = 0.2;
 };
@@ -10,13 +10,18 @@
 #include "QGCMapEngine.h"
 
 #include <QtCore/QApplicationStatic>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
 
 #include "QGCCachedTileSet.h"
 #include "QGCCacheTile.h"
 #include "QGCLoggingCategory.h"
 #include "QGCMapTasks.h"
+#include "QGCMapUrlEngine.h"
 #include "QGCTile.h"
+#include "QGCTileArchive.h"
 #include "QGCTileCacheWorker.h"
+#include "QGCTileReadPool.h"
 #include "QGCTileSet.h"
 #include "QGeoFileTileCacheQGC.h"
 
@@ -46,6 +51,10 @@ QGCMapEngine::QGCMapEngine(QObject *parent)
 
 QGCMapEngine::~QGCMapEngine()
 {
+    if (m_readPool) {
+        m_readPool->stop();
+    }
+
     if (m_initialized && m_worker) {
         (void) disconnect(m_worker);
         m_worker->stop();
@@ -68,24 +77,176 @@ void QGCMapEngine::init(const QString &databasePath)
 
     m_initialized = true;
 
+    m_databasePath = databasePath;
+    m_readPool = new QGCTileReadPool(this);
     m_worker = new QGCCacheWorker(this);
     m_worker->setDatabaseFile(databasePath);
+    m_worker->setReadPool(m_readPool);
     (void) connect(m_worker, &QGCCacheWorker::updateTotals, this, &QGCMapEngine::_updateTotals);
+    (void) connect(m_worker, &QGCCacheWorker::databaseReady, this, &QGCMapEngine::_databaseReady);
 
     QGCMapTask *task = new QGCMapTask(QGCMapTask::TaskType::taskInit);
     if (!addTask(task)) {
         task->deleteLater();
         m_initialized = false;
+        return;
     }
+
+    _restoreArchives();
 }
 
 bool QGCMapEngine::addTask(QGCMapTask *task)
 {
+    // Until the worker has set up the database all fetches go through it
+    if ((task->type() == QGCMapTask::TaskType::taskFetchTile) && m_readPool && m_readPool->isRunning()) {
+        m_readPool->enqueueTask(static_cast<QGCFetchTileTask*>(task));
+        return true;
+    }
+
     bool result = false;
     (void) QMetaObject::invokeMethod(m_worker, &QGCCacheWorker::enqueueTask, Qt::DirectConnection, qReturnArg(result), task);
     return result;
 }
 
+void QGCMapEngine::setViewport(const QString &type, int zoom, double centerX, double centerY)
+{
+    if (m_readPool) {
+        m_readPool->setViewport(UrlFactory::hashFromProviderType(type), zoom, centerX, centerY);
+    }
+}
+
+bool QGCMapEngine::mountArchive(const QString &path, const QString &mapType)
+{
+    const int mapId = UrlFactory::getQtMapIdFromProviderType(mapType);
+    if (mapId < 0) {
+        qCWarning(QGCMapEngineLog) << "Unknown map type for archive" << path << mapType;
+        return false;
+    }
+
+    const QString canonicalPath = QFileInfo(path).canonicalFilePath();
+    if (canonicalPath.isEmpty()) {
+        qCWarning(QGCMapEngineLog) << "Archive not found" << path;
+        return false;
+    }
+
+    std::shared_ptr<const QGCTileArchive> archive = QGCTileArchive::open(canonicalPath);
+    if (!archive) {
+        return false;
+    }
+
+    {
+        QWriteLocker lock(&m_archivesLock);
+        for (const MountedArchive &mounted : std::as_const(m_archives)) {
+            if (mounted.archive->path() == canonicalPath) {
+                qCDebug(QGCMapEngineLog) << "Archive already mounted" << canonicalPath;
+                return true;
+            }
+        }
+
+        MountedArchive mounted;
+        mounted.archive = std::move(archive);
+        mounted.mapType = mapType;
+        mounted.mapId = mapId;
+        m_archives.append(mounted);
+    }
+
+    qCDebug(QGCMapEngineLog) << "Mounted archive" << canonicalPath << "as" << mapType;
+    _saveArchives();
+    return true;
+}
+
+void QGCMapEngine::unmountArchive(const QString &path)
+{
+    const QString canonicalPath = QFileInfo(path).canonicalFilePath();
+    QList<MountedArchive> removed;
+    {
+        QWriteLocker lock(&m_archivesLock);
+        (void) m_archives.removeIf([&path, &canonicalPath, &removed](const MountedArchive &mounted) {
+            if ((mounted.archive->path() == path) || (mounted.archive->path() == canonicalPath)) {
+                removed.append(mounted);
+                return true;
+            }
+            return false;
+        });
+    }
+
+    // No archiveTile() lookup can reach these anymore, so the per-thread readers can go now
+    // rather than lingering until the last worker thread exits
+    for (const MountedArchive &mounted : removed) {
+        mounted.archive->close();
+    }
+
+    qCDebug(QGCMapEngineLog) << "Unmounted archive" << path;
+    _saveArchives();
+}
+
+QList<QGCMapEngine::MountedArchive> QGCMapEngine::archives() const
+{
+    QReadLocker lock(&m_archivesLock);
+    return m_archives;
+}
+
+QByteArray QGCMapEngine::archiveTile(int mapId, int x, int y, int z, QString &format) const
+{
+    QReadLocker lock(&m_archivesLock);
+    for (const MountedArchive &mounted : m_archives) {
+        if ((mounted.mapId != mapId) || !mounted.archive->hasZoom(z)) {
+            continue;
+        }
+
+        const QByteArray data = mounted.archive->tile(x, y, z);
+        if (!data.isEmpty()) {
+            format = mounted.archive->info().tileFormat;
+            return data;
+        }
+    }
+
+    return QByteArray();
+}
+
+void QGCMapEngine::_restoreArchives()
+{
+    QSettings settings;
+    const int count = settings.beginReadArray(kArchivesGroup);
+    QList<QPair<QString, QString>> mounts;
+    for (int i = 0; i < count; i++) {
+        settings.setArrayIndex(i);
+        mounts.append(qMakePair(settings.value("path").toString(), settings.value("mapType").toString()));
+    }
+    settings.endArray();
+
+    // Archives that went missing are dropped from the settings on the next save
+    for (const QPair<QString, QString> &mount : std::as_const(mounts)) {
+        if (!mountArchive(mount.first, mount.second)) {
+            qCWarning(QGCMapEngineLog) << "Failed to restore archive" << mount.first;
+        }
+    }
+}
+
+void QGCMapEngine::_saveArchives() const
+{
+    const QList<MountedArchive> mounted = archives();
+
+    QSettings settings;
+    settings.remove(kArchivesGroup);
+    settings.beginWriteArray(kArchivesGroup, mounted.size());
+    for (qsizetype i = 0; i < mounted.size(); i++) {
+        settings.setArrayIndex(i);
+        settings.setValue("path", mounted[i].archive->path());
+        settings.setValue("mapType", mounted[i].mapType);
+    }
+    settings.endArray();
+}
+
+void QGCMapEngine::_databaseReady()
+{
+    if (m_readPool->isRunning()) {
+        m_readPool->resetConnections();
+    } else {
+        m_readPool->start(m_databasePath);
+    }
+}
+
 void QGCMapEngine::_updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize)
 {
     emit updateTotals(totaltiles, totalsize, defaulttiles, defaultsize);
@@ -9,14 +9,20 @@
 
 #pragma once
 
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QString>
 
+#include <memory>
+
 Q_DECLARE_LOGGING_CATEGORY(QGCMapEngineLog)
 
 class QGCMapTask;
 class QGCCacheWorker;
+class QGCTileArchive;
+class QGCTileReadPool;
 
 class QGCMapEngine : public QObject
 {
@@ -28,6 +34,25 @@ class QGCMapEngine : public QObject
 
     void init(const QString &databasePath);
     bool addTask(QGCMapTask *task);
+    /// Cached tiles nearest to the viewport center are read first
+    void setViewport(const QString &type, int zoom, double centerX, double centerY);
+
+    /// Serves the tiles of an MBTiles or PMTiles file as the given map type, without copying them
+    /// into the cache database. Mounted archives are remembered across restarts.
+    bool mountArchive(const QString &path, const QString &mapType);
+    void unmountArchive(const QString &path);
+
+    struct MountedArchive {
+        std::shared_ptr<const QGCTileArchive> archive;
+        QString mapType;
+        int mapId = -1;
+    };
+    QList<MountedArchive> archives() const;
+
+    /// Tile of the first mounted archive of the map type that has it, safe to call from any thread
+    ///     @param format Receives the image format of the tile
+    /// @return empty if no archive has the tile
+    QByteArray archiveTile(int mapId, int x, int y, int z, QString &format) const;
 
     static QGCMapEngine *instance();
 
@@ -37,11 +62,21 @@ class QGCMapEngine : public QObject
 private slots:
     void _updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
     void _pruned() { m_pruning = false; }
+    void _databaseReady();
 
 private:
+    void _restoreArchives();
+    void _saveArchives() const;
+
     QGCCacheWorker *m_worker = nullptr;
+    QGCTileReadPool *m_readPool = nullptr;
+    QString m_databasePath;
+    QList<MountedArchive> m_archives;
+    mutable QReadWriteLock m_archivesLock;
     bool m_pruning = false;
     std::atomic<bool> m_initialized = false;
+
+    static constexpr const char *kArchivesGroup = "QGCMapArchives";
 };
 
 extern QGCMapEngine *getQGCMapEngine();
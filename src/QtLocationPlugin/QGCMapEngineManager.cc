@@ -10,6 +10,7 @@
 #include "QGCMapEngineManager.h"
 
 #include <QtCore/QApplicationStatic>
+#include <QtCore/QFileInfo>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QSettings>
 #include <QtCore/QStorageInfo>
@@ -22,9 +23,11 @@
 #include "QGCLoggingCategory.h"
 #include "QGCMapEngine.h"
 #include "QGCMapUrlEngine.h"
+#include "QGCTileArchive.h"
 #include "QGeoFileTileCacheQGC.h"
 #include "QmlObjectListModel.h"
 #include "SettingsManager.h"
+#include "TerrainRegionDownload.h"
 
 using namespace Qt::StringLiterals;
 
@@ -101,6 +104,8 @@ void QGCMapEngineManager::loadTileSets()
         emit tileSetsChanged();
     }
 
+    _appendArchiveSets();
+
     QGCFetchTileSetTask *task = new QGCFetchTileSetTask();
     (void) connect(task, &QGCFetchTileSetTask::tileSetFetched, this, &QGCMapEngineManager::_tileSetFetched);
     (void) connect(task, &QGCMapTask::error, this, &QGCMapEngineManager::taskError);
@@ -109,6 +114,50 @@ void QGCMapEngineManager::loadTileSets()
     }
 }
 
+void QGCMapEngineManager::_appendArchiveSets()
+{
+    const QList<QGCMapEngine::MountedArchive> archives = getQGCMapEngine()->archives();
+    for (const QGCMapEngine::MountedArchive &mounted : archives) {
+        const QGCTileArchive::Info &info = mounted.archive->info();
+        const quint32 tileCount = static_cast<quint32>(qMin<quint64>(info.tileCount, UINT32_MAX));
+
+        QGCCachedTileSet *const set = new QGCCachedTileSet(info.name);
+        set->setArchivePath(mounted.archive->path());
+        set->setMapTypeStr(mounted.mapType);
+        set->setType(mounted.mapType);
+        set->setTopleftLat(info.north);
+        set->setTopleftLon(info.west);
+        set->setBottomRightLat(info.south);
+        set->setBottomRightLon(info.east);
+        set->setMinZoom(info.minZoom);
+        set->setMaxZoom(info.maxZoom);
+        set->setCreationDate(QFileInfo(mounted.archive->path()).lastModified());
+        set->setTotalTileCount(tileCount);
+        set->setTotalTileSize(info.size);
+        set->setSavedTileCount(tileCount);
+        set->setSavedTileSize(info.size);
+        set->setUniqueTileCount(tileCount);
+        set->setUniqueTileSize(info.size);
+        set->setManager(this);
+        _tileSets->append(set);
+    }
+
+    if (!archives.isEmpty()) {
+        emit tileSetsChanged();
+    }
+}
+
+bool QGCMapEngineManager::mountArchive(const QString &path, const QString &mapType)
+{
+    if (!getQGCMapEngine()->mountArchive(path, mapType)) {
+        setErrorMessage(tr("Could not open %1 as a raster MBTiles or PMTiles archive").arg(QFileInfo(path).fileName()));
+        return false;
+    }
+
+    loadTileSets();
+    return true;
+}
+
 void QGCMapEngineManager::_tileSetFetched(QGCCachedTileSet *tileSet)
 {
     if (tileSet->type() == QStringLiteral("Invalid")) {
@@ -166,11 +215,41 @@ void QGCMapEngineManager::startDownload(const QString &name, const QString &mapT
         if (!getQGCMapEngine()->addTask(task)) {
             task->deleteLater();
         }
+
+        if (elevationProviderName == QString::fromLatin1(CopernicusElevationProvider::kProviderKey)) {
+            _startTerrainDownload(name);
+        }
     } else {
         qCWarning(QGCMapEngineManagerLog) << "No Tiles to save";
     }
 }
 
+void QGCMapEngineManager::_startTerrainDownload(const QString &name)
+{
+    // Terrain queries read decoded tiles from their own cache, fill it for the region too so they work offline
+    const QList<QGeoCoordinate> region = {
+        QGeoCoordinate(_topleftLat, _topleftLon),
+        QGeoCoordinate(_topleftLat, _bottomRightLon),
+        QGeoCoordinate(_bottomRightLat, _bottomRightLon),
+        QGeoCoordinate(_bottomRightLat, _topleftLon),
+    };
+
+    TerrainRegionDownload *const download = new TerrainRegionDownload(this);
+    (void) connect(download, &TerrainRegionDownload::finished, this, [this, download, name](bool success) {
+        qCDebug(QGCMapEngineManagerLog) << "Terrain download for" << name << "saved:" << download->savedCount()
+                                        << "already stored:" << download->skippedCount() << "failed:" << download->failedCount();
+        if (!success) {
+            setErrorMessage(tr("%1 of the terrain tiles for %2 could not be downloaded, terrain queries there need a connection").arg(download->failedCount()).arg(name));
+        }
+        download->deleteLater();
+    });
+
+    if (!download->start(region)) {
+        qCWarning(QGCMapEngineManagerLog) << "Terrain download not started for" << name;
+        download->deleteLater();
+    }
+}
+
 void QGCMapEngineManager::_tileSetSaved(QGCCachedTileSet *set)
 {
     qCDebug(QGCMapEngineManagerLog) << "New tile set saved (" << set->name() << "). Starting download...";
@@ -210,7 +289,13 @@ void QGCMapEngineManager::deleteTileSet(QGCCachedTileSet *tileSet)
 {
     qCDebug(QGCMapEngineManagerLog) << "Deleting tile set" << tileSet->name();
 
-    if (tileSet->defaultSet()) {
+    if (tileSet->archive()) {
+        // The file itself is left alone
+        getQGCMapEngine()->unmountArchive(tileSet->archivePath());
+        (void) _tileSets->removeOne(tileSet);
+        tileSet->deleteLater();
+        emit tileSetsChanged();
+    } else if (tileSet->defaultSet()) {
         for (qsizetype i = 0; i < _tileSets->count(); i++ ) {
             QGCCachedTileSet* const set = qobject_cast<QGCCachedTileSet*>(_tileSets->get(i));
             if (set) {
@@ -238,6 +323,11 @@ void QGCMapEngineManager::deleteTileSet(QGCCachedTileSet *tileSet)
 
 void QGCMapEngineManager::renameTileSet(QGCCachedTileSet *tileSet, const QString &newName)
 {
+    // Archives are named by their own metadata
+    if (tileSet->archive()) {
+        return;
+    }
+
     int idx = 1;
     QString name = newName;
     while (findName(name)) {
@@ -401,7 +491,8 @@ bool QGCMapEngineManager::exportSets(const QString &path)
 
     for (qsizetype i = 0; i < _tileSets->count(); i++) {
         QGCCachedTileSet* const set = qobject_cast<QGCCachedTileSet*>(_tileSets->get(i));
-        if (set->selected()) {
+        // Archives are shared as the files they already are
+        if (set->selected() && !set->archive()) {
             sets.append(set);
         }
     }
@@ -61,6 +61,8 @@ class QGCMapEngineManager : public QObject
     Q_INVOKABLE QString getUniqueName() const;
     Q_INVOKABLE void deleteTileSet(QGCCachedTileSet *tileSet);
     Q_INVOKABLE void loadTileSets();
+    /// Serves an MBTiles or PMTiles file as the map type, listed as a read only tile set
+    Q_INVOKABLE bool mountArchive(const QString &path, const QString &mapType);
     Q_INVOKABLE void renameTileSet(QGCCachedTileSet *tileSet, const QString &newName);
     Q_INVOKABLE void resetAction() { setImportAction(ImportAction::ActionNone); }
     Q_INVOKABLE void selectAll();
@@ -115,6 +117,10 @@ private slots:
     void _updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
 
 private:
+    void _appendArchiveSets();
+    /// Fills the terrain tile cache for the region of the last updateForCurrentView
+    void _startTerrainDownload(const QString &name);
+
     QmlObjectListModel *_tileSets = nullptr;
     QGCTileSet _imageSet;
     QGCTileSet _elevationSet;
@@ -13,6 +13,8 @@
 #include <QtCore/QQueue>
 #include <QtCore/QString>
 
+#include <atomic>
+
 #include "QGCCacheTile.h"
 #include "QGCCachedTileSet.h"
 #include "QGCTile.h"
@@ -135,11 +137,16 @@ class QGCFetchTileTask : public QGCMapTask
 
     QString hash() const { return m_hash; }
 
+    /// Thread safe. A cancelled task is dropped without being answered.
+    void cancel() { m_cancelled = true; }
+    bool isCancelled() const { return m_cancelled; }
+
 signals:
     void tileFetched(QGCCacheTile *tile);
 
 private:
     const QString m_hash;
+    std::atomic_bool m_cancelled = false;
 };
 
 //-----------------------------------------------------------------------------
@@ -172,27 +179,32 @@ class QGCGetTileDownloadListTask : public QGCMapTask
     Q_OBJECT
 
 public:
-    QGCGetTileDownloadListTask(quint64 setID, int count, QObject *parent = nullptr)
+    /// Lists up to count pending tiles listed after afterRowID, 0 starts from the beginning
+    QGCGetTileDownloadListTask(quint64 setID, int count, qint64 afterRowID = 0, QObject *parent = nullptr)
         : QGCMapTask(TaskType::taskGetTileDownloadList, parent)
         , m_setID(setID)
         , m_count(count)
+        , m_afterRowID(afterRowID)
     {}
     ~QGCGetTileDownloadListTask() = default;
 
     quint64 setID() const { return m_setID; }
     int count() const { return m_count; }
+    qint64 afterRowID() const { return m_afterRowID; }
 
-    void setTileListFetched(const QQueue<QGCTile*> &tiles)
+    void setTileListFetched(const QQueue<QGCTile*> &tiles, qint64 lastRowID)
     {
-        emit tileListFetched(tiles);
+        emit tileListFetched(tiles, lastRowID);
     }
 
 signals:
-    void tileListFetched(QQueue<QGCTile*> tiles);
+    /// lastRowID continues the list in the next task
+    void tileListFetched(QQueue<QGCTile*> tiles, qint64 lastRowID);
 
 private:
     const quint64 m_setID = 0;
     const int m_count = 0;
+    const qint64 m_afterRowID = 0;
 };
 
 //-----------------------------------------------------------------------------
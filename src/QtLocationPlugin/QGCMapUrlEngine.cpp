@@ -154,6 +154,21 @@ int UrlFactory::lat2tileY(QStringView mapType, double lat, int z)
     return 0;
 }
 
+quint64 UrlFactory::tileZOrder(int x, int y)
+{
+    const auto spread = [](quint64 v) {
+        v &= 0xFFFFFFFFULL;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        v = (v | (v << 2)) & 0x3333333333333333ULL;
+        v = (v | (v << 1)) & 0x5555555555555555ULL;
+        return v;
+    };
+
+    return (spread(static_cast<quint32>(y)) << 1) | spread(static_cast<quint32>(x));
+}
+
 QGCTileSet UrlFactory::getTileCount(int zoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, QStringView mapType)
 {
     const SharedMapProvider provider = getMapProviderFromProviderType(mapType);
@@ -272,6 +287,25 @@ QString UrlFactory::tileHashToType(QStringView tileHash)
     return providerTypeFromHash(providerHash);
 }
 
+bool UrlFactory::parseTileHash(QStringView tileHash, int &providerHash, int &x, int &y, int &z)
+{
+    // Layout from getTileHash
+    if (tileHash.size() != 29) {
+        return false;
+    }
+
+    bool okHash = false;
+    bool okX = false;
+    bool okY = false;
+    bool okZ = false;
+    providerHash = tileHash.mid(0, 10).toInt(&okHash);
+    x = tileHash.mid(10, 8).toInt(&okX);
+    y = tileHash.mid(18, 8).toInt(&okY);
+    z = tileHash.mid(26, 3).toInt(&okZ);
+
+    return (okHash && okX && okY && okZ);
+}
+
 QString UrlFactory::getTileHash(QStringView type, int x, int y, int z)
 {
     const int hash = hashFromProviderType(type);
@@ -33,6 +33,8 @@ class UrlFactory
 
     static int long2tileX(QStringView mapType, double lon, int z);
     static int lat2tileY(QStringView mapType, double lat, int z);
+    /// Morton code of tile coordinates, tiles sorted by it are visited in Z-order
+    static quint64 tileZOrder(int x, int y);
 
     static QGCTileSet getTileCount(int zoom, double topleftLon, double topleftLat,
                             double bottomRightLon, double bottomRightLat,
@@ -49,6 +51,7 @@ class UrlFactory
 
     static int hashFromProviderType(QStringView type);
     static QString tileHashToType(QStringView tileHash);
+    static bool parseTileHash(QStringView tileHash, int &providerHash, int &x, int &y, int &z);
     static QString getTileHash(QStringView type, int x, int y, int z);
 
 private:
@@ -0,0 +1,544 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileArchive.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QUrl>
+#include <QtCore/QtEndian>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "QGCLoggingCategory.h"
+#include "QGCZlib.h"
+
+QGC_LOGGING_CATEGORY(QGCTileArchiveLog, "qgc.qtlocationplugin.qgctilearchive")
+
+namespace {
+
+bool _isRasterFormat(const QString &format)
+{
+    return ((format == QStringLiteral("png")) || (format == QStringLiteral("jpg")) || (format == QStringLiteral("webp")));
+}
+
+/*===========================================================================*/
+
+/// https://github.com/mapbox/mbtiles-spec, an SQLite database with TMS tile rows
+class MBTilesArchive final : public QGCTileArchive
+{
+public:
+    explicit MBTilesArchive(const QString &path)
+        : QGCTileArchive(path, Format::MBTiles)
+        , _id(_nextId++)
+    {}
+
+    ~MBTilesArchive() final
+    {
+        close();
+    }
+
+    bool load()
+    {
+        Reader *const reader = _reader();
+        if (!reader) {
+            return false;
+        }
+
+        QSqlQuery query(reader->db);
+        if (!query.exec("SELECT name, value FROM metadata")) {
+            qCWarning(QGCTileArchiveLog) << "Not an MBTiles file:" << _path << query.lastError().text();
+            return false;
+        }
+
+        QHash<QString, QString> metadata;
+        while (query.next()) {
+            metadata.insert(query.value(0).toString(), query.value(1).toString());
+        }
+
+        _info.name = metadata.value(QStringLiteral("name"));
+        _info.tileFormat = metadata.value(QStringLiteral("format"), QStringLiteral("png")).toLower();
+        if (_info.tileFormat == QStringLiteral("jpeg")) {
+            _info.tileFormat = QStringLiteral("jpg");
+        }
+        if (!_isRasterFormat(_info.tileFormat)) {
+            qCWarning(QGCTileArchiveLog) << "MBTiles tile format not supported:" << _info.tileFormat << _path;
+            return false;
+        }
+
+        const QStringList bounds = metadata.value(QStringLiteral("bounds")).split(QLatin1Char(','));
+        if (bounds.size() == 4) {
+            _info.west = bounds[0].toDouble();
+            _info.south = bounds[1].toDouble();
+            _info.east = bounds[2].toDouble();
+            _info.north = bounds[3].toDouble();
+        }
+
+        if (!query.exec("SELECT MIN(zoom_level), MAX(zoom_level), COUNT(*) FROM tiles") || !query.next()) {
+            qCWarning(QGCTileArchiveLog) << "MBTiles has no tiles table:" << _path << query.lastError().text();
+            return false;
+        }
+        // Metadata zoom levels are optional and sometimes wrong, the tiles table is what is served
+        _info.minZoom = query.value(0).toInt();
+        _info.maxZoom = query.value(1).toInt();
+        _info.tileCount = query.value(2).toULongLong();
+
+        return true;
+    }
+
+    QByteArray tile(int x, int y, int z) const final
+    {
+        if (!hasZoom(z)) {
+            return QByteArray();
+        }
+
+        Reader *const reader = _reader();
+        if (!reader) {
+            return QByteArray();
+        }
+
+        QByteArray data;
+        reader->tileQuery.bindValue(0, z);
+        reader->tileQuery.bindValue(1, x);
+        reader->tileQuery.bindValue(2, (1 << z) - 1 - y);
+        if (reader->tileQuery.exec() && reader->tileQuery.next()) {
+            data = reader->tileQuery.value(0).toByteArray();
+        }
+        reader->tileQuery.finish();
+
+        return data;
+    }
+
+    void close() const final
+    {
+        QMutexLocker lock(&_mutex);
+        _closed = true;
+        for (auto it = _readers.begin(); it != _readers.end(); ++it) {
+            const QString session = it.value()->session;
+            delete it.value();
+            QSqlDatabase::removeDatabase(session);
+        }
+        _readers.clear();
+    }
+
+private:
+    struct Reader {
+        QString session;
+        QSqlDatabase db;
+        QSqlQuery tileQuery;
+    };
+
+    /// Connections can only be used by the thread that opened them, each thread gets its own
+    Reader *_reader() const
+    {
+        const Qt::HANDLE thread = QThread::currentThreadId();
+
+        QMutexLocker lock(&_mutex);
+        if (_closed) {
+            return nullptr;
+        }
+
+        Reader *reader = _readers.value(thread);
+        if (reader) {
+            return reader;
+        }
+
+        const QString session = QStringLiteral("QGCTileArchive_%1_%2").arg(_id).arg(reinterpret_cast<quintptr>(thread));
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", session);
+        // immutable skips all locking, the file is never written while mounted
+        db.setDatabaseName(QUrl::fromLocalFile(_path).toString() + QStringLiteral("?mode=ro&immutable=1"));
+        db.setConnectOptions("QSQLITE_OPEN_URI;QSQLITE_OPEN_READONLY");
+        if (!db.open()) {
+            qCWarning(QGCTileArchiveLog) << "MBTiles open failed:" << _path << db.lastError().text();
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(session);
+            return nullptr;
+        }
+
+        QSqlQuery query(db);
+        // Pages are read straight from the mapping instead of through the page cache
+        (void) query.exec(QStringLiteral("PRAGMA mmap_size = %1").arg(QFileInfo(_path).size()));
+        (void) query.exec("PRAGMA cache_size = -2048");
+
+        reader = new Reader;
+        reader->session = session;
+        reader->db = db;
+        reader->tileQuery = QSqlQuery(db);
+        if (!reader->tileQuery.prepare("SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?")) {
+            qCWarning(QGCTileArchiveLog) << "MBTiles prepare failed:" << _path << reader->tileQuery.lastError().text();
+            delete reader;
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(session);
+            return nullptr;
+        }
+
+        (void) _readers.insert(thread, reader);
+        return reader;
+    }
+
+    const uint _id;
+    mutable QMutex _mutex;
+    mutable QHash<Qt::HANDLE, Reader*> _readers;
+    mutable bool _closed = false;
+
+    static inline std::atomic_uint _nextId = 0;
+};
+
+/*===========================================================================*/
+
+/// https://github.com/protomaps/PMTiles/blob/main/spec/v3/spec.md, a single file of tiles addressed
+/// through Hilbert curve tile IDs and varint encoded directories
+class PMTilesArchive final : public QGCTileArchive
+{
+public:
+    explicit PMTilesArchive(const QString &path)
+        : QGCTileArchive(path, Format::PMTiles)
+        , _file(path)
+    {}
+
+    bool load()
+    {
+        if (!_file.open(QIODevice::ReadOnly)) {
+            qCWarning(QGCTileArchiveLog) << "PMTiles open failed:" << _path << _file.errorString();
+            return false;
+        }
+
+        _size = static_cast<quint64>(_file.size());
+        _data = _file.map(0, _file.size());
+        if (!_data) {
+            qCWarning(QGCTileArchiveLog) << "PMTiles map failed:" << _path << _file.errorString();
+            return false;
+        }
+
+        if ((_size < kHeaderSize) || (memcmp(_data, "PMTiles", 7) != 0) || (_data[7] != 3)) {
+            qCWarning(QGCTileArchiveLog) << "Not a PMTiles v3 file:" << _path;
+            return false;
+        }
+
+        const quint64 rootOffset = qFromLittleEndian<quint64>(_data + 8);
+        const quint64 rootLength = qFromLittleEndian<quint64>(_data + 16);
+        const quint64 metadataOffset = qFromLittleEndian<quint64>(_data + 24);
+        const quint64 metadataLength = qFromLittleEndian<quint64>(_data + 32);
+        _leafOffset = qFromLittleEndian<quint64>(_data + 40);
+        _tileDataOffset = qFromLittleEndian<quint64>(_data + 56);
+        _info.tileCount = qFromLittleEndian<quint64>(_data + 72);
+        _internalCompression = _data[97];
+        _tileCompression = _data[98];
+
+        switch (_data[99]) {
+        case 2:
+            _info.tileFormat = QStringLiteral("png");
+            break;
+        case 3:
+            _info.tileFormat = QStringLiteral("jpg");
+            break;
+        case 4:
+            _info.tileFormat = QStringLiteral("webp");
+            break;
+        default:
+            qCWarning(QGCTileArchiveLog) << "PMTiles tile type not supported:" << _data[99] << _path;
+            return false;
+        }
+
+        if ((_internalCompression != kCompressionNone) && (_internalCompression != kCompressionGzip)) {
+            qCWarning(QGCTileArchiveLog) << "PMTiles directory compression not supported:" << _internalCompression << _path;
+            return false;
+        }
+        if (_tileCompression > kCompressionGzip) {
+            qCWarning(QGCTileArchiveLog) << "PMTiles tile compression not supported:" << _tileCompression << _path;
+            return false;
+        }
+
+        _info.minZoom = _data[100];
+        _info.maxZoom = qMin<int>(_data[101], kMaxZoom);
+        _info.west = qFromLittleEndian<qint32>(_data + 102) / 1e7;
+        _info.south = qFromLittleEndian<qint32>(_data + 106) / 1e7;
+        _info.east = qFromLittleEndian<qint32>(_data + 110) / 1e7;
+        _info.north = qFromLittleEndian<qint32>(_data + 114) / 1e7;
+
+        if (!_readDirectory(rootOffset, rootLength, _root)) {
+            qCWarning(QGCTileArchiveLog) << "PMTiles root directory is corrupt:" << _path;
+            return false;
+        }
+
+        QByteArray metadata;
+        if ((metadataLength > 0) && _decompress(_bytes(metadataOffset, metadataLength), _internalCompression, metadata)) {
+            _info.name = QJsonDocument::fromJson(metadata).object().value(QStringLiteral("name")).toString();
+        }
+
+        return true;
+    }
+
+    QByteArray tile(int x, int y, int z) const final
+    {
+        if (!hasZoom(z) || (x < 0) || (y < 0) || (x >= (1 << z)) || (y >= (1 << z))) {
+            return QByteArray();
+        }
+
+        const quint64 tileId = _tileId(x, y, z);
+        Directory directory = _root;
+        for (int depth = 0; depth < kMaxDepth; depth++) {
+            const Entry *const entry = _findEntry(directory, tileId);
+            if (!entry) {
+                return QByteArray();
+            }
+
+            if (entry->runLength > 0) {
+                QByteArray data;
+                if (!_decompress(_bytes(_tileDataOffset + entry->offset, entry->length), _tileCompression, data)) {
+                    return QByteArray();
+                }
+                return data;
+            }
+
+            directory = _leaf(_leafOffset + entry->offset, entry->length);
+            if (directory.isEmpty()) {
+                return QByteArray();
+            }
+        }
+
+        qCWarning(QGCTileArchiveLog) << "PMTiles directories nested too deep:" << _path;
+        return QByteArray();
+    }
+
+private:
+    struct Entry {
+        quint64 tileId = 0;
+        quint64 offset = 0;
+        quint32 length = 0;
+        quint32 runLength = 0;     ///< 0 for a leaf directory
+    };
+    using Directory = QList<Entry>;
+
+    /// Data within the mapping, not copied
+    QByteArray _bytes(quint64 offset, quint64 length) const
+    {
+        if ((offset > _size) || (length > (_size - offset))) {
+            return QByteArray();
+        }
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(_data + offset), static_cast<qsizetype>(length));
+    }
+
+    static bool _decompress(const QByteArray &data, quint8 compression, QByteArray &result)
+    {
+        if (data.isEmpty()) {
+            return false;
+        }
+        if (compression == kCompressionGzip) {
+            return QGCZlib::inflateGzipData(data, result);
+        }
+        // Detached from the mapping, the tile may outlive the archive
+        result = QByteArray(data.constData(), data.size());
+        return true;
+    }
+
+    static bool _readVarint(const char *&pos, const char *end, quint64 &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= end) {
+                return false;
+            }
+            const quint8 byte = static_cast<quint8>(*pos++);
+            value |= (static_cast<quint64>(byte & 0x7f) << shift);
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool _readDirectory(quint64 offset, quint64 length, Directory &directory) const
+    {
+        QByteArray data;
+        if (!_decompress(_bytes(offset, length), _internalCompression, data)) {
+            return false;
+        }
+
+        const char *pos = data.constData();
+        const char *const end = pos + data.size();
+
+        quint64 count = 0;
+        // Every entry takes at least one byte for each of its four fields
+        if (!_readVarint(pos, end, count) || (count > static_cast<quint64>(data.size()))) {
+            return false;
+        }
+
+        directory.resize(static_cast<qsizetype>(count));
+        quint64 value = 0;
+        quint64 tileId = 0;
+        for (Entry &entry : directory) {
+            if (!_readVarint(pos, end, value)) {
+                return false;
+            }
+            tileId += value;
+            entry.tileId = tileId;
+        }
+        for (Entry &entry : directory) {
+            if (!_readVarint(pos, end, value)) {
+                return false;
+            }
+            entry.runLength = static_cast<quint32>(value);
+        }
+        for (Entry &entry : directory) {
+            if (!_readVarint(pos, end, value)) {
+                return false;
+            }
+            entry.length = static_cast<quint32>(value);
+        }
+        for (qsizetype i = 0; i < directory.size(); i++) {
+            if (!_readVarint(pos, end, value)) {
+                return false;
+            }
+            // 0 continues right after the previous entry
+            if ((value == 0) && (i > 0)) {
+                directory[i].offset = directory[i - 1].offset + directory[i - 1].length;
+            } else {
+                directory[i].offset = value - 1;
+            }
+        }
+
+        return true;
+    }
+
+    Directory _leaf(quint64 offset, quint64 length) const
+    {
+        QMutexLocker lock(&_leafMutex);
+        const auto it = _leaves.constFind(offset);
+        if (it != _leaves.constEnd()) {
+            return it.value();
+        }
+
+        Directory directory;
+        if (!_readDirectory(offset, length, directory)) {
+            qCWarning(QGCTileArchiveLog) << "PMTiles leaf directory is corrupt:" << _path << offset;
+            return Directory();
+        }
+
+        if (_leaves.size() >= kMaxLeaves) {
+            _leaves.clear();
+        }
+        (void) _leaves.insert(offset, directory);
+        return directory;
+    }
+
+    static const Entry *_findEntry(const Directory &directory, quint64 tileId)
+    {
+        // Last entry starting at or before the tile
+        auto it = std::upper_bound(directory.cbegin(), directory.cend(), tileId, [](quint64 id, const Entry &entry) {
+            return (id < entry.tileId);
+        });
+        if (it == directory.cbegin()) {
+            return nullptr;
+        }
+        --it;
+
+        if ((it->runLength == 0) || ((tileId - it->tileId) < it->runLength)) {
+            return &(*it);
+        }
+        return nullptr;
+    }
+
+    /// Tiles of all lower zoom levels, then the position along the Hilbert curve of the zoom level
+    static quint64 _tileId(int x, int y, int z)
+    {
+        quint64 tileId = ((1ULL << (2 * z)) - 1) / 3;
+        qint64 tx = x;
+        qint64 ty = y;
+        for (qint64 s = (1LL << z) / 2; s > 0; s /= 2) {
+            const qint64 rx = ((tx & s) != 0) ? 1 : 0;
+            const qint64 ry = ((ty & s) != 0) ? 1 : 0;
+            tileId += static_cast<quint64>(s * s * ((3 * rx) ^ ry));
+            if (ry == 0) {
+                if (rx == 1) {
+                    tx = s - 1 - tx;
+                    ty = s - 1 - ty;
+                }
+                std::swap(tx, ty);
+            }
+        }
+        return tileId;
+    }
+
+    QFile _file;
+    const uchar *_data = nullptr;
+    quint64 _size = 0;
+    quint64 _leafOffset = 0;
+    quint64 _tileDataOffset = 0;
+    quint8 _internalCompression = kCompressionNone;
+    quint8 _tileCompression = kCompressionNone;
+    Directory _root;
+    mutable QMutex _leafMutex;
+    mutable QHash<quint64, Directory> _leaves;     ///< By file offset
+
+    static constexpr quint64 kHeaderSize = 127;
+    static constexpr quint8 kCompressionNone = 1;
+    static constexpr quint8 kCompressionGzip = 2;
+    static constexpr int kMaxZoom = 26;             ///< Deepest zoom a 64 bit tile ID addresses
+    static constexpr int kMaxDepth = 4;             ///< Root and up to three levels of leaves
+    static constexpr qsizetype kMaxLeaves = 64;
+};
+
+} // namespace
+
+/*===========================================================================*/
+
+QGCTileArchive::QGCTileArchive(const QString &path, Format format)
+    : _path(path)
+    , _format(format)
+{
+    _info.size = static_cast<quint64>(QFileInfo(path).size());
+}
+
+std::unique_ptr<QGCTileArchive> QGCTileArchive::open(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(QGCTileArchiveLog) << "Open failed:" << path << file.errorString();
+        return nullptr;
+    }
+    const QByteArray magic = file.read(16);
+    file.close();
+
+    std::unique_ptr<QGCTileArchive> archive;
+    if (magic.startsWith("PMTiles")) {
+        auto pmtiles = std::make_unique<PMTilesArchive>(path);
+        if (pmtiles->load()) {
+            archive = std::move(pmtiles);
+        }
+    } else if (magic.startsWith("SQLite format 3")) {
+        auto mbtiles = std::make_unique<MBTilesArchive>(path);
+        if (mbtiles->load()) {
+            archive = std::move(mbtiles);
+        }
+    } else {
+        qCWarning(QGCTileArchiveLog) << "Not an MBTiles or PMTiles file:" << path;
+    }
+
+    if (archive) {
+        if (archive->_info.name.isEmpty()) {
+            archive->_info.name = QFileInfo(path).completeBaseName();
+        }
+        qCDebug(QGCTileArchiveLog) << "Opened" << path << archive->_info.name << archive->_info.tileFormat
+                                   << "zoom" << archive->_info.minZoom << "-" << archive->_info.maxZoom
+                                   << "tiles" << archive->_info.tileCount;
+    }
+
+    return archive;
+}
@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+
+#include <memory>
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTileArchiveLog)
+
+/// Read-only MBTiles or PMTiles archive of raster map tiles. Tiles are read straight from the
+/// memory mapped file, nothing is copied into the tile cache database.
+class QGCTileArchive
+{
+public:
+    enum class Format {
+        MBTiles,
+        PMTiles,
+    };
+
+    struct Info {
+        QString name;
+        QString tileFormat;         ///< png, jpg or webp
+        int minZoom = 0;
+        int maxZoom = 0;
+        double west = -180.;
+        double south = -85.0511;
+        double east = 180.;
+        double north = 85.0511;
+        quint64 tileCount = 0;
+        quint64 size = 0;           ///< Bytes on disk
+    };
+
+    virtual ~QGCTileArchive() = default;
+
+    /// The format is told from the file contents
+    /// @return nullptr if the file is not a raster tile archive
+    static std::unique_ptr<QGCTileArchive> open(const QString &path);
+
+    /// Encoded image of the XYZ tile, empty if the archive does not have it. Safe to call from any thread.
+    virtual QByteArray tile(int x, int y, int z) const = 0;
+
+    /// Releases the open file handles now instead of when the last reference goes away. tile()
+    /// returns nothing afterwards. Must not race tile(), callers stop lookups before closing.
+    virtual void close() const {}
+
+    const QString &path() const { return _path; }
+    Format format() const { return _format; }
+    const Info &info() const { return _info; }
+    bool hasZoom(int z) const { return ((z >= _info.minZoom) && (z <= _info.maxZoom)); }
+
+protected:
+    QGCTileArchive(const QString &path, Format format);
+
+    QString _path;
+    Format _format;
+    Info _info;
+};
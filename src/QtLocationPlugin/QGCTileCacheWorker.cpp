@@ -17,13 +17,44 @@
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 
+#include <algorithm>
+#include <vector>
+
 #include "QGCCachedTileSet.h"
 #include "QGCLoggingCategory.h"
 #include "QGCMapTasks.h"
 #include "QGCMapUrlEngine.h"
+#include "QGCTileReadPool.h"
 
 QGC_LOGGING_CATEGORY(QGCTileCacheWorkerLog, "qgc.qtlocationplugin.qgctilecacheworker")
 
+namespace {
+    constexpr const char *kCreateTilesSql =
+        "CREATE TABLE IF NOT EXISTS Tiles ("
+        "tileID INTEGER PRIMARY KEY NOT NULL, "
+        "tileKey INTEGER NOT NULL UNIQUE, "
+        "format TEXT NOT NULL, "
+        "tile BLOB NULL, "
+        "size INTEGER, "
+        "type INTEGER, "
+        "date INTEGER DEFAULT 0)";
+
+    constexpr const char *kCreateTilesDownloadSql =
+        "CREATE TABLE IF NOT EXISTS TilesDownload ("
+        "setID INTEGER, "
+        "tileKey INTEGER NOT NULL UNIQUE, "
+        "type INTEGER, "
+        "x INTEGER, "
+        "y INTEGER, "
+        "z INTEGER, "
+        "state INTEGER DEFAULT 0)";
+
+    constexpr const char *kCreateTileProvidersSql =
+        "CREATE TABLE IF NOT EXISTS TileProviders ("
+        "providerID INTEGER PRIMARY KEY NOT NULL, "
+        "hash INTEGER NOT NULL UNIQUE)";
+}
+
 QGCCacheWorker::QGCCacheWorker(QObject *parent)
     : QThread(parent)
 {
@@ -35,10 +66,22 @@ QGCCacheWorker::~QGCCacheWorker()
     qCDebug(QGCTileCacheWorkerLog) << this;
 }
 
+quint64 QGCCacheWorker::tileKey(int providerID, int x, int y, int z)
+{
+    constexpr quint64 coordMask = (1ULL << kKeyCoordBits) - 1;
+    constexpr quint64 zoomMask = (1ULL << kKeyZoomBits) - 1;
+
+    return (static_cast<quint64>(providerID & kMaxProviderID) << (kKeyZoomBits + (2 * kKeyCoordBits)))
+        | ((static_cast<quint64>(z) & zoomMask) << (2 * kKeyCoordBits))
+        | ((static_cast<quint64>(x) & coordMask) << kKeyCoordBits)
+        | (static_cast<quint64>(y) & coordMask);
+}
+
 void QGCCacheWorker::stop()
 {
     QMutexLocker lock(&_taskQueueMutex);
     qDeleteAll(_taskQueue);
+    _taskQueue.clear();
     lock.unlock();
 
     if (isRunning()) {
@@ -88,7 +131,13 @@ void QGCCacheWorker::run()
         if (!_taskQueue.isEmpty()) {
             QGCMapTask* const task = _taskQueue.dequeue();
             lock.unlock();
+            if (!_runsInWriteBatch(task)) {
+                _commitWrites();
+            }
             _runTask(task);
+            if ((_pendingWrites >= kMaxPendingWrites) || (_writeTransaction && _writeTimer.hasExpired(kCommitInterval))) {
+                _commitWrites();
+            }
             lock.relock();
             task->deleteLater();
 
@@ -106,6 +155,17 @@ void QGCCacheWorker::run()
                     lock.relock();
                 }
             }
+        } else if (_writeTransaction) {
+            // Downloads trickle in, give the next tiles a chance to join the transaction
+            const qint64 remaining = kCommitInterval - _writeTimer.elapsed();
+            if (remaining > 0) {
+                (void) _waitc.wait(lock.mutex(), static_cast<unsigned long>(remaining));
+            }
+            if (_taskQueue.isEmpty()) {
+                lock.unlock();
+                _commitWrites();
+                lock.relock();
+            }
         } else {
             (void) _waitc.wait(lock.mutex(), 5000);
             if (_taskQueue.isEmpty()) {
@@ -165,6 +225,51 @@ void QGCCacheWorker::_runTask(QGCMapTask *task)
     }
 }
 
+bool QGCCacheWorker::_runsInWriteBatch(const QGCMapTask *task)
+{
+    switch (task->type()) {
+    case QGCMapTask::TaskType::taskCacheTile:
+    case QGCMapTask::TaskType::taskFetchTile:
+    case QGCMapTask::TaskType::taskGetTileDownloadList:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void QGCCacheWorker::_beginWrites()
+{
+    if (_writeTransaction) {
+        return;
+    }
+
+    _writeTransaction = _db->transaction();
+    if (!_writeTransaction) {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (begin transaction):" << _db->lastError().text();
+        return;
+    }
+
+    _writeTimer.start();
+}
+
+void QGCCacheWorker::_commitWrites()
+{
+    if (!_writeTransaction) {
+        return;
+    }
+
+    _writeTransaction = false;
+    if (!_db->commit()) {
+        // Tiles and their download list entries are rolled back together, the download can still resume
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (commit tiles):" << _db->lastError().text();
+        (void) _db->rollback();
+    } else {
+        qCDebug(QGCTileCacheWorkerLog) << "Committed" << _pendingWrites << "tiles in" << _writeTimer.elapsed() << "ms";
+    }
+
+    _pendingWrites = 0;
+}
+
 void QGCCacheWorker::_deleteBingNoTileTiles()
 {
     static const QString alreadyDoneKey = QStringLiteral("_deleteBingNoTileTilesDone");
@@ -189,7 +294,7 @@ void QGCCacheWorker::_deleteBingNoTileTiles()
     QSqlQuery query(*_db);
     QList<quint64> idsToDelete;
     // Select tiles in default set only, sorted by oldest.
-    QString s = QStringLiteral("SELECT tileID, tile, hash FROM Tiles WHERE LENGTH(tile) = %1").arg(noTileBytes.length());
+    QString s = QStringLiteral("SELECT tileID, tile, tileKey FROM Tiles WHERE LENGTH(tile) = %1").arg(noTileBytes.length());
     if (!query.exec(s)) {
         qCWarning(QGCTileCacheWorkerLog) << "query failed";
         return;
@@ -198,7 +303,7 @@ void QGCCacheWorker::_deleteBingNoTileTiles()
     while (query.next()) {
         if (query.value(1).toByteArray() == noTileBytes) {
             idsToDelete.append(query.value(0).toULongLong());
-            qCDebug(QGCTileCacheWorkerLog) << "HASH:" << query.value(2).toString();
+            qCDebug(QGCTileCacheWorkerLog) << "KEY:" << query.value(2).toULongLong();
         }
     }
 
@@ -246,26 +351,72 @@ void QGCCacheWorker::_saveTile(QGCMapTask *mtask)
     }
 
     QGCSaveTileTask *task = static_cast<QGCSaveTileTask*>(mtask);
-    QSqlQuery query(*_db);
-    (void) query.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-    query.addBindValue(task->tile()->hash);
-    query.addBindValue(task->tile()->format);
-    query.addBindValue(task->tile()->img);
-    query.addBindValue(task->tile()->img.size());
-    query.addBindValue(task->tile()->type);
-    query.addBindValue(QDateTime::currentSecsSinceEpoch());
-    if (!query.exec()) {
+    quint64 key = 0;
+    if (!_tileKeyFromHash(task->tile()->hash, true, key)) {
+        return;
+    }
+
+    QSqlQuery *const query = _statement(StatementSaveTile);
+    if (!query) {
+        return;
+    }
+
+    _beginWrites();
+    _pendingWrites++;
+
+    const bool downloadSet = (task->tile()->tileSet != UINT64_MAX);
+    query->bindValue(0, static_cast<qint64>(key));
+    query->bindValue(1, task->tile()->format);
+    query->bindValue(2, task->tile()->img);
+    query->bindValue(3, task->tile()->img.size());
+    query->bindValue(4, task->tile()->type);
+    query->bindValue(5, QDateTime::currentSecsSinceEpoch());
+    quint64 tileID = 0;
+    bool addToSet = true;
+    if (query->exec()) {
+        tileID = query->lastInsertId().toULongLong();
+    } else if (downloadSet) {
+        // The map view cached the tile since the set was created, it still belongs to the set below
+        tileID = _findTile(key);
+        if (tileID == 0) {
+            // The insert failed for another reason, the tile stays in the download list to be fetched again
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (saveTile() insert):" << query->lastError().text();
+            return;
+        }
+        addToSet = false;
+    } else {
         // Tile was already there.
         // QtLocation some times requests the same tile twice in a row. The first is saved, the second is already there.
         return;
     }
 
-    const quint64 tileID = query.lastInsertId().toULongLong();
-    const quint64 setID = (task->tile()->tileSet == UINT64_MAX) ? _getDefaultTileSet() : task->tile()->tileSet;
-    const QString s = QStringLiteral("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-    (void) query.prepare(s);
-    if (!query.exec()) {
-        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+    const quint64 setID = downloadSet ? task->tile()->tileSet : _getDefaultTileSet();
+    if (downloadSet) {
+        // Leaving the download list in the same transaction as the tile is saved is what lets a
+        // download resume, no other per tile state is written
+        QSqlQuery *const downloadQuery = _statement(StatementRemoveDownloadTile);
+        if (downloadQuery) {
+            downloadQuery->bindValue(0, setID);
+            downloadQuery->bindValue(1, static_cast<qint64>(key));
+            if (!downloadQuery->exec()) {
+                qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (remove tile from TilesDownload):" << downloadQuery->lastError().text();
+            } else if (downloadQuery->numRowsAffected() > 0) {
+                addToSet = true;
+            }
+        }
+    }
+
+    if (!addToSet || (tileID == 0)) {
+        return;
+    }
+
+    QSqlQuery *const setQuery = _statement(StatementAddSetTile);
+    if (setQuery) {
+        setQuery->bindValue(0, tileID);
+        setQuery->bindValue(1, setID);
+        if (!setQuery->exec()) {
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (add tile into SetTiles):" << setQuery->lastError().text();
+        }
     }
 
     qCDebug(QGCTileCacheWorkerLog) << "HASH:" << task->tile()->hash;
@@ -278,18 +429,27 @@ void QGCCacheWorker::_getTile(QGCMapTask* mtask)
     }
 
     QGCFetchTileTask *task = static_cast<QGCFetchTileTask*>(mtask);
-    QSqlQuery query(*_db);
-    const QString s = QStringLiteral("SELECT tile, format, type FROM Tiles WHERE hash = \"%1\"").arg(task->hash());
-    if (query.exec(s) && query.next()) {
-        const QByteArray &arrray = query.value(0).toByteArray();
-        const QString &format = query.value(1).toString();
-        const QString &type = query.value(2).toString();
-        qCDebug(QGCTileCacheWorkerLog) << "(Found in DB) HASH:" << task->hash();
-        QGCCacheTile *tile = new QGCCacheTile(task->hash(), arrray, format, type);
-        task->setTileFetched(tile);
+    if (task->isCancelled()) {
         return;
     }
 
+    quint64 key = 0;
+    QSqlQuery *const query = _tileKeyFromHash(task->hash(), false, key) ? _statement(StatementGetTile) : nullptr;
+    if (query) {
+        query->bindValue(0, static_cast<qint64>(key));
+        if (query->exec() && query->next()) {
+            const QByteArray array = query->value(0).toByteArray();
+            const QString format = query->value(1).toString();
+            const QString type = query->value(2).toString();
+            query->finish();
+            qCDebug(QGCTileCacheWorkerLog) << "(Found in DB) HASH:" << task->hash();
+            QGCCacheTile *tile = new QGCCacheTile(task->hash(), array, format, type);
+            task->setTileFetched(tile);
+            return;
+        }
+        query->finish();
+    }
+
     qCDebug(QGCTileCacheWorkerLog) << "(NOT in DB) HASH:" << task->hash();
     task->setError("Tile not in cache database");
 }
@@ -411,19 +571,111 @@ void QGCCacheWorker::_updateTotals()
     }
 }
 
-quint64 QGCCacheWorker::_findTile(const QString &hash)
+quint64 QGCCacheWorker::_findTile(quint64 tileKey)
 {
     quint64 tileID = 0;
 
-    QSqlQuery query(*_db);
-    const QString s = QStringLiteral("SELECT tileID FROM Tiles WHERE hash = \"%1\"").arg(hash);
-    if (query.exec(s) && query.next()) {
-        tileID = query.value(0).toULongLong();
+    QSqlQuery *const query = _statement(StatementFindTile);
+    if (!query) {
+        return tileID;
+    }
+
+    query->bindValue(0, static_cast<qint64>(tileKey));
+    if (query->exec() && query->next()) {
+        tileID = query->value(0).toULongLong();
     }
+    query->finish();
 
     return tileID;
 }
 
+QSqlQuery *QGCCacheWorker::_statement(Statement statement)
+{
+    static constexpr std::array<const char*, StatementCount> sql = {
+        "SELECT tile, format, type FROM Tiles WHERE tileKey = ?",
+        "SELECT tileID FROM Tiles WHERE tileKey = ?",
+        "INSERT INTO Tiles(tileKey, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)",
+        "INSERT INTO SetTiles(tileID, setID) VALUES(?, ?)",
+        "DELETE FROM TilesDownload WHERE setID = ? AND tileKey = ?",
+    };
+
+    std::unique_ptr<QSqlQuery> &query = _statements[statement];
+    if (!query) {
+        query = std::make_unique<QSqlQuery>(*_db);
+        if (!query->prepare(sql[statement])) {
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (prepare):" << query->lastError().text() << sql[statement];
+            query.reset();
+        }
+    }
+
+    return query.get();
+}
+
+void QGCCacheWorker::_clearStatements()
+{
+    for (std::unique_ptr<QSqlQuery> &query : _statements) {
+        query.reset();
+    }
+}
+
+int QGCCacheWorker::_providerID(int providerHash, bool create)
+{
+    const QHash<int, int>::const_iterator it = _providerIDs.constFind(providerHash);
+    if ((it != _providerIDs.constEnd()) && ((it.value() >= 0) || !create)) {
+        return it.value();
+    }
+
+    QSqlQuery query(*_db);
+    (void) query.prepare("SELECT providerID FROM TileProviders WHERE hash = ?");
+    query.addBindValue(providerHash);
+    if (query.exec() && query.next()) {
+        const int providerID = query.value(0).toInt();
+        (void) _providerIDs.insert(providerHash, providerID);
+        return providerID;
+    }
+
+    if (!create) {
+        (void) _providerIDs.insert(providerHash, -1);
+        return -1;
+    }
+
+    (void) query.prepare("INSERT INTO TileProviders(hash) VALUES(?)");
+    query.addBindValue(providerHash);
+    if (!query.exec()) {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (add provider into TileProviders):" << query.lastError().text();
+        return -1;
+    }
+
+    const int providerID = query.lastInsertId().toInt();
+    if (providerID > kMaxProviderID) {
+        qCWarning(QGCTileCacheWorkerLog) << "Too many tile providers in cache";
+        return -1;
+    }
+
+    (void) _providerIDs.insert(providerHash, providerID);
+    return providerID;
+}
+
+bool QGCCacheWorker::_tileKeyFromHash(const QString &hash, bool create, quint64 &tileKey)
+{
+    int providerHash = 0;
+    int x = 0;
+    int y = 0;
+    int z = 0;
+    if (!UrlFactory::parseTileHash(hash, providerHash, x, y, z)) {
+        qCWarning(QGCTileCacheWorkerLog) << "Invalid tile hash" << hash;
+        return false;
+    }
+
+    const int providerID = _providerID(providerHash, create);
+    if (providerID < 0) {
+        return false;
+    }
+
+    tileKey = QGCCacheWorker::tileKey(providerID, x, y, z);
+    return true;
+}
+
 void QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
 {
     if (!_valid) {
@@ -457,42 +709,67 @@ void QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
     // Get just created (auto-incremented) setID
     const quint64 setID = query.lastInsertId().toULongLong();
     task->tileSet()->setId(setID);
+    const QString type = task->tileSet()->type();
+    const int qtMapId = UrlFactory::getQtMapIdFromProviderType(type);
+    const int providerID = _providerID(UrlFactory::hashFromProviderType(type), true);
+    QSqlQuery *const setQuery = _statement(StatementAddSetTile);
+    if ((providerID < 0) || !setQuery || !query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, tileKey, type, x, y, z, state) VALUES(?, ?, ?, ?, ?, ?, ?)")) {
+        mtask->setError("Error creating tile set download list");
+        return;
+    }
+
     // Prepare Download List
     (void) _db->transaction();
     for (int z = task->tileSet()->minZoom(); z <= task->tileSet()->maxZoom(); z++) {
         const QGCTileSet set = UrlFactory::getTileCount(z,
             task->tileSet()->topleftLon(), task->tileSet()->topleftLat(),
-            task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), task->tileSet()->type());
-        const QString type = task->tileSet()->type();
+            task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), type);
+        // Listed in Z-order, tiles downloaded one after another are neighbours and are stored next to each other
+        struct ListedTile {
+            quint64 zOrder;
+            int x;
+            int y;
+        };
+        std::vector<ListedTile> listed;
+        listed.reserve(static_cast<size_t>(set.tileX1 - set.tileX0 + 1) * static_cast<size_t>(set.tileY1 - set.tileY0 + 1));
         for (int x = set.tileX0; x <= set.tileX1; x++) {
             for (int y = set.tileY0; y <= set.tileY1; y++) {
-                // See if tile is already downloaded
-                const QString hash = UrlFactory::getTileHash(type, x, y, z);
-                const quint64 tileID = _findTile(hash);
-                if (tileID == 0) {
-                    // Set to download
-                    (void) query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ? ,? ,?)");
-                    query.addBindValue(setID);
-                    query.addBindValue(hash);
-                    query.addBindValue(UrlFactory::getQtMapIdFromProviderType(type));
-                    query.addBindValue(x);
-                    query.addBindValue(y);
-                    query.addBindValue(z);
-                    query.addBindValue(0);
-                    if (!query.exec()) {
-                        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (add tile into TilesDownload):" << query.lastError().text();
-                        mtask->setError("Error creating tile set download list");
-                        return;
-                    }
-                } else {
-                    // Tile already in the database. No need to dowload.
-                    const QString s = QStringLiteral("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-                    (void) query.prepare(s);
-                    if (!query.exec()) {
-                        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
-                    }
-                    qCDebug(QGCTileCacheWorkerLog) << "Already Cached HASH:" << hash;
+                listed.push_back({ UrlFactory::tileZOrder(x - set.tileX0, y - set.tileY0), x, y });
+            }
+        }
+        std::sort(listed.begin(), listed.end(), [](const ListedTile &a, const ListedTile &b) {
+            return (a.zOrder < b.zOrder);
+        });
+
+        for (const ListedTile &listedTile : listed) {
+            const int x = listedTile.x;
+            const int y = listedTile.y;
+            // See if tile is already downloaded
+            const quint64 key = tileKey(providerID, x, y, z);
+            const quint64 tileID = _findTile(key);
+            if (tileID == 0) {
+                // Set to download
+                query.bindValue(0, setID);
+                query.bindValue(1, static_cast<qint64>(key));
+                query.bindValue(2, qtMapId);
+                query.bindValue(3, x);
+                query.bindValue(4, y);
+                query.bindValue(5, z);
+                query.bindValue(6, 0);
+                if (!query.exec()) {
+                    qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (add tile into TilesDownload):" << query.lastError().text();
+                    (void) _db->rollback();
+                    mtask->setError("Error creating tile set download list");
+                    return;
+                }
+            } else {
+                // Tile already in the database. No need to dowload.
+                setQuery->bindValue(0, tileID);
+                setQuery->bindValue(1, setID);
+                if (!setQuery->exec()) {
+                    qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (add tile into SetTiles):" << setQuery->lastError().text();
                 }
+                qCDebug(QGCTileCacheWorkerLog) << "Already Cached:" << type << x << y << z;
             }
         }
     }
@@ -509,28 +786,30 @@ void QGCCacheWorker::_getTileDownloadList(QGCMapTask *mtask)
 
     QQueue<QGCTile*> tiles;
     QGCGetTileDownloadListTask *task = static_cast<QGCGetTileDownloadListTask*>(mtask);
+    qint64 lastRowID = task->afterRowID();
+    // Walks the list by rowid instead of marking tiles as downloading, tiles leave the list once saved
     QSqlQuery query(*_db);
-    QString s = QStringLiteral("SELECT hash, type, x, y, z FROM TilesDownload WHERE setID = %1 AND state = 0 LIMIT %2").arg(task->setID()).arg(task->count());
-    if (query.exec(s)) {
+    (void) query.prepare("SELECT rowid, type, x, y, z FROM TilesDownload WHERE setID = ? AND state = ? AND rowid > ? ORDER BY rowid LIMIT ?");
+    query.addBindValue(task->setID());
+    query.addBindValue(static_cast<int>(QGCTile::StatePending));
+    query.addBindValue(lastRowID);
+    query.addBindValue(task->count());
+    if (query.exec()) {
         while (query.next()) {
             QGCTile *tile = new QGCTile;
             // tile->setTileSet(task->setID());
-            tile->hash = query.value("hash").toString();
-            tile->type = UrlFactory::getProviderTypeFromQtMapId(query.value("type").toInt());
-            tile->x = query.value("x").toInt();
-            tile->y = query.value("y").toInt();
-            tile->z = query.value("z").toInt();
+            lastRowID = query.value(0).toLongLong();
+            tile->type = UrlFactory::getProviderTypeFromQtMapId(query.value(1).toInt());
+            tile->x = query.value(2).toInt();
+            tile->y = query.value(3).toInt();
+            tile->z = query.value(4).toInt();
+            tile->hash = UrlFactory::getTileHash(tile->type, tile->x, tile->y, tile->z);
             tiles.enqueue(tile);
         }
-
-        for (int i = 0; i < tiles.size(); i++) {
-            s = QStringLiteral("UPDATE TilesDownload SET state = %1 WHERE setID = %2 and hash = \"%3\"").arg(static_cast<int>(QGCTile::StateDownloading)).arg(task->setID()).arg(tiles[i]->hash);
-            if (!query.exec(s)) {
-                qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (set TilesDownload state):" << query.lastError().text();
-            }
-        }
+    } else {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (get TilesDownload):" << query.lastError().text();
     }
-    task->setTileListFetched(tiles);
+    task->setTileListFetched(tiles, lastRowID);
 }
 
 void QGCCacheWorker::_updateTileDownloadState(QGCMapTask *mtask)
@@ -541,16 +820,27 @@ void QGCCacheWorker::_updateTileDownloadState(QGCMapTask *mtask)
 
     QGCUpdateTileDownloadStateTask *task = static_cast<QGCUpdateTileDownloadStateTask*>(mtask);
     QSqlQuery query(*_db);
-    QString s;
-    if (task->state() == QGCTile::StateComplete) {
-        s = QStringLiteral("DELETE FROM TilesDownload WHERE setID = %1 AND hash = \"%2\"").arg(task->setID()).arg(task->hash());
-    } else if (task->hash() == "*") {
-        s = QStringLiteral("UPDATE TilesDownload SET state = %1 WHERE setID = %2").arg(static_cast<int>(task->state())).arg(task->setID());
+    if ((task->hash() == "*") && (task->state() != QGCTile::StateComplete)) {
+        (void) query.prepare("UPDATE TilesDownload SET state = ? WHERE setID = ?");
+        query.addBindValue(static_cast<int>(task->state()));
+        query.addBindValue(task->setID());
     } else {
-        s = QStringLiteral("UPDATE TilesDownload SET state = %1 WHERE setID = %2 AND hash = \"%3\"").arg(static_cast<int>(task->state())).arg(task->setID()).arg(task->hash());
+        quint64 key = 0;
+        if (!_tileKeyFromHash(task->hash(), false, key)) {
+            return;
+        }
+
+        if (task->state() == QGCTile::StateComplete) {
+            (void) query.prepare("DELETE FROM TilesDownload WHERE setID = ? AND tileKey = ?");
+        } else {
+            (void) query.prepare("UPDATE TilesDownload SET state = ? WHERE setID = ? AND tileKey = ?");
+            query.addBindValue(static_cast<int>(task->state()));
+        }
+        query.addBindValue(task->setID());
+        query.addBindValue(static_cast<qint64>(key));
     }
 
-    if (!query.exec(s)) {
+    if (!query.exec()) {
         qCWarning(QGCTileCacheWorkerLog) << "Error:" << query.lastError().text();
     }
 }
@@ -564,7 +854,7 @@ void QGCCacheWorker::_pruneCache(QGCMapTask *mtask)
     QGCPruneCacheTask *task = static_cast<QGCPruneCacheTask*>(mtask);
     QSqlQuery query(*_db);
     // Select tiles in default set only, sorted by oldest.
-    QString s = QStringLiteral("SELECT tileID, size, hash FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1) ORDER BY DATE ASC LIMIT 128").arg(_getDefaultTileSet());
+    QString s = QStringLiteral("SELECT tileID, size, tileKey FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1) ORDER BY DATE ASC LIMIT 128").arg(_getDefaultTileSet());
     if (!query.exec(s)) {
         return;
     }
@@ -574,7 +864,7 @@ void QGCCacheWorker::_pruneCache(QGCMapTask *mtask)
     while (query.next() && (amount >= 0)) {
         tlist << query.value(0).toULongLong();
         amount -= query.value(1).toULongLong();
-        qCDebug(QGCTileCacheWorkerLog) << "HASH:" << query.value(2).toString();
+        qCDebug(QGCTileCacheWorkerLog) << "KEY:" << query.value(2).toULongLong();
     }
 
     while (!tlist.isEmpty()) {
@@ -635,6 +925,8 @@ void QGCCacheWorker::_resetCacheDatabase(QGCMapTask *mtask)
     }
 
     QGCResetTask *task = static_cast<QGCResetTask*>(mtask);
+    _clearStatements();
+    _providerIDs.clear();
     QSqlQuery query(*_db);
     QString s = QStringLiteral("DROP TABLE Tiles");
     (void) query.exec(s);
@@ -644,7 +936,12 @@ void QGCCacheWorker::_resetCacheDatabase(QGCMapTask *mtask)
     (void) query.exec(s);
     s = QStringLiteral("DROP TABLE TilesDownload");
     (void) query.exec(s);
+    s = QStringLiteral("DROP TABLE TileProviders");
+    (void) query.exec(s);
     _valid = _createDB(*_db);
+    if (_valid) {
+        emit databaseReady();
+    }
     task->setResetCompleted();
 }
 
@@ -657,9 +954,14 @@ void QGCCacheWorker::_importSets(QGCMapTask *mtask)
     QGCImportTileTask *task = static_cast<QGCImportTileTask*>(mtask);
     // If replacing, simply copy over it
     if (task->replace()) {
-        // Close and delete old database
+        // Close and delete old database, the readers let go of it and its WAL files first
+        if (_readPool) {
+            _readPool->suspend();
+        }
         _disconnectDB();
         (void) QFile::remove(_databasePath);
+        (void) QFile::remove(_databasePath + QStringLiteral("-wal"));
+        (void) QFile::remove(_databasePath + QStringLiteral("-shm"));
         // Copy given database
         (void) QFile::copy(task->path(), _databasePath);
         task->setProgress(25);
@@ -668,6 +970,9 @@ void QGCCacheWorker::_importSets(QGCMapTask *mtask)
             task->setProgress(50);
             _connectDB();
         }
+        if (_readPool) {
+            _readPool->resume();
+        }
         task->setProgress(100);
     } else {
         // Open imported set
@@ -676,6 +981,19 @@ void QGCCacheWorker::_importSets(QGCMapTask *mtask)
         dbImport->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
         if (dbImport->open()) {
             QSqlQuery query(*dbImport);
+            // Databases from before tile keys still identify tiles by their hash
+            const bool keyed = query.exec("PRAGMA user_version") && query.next() && (query.value(0).toInt() >= 1);
+            // Provider ids are local to a database, map the imported ones to ours
+            QHash<int, int> importProviderIDs;
+            if (keyed && query.exec("SELECT providerID, hash FROM TileProviders")) {
+                while (query.next()) {
+                    (void) importProviderIDs.insert(query.value(0).toInt(), _providerID(query.value(1).toInt(), true));
+                }
+            }
+            QSqlQuery *const saveQuery = _statement(StatementSaveTile);
+            QSqlQuery *const setQuery = _statement(StatementAddSetTile);
+            constexpr int providerShift = kKeyZoomBits + (2 * kKeyCoordBits);
+            constexpr quint64 tileMask = (1ULL << providerShift) - 1;
             // Prepare progress report
             quint64 tileCount = 0;
             int lastProgress = -1;
@@ -685,7 +1003,7 @@ void QGCCacheWorker::_importSets(QGCMapTask *mtask)
                 tileCount  = query.value(0).toULongLong();
             }
 
-            if (tileCount > 0) {
+            if ((tileCount > 0) && saveQuery && setQuery) {
                 // Iterate Tile Sets
                 s = QStringLiteral("SELECT * FROM TileSets ORDER BY defaultSet DESC, name ASC");
                 if (query.exec(s)) {
@@ -754,24 +1072,33 @@ void QGCCacheWorker::_importSets(QGCMapTask *mtask)
                             (void) _db->transaction();
                             while (subQuery.next()) {
                                 tilesFound++;
-                                const QString hash = subQuery.value("hash").toString();
+                                quint64 key = 0;
+                                if (keyed) {
+                                    const quint64 importKey = subQuery.value("tileKey").toULongLong();
+                                    const int providerID = importProviderIDs.value(static_cast<int>(importKey >> providerShift), -1);
+                                    if (providerID < 0) {
+                                        continue;
+                                    }
+                                    key = (static_cast<quint64>(providerID) << providerShift) | (importKey & tileMask);
+                                } else if (!_tileKeyFromHash(subQuery.value("hash").toString(), true, key)) {
+                                    continue;
+                                }
                                 const QString format = subQuery.value("format").toString();
                                 const QByteArray img = subQuery.value("tile").toByteArray();
                                 const int type = subQuery.value("type").toInt();
                                 // Save tile
-                                (void) cQuery.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-                                cQuery.addBindValue(hash);
-                                cQuery.addBindValue(format);
-                                cQuery.addBindValue(img);
-                                cQuery.addBindValue(img.size());
-                                cQuery.addBindValue(type);
-                                cQuery.addBindValue(QDateTime::currentSecsSinceEpoch());
-                                if (cQuery.exec()) {
+                                saveQuery->bindValue(0, static_cast<qint64>(key));
+                                saveQuery->bindValue(1, format);
+                                saveQuery->bindValue(2, img);
+                                saveQuery->bindValue(3, img.size());
+                                saveQuery->bindValue(4, type);
+                                saveQuery->bindValue(5, QDateTime::currentSecsSinceEpoch());
+                                if (saveQuery->exec()) {
                                     tilesSaved++;
-                                    const quint64 importTileID = cQuery.lastInsertId().toULongLong();
-                                    const QString s2 = QStringLiteral("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(importTileID).arg(insertSetID);
-                                    (void) cQuery.prepare(s2);
-                                    (void) cQuery.exec();
+                                    const quint64 importTileID = saveQuery->lastInsertId().toULongLong();
+                                    setQuery->bindValue(0, importTileID);
+                                    setQuery->bindValue(1, insertSetID);
+                                    (void) setQuery->exec();
                                     currentCount++;
                                     if (tileCount > 0) {
                                         const int progress = static_cast<int>((static_cast<double>(currentCount) / static_cast<double>(tileCount)) * 100.0);
@@ -840,6 +1167,20 @@ void QGCCacheWorker::_exportSets(QGCMapTask *mtask)
     dbExport->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
     if (dbExport->open()) {
         if (_createDB(*dbExport, false)) {
+            // Tile keys refer to our provider ids, so the exported database gets the same ones
+            QSqlQuery providerQuery(*_db);
+            QSqlQuery exportProviderQuery(*dbExport);
+            (void) exportProviderQuery.prepare("INSERT INTO TileProviders(providerID, hash) VALUES(?, ?)");
+            if (providerQuery.exec("SELECT providerID, hash FROM TileProviders")) {
+                while (providerQuery.next()) {
+                    exportProviderQuery.bindValue(0, providerQuery.value(0));
+                    exportProviderQuery.bindValue(1, providerQuery.value(1));
+                    if (!exportProviderQuery.exec()) {
+                        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (export TileProviders):" << exportProviderQuery.lastError().text();
+                    }
+                }
+            }
+
             // Prepare progress report
             quint64 tileCount = 0;
             quint64 currentCount = 0;
@@ -901,13 +1242,13 @@ void QGCCacheWorker::_exportSets(QGCMapTask *mtask)
                         continue;
                     }
 
-                    const QString hash = subQuery.value("hash").toString();
+                    const qint64 key = subQuery.value("tileKey").toLongLong();
                     const QString format = subQuery.value("format").toString();
                     const QByteArray img = subQuery.value("tile").toByteArray();
                     const int type = subQuery.value("type").toInt();
                     // Save tile
-                    (void) exportQuery.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-                    exportQuery.addBindValue(hash);
+                    (void) exportQuery.prepare("INSERT INTO Tiles(tileKey, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
+                    exportQuery.addBindValue(key);
                     exportQuery.addBindValue(format);
                     exportQuery.addBindValue(img);
                     exportQuery.addBindValue(img.size());
@@ -955,7 +1296,19 @@ bool QGCCacheWorker::_init()
         qCDebug(QGCTileCacheWorkerLog) << "Mapping cache directory:" << _databasePath;
         // Initialize Database
         if (_connectDB()) {
-            _valid = _createDB(*_db);
+            if (!_migrateDB()) {
+                // The old cache is kept aside and an empty one started in its place
+                _disconnectDB();
+                const QString backupPath = _backupDB();
+                if (!backupPath.isEmpty()) {
+                    qCWarning(QGCTileCacheWorkerLog) << "Map Cache migration failed, old cache kept as" << backupPath;
+                    (void) _connectDB();
+                } else {
+                    qCCritical(QGCTileCacheWorkerLog) << "Map Cache migration failed and the old cache could not be moved aside";
+                    _valid = false;
+                }
+            }
+            _valid = _valid && _createDB(*_db);
             if (!_valid) {
                 _failed = true;
             }
@@ -969,6 +1322,10 @@ bool QGCCacheWorker::_init()
         _failed = true;
     }
 
+    if (!_failed) {
+        emit databaseReady();
+    }
+
     return !_failed;
 }
 
@@ -978,26 +1335,141 @@ bool QGCCacheWorker::_connectDB()
     _db->setDatabaseName(_databasePath);
     _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
     _valid = _db->open();
+    if (_valid) {
+        // WAL lets readers run alongside a writer and makes each commit a sequential append
+        static constexpr const char *pragmas[] = {
+            "PRAGMA journal_mode = WAL",
+            "PRAGMA synchronous = NORMAL",
+            "PRAGMA temp_store = MEMORY",
+            "PRAGMA cache_size = -16384",
+            "PRAGMA mmap_size = 268435456",
+        };
+        QSqlQuery query(*_db);
+        for (const char *pragma : pragmas) {
+            if (!query.exec(pragma)) {
+                qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (pragma):" << pragma << query.lastError().text();
+            }
+        }
+    }
     return _valid;
 }
 
+QString QGCCacheWorker::_backupDB() const
+{
+    const QString backupPath = QStringLiteral("%1.%2.bak").arg(_databasePath, QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss")));
+    if (!QFile::rename(_databasePath, backupPath)) {
+        return QString();
+    }
+
+    // Whatever is left in the WAL belongs to the old cache
+    for (const QLatin1String suffix : { QLatin1String("-wal"), QLatin1String("-shm") }) {
+        if (QFile::exists(_databasePath + suffix)) {
+            (void) QFile::rename(_databasePath + suffix, backupPath + suffix);
+        }
+    }
+
+    return backupPath;
+}
+
+bool QGCCacheWorker::_migrateDB()
+{
+    QSqlDatabase &db = *_db;
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (read schema version):" << query.lastError().text();
+        return false;
+    }
+
+    if (query.value(0).toInt() >= kSchemaVersion) {
+        return true;
+    }
+
+    if (!query.exec("SELECT name FROM sqlite_master WHERE type = 'table' AND name = 'Tiles'")) {
+        return false;
+    }
+    if (!query.next()) {
+        // New database
+        return true;
+    }
+    query.finish();
+
+    qCDebug(QGCTileCacheWorkerLog) << "Migrating map cache to tile keys";
+
+    bool res = db.transaction()
+        && query.exec(kCreateTileProvidersSql)
+        && query.exec("ALTER TABLE Tiles RENAME TO TilesLegacy")
+        && query.exec("DROP INDEX IF EXISTS hash")
+        && query.exec(kCreateTilesSql)
+        && query.exec("ALTER TABLE TilesDownload RENAME TO TilesDownloadLegacy")
+        && query.exec(kCreateTilesDownloadSql);
+
+    quint64 dropped = 0;
+    if (res) {
+        QSqlQuery select(db);
+        QSqlQuery insert(db);
+        res = select.exec("SELECT tileID, hash, format, tile, size, type, date FROM TilesLegacy")
+            && insert.prepare("INSERT INTO Tiles(tileID, tileKey, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?, ?)");
+        while (res && select.next()) {
+            quint64 key = 0;
+            if (!_tileKeyFromHash(select.value(1).toString(), true, key)) {
+                dropped++;
+                continue;
+            }
+            insert.bindValue(0, select.value(0));
+            insert.bindValue(1, static_cast<qint64>(key));
+            for (int i = 2; i < 7; i++) {
+                insert.bindValue(i, select.value(i));
+            }
+            res = insert.exec();
+        }
+    }
+
+    if (res) {
+        QSqlQuery select(db);
+        QSqlQuery insert(db);
+        res = select.exec("SELECT setID, hash, type, x, y, z, state FROM TilesDownloadLegacy")
+            && insert.prepare("INSERT OR IGNORE INTO TilesDownload(setID, tileKey, type, x, y, z, state) VALUES(?, ?, ?, ?, ?, ?, ?)");
+        while (res && select.next()) {
+            quint64 key = 0;
+            if (!_tileKeyFromHash(select.value(1).toString(), true, key)) {
+                continue;
+            }
+            insert.bindValue(0, select.value(0));
+            insert.bindValue(1, static_cast<qint64>(key));
+            for (int i = 2; i < 7; i++) {
+                insert.bindValue(i, select.value(i));
+            }
+            res = insert.exec();
+        }
+    }
+
+    res = res
+        && query.exec("DROP TABLE TilesLegacy")
+        && query.exec("DROP TABLE TilesDownloadLegacy")
+        && ((dropped == 0) || query.exec("DELETE FROM SetTiles WHERE tileID NOT IN (SELECT tileID FROM Tiles)"))
+        && query.exec(QStringLiteral("PRAGMA user_version = %1").arg(kSchemaVersion))
+        && db.commit();
+
+    if (!res) {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (migrate):" << query.lastError().text() << db.lastError().text();
+        (void) db.rollback();
+    } else if (dropped > 0) {
+        qCWarning(QGCTileCacheWorkerLog) << "Dropped" << dropped << "tiles with invalid hashes during migration";
+    }
+
+    _clearStatements();
+    _providerIDs.clear();
+
+    return res;
+}
+
 bool QGCCacheWorker::_createDB(QSqlDatabase &db, bool createDefault)
 {
     bool res = false;
     QSqlQuery query(db);
-    if (!query.exec(
-        "CREATE TABLE IF NOT EXISTS Tiles ("
-        "tileID INTEGER PRIMARY KEY NOT NULL, "
-        "hash TEXT NOT NULL UNIQUE, "
-        "format TEXT NOT NULL, "
-        "tile BLOB NULL, "
-        "size INTEGER, "
-        "type INTEGER, "
-        "date INTEGER DEFAULT 0)"))
-    {
+    if (!query.exec(kCreateTilesSql)) {
         qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (create Tiles db):" << query.lastError().text();
     } else {
-        (void) query.exec("CREATE INDEX IF NOT EXISTS hash ON Tiles ( hash, size, type ) ");
         if (!query.exec(
             "CREATE TABLE IF NOT EXISTS TileSets ("
             "setID INTEGER PRIMARY KEY NOT NULL, "
@@ -1020,16 +1492,12 @@ bool QGCCacheWorker::_createDB(QSqlDatabase &db, bool createDefault)
             "setID INTEGER, "
             "tileID INTEGER)")) {
             qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (create SetTiles db):" << query.lastError().text();
-        } else if (!query.exec(
-            "CREATE TABLE IF NOT EXISTS TilesDownload ("
-            "setID INTEGER, "
-            "hash TEXT NOT NULL UNIQUE, "
-            "type INTEGER, "
-            "x INTEGER, "
-            "y INTEGER, "
-            "z INTEGER, "
-            "state INTEGER DEFAULT 0)")) {
+        } else if (!query.exec(kCreateTilesDownloadSql)) {
             qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (create TilesDownload db):" << query.lastError().text();
+        } else if (!query.exec(kCreateTileProvidersSql)) {
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (create TileProviders db):" << query.lastError().text();
+        } else if (!query.exec(QStringLiteral("PRAGMA user_version = %1").arg(kSchemaVersion))) {
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (set schema version):" << query.lastError().text();
         } else {
             // Database it ready for use
             res = true;
@@ -1065,6 +1533,9 @@ bool QGCCacheWorker::_createDB(QSqlDatabase &db, bool createDefault)
 void QGCCacheWorker::_disconnectDB()
 {
     if (_db) {
+        _commitWrites();
+        _clearStatements();
+        _providerIDs.clear();
         _db.reset();
         QSqlDatabase::removeDatabase(kSession);
     }
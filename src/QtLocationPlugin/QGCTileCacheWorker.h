@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QQueue>
@@ -16,11 +18,16 @@
 #include <QtCore/QThread>
 #include <QtCore/QWaitCondition>
 
+#include <array>
+#include <memory>
+
 Q_DECLARE_LOGGING_CATEGORY(QGCTileCacheWorkerLog)
 
 class QGCMapTask;
+class QGCTileReadPool;
 class QGCCachedTileSet;
 class QSqlDatabase;
+class QSqlQuery;
 
 class QGCCacheWorker : public QThread
 {
@@ -31,6 +38,12 @@ class QGCCacheWorker : public QThread
     ~QGCCacheWorker();
 
     void setDatabaseFile(const QString &path) { _databasePath = path; }
+    /// Readers sharing the database, suspended while an import replaces the file
+    void setReadPool(QGCTileReadPool *readPool) { _readPool = readPool; }
+    bool isValid() const { return _valid; }
+
+    /// Packs a per database provider id, zoom and tile coordinates into the integer key of a tile
+    static quint64 tileKey(int providerID, int x, int y, int z);
 
 public slots:
     bool enqueueTask(QGCMapTask *task);
@@ -38,12 +51,18 @@ public slots:
 
 signals:
     void updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
+    /// The database was created, replaced or reset and is ready for other connections
+    void databaseReady();
 
 protected:
     void run() final;
 
 private:
     void _runTask(QGCMapTask *task);
+    /// Tile saves share one transaction, committed every kMaxPendingWrites tiles or kCommitInterval
+    void _beginWrites();
+    void _commitWrites();
+    static bool _runsInWriteBatch(const QGCMapTask *task);
 
     void _saveTile(QGCMapTask *task);
     void _getTile(QGCMapTask *task);
@@ -59,12 +78,32 @@ public slots:
     void _exportSets(QGCMapTask *task);
     bool _testTask(QGCMapTask *task);
 
+    enum Statement {
+        StatementGetTile,
+        StatementFindTile,
+        StatementSaveTile,
+        StatementAddSetTile,
+        StatementRemoveDownloadTile,
+        StatementCount
+    };
+
     bool _connectDB();
     void _disconnectDB();
     bool _createDB(QSqlDatabase &db, bool createDefault = true);
+    /// Converts a cache from before tile keys, see kSchemaVersion
+    bool _migrateDB();
+    /// Moves the closed database aside
+    ///     @return path it was moved to, empty on failure
+    QString _backupDB() const;
     bool _findTileSetID(const QString &name, quint64 &setID);
     bool _init();
-    quint64 _findTile(const QString &hash);
+    quint64 _findTile(quint64 tileKey);
+    /// Prepared once per connection and reused for every call
+    QSqlQuery *_statement(Statement statement);
+    void _clearStatements();
+    /// Id of the provider in the TileProviders table, -1 if it isn't there and create is false
+    int _providerID(int providerHash, bool create);
+    bool _tileKeyFromHash(const QString &hash, bool create, quint64 &tileKey);
     quint64 _getDefaultTileSet();
     void _deleteBingNoTileTiles();
     void _deleteTileSet(quint64 id);
@@ -72,10 +111,13 @@ public slots:
     void _updateTotals();
 
     std::shared_ptr<QSqlDatabase> _db = nullptr;
+    std::array<std::unique_ptr<QSqlQuery>, StatementCount> _statements;
+    QHash<int, int> _providerIDs;   ///< Provider hash to provider id
     QMutex _taskQueueMutex;
     QQueue<QGCMapTask*> _taskQueue;
     QWaitCondition _waitc;
     QString _databasePath;
+    QGCTileReadPool *_readPool = nullptr;
     quint32 _defaultCount = 0;
     quint32 _totalCount = 0;
     quint64 _defaultSet = UINT64_MAX;
@@ -83,6 +125,9 @@ public slots:
     quint64 _totalSize = 0;
     QElapsedTimer _updateTimer;
     int _updateTimeout = kShortTimeout;
+    QElapsedTimer _writeTimer;      ///< Started with the open write transaction
+    int _pendingWrites = 0;         ///< Tiles saved in the open write transaction
+    bool _writeTransaction = false;
     std::atomic_bool _failed = false;
     std::atomic_bool _valid = false;
 
@@ -90,4 +135,15 @@ public slots:
     static constexpr const char *kExportSession = "QGeoTileExportSession";
     static constexpr int kShortTimeout = 2;
     static constexpr int kLongTimeout = 5;
+    static constexpr int kMaxPendingWrites = 256;
+    static constexpr int kCommitInterval = 500;     ///< ms
+
+    /// PRAGMA user_version of the current schema. 0 is the original schema keyed by text hashes.
+    static constexpr int kSchemaVersion = 1;
+
+    // Tile key layout, 63 bits so it stays a positive SQLite integer
+    static constexpr int kKeyCoordBits = 23;    ///< QGC_MAX_MAP_ZOOM
+    static constexpr int kKeyZoomBits = 5;
+    static constexpr int kKeyProviderBits = 12;
+    static constexpr int kMaxProviderID = (1 << kKeyProviderBits) - 1;
 };
@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileDownloader.h"
+
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QTimer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkReply>
+
+#include <algorithm>
+
+#include "QGCFileDownload.h"
+#include "QGCLoggingCategory.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCTile.h"
+#include "QGeoTileFetcherQGC.h"
+
+QGC_LOGGING_CATEGORY(QGCTileDownloaderLog, "qgc.qtlocationplugin.qgctiledownloader")
+
+QGCTileDownloader::QGCTileDownloader(QObject *parent)
+    : QObject(parent)
+    , _networkManager(new QNetworkAccessManager(this))
+    , _requestFactory(&QGCTileDownloader::_defaultRequest)
+{
+#if !defined(Q_OS_IOS) && !defined(Q_OS_ANDROID)
+    QNetworkProxy proxy = _networkManager->proxy();
+    proxy.setType(QNetworkProxy::DefaultProxy);
+    _networkManager->setProxy(proxy);
+#endif
+
+    qCDebug(QGCTileDownloaderLog) << this;
+}
+
+QGCTileDownloader::~QGCTileDownloader()
+{
+    abort();
+
+    qCDebug(QGCTileDownloaderLog) << this << "downloaded:" << _stats.downloaded << "failed:" << _stats.failed
+                                  << "retried:" << _stats.retried << "http2:" << _stats.http2;
+}
+
+void QGCTileDownloader::setConcurrency(int initial, int minimum, int maximum)
+{
+    _minimum = qMax(1, minimum);
+    _maximum = qMax(_minimum, maximum);
+    _limit = qBound(_minimum, initial, _maximum);
+
+    _schedule();
+}
+
+void QGCTileDownloader::enqueue(const QList<QGCTile*> &tiles)
+{
+    QList<Job> jobs;
+    jobs.reserve(tiles.size());
+    for (QGCTile *tile : tiles) {
+        Job job;
+        job.tile = tile;
+        jobs.append(job);
+    }
+
+    // Neighbouring tiles requested together are saved next to each other
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b) {
+        if (a.tile->z != b.tile->z) {
+            return (a.tile->z < b.tile->z);
+        }
+        return (UrlFactory::tileZOrder(a.tile->x, a.tile->y) < UrlFactory::tileZOrder(b.tile->x, b.tile->y));
+    });
+
+    _pending.append(jobs);
+    _schedule();
+}
+
+void QGCTileDownloader::clearPending()
+{
+    for (const Job &job : std::as_const(_pending)) {
+        delete job.tile;
+    }
+    _pending.clear();
+
+    for (const Job &job : std::as_const(_retrying)) {
+        delete job.tile;
+    }
+    _retrying.clear();
+
+    _abortCount++;
+}
+
+void QGCTileDownloader::abort()
+{
+    clearPending();
+
+    for (auto it = _replies.constBegin(); it != _replies.constEnd(); ++it) {
+        QNetworkReply *const reply = it.key();
+        (void) reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+        delete it.value().tile;
+    }
+    _replies.clear();
+}
+
+void QGCTileDownloader::_schedule()
+{
+    while (!_pending.isEmpty() && (_replies.size() < concurrency())) {
+        _send(_pending.takeFirst());
+    }
+}
+
+void QGCTileDownloader::_send(Job job)
+{
+    QNetworkRequest request = _requestFactory(*job.tile);
+    if (request.url().isEmpty()) {
+        _stats.failed++;
+        emit tileFailed(job.tile->hash, tr("No tile URL"));
+        delete job.tile;
+        return;
+    }
+
+    request.setOriginatingObject(this);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+
+    QNetworkReply *const reply = _networkManager->get(request);
+    QGCFileDownload::setIgnoreSSLErrorsIfNeeded(*reply);
+    (void) connect(reply, &QNetworkReply::finished, this, &QGCTileDownloader::_replyFinished);
+
+    job.sent.start();
+    (void) _replies.insert(reply, job);
+}
+
+void QGCTileDownloader::_replyFinished()
+{
+    QNetworkReply *const reply = qobject_cast<QNetworkReply*>(QObject::sender());
+    if (!reply) {
+        return;
+    }
+    reply->deleteLater();
+
+    const auto it = _replies.constFind(reply);
+    if (it == _replies.constEnd()) {
+        qCWarning(QGCTileDownloaderLog) << "Reply not in list";
+        return;
+    }
+    const Job job = it.value();
+    (void) _replies.erase(it);
+
+    if (reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) {
+        _stats.http2++;
+        if (!_http2) {
+            _http2 = true;
+            qCDebug(QGCTileDownloaderLog) << "Provider multiplexes over HTTP/2" << reply->url().host();
+        }
+    }
+
+    if (reply->error() == QNetworkReply::NoError) {
+        _adaptLimit(job.sent.nsecsElapsed() / 1e6);
+        _stats.downloaded++;
+        emit tileDownloaded(job.tile->hash, reply->readAll());
+        delete job.tile;
+    } else if (_isRetryable(reply)) {
+        _backOff();
+        if (job.retries < kMaxRetries) {
+            _retry(job, reply);
+        } else {
+            _stats.failed++;
+            qCDebug(QGCTileDownloaderLog) << "Giving up on" << job.tile->hash << reply->errorString();
+            emit tileFailed(job.tile->hash, reply->errorString());
+            delete job.tile;
+        }
+    } else {
+        _stats.failed++;
+        qCDebug(QGCTileDownloaderLog) << "Error fetching tile" << job.tile->hash << reply->errorString();
+        emit tileFailed(job.tile->hash, reply->errorString());
+        delete job.tile;
+    }
+
+    _schedule();
+}
+
+void QGCTileDownloader::_retry(Job job, QNetworkReply *reply)
+{
+    job.retries++;
+    _stats.retried++;
+
+    int delay = qMin(kMaxBackoff, kBaseBackoff << (job.retries - 1));
+    bool ok = false;
+    const int retryAfter = reply->rawHeader(QByteArrayLiteral("Retry-After")).toInt(&ok);
+    if (ok && (retryAfter >= 0)) {
+        delay = qMin(kMaxBackoff, retryAfter * 1000);
+    } else {
+        // Jitter spreads out the retries of a burst of failures
+        delay = (delay / 2) + static_cast<int>(QRandomGenerator::global()->bounded((delay / 2) + 1));
+    }
+    qCDebug(QGCTileDownloaderLog) << "Retrying" << job.tile->hash << "in" << delay << "ms" << reply->errorString();
+
+    QGCTile *const tile = job.tile;
+    const quint64 abortCount = _abortCount;
+    _retrying.append(job);
+    QTimer::singleShot(delay, this, [this, tile, abortCount]() {
+        if (abortCount != _abortCount) {
+            return;
+        }
+
+        for (qsizetype i = 0; i < _retrying.size(); i++) {
+            if (_retrying[i].tile == tile) {
+                _pending.prepend(_retrying.takeAt(i));
+                break;
+            }
+        }
+        _schedule();
+    });
+}
+
+void QGCTileDownloader::_adaptLimit(double latency)
+{
+    _latency = (_latency > 0.) ? (_latency + (kLatencySmoothing * (latency - _latency))) : latency;
+    // Drifts up slowly so a slower route to the provider is learnt again
+    _baseLatency = (_baseLatency > 0.) ? qMin(latency, _baseLatency * 1.001) : latency;
+
+    if (_latency <= ((_baseLatency * kLatencyTolerance) + kLatencySlack)) {
+        // About one more request in flight per round of replies
+        _limit = qMin<double>(_ceiling(), _limit + (1. / _limit));
+    } else {
+        // Requests queue up somewhere on the way, ease off
+        _limit = qMax<double>(_minimum, _limit - (1. / _limit));
+    }
+}
+
+void QGCTileDownloader::_backOff()
+{
+    // A burst of failures from the same round of requests is a single congestion event
+    if (_decreaseTimer.isValid() && (_decreaseTimer.elapsed() < qMax(_latency, 100.))) {
+        return;
+    }
+
+    _limit = qMax<double>(_minimum, _limit / 2.);
+    _decreaseTimer.start();
+    qCDebug(QGCTileDownloaderLog) << "Concurrency lowered to" << concurrency();
+}
+
+int QGCTileDownloader::_ceiling() const
+{
+    return (_http2 ? _maximum : qMin(_maximum, kMaxHttp1Concurrency));
+}
+
+bool QGCTileDownloader::_isRetryable(QNetworkReply *reply)
+{
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if ((status == 408) || (status == 429) || (status >= 500)) {
+        return true;
+    }
+    if (status != 0) {
+        return false;
+    }
+
+    switch (reply->error()) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::OperationCanceledError:     // Transfer timeout
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QNetworkRequest QGCTileDownloader::_defaultRequest(const QGCTile &tile)
+{
+    const int mapId = UrlFactory::getQtMapIdFromProviderType(tile.type);
+    return QGeoTileFetcherQGC::getNetworkRequest(mapId, tile.x, tile.y, tile.z);
+}
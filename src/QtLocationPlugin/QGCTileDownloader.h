@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtNetwork/QNetworkRequest>
+
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTileDownloaderLog)
+
+struct QGCTile;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/// Downloads offline map tiles with a concurrency limit adapted to the provider. The limit grows while
+/// replies come back as fast as the quickest seen so far and shrinks when they queue up, or when the
+/// provider fails or throttles. Providers answering over HTTP/2 multiplex every request on one
+/// connection and are allowed more requests in flight than HTTP/1.1 ones. Failed requests that may
+/// succeed later are retried with exponential backoff. Queued tiles are requested in Z-order.
+class QGCTileDownloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        uint64_t downloaded = 0;
+        uint64_t failed = 0;
+        uint64_t retried = 0;
+        uint64_t http2 = 0;     ///< Replies received over HTTP/2
+    };
+
+    /// Builds the request of a tile, by default from the tile's map provider
+    using RequestFactory = std::function<QNetworkRequest(const QGCTile &tile)>;
+
+    explicit QGCTileDownloader(QObject *parent = nullptr);
+    ~QGCTileDownloader();
+
+    void setRequestFactory(const RequestFactory &factory) { _requestFactory = factory; }
+    /// Starting limit and the range it adapts within
+    void setConcurrency(int initial, int minimum = kMinConcurrency, int maximum = kMaxConcurrency);
+
+    /// Takes ownership of the tiles
+    void enqueue(const QList<QGCTile*> &tiles);
+    /// Drops queued and retrying tiles, requests in flight complete
+    void clearPending();
+    /// Drops everything, including requests in flight
+    void abort();
+
+    int pendingCount() const { return _pending.size(); }
+    int inFlightCount() const { return _replies.size(); }
+    bool isIdle() const { return (_pending.isEmpty() && _replies.isEmpty() && _retrying.isEmpty()); }
+    int concurrency() const { return static_cast<int>(_limit); }
+    bool http2() const { return _http2; }
+    const Stats &stats() const { return _stats; }
+
+signals:
+    void tileDownloaded(const QString &hash, const QByteArray &data);
+    /// Not retried any more
+    void tileFailed(const QString &hash, const QString &errorString);
+
+private slots:
+    void _replyFinished();
+
+private:
+    struct Job {
+        QGCTile *tile = nullptr;
+        int retries = 0;
+        QElapsedTimer sent;
+    };
+
+    void _schedule();
+    void _send(Job job);
+    void _retry(Job job, QNetworkReply *reply);
+    /// Called with the latency of every successful reply
+    void _adaptLimit(double latency);
+    /// Called when the provider failed or throttled a request
+    void _backOff();
+    int _ceiling() const;
+    static bool _isRetryable(QNetworkReply *reply);
+    static QNetworkRequest _defaultRequest(const QGCTile &tile);
+
+    QNetworkAccessManager *_networkManager = nullptr;
+    RequestFactory _requestFactory;
+    QList<Job> _pending;
+    QList<Job> _retrying;                       ///< Waiting for their backoff to expire
+    QHash<QNetworkReply*, Job> _replies;
+    Stats _stats;
+
+    double _limit = kInitialConcurrency;
+    int _minimum = kMinConcurrency;
+    int _maximum = kMaxConcurrency;
+    bool _http2 = false;
+    double _latency = 0.;                       ///< Smoothed reply latency, ms
+    double _baseLatency = 0.;                   ///< Quickest reply latency, ms
+    QElapsedTimer _decreaseTimer;               ///< Since the limit was last cut
+    quint64 _abortCount = 0;                    ///< Invalidates pending retry timers
+
+    static constexpr int kInitialConcurrency = 4;
+    static constexpr int kMinConcurrency = 1;
+    static constexpr int kMaxConcurrency = 32;
+    /// QNetworkAccessManager opens at most 6 HTTP/1.1 connections per host and queues the rest
+    static constexpr int kMaxHttp1Concurrency = 6;
+    static constexpr int kMaxRetries = 4;       ///< A tile is requested at most kMaxRetries + 1 times
+    static constexpr int kBaseBackoff = 500;    ///< ms, doubled every retry
+    static constexpr int kMaxBackoff = 30000;   ///< ms
+    static constexpr double kLatencySmoothing = 0.1;
+    static constexpr double kLatencyTolerance = 2.;
+    static constexpr double kLatencySlack = 20.;    ///< ms, local networks answer too fast for a ratio alone
+};
@@ -0,0 +1,339 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileReadPool.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QThread>
+#include <QtCore/QUrl>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#include "QGCLoggingCategory.h"
+#include "QGCMapTasks.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCTileCacheWorker.h"
+
+QGC_LOGGING_CATEGORY(QGCTileReadPoolLog, "qgc.qtlocationplugin.qgctilereadpool")
+
+namespace {
+
+/// Query only connection owned by a single reader thread
+class TileReader
+{
+public:
+    explicit TileReader(const QString &session)
+        : _session(session)
+    {}
+    ~TileReader() { close(); }
+
+    bool isOpen() const { return (_tileQuery != nullptr); }
+
+    bool open(const QString &databasePath)
+    {
+        close();
+
+        _db = std::make_unique<QSqlDatabase>(QSqlDatabase::addDatabase("QSQLITE", _session));
+        // mode=rw never creates the file, which may be in the middle of being replaced by an import.
+        // No shared cache, it would serialize readers with the writer on table locks. Not opened read only
+        // either, a read only connection can't create the WAL index if the writer isn't connected.
+        _db->setDatabaseName(QUrl::fromLocalFile(databasePath).toString() + QStringLiteral("?mode=rw"));
+        _db->setConnectOptions("QSQLITE_OPEN_URI");
+        if (!_db->open()) {
+            qCWarning(QGCTileReadPoolLog) << "Map Cache SQL error (open reader):" << _db->lastError().text();
+            close();
+            return false;
+        }
+
+        QSqlQuery query(*_db);
+        (void) query.exec("PRAGMA query_only = ON");
+        (void) query.exec("PRAGMA cache_size = -8192");
+        (void) query.exec("PRAGMA mmap_size = 268435456");
+
+        auto tileQuery = std::make_unique<QSqlQuery>(*_db);
+        auto providerQuery = std::make_unique<QSqlQuery>(*_db);
+        if (!tileQuery->prepare("SELECT tile, format, type FROM Tiles WHERE tileKey = ?")
+            || !providerQuery->prepare("SELECT providerID FROM TileProviders WHERE hash = ?")) {
+            qCWarning(QGCTileReadPoolLog) << "Map Cache SQL error (prepare reader):" << tileQuery->lastError().text() << providerQuery->lastError().text();
+            tileQuery.reset();
+            providerQuery.reset();
+            close();
+            return false;
+        }
+
+        _tileQuery = std::move(tileQuery);
+        _providerQuery = std::move(providerQuery);
+        return true;
+    }
+
+    void close()
+    {
+        _tileQuery.reset();
+        _providerQuery.reset();
+        _providerIDs.clear();
+        if (_db) {
+            _db.reset();
+            QSqlDatabase::removeDatabase(_session);
+        }
+    }
+
+    /// @return nullptr if the tile is not in the cache
+    QGCCacheTile *fetch(const QString &hash, int providerHash, int x, int y, int z)
+    {
+        // Only found ids are kept, the writer may add a provider at any time
+        int providerID = _providerIDs.value(providerHash, -1);
+        if (providerID < 0) {
+            _providerQuery->bindValue(0, providerHash);
+            if (_providerQuery->exec() && _providerQuery->next()) {
+                providerID = _providerQuery->value(0).toInt();
+                (void) _providerIDs.insert(providerHash, providerID);
+            }
+            _providerQuery->finish();
+            if (providerID < 0) {
+                return nullptr;
+            }
+        }
+
+        QGCCacheTile *tile = nullptr;
+        _tileQuery->bindValue(0, static_cast<qint64>(QGCCacheWorker::tileKey(providerID, x, y, z)));
+        if (!_tileQuery->exec()) {
+            qCWarning(QGCTileReadPoolLog) << "Map Cache SQL error (read tile):" << _tileQuery->lastError().text();
+            close();
+            return nullptr;
+        }
+        if (_tileQuery->next()) {
+            tile = new QGCCacheTile(hash, _tileQuery->value(0).toByteArray(), _tileQuery->value(1).toString(), _tileQuery->value(2).toString());
+        }
+        // Ends the read transaction so the writer can checkpoint
+        _tileQuery->finish();
+
+        return tile;
+    }
+
+private:
+    const QString _session;
+    std::unique_ptr<QSqlDatabase> _db;
+    std::unique_ptr<QSqlQuery> _tileQuery;
+    std::unique_ptr<QSqlQuery> _providerQuery;
+    QHash<int, int> _providerIDs;
+};
+
+}
+
+QGCTileReadPool::QGCTileReadPool(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(QGCTileReadPoolLog) << this;
+}
+
+QGCTileReadPool::~QGCTileReadPool()
+{
+    stop();
+
+    qCDebug(QGCTileReadPoolLog) << this;
+}
+
+void QGCTileReadPool::start(const QString &databasePath, int readerCount)
+{
+    if (isRunning()) {
+        return;
+    }
+
+    _databasePath = databasePath;
+    {
+        QMutexLocker lock(&_mutex);
+        _stopping = false;
+        _suspended = false;
+    }
+
+    for (int i = 0; i < qMax(1, readerCount); i++) {
+        QThread *const thread = QThread::create([this, i]() {
+            _run(i);
+        });
+        thread->setObjectName(QStringLiteral("QGCTileReader%1").arg(i));
+        _threads.append(thread);
+        thread->start(QThread::NormalPriority);
+    }
+}
+
+void QGCTileReadPool::stop()
+{
+    QMutexLocker lock(&_mutex);
+    _stopping = true;
+    _suspendedWaitc.wakeAll();
+    for (const PendingTask &pending : std::as_const(_tasks)) {
+        delete pending.task;
+    }
+    _tasks.clear();
+    _waitc.wakeAll();
+    lock.unlock();
+
+    for (QThread *thread : std::as_const(_threads)) {
+        (void) thread->wait();
+        delete thread;
+    }
+    _threads.clear();
+}
+
+void QGCTileReadPool::suspend()
+{
+    QMutexLocker lock(&_mutex);
+    _suspended = true;
+    _waitc.wakeAll();
+    while (!_stopping && (_suspendedReaders < _runningReaders)) {
+        (void) _suspendedWaitc.wait(lock.mutex());
+    }
+}
+
+void QGCTileReadPool::resume()
+{
+    QMutexLocker lock(&_mutex);
+    _suspended = false;
+    _generation++;
+    _waitc.wakeAll();
+}
+
+void QGCTileReadPool::enqueueTask(QGCFetchTileTask *task)
+{
+    PendingTask pending;
+    pending.task = task;
+    if (!UrlFactory::parseTileHash(task->hash(), pending.providerHash, pending.x, pending.y, pending.z)) {
+        qCWarning(QGCTileReadPoolLog) << "Invalid tile hash" << task->hash();
+        task->setError("Tile not in cache database");
+        task->deleteLater();
+        return;
+    }
+
+    QMutexLocker lock(&_mutex);
+    _tasks.append(pending);
+    _waitc.wakeOne();
+}
+
+void QGCTileReadPool::setViewport(int providerHash, int zoom, double centerX, double centerY)
+{
+    QMutexLocker lock(&_mutex);
+    _viewportProviderHash = providerHash;
+    _viewportZoom = zoom;
+    _viewportX = centerX;
+    _viewportY = centerY;
+}
+
+QGCTileReadPool::Stats QGCTileReadPool::stats() const
+{
+    Stats stats;
+    stats.fetched = _fetched;
+    stats.missed = _missed;
+    stats.cancelled = _cancelled;
+    return stats;
+}
+
+double QGCTileReadPool::_priority(const PendingTask &pending) const
+{
+    if (_viewportZoom < 0) {
+        return 0.;
+    }
+
+    // Other map types and zoom levels come after every tile of the viewport, nearest zoom first
+    double priority = 0.;
+    if (pending.providerHash != _viewportProviderHash) {
+        priority += 1e30;
+    }
+    const int zoomDelta = pending.z - _viewportZoom;
+    priority += qAbs(zoomDelta) * 1e20;
+
+    // Distance from the center in tiles of the pending tile's zoom level
+    const double scale = std::ldexp(1., zoomDelta);
+    const double dx = (pending.x + 0.5) - (_viewportX * scale);
+    const double dy = (pending.y + 0.5) - (_viewportY * scale);
+    priority += (dx * dx) + (dy * dy);
+
+    return priority;
+}
+
+QGCTileReadPool::PendingTask QGCTileReadPool::_takeTask()
+{
+    // Scanned on every take since the viewport moves while tasks are queued
+    qsizetype best = 0;
+    double bestPriority = std::numeric_limits<double>::max();
+    for (qsizetype i = 0; i < _tasks.size(); i++) {
+        const double priority = _priority(_tasks[i]);
+        if (priority < bestPriority) {
+            bestPriority = priority;
+            best = i;
+        }
+    }
+
+    return _tasks.takeAt(best);
+}
+
+void QGCTileReadPool::_run(int index)
+{
+    TileReader reader(QStringLiteral("%1%2").arg(kSession).arg(index));
+    int generation = -1;
+
+    QMutexLocker lock(&_mutex);
+    _runningReaders++;
+    while (true) {
+        while (!_stopping && (_suspended || _tasks.isEmpty())) {
+            if (_suspended && reader.isOpen()) {
+                // Let go of the database and its WAL files while it is being replaced
+                lock.unlock();
+                reader.close();
+                lock.relock();
+                continue;
+            }
+            if (_suspended) {
+                _suspendedReaders++;
+                _suspendedWaitc.wakeAll();
+                while (!_stopping && _suspended) {
+                    (void) _waitc.wait(lock.mutex());
+                }
+                _suspendedReaders--;
+                continue;
+            }
+            (void) _waitc.wait(lock.mutex());
+        }
+        if (_stopping) {
+            break;
+        }
+
+        const PendingTask pending = _takeTask();
+        lock.unlock();
+
+        QGCFetchTileTask *const task = pending.task;
+        if (task->isCancelled()) {
+            _cancelled++;
+        } else {
+            const int currentGeneration = _generation;
+            if ((generation != currentGeneration) || !reader.isOpen()) {
+                generation = currentGeneration;
+                (void) reader.open(_databasePath);
+            }
+
+            QGCCacheTile *const tile = reader.isOpen() ? reader.fetch(task->hash(), pending.providerHash, pending.x, pending.y, pending.z) : nullptr;
+            if (tile) {
+                _fetched++;
+                task->setTileFetched(tile);
+            } else {
+                _missed++;
+                task->setError("Tile not in cache database");
+            }
+        }
+        task->deleteLater();
+
+        lock.relock();
+    }
+    _runningReaders--;
+    _suspendedWaitc.wakeAll();
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QWaitCondition>
+
+#include <atomic>
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTileReadPoolLog)
+
+class QGCFetchTileTask;
+class QThread;
+
+/// Serves tile fetches from the cache database on several threads, each with its own read only
+/// connection. Runs alongside QGCCacheWorker, which stays the only writer. Pending fetches closest
+/// to the current viewport are served first, cancelled fetches are dropped unanswered.
+class QGCTileReadPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        uint64_t fetched = 0;
+        uint64_t missed = 0;        ///< Not in the cache
+        uint64_t cancelled = 0;
+    };
+
+    explicit QGCTileReadPool(QObject *parent = nullptr);
+    ~QGCTileReadPool();
+
+    /// The database must already be created by the cache worker
+    void start(const QString &databasePath, int readerCount = kDefaultReaderCount);
+    void stop();
+    bool isRunning() const { return !_threads.isEmpty(); }
+
+    /// Readers reconnect before their next fetch. Used when the database was reset or replaced.
+    void resetConnections() { _generation++; }
+
+    /// Thread safe. Returns once every reader has closed its connection, the database file can then be
+    /// replaced. Fetches queued meanwhile wait for resume.
+    void suspend();
+    /// Thread safe. Readers reconnect to the database and carry on with the queued fetches.
+    void resume();
+
+    /// Thread safe. Tasks queued before start are served once it is called. Takes ownership of task.
+    void enqueueTask(QGCFetchTileTask *task);
+
+    /// Thread safe. Tile coordinates of the viewport center at the given zoom.
+    void setViewport(int providerHash, int zoom, double centerX, double centerY);
+
+    Stats stats() const;
+
+    static constexpr int kDefaultReaderCount = 4;
+
+private:
+    struct PendingTask {
+        QGCFetchTileTask *task = nullptr;
+        int providerHash = 0;
+        int x = 0;
+        int y = 0;
+        int z = 0;
+    };
+
+    void _run(int index);
+    /// Called with _mutex held
+    PendingTask _takeTask();
+    double _priority(const PendingTask &pending) const;
+
+    QString _databasePath;
+    QList<QThread*> _threads;
+
+    mutable QMutex _mutex;
+    QWaitCondition _waitc;
+    QList<PendingTask> _tasks;
+    bool _stopping = false;
+    bool _suspended = false;
+    int _runningReaders = 0;
+    int _suspendedReaders = 0;
+    QWaitCondition _suspendedWaitc;
+    int _viewportProviderHash = 0;
+    int _viewportZoom = -1;
+    double _viewportX = 0.;
+    double _viewportY = 0.;
+
+    std::atomic_int _generation = 0;
+    std::atomic<uint64_t> _fetched = 0;
+    std::atomic<uint64_t> _missed = 0;
+    std::atomic<uint64_t> _cancelled = 0;
+
+    static constexpr const char *kSession = "QGeoTileReadSession";
+};
@@ -12,6 +12,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QStandardPaths>
+#include <QtGui/QImage>
 
 #include "AppSettings.h"
 #include "MapsSettings.h"
@@ -58,6 +59,34 @@ QGeoFileTileCacheQGC::~QGeoFileTileCacheQGC()
     qCDebug(QGeoFileTileCacheQGCLog) << this;
 }
 
+QSharedPointer<QGeoTileTexture> QGeoFileTileCacheQGC::get(const QGeoTileSpec &spec)
+{
+    const QSharedPointer<QGeoTileTexture> texture = QGeoFileTileCache::get(spec);
+    if (texture) {
+        return texture;
+    }
+
+    return _getFromArchive(spec);
+}
+
+QSharedPointer<QGeoTileTexture> QGeoFileTileCacheQGC::_getFromArchive(const QGeoTileSpec &spec)
+{
+    QString format;
+    const QByteArray bytes = getQGCMapEngine()->archiveTile(spec.mapId(), spec.x(), spec.y(), spec.zoom(), format);
+    if (bytes.isEmpty()) {
+        return QSharedPointer<QGeoTileTexture>();
+    }
+
+    QImage image;
+    if (!image.loadFromData(bytes, qPrintable(format))) {
+        qCWarning(QGeoFileTileCacheQGCLog) << "Undecodable archive tile" << spec.mapId() << spec.x() << spec.y() << spec.zoom();
+        return QSharedPointer<QGeoTileTexture>();
+    }
+
+    // Only the decoded texture is cached, reading the archive again is as quick as the memory cache
+    return addToTextureCache(spec, image);
+}
+
 uint32_t QGeoFileTileCacheQGC::_getMemLimit(const QVariantMap &parameters)
 {
     uint32_t memLimit = 0;
@@ -24,6 +24,9 @@ class QGeoFileTileCacheQGC : public QGeoFileTileCache
     explicit QGeoFileTileCacheQGC(const QVariantMap &parameters, QObject *parent = nullptr);
     ~QGeoFileTileCacheQGC();
 
+    /// Falls back to the mounted tile archives before the tile is fetched
+    QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) final;
+
     static quint32 getMaxDiskCacheSetting();
     static void cacheTile(const QString &type, int x, int y, int z, const QByteArray &image, const QString &format, qulonglong set = UINT64_MAX);
     static void cacheTile(const QString &type, const QString &hash, const QByteArray &image, const QString &format, qulonglong set = UINT64_MAX);
@@ -32,6 +35,8 @@ class QGeoFileTileCacheQGC : public QGeoFileTileCache
     static QString getCachePath() { return _cachePath; }
 
 private:
+    QSharedPointer<QGeoTileTexture> _getFromArchive(const QGeoTileSpec &spec);
+
     // QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const final;
     // QGeoTileSpec filenameToTileSpec(const QString &filename) const final;
 
@@ -61,6 +61,7 @@ bool QGeoTiledMapReplyQGC::init()
     QGCFetchTileTask *task = QGeoFileTileCacheQGC::createFetchTileTask(UrlFactory::getProviderTypeFromQtMapId(tileSpec().mapId()), tileSpec().x(), tileSpec().y(), tileSpec().zoom());
     (void) connect(task, &QGCFetchTileTask::tileFetched, this, &QGeoTiledMapReplyQGC::_cacheReply);
     (void) connect(task, &QGCMapTask::error, this, &QGeoTiledMapReplyQGC::_cacheError);
+    _fetchTask = task;
     if (!getQGCMapEngine()->addTask(task)) {
         task->deleteLater();
         m_initialized = false;
@@ -216,5 +217,10 @@ void QGeoTiledMapReplyQGC::_cacheError(QGCMapTask::TaskType type, QStringView er
 
 void QGeoTiledMapReplyQGC::abort()
 {
+    // The tile scrolled out of view, don't spend a cache read on it
+    if (_fetchTask) {
+        _fetchTask->cancel();
+    }
+
     QGeoTiledMapReply::abort();
 }
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -44,6 +45,7 @@ private slots:
 
     QNetworkAccessManager *_networkManager = nullptr;
     QNetworkRequest _request;
+    QPointer<QGCFetchTileTask> _fetchTask;
     bool m_initialized = false;
 
     static QByteArray _bingNoTileImage;
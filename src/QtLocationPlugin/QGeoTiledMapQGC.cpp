@@ -9,7 +9,13 @@
 
 #include "QGeoTiledMapQGC.h"
 
+#include <QtCore/QtMath>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeomaptype_p.h>
+
 #include "QGCLoggingCategory.h"
+#include "QGCMapEngine.h"
+#include "QGCMapUrlEngine.h"
 #include "QGeoTiledMappingManagerEngineQGC.h"
 
 QGC_LOGGING_CATEGORY(QGeoTiledMapQGCLog, "qgc.qtlocationplugin.qgeotiledmapqgc")
@@ -18,6 +24,8 @@ QGeoTiledMapQGC::QGeoTiledMapQGC(QGeoTiledMappingManagerEngineQGC *engine, QObje
     : QGeoTiledMap(engine, parent)
 {
     qCDebug(QGeoTiledMapQGCLog) << this;
+
+    (void) connect(this, &QGeoMap::cameraDataChanged, this, &QGeoTiledMapQGC::_cameraDataChanged);
 }
 
 QGeoTiledMapQGC::~QGeoTiledMapQGC()
@@ -32,6 +40,20 @@ QGeoMap::Capabilities QGeoTiledMapQGC::capabilities() const
                         | SupportsVisibleArea);
 }
 
+void QGeoTiledMapQGC::_cameraDataChanged(const QGeoCameraData &cameraData)
+{
+    const QString type = UrlFactory::getProviderTypeFromQtMapId(activeMapType().mapId());
+    if (type.isEmpty()) {
+        return;
+    }
+
+    const int zoom = qFloor(cameraData.zoomLevel());
+    const QGeoCoordinate center = cameraData.center();
+    const int centerX = UrlFactory::long2tileX(type, center.longitude(), zoom);
+    const int centerY = UrlFactory::lat2tileY(type, center.latitude(), zoom);
+    getQGCMapEngine()->setViewport(type, zoom, centerX + 0.5, centerY + 0.5);
+}
+
 /*void QGeoTiledMapQGC::evaluateCopyrights(const QSet<QGeoTileSpec> &visibleTiles)
 {
     if (visibleTiles.isEmpty()) {
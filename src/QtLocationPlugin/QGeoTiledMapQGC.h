@@ -14,6 +14,7 @@
 
 Q_DECLARE_LOGGING_CATEGORY(QGeoTiledMapQGCLog)
 
+class QGeoCameraData;
 class QGeoTiledMappingManagerEngineQGC;
 
 class QGeoTiledMapQGC : public QGeoTiledMap
@@ -26,6 +27,9 @@ class QGeoTiledMapQGC : public QGeoTiledMap
 
     QGeoMap::Capabilities capabilities() const final;
 
+private slots:
+    void _cameraDataChanged(const QGeoCameraData &cameraData);
+
 private:
     // void evaluateCopyrights(const QSet<QGeoTileSpec> &visibleTiles) final;
 };
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainPathProfile.h"
+
+#include <QtCore/QtMath>
+
+TerrainPathProfile TerrainPathProfile::layout(const QList<QGeoCoordinate> &polyPath, double spacing)
+{
+    TerrainPathProfile profile;
+    if (polyPath.count() < 2) {
+        return profile;
+    }
+
+    profile.segments.resize(polyPath.count() - 1);
+
+    qsizetype first = 0;
+    for (qsizetype i = 0; i < profile.segments.count(); i++) {
+        const QGeoCoordinate &fromCoord = polyPath[i];
+        const QGeoCoordinate &toCoord = polyPath[i + 1];
+        Segment &segment = profile.segments[i];
+
+        const int steps = qCeil(toCoord.distanceTo(fromCoord) / spacing);
+        segment.first = first;
+        if (steps == 0) {
+            segment.count = 2;
+            segment.distanceBetween = segment.finalDistanceBetween = fromCoord.distanceTo(toCoord);
+        } else {
+            segment.count = steps + 1;
+            const double latDiff = toCoord.latitude() - fromCoord.latitude();
+            const double lonDiff = toCoord.longitude() - fromCoord.longitude();
+            const QGeoCoordinate secondCoord(fromCoord.latitude() + (latDiff / steps), fromCoord.longitude() + (lonDiff / steps));
+            const QGeoCoordinate secondLastCoord(fromCoord.latitude() + ((latDiff * (steps - 1)) / steps), fromCoord.longitude() + ((lonDiff * (steps - 1)) / steps));
+            segment.distanceBetween = fromCoord.distanceTo((steps == 1) ? toCoord : secondCoord);
+            segment.finalDistanceBetween = ((steps == 1) ? fromCoord : secondLastCoord).distanceTo(toCoord);
+        }
+        first += segment.count;
+    }
+
+    profile.heights.fill(qQNaN(), first);
+    return profile;
+}
+
+void TerrainPathProfile::segmentCoordinates(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, qsizetype count, double *latitudes, double *longitudes)
+{
+    const double lat = fromCoord.latitude();
+    const double lon = fromCoord.longitude();
+    const double latDiff = toCoord.latitude() - lat;
+    const double lonDiff = toCoord.longitude() - lon;
+    const qsizetype steps = count - 1;
+
+    for (qsizetype i = 0; i < steps; i++) {
+        latitudes[i] = lat + ((latDiff * static_cast<double>(i)) / static_cast<double>(steps));
+        longitudes[i] = lon + ((lonDiff * static_cast<double>(i)) / static_cast<double>(steps));
+    }
+
+    // The last one is always the end point
+    latitudes[steps] = toCoord.latitude();
+    longitudes[steps] = toCoord.longitude();
+}
+
+QList<TerrainPathProfile::Task> TerrainPathProfile::tasks(qsizetype taskSize) const
+{
+    QList<Task> result;
+
+    qsizetype taskStart = 0;
+    for (qsizetype i = 0; i < segments.count(); i++) {
+        if (((segments[i].first + segments[i].count) - segments[taskStart].first) >= taskSize) {
+            result.append({ taskStart, i + 1 });
+            taskStart = i + 1;
+        }
+    }
+    if (taskStart < segments.count()) {
+        result.append({ taskStart, segments.count() });
+    }
+
+    return result;
+}
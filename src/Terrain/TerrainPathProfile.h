@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QMetaType>
+#include <QtCore/QtNumeric>
+#include <QtPositioning/QGeoCoordinate>
+
+/// Terrain heights along every segment of a poly path, the heights of all segments are stored back to back
+/// in one buffer. Segments are sampled the same way as a single path query between their end points.
+struct TerrainPathProfile
+{
+    struct Segment {
+        qsizetype first = 0;                ///< Index of the first height of the segment in heights
+        qsizetype count = 0;                ///< Number of heights, both end points included
+        double distanceBetween = 0.;        ///< Distance between each height value
+        double finalDistanceBetween = 0.;   ///< Distance between final two height values
+    };
+
+    /// Run of whole segments, [firstSegment, endSegment)
+    struct Task {
+        qsizetype firstSegment = 0;
+        qsizetype endSegment = 0;
+    };
+
+    /// Sets up the segments between each coordinate of polyPath, heights are filled with NaN
+    ///     @param spacing Distance between the heights of a segment in meters
+    static TerrainPathProfile layout(const QList<QGeoCoordinate> &polyPath, double spacing);
+
+    /// Coordinates of the heights of a segment laid out from fromCoord to toCoord
+    static void segmentCoordinates(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, qsizetype count, double *latitudes, double *longitudes);
+
+    /// Splits the segments into runs of at least taskSize heights each, except for the last one
+    QList<Task> tasks(qsizetype taskSize) const;
+
+    const double *segmentHeights(qsizetype segment) const { return (heights.constData() + segments[segment].first); }
+    QList<double> segmentHeightList(qsizetype segment) const { return heights.mid(segments[segment].first, segments[segment].count); }
+
+    QList<Segment> segments;
+    QList<double> heights;
+};
+Q_DECLARE_METATYPE(TerrainPathProfile)
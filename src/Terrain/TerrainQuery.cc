@@ -230,11 +230,11 @@ void TerrainPathQuery::_pathHeights(bool success, double distanceBetween, double
 TerrainPolyPathQuery::TerrainPolyPathQuery(bool autoDelete, QObject *parent)
     : QObject(parent)
     , _autoDelete(autoDelete)
-    , _pathQuery(new TerrainPathQuery(false, this))
+    , _terrainQuery(new TerrainOfflineQuery(this))
 {
     // qCDebug(TerrainQueryLog) << Q_FUNC_INFO << this;
 
-    (void) connect(_pathQuery, &TerrainPathQuery::terrainDataReceived, this, &TerrainPolyPathQuery::_terrainDataReceived);
+    (void) connect(_terrainQuery, &TerrainQueryInterface::polyPathHeightsReceived, this, &TerrainPolyPathQuery::_polyPathHeights);
 }
 
 TerrainPolyPathQuery::~TerrainPolyPathQuery()
@@ -257,30 +257,30 @@ void TerrainPolyPathQuery::requestData(const QList<QGeoCoordinate> &polyPath)
 {
     qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "count" << polyPath.count();
 
-    _rgCoords = polyPath;
-    _curIndex = 0;
-    _pathQuery->requestData(_rgCoords[0], _rgCoords[1]);
+    // All segments are sampled in a single query
+    _terrainQuery->requestPolyPathHeights(polyPath);
 }
 
-void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo)
+void TerrainPolyPathQuery::_polyPathHeights(bool success, const TerrainPathProfile &profile)
 {
-    qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "success:_curIndex" << success << _curIndex;
-
-    if (!success) {
-        _rgPathHeightInfo.clear();
-        emit terrainDataReceived(false, _rgPathHeightInfo);
-        return;
+    qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "success:segments" << success << profile.segments.count();
+
+    QList<TerrainPathQuery::PathHeightInfo_t> rgPathHeightInfo;
+    if (success) {
+        rgPathHeightInfo.reserve(profile.segments.count());
+        for (qsizetype i = 0; i < profile.segments.count(); i++) {
+            const TerrainPathProfile::Segment &segment = profile.segments[i];
+            TerrainPathQuery::PathHeightInfo_t pathHeightInfo;
+            pathHeightInfo.distanceBetween = segment.distanceBetween;
+            pathHeightInfo.finalDistanceBetween = segment.finalDistanceBetween;
+            pathHeightInfo.heights = profile.segmentHeightList(i);
+            rgPathHeightInfo.append(pathHeightInfo);
+        }
     }
 
-    (void) _rgPathHeightInfo.append(pathHeightInfo);
-
-    if (++_curIndex >= (_rgCoords.count() - 1)) {
-        qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "complete";
-        emit terrainDataReceived(true, _rgPathHeightInfo);
-        if (_autoDelete) {
-            deleteLater();
-        }
-    } else {
-        _pathQuery->requestData(_rgCoords[_curIndex], _rgCoords[_curIndex + 1]);
+    emit pathProfileReceived(success, profile);
+    emit terrainDataReceived(success, rgPathHeightInfo);
+    if (_autoDelete) {
+        deleteLater();
     }
 }
@@ -160,14 +160,13 @@ class TerrainPolyPathQuery : public QObject
 signals:
     /// Signalled when terrain data comes back from server
     void terrainDataReceived(bool success, const QList<TerrainPathQuery::PathHeightInfo_t> &rgPathHeightInfo);
+    /// Same data as terrainDataReceived, the heights of all segments in one buffer
+    void pathProfileReceived(bool success, const TerrainPathProfile &profile);
 
 private slots:
-    void _terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo);
+    void _polyPathHeights(bool success, const TerrainPathProfile &profile);
 
 private:
     bool _autoDelete = false;
-    int _curIndex = 0;
-    QList<QGeoCoordinate> _rgCoords;
-    QList<TerrainPathQuery::PathHeightInfo_t> _rgPathHeightInfo;
-    TerrainPathQuery *_pathQuery = nullptr;
+    TerrainQueryInterface *_terrainQuery = nullptr;
 };
@@ -49,6 +49,12 @@ void TerrainQueryInterface::requestCarpetHeights(const QGeoCoordinate &swCoord,
     qCWarning(TerrainQueryInterfaceLog) << Q_FUNC_INFO << "Not Supported";
 }
 
+void TerrainQueryInterface::requestPolyPathHeights(const QList<QGeoCoordinate> &polyPath)
+{
+    Q_UNUSED(polyPath);
+    qCWarning(TerrainQueryInterfaceLog) << Q_FUNC_INFO << "Not Supported";
+}
+
 void TerrainQueryInterface::signalCoordinateHeights(bool success, const QList<double> &heights)
 {
     emit coordinateHeightsReceived(success, heights);
@@ -64,6 +70,11 @@ void TerrainQueryInterface::signalCarpetHeights(bool success, double minHeight,
     emit carpetHeightsReceived(success, minHeight, maxHeight, carpet);
 }
 
+void TerrainQueryInterface::signalPolyPathHeights(bool success, const TerrainPathProfile &profile)
+{
+    emit polyPathHeightsReceived(success, profile);
+}
+
 void TerrainQueryInterface::_requestFailed()
 {
     switch (_queryMode) {
@@ -76,6 +87,9 @@ void TerrainQueryInterface::_requestFailed()
     case TerrainQuery::QueryModeCarpet:
         emit carpetHeightsReceived(false, qQNaN(), qQNaN(), QList<QList<double>>());
         break;
+    case TerrainQuery::QueryModePolyPath:
+        emit polyPathHeightsReceived(false, TerrainPathProfile());
+        break;
     default:
         qCWarning(TerrainQueryInterfaceLog) << Q_FUNC_INFO << "Query Mode Not Supported";
         break;
@@ -111,6 +125,12 @@ void TerrainOfflineQuery::requestPathHeights(const QGeoCoordinate &fromCoord, co
     TerrainTileManager::instance()->addPathQuery(this, fromCoord, toCoord);
 }
 
+void TerrainOfflineQuery::requestPolyPathHeights(const QList<QGeoCoordinate> &polyPath)
+{
+    _queryMode = TerrainQuery::QueryModePolyPath;
+    TerrainTileManager::instance()->addPolyPathQuery(this, polyPath);
+}
+
 /*===========================================================================*/
 
 TerrainOnlineQuery::TerrainOnlineQuery(QObject *parent)
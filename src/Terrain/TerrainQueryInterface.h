@@ -14,6 +14,8 @@
 #include <QtCore/QObject>
 #include <QtNetwork/QNetworkReply>
 
+#include "TerrainPathProfile.h"
+
 class QGeoCoordinate;
 class QNetworkAccessManager;
 
@@ -25,7 +27,8 @@ namespace TerrainQuery
         QueryModeNone,
         QueryModeCoordinates,
         QueryModePath,
-        QueryModeCarpet
+        QueryModeCarpet,
+        QueryModePolyPath
     };
 
     enum class State {
@@ -60,14 +63,21 @@ class TerrainQueryInterface : public QObject
     ///     @param statsOnly true: Return only stats, no carpet data
     virtual void requestCarpetHeights(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly);
 
+    /// Requests terrain heights along every segment of the poly path in a single query.
+    /// Signals: polyPathHeightsReceived
+    ///     @param polyPath coordinates of the segment end points
+    virtual void requestPolyPathHeights(const QList<QGeoCoordinate> &polyPath);
+
     void signalCoordinateHeights(bool success, const QList<double> &heights);
     void signalPathHeights(bool success, double distanceBetween, double finalDistanceBetween, const QList<double> &heights);
     void signalCarpetHeights(bool success, double minHeight, double maxHeight, const QList<QList<double>> &carpet);
+    void signalPolyPathHeights(bool success, const TerrainPathProfile &profile);
 
 signals:
     void coordinateHeightsReceived(bool success, const QList<double> &heights);
     void pathHeightsReceived(bool success, double distanceBetween, double finalDistanceBetween, const QList<double> &heights);
     void carpetHeightsReceived(bool success, double minHeight, double maxHeight, const QList<QList<double>> &carpet);
+    void polyPathHeightsReceived(bool success, const TerrainPathProfile &profile);
 
 protected:
     virtual void _requestFailed();
@@ -87,6 +97,7 @@ class TerrainOfflineQuery : public TerrainQueryInterface
 
     void requestCoordinateHeights(const QList<QGeoCoordinate> &coordinates) override;
     void requestPathHeights(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord) override;
+    void requestPolyPathHeights(const QList<QGeoCoordinate> &polyPath) override;
 };
 
 /*===========================================================================*/
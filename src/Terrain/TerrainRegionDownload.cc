@@ -0,0 +1,207 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainRegionDownload.h"
+#include "TerrainTileCache.h"
+#include "TerrainTileCopernicus.h"
+#include "TerrainTileManager.h"
+#include "ElevationMapProvider.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCLoggingCategory.h"
+#include "QGCTile.h"
+
+#include <QtCore/QtNumeric>
+
+QGC_LOGGING_CATEGORY(TerrainRegionDownloadLog, "qgc.terrain.terrainregiondownload")
+
+TerrainRegionDownload::TerrainRegionDownload(QObject *parent)
+    : QObject(parent)
+    , _downloader(new QGCTileDownloader(this))
+{
+    // qCDebug(TerrainRegionDownloadLog) << Q_FUNC_INFO << this;
+
+    (void) connect(_downloader, &QGCTileDownloader::tileDownloaded, this, &TerrainRegionDownload::_tileDownloaded);
+    (void) connect(_downloader, &QGCTileDownloader::tileFailed, this, &TerrainRegionDownload::_tileFailed);
+}
+
+TerrainRegionDownload::~TerrainRegionDownload()
+{
+    // qCDebug(TerrainRegionDownloadLog) << Q_FUNC_INFO << this;
+}
+
+QList<QPoint> TerrainRegionDownload::tilesForPolygon(const QList<QGeoCoordinate> &polygon)
+{
+    QList<QPoint> tiles;
+    if (polygon.count() < 3) {
+        return tiles;
+    }
+
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(QString::fromLatin1(CopernicusElevationProvider::kProviderKey));
+    if (!provider) {
+        qCWarning(TerrainRegionDownloadLog) << "Elevation provider not found";
+        return tiles;
+    }
+
+    double minLat = polygon.first().latitude();
+    double maxLat = minLat;
+    for (const QGeoCoordinate &coord : polygon) {
+        minLat = qMin(minLat, coord.latitude());
+        maxLat = qMax(maxLat, coord.latitude());
+    }
+
+    // Within a row of tiles the polygon lies between the westmost and eastmost points of its edges in that row
+    for (int y = provider->lat2tileY(minLat, 1); y <= provider->lat2tileY(maxLat, 1); y++) {
+        const double south = (y * TerrainTileCopernicus::kTileSizeDegrees) - 90.0;
+        const double north = south + TerrainTileCopernicus::kTileSizeDegrees;
+
+        double west = qInf();
+        double east = -qInf();
+        for (qsizetype i = 0; i < polygon.count(); i++) {
+            const QGeoCoordinate &from = polygon[i];
+            const QGeoCoordinate &to = polygon[(i + 1) % polygon.count()];
+            const double lat1 = from.latitude();
+            const double lat2 = to.latitude();
+            if ((qMax(lat1, lat2) < south) || (qMin(lat1, lat2) > north)) {
+                continue;
+            }
+
+            if (lat1 == lat2) {
+                west = qMin(west, qMin(from.longitude(), to.longitude()));
+                east = qMax(east, qMax(from.longitude(), to.longitude()));
+                continue;
+            }
+
+            // The part of the edge inside the row
+            const double t1 = qBound(0.0, (south - lat1) / (lat2 - lat1), 1.0);
+            const double t2 = qBound(0.0, (north - lat1) / (lat2 - lat1), 1.0);
+            const double lon1 = from.longitude() + (t1 * (to.longitude() - from.longitude()));
+            const double lon2 = from.longitude() + (t2 * (to.longitude() - from.longitude()));
+            west = qMin(west, qMin(lon1, lon2));
+            east = qMax(east, qMax(lon1, lon2));
+        }
+
+        if (west > east) {
+            continue;
+        }
+        for (int x = provider->long2tileX(west, 1); x <= provider->long2tileX(east, 1); x++) {
+            tiles.append(QPoint(x, y));
+        }
+    }
+
+    return tiles;
+}
+
+bool TerrainRegionDownload::start(const QList<QGeoCoordinate> &polygon)
+{
+    if (_running) {
+        qCWarning(TerrainRegionDownloadLog) << "Download already running";
+        return false;
+    }
+
+    if (!_diskCache) {
+        _diskCache = TerrainTileManager::instance()->diskCache();
+        if (!_diskCache) {
+            qCWarning(TerrainRegionDownloadLog) << "No terrain tile cache to download to";
+            return false;
+        }
+    }
+
+    const QList<QPoint> tiles = tilesForPolygon(polygon);
+    if (tiles.isEmpty() || (tiles.count() > kMaxTileCount)) {
+        qCWarning(TerrainRegionDownloadLog) << "Region has" << tiles.count() << "tiles, at most" << kMaxTileCount << "can be downloaded";
+        return false;
+    }
+
+    _tileCount = tiles.count();
+    _savedCount = 0;
+    _skippedCount = 0;
+    _failedCount = 0;
+
+    const QString providerType = QString::fromLatin1(CopernicusElevationProvider::kProviderKey);
+    const int mapId = UrlFactory::getQtMapIdFromProviderType(providerType);
+
+    QList<QGCTile*> downloads;
+    for (const QPoint &tile : tiles) {
+        const quint64 key = TerrainTileCache::tileKey(mapId, tile.x(), tile.y(), 1);
+        if (_diskCache->contains(key)) {
+            _skippedCount++;
+            continue;
+        }
+
+        QGCTile *const download = new QGCTile;
+        download->x = tile.x();
+        download->y = tile.y();
+        download->z = 1;
+        download->type = providerType;
+        download->hash = QString::number(key);
+        downloads.append(download);
+    }
+
+    qCDebug(TerrainRegionDownloadLog) << "Tiles:" << _tileCount << "already stored:" << _skippedCount;
+
+    _running = true;
+    if (downloads.isEmpty()) {
+        _tileCompleted();
+        return true;
+    }
+
+    emit progress(_skippedCount, _tileCount);
+    _downloader->enqueue(downloads);
+    return true;
+}
+
+void TerrainRegionDownload::cancel()
+{
+    if (!_running) {
+        return;
+    }
+
+    _downloader->abort();
+    _running = false;
+    emit finished(false);
+}
+
+void TerrainRegionDownload::_tileDownloaded(const QString &hash, const QByteArray &data)
+{
+    // Stored in the form TerrainTile reads, a fraction of the size of the JSON
+    const QByteArray serialized = TerrainTileCopernicus::serializeFromData(data);
+    if (serialized.isEmpty() || !TerrainTile(serialized).isValid()) {
+        qCWarning(TerrainRegionDownloadLog) << "Invalid tile" << hash;
+        _failedCount++;
+    } else if (!_diskCache->insert(hash.toULongLong(), serialized)) {
+        qCWarning(TerrainRegionDownloadLog) << "Terrain tile cache is full";
+        _failedCount++;
+    } else {
+        _savedCount++;
+    }
+
+    _tileCompleted();
+}
+
+void TerrainRegionDownload::_tileFailed(const QString &hash, const QString &errorString)
+{
+    qCDebug(TerrainRegionDownloadLog) << "Failed to download" << hash << errorString;
+    _failedCount++;
+
+    _tileCompleted();
+}
+
+void TerrainRegionDownload::_tileCompleted()
+{
+    const int completed = _savedCount + _skippedCount + _failedCount;
+    emit progress(completed, _tileCount);
+
+    if (completed < _tileCount) {
+        return;
+    }
+
+    qCDebug(TerrainRegionDownloadLog) << "Done, saved:" << _savedCount << "failed:" << _failedCount;
+    _running = false;
+    emit finished(_failedCount == 0);
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QPoint>
+#include <QtPositioning/QGeoCoordinate>
+
+#include "QGCTileDownloader.h"
+
+class TerrainTileDiskCache;
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainRegionDownloadLog)
+
+/// Downloads every Copernicus elevation tile touching a polygon into the terrain tile disk cache, so terrain
+/// queries over the region are answered without the network. Tiles are stored as their elevation grids,
+/// not the JSON they are served as. Tiles already stored are skipped.
+class TerrainRegionDownload : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TerrainRegionDownload(QObject *parent = nullptr);
+    ~TerrainRegionDownload();
+
+    /// Copernicus tile coordinates of the tiles overlapping polygon
+    static QList<QPoint> tilesForPolygon(const QList<QGeoCoordinate> &polygon);
+
+    /// Defaults to the cache of TerrainTileManager
+    void setDiskCache(TerrainTileDiskCache *diskCache) { _diskCache = diskCache; }
+    void setRequestFactory(const QGCTileDownloader::RequestFactory &factory) { _downloader->setRequestFactory(factory); }
+
+    /// @return false if nothing could be started, finished is not signalled then
+    bool start(const QList<QGeoCoordinate> &polygon);
+    void cancel();
+
+    bool isRunning() const { return _running; }
+    int tileCount() const { return _tileCount; }
+    int savedCount() const { return _savedCount; }
+    int skippedCount() const { return _skippedCount; }     ///< Already stored
+    int failedCount() const { return _failedCount; }
+
+signals:
+    void progress(int completed, int total);
+    /// @param success true: every tile of the region is stored
+    void finished(bool success);
+
+private slots:
+    void _tileDownloaded(const QString &hash, const QByteArray &data);
+    void _tileFailed(const QString &hash, const QString &errorString);
+
+private:
+    void _tileCompleted();
+
+    QGCTileDownloader *_downloader = nullptr;
+    TerrainTileDiskCache *_diskCache = nullptr;
+    bool _running = false;
+    int _tileCount = 0;
+    int _savedCount = 0;
+    int _skippedCount = 0;
+    int _failedCount = 0;
+
+    static constexpr int kMaxTileCount = 100000;    ///< About 300 MB of tiles
+};
@@ -13,6 +13,17 @@
 #include <QtCore/QtNumeric>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <cstring>
+
+// SSE2 is part of every x86-64 target and NEON of every AArch64 one, no runtime dispatch needed
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define TERRAIN_TILE_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define TERRAIN_TILE_NEON
+    #include <arm_neon.h>
+#endif
+
 QGC_LOGGING_CATEGORY(TerrainTileLog, "qgc.terrain.terraintile");
 
 TerrainTile::TerrainTile(const QByteArray &byteArray)
@@ -40,6 +51,11 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
         return;
     }
 
+    if ((_tileInfo.gridSizeLat <= 0) || (_tileInfo.gridSizeLon <= 0)) {
+        qCWarning(TerrainTileLog) << this << "Tile grid is empty";
+        return;
+    }
+
     _cellSizeLat = (_tileInfo.neLat - _tileInfo.swLat) / _tileInfo.gridSizeLat;
     _cellSizeLon = (_tileInfo.neLon - _tileInfo.swLon) / _tileInfo.gridSizeLon;
 
@@ -49,18 +65,10 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
     qCDebug(TerrainTileLog) << this << "TileInfo: min, max, avg:" << _tileInfo.minElevation << _tileInfo.maxElevation << _tileInfo.avgElevation;
     qCDebug(TerrainTileLog) << this << "TileInfo: cell size:" << _cellSizeLat << _cellSizeLon;
 
-    _elevationData.resize(_tileInfo.gridSizeLat);
-    for (int k = 0; k < _tileInfo.gridSizeLat; k++) {
-        _elevationData[k].resize(_tileInfo.gridSizeLon);
-    }
-
-    int valueIndex = 0;
-    const int16_t* const pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _tileInfo.gridSizeLat; i++) {
-        for (int j = 0; j < _tileInfo.gridSizeLon; j++) {
-            _elevationData[i][j] = pTileData[valueIndex++];
-        }
-    }
+    const size_t cellCount = static_cast<size_t>(_tileInfo.gridSizeLat) * static_cast<size_t>(_tileInfo.gridSizeLon);
+    _elevationData.reset(static_cast<int16_t*>(qMallocAligned(cellCount * sizeof(int16_t), kGridAlignment)));
+    // The serialized data follows a packed header and may be unaligned
+    (void) memcpy(_elevationData.get(), byteArray.constData() + cTileHeaderBytes, cellCount * sizeof(int16_t));
 
     _isValid = true;
 }
@@ -71,41 +79,178 @@ TerrainTile::~TerrainTile()
 }
 
 double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
+{
+    const double latitude = coordinate.latitude();
+    const double longitude = coordinate.longitude();
+    double elevation = qQNaN();
+    elevations(&latitude, &longitude, &elevation, 1);
+    return elevation;
+}
+
+double TerrainTile::_interpolate(double row, double column) const
+{
+    const int lastRow = _tileInfo.gridSizeLat - 1;
+    const int lastColumn = _tileInfo.gridSizeLon - 1;
+    row = qBound(0.0, row, static_cast<double>(lastRow));
+    column = qBound(0.0, column, static_cast<double>(lastColumn));
+
+    const int row0 = static_cast<int>(row);
+    const int column0 = static_cast<int>(column);
+    const int row1 = qMin(row0 + 1, lastRow);
+    const int column1 = qMin(column0 + 1, lastColumn);
+    const double rowWeight = row - row0;
+    const double columnWeight = column - column0;
+
+    const int16_t *const data = _elevationData.get();
+    const int stride = _tileInfo.gridSizeLon;
+    const double south = data[(row0 * stride) + column0] + (columnWeight * (data[(row0 * stride) + column1] - data[(row0 * stride) + column0]));
+    const double north = data[(row1 * stride) + column0] + (columnWeight * (data[(row1 * stride) + column1] - data[(row1 * stride) + column0]));
+    return south + (rowWeight * (north - south));
+}
+
+void TerrainTile::_elevationsScalar(const double *latitudes, const double *longitudes, double *elevations, qsizetype count) const
+{
+    for (qsizetype i = 0; i < count; i++) {
+        const double latitude = latitudes[i];
+        const double longitude = longitudes[i];
+        // Written so NaN coordinates are outside too
+        if (!((latitude >= _tileInfo.swLat) && (latitude <= _tileInfo.neLat) && (longitude >= _tileInfo.swLon) && (longitude <= _tileInfo.neLon))) {
+            elevations[i] = qQNaN();
+            continue;
+        }
+
+        // Values are cell centers, half a cell in from the tile edges
+        elevations[i] = _interpolate(((latitude - _tileInfo.swLat) / _cellSizeLat) - 0.5, ((longitude - _tileInfo.swLon) / _cellSizeLon) - 0.5);
+    }
+}
+
+void TerrainTile::elevations(const double *latitudes, const double *longitudes, double *elevations, qsizetype count) const
 {
     if (!_isValid) {
         qCWarning(TerrainTileLog) << this << "Request for elevation, but tile is invalid.";
-        return qQNaN();
+        for (qsizetype i = 0; i < count; i++) {
+            elevations[i] = qQNaN();
+        }
+        return;
     }
 
-    const double latDeltaSw = coordinate.latitude() - _tileInfo.swLat;
-    const double lonDeltaSw = coordinate.longitude() - _tileInfo.swLon;
+    qsizetype i = 0;
 
-    const int16_t latIndex = qFloor(latDeltaSw / _cellSizeLat);
-    const int16_t lonIndex = qFloor(lonDeltaSw / _cellSizeLon);
+#if defined(TERRAIN_TILE_SSE2) || defined(TERRAIN_TILE_NEON)
+    // Two coordinates at a time, the four corner values of each are gathered from the grid
+    const int lastRow = _tileInfo.gridSizeLat - 1;
+    const int lastColumn = _tileInfo.gridSizeLon - 1;
+    const int stride = _tileInfo.gridSizeLon;
+    const int16_t *const data = _elevationData.get();
 
-    const bool latIndexInvalid = (latIndex < 0) || (latIndex > (_tileInfo.gridSizeLat - 1));
-    const bool lonIndexInvalid = (lonIndex < 0) || (lonIndex > (_tileInfo.gridSizeLon - 1));
+    alignas(16) int32_t rowIndex[4];
+    alignas(16) int32_t columnIndex[4];
+    alignas(16) double corner00[2];
+    alignas(16) double corner01[2];
+    alignas(16) double corner10[2];
+    alignas(16) double corner11[2];
 
-    if (latIndexInvalid || lonIndexInvalid) {
-        qCWarning(TerrainTileLog) << this << "Internal error: coordinate" << coordinate << "outside tile bounds";
-        return qQNaN();
-    }
+    const auto gather = [&]() {
+        for (int lane = 0; lane < 2; lane++) {
+            const int row0 = rowIndex[lane];
+            const int column0 = columnIndex[lane];
+            const int row1 = qMin(row0 + 1, lastRow);
+            const int column1 = qMin(column0 + 1, lastColumn);
+            corner00[lane] = data[(row0 * stride) + column0];
+            corner01[lane] = data[(row0 * stride) + column1];
+            corner10[lane] = data[(row1 * stride) + column0];
+            corner11[lane] = data[(row1 * stride) + column1];
+        }
+    };
+#endif
 
-    if ((latIndex >= _elevationData.size()) || (lonIndex >= _elevationData[latIndex].size())) {
-        qCWarning(TerrainTileLog).noquote() << this << "Internal error: _elevationData size inconsistent _tileInfo << coordinate" << coordinate
-            << "\n\t_tillIndo.gridSizeLat:" << _tileInfo.gridSizeLat << "_tileInfo.gridSizeLon:" << _tileInfo.gridSizeLon
-            << "\n\t_data.size():" << _elevationData.size() << "_elevationData[latIndex].size():" << _elevationData[latIndex].size();
-        return qQNaN();
-    }
+#if defined(TERRAIN_TILE_SSE2)
+    const __m128d swLat = _mm_set1_pd(_tileInfo.swLat);
+    const __m128d swLon = _mm_set1_pd(_tileInfo.swLon);
+    const __m128d neLat = _mm_set1_pd(_tileInfo.neLat);
+    const __m128d neLon = _mm_set1_pd(_tileInfo.neLon);
+    const __m128d rowsPerDegree = _mm_set1_pd(1.0 / _cellSizeLat);
+    const __m128d columnsPerDegree = _mm_set1_pd(1.0 / _cellSizeLon);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d maxRow = _mm_set1_pd(lastRow);
+    const __m128d maxColumn = _mm_set1_pd(lastColumn);
+    const __m128d nan = _mm_set1_pd(qQNaN());
 
-    const int16_t elevation = _elevationData[latIndex][lonIndex];
-    if (elevation < _tileInfo.minElevation) {
-        qCWarning(TerrainTileLog) << this << "Warning: elevation read is below min elevation in tile:" << elevation << "<" << _tileInfo.minElevation;
-    } else if (elevation > _tileInfo.maxElevation) {
-        qCWarning(TerrainTileLog) << this << "Warning: elevation read is above max elevation in tile:" << elevation << ">" << _tileInfo.maxElevation;
+    for (; (i + 2) <= count; i += 2) {
+        const __m128d latitude = _mm_loadu_pd(latitudes + i);
+        const __m128d longitude = _mm_loadu_pd(longitudes + i);
+        const __m128d inside = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(latitude, swLat), _mm_cmple_pd(latitude, neLat)),
+                                          _mm_and_pd(_mm_cmpge_pd(longitude, swLon), _mm_cmple_pd(longitude, neLon)));
+
+        // Clamped to the grid, max takes the zero for NaN coordinates. Truncation is floor for the non negative positions.
+        const __m128d row = _mm_min_pd(_mm_max_pd(_mm_sub_pd(_mm_mul_pd(_mm_sub_pd(latitude, swLat), rowsPerDegree), half), zero), maxRow);
+        const __m128d column = _mm_min_pd(_mm_max_pd(_mm_sub_pd(_mm_mul_pd(_mm_sub_pd(longitude, swLon), columnsPerDegree), half), zero), maxColumn);
+        const __m128i row0 = _mm_cvttpd_epi32(row);
+        const __m128i column0 = _mm_cvttpd_epi32(column);
+        const __m128d rowWeight = _mm_sub_pd(row, _mm_cvtepi32_pd(row0));
+        const __m128d columnWeight = _mm_sub_pd(column, _mm_cvtepi32_pd(column0));
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(rowIndex), row0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(columnIndex), column0);
+        gather();
+
+        const __m128d c00 = _mm_load_pd(corner00);
+        const __m128d c01 = _mm_load_pd(corner01);
+        const __m128d c10 = _mm_load_pd(corner10);
+        const __m128d c11 = _mm_load_pd(corner11);
+        const __m128d south = _mm_add_pd(c00, _mm_mul_pd(columnWeight, _mm_sub_pd(c01, c00)));
+        const __m128d north = _mm_add_pd(c10, _mm_mul_pd(columnWeight, _mm_sub_pd(c11, c10)));
+        const __m128d elevation = _mm_add_pd(south, _mm_mul_pd(rowWeight, _mm_sub_pd(north, south)));
+
+        _mm_storeu_pd(elevations + i, _mm_or_pd(_mm_and_pd(inside, elevation), _mm_andnot_pd(inside, nan)));
     }
+#elif defined(TERRAIN_TILE_NEON)
+    const float64x2_t swLat = vdupq_n_f64(_tileInfo.swLat);
+    const float64x2_t swLon = vdupq_n_f64(_tileInfo.swLon);
+    const float64x2_t neLat = vdupq_n_f64(_tileInfo.neLat);
+    const float64x2_t neLon = vdupq_n_f64(_tileInfo.neLon);
+    const float64x2_t rowsPerDegree = vdupq_n_f64(1.0 / _cellSizeLat);
+    const float64x2_t columnsPerDegree = vdupq_n_f64(1.0 / _cellSizeLon);
+    const float64x2_t half = vdupq_n_f64(0.5);
+    const float64x2_t zero = vdupq_n_f64(0.0);
+    const float64x2_t maxRow = vdupq_n_f64(lastRow);
+    const float64x2_t maxColumn = vdupq_n_f64(lastColumn);
+    const float64x2_t nan = vdupq_n_f64(qQNaN());
+
+    for (; (i + 2) <= count; i += 2) {
+        const float64x2_t latitude = vld1q_f64(latitudes + i);
+        const float64x2_t longitude = vld1q_f64(longitudes + i);
+        const uint64x2_t inside = vandq_u64(vandq_u64(vcgeq_f64(latitude, swLat), vcleq_f64(latitude, neLat)),
+                                            vandq_u64(vcgeq_f64(longitude, swLon), vcleq_f64(longitude, neLon)));
 
-    qCDebug(TerrainTileLog) << this << "latIndex, lonIndex:" << latIndex << lonIndex << "elevation:" << elevation;
+        // The nm variants take the number for NaN coordinates
+        const float64x2_t row = vminnmq_f64(vmaxnmq_f64(vsubq_f64(vmulq_f64(vsubq_f64(latitude, swLat), rowsPerDegree), half), zero), maxRow);
+        const float64x2_t column = vminnmq_f64(vmaxnmq_f64(vsubq_f64(vmulq_f64(vsubq_f64(longitude, swLon), columnsPerDegree), half), zero), maxColumn);
+        const float64x2_t row0 = vrndmq_f64(row);
+        const float64x2_t column0 = vrndmq_f64(column);
+        const float64x2_t rowWeight = vsubq_f64(row, row0);
+        const float64x2_t columnWeight = vsubq_f64(column, column0);
+
+        const int64x2_t rowIndex64 = vcvtq_s64_f64(row0);
+        const int64x2_t columnIndex64 = vcvtq_s64_f64(column0);
+        rowIndex[0] = static_cast<int32_t>(vgetq_lane_s64(rowIndex64, 0));
+        rowIndex[1] = static_cast<int32_t>(vgetq_lane_s64(rowIndex64, 1));
+        columnIndex[0] = static_cast<int32_t>(vgetq_lane_s64(columnIndex64, 0));
+        columnIndex[1] = static_cast<int32_t>(vgetq_lane_s64(columnIndex64, 1));
+        gather();
+
+        const float64x2_t c00 = vld1q_f64(corner00);
+        const float64x2_t c01 = vld1q_f64(corner01);
+        const float64x2_t c10 = vld1q_f64(corner10);
+        const float64x2_t c11 = vld1q_f64(corner11);
+        const float64x2_t south = vfmaq_f64(c00, columnWeight, vsubq_f64(c01, c00));
+        const float64x2_t north = vfmaq_f64(c10, columnWeight, vsubq_f64(c11, c10));
+        const float64x2_t elevation = vfmaq_f64(south, rowWeight, vsubq_f64(north, south));
+
+        vst1q_f64(elevations + i, vbslq_f64(inside, elevation, nan));
+    }
+#endif
 
-    return static_cast<double>(elevation);
+    _elevationsScalar(latitudes + i, longitudes + i, elevations + i, count - i);
 }
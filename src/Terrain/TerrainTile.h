@@ -9,9 +9,10 @@
 
 #pragma once
 
-#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 
+#include <memory>
+
 class QGeoCoordinate;
 class TerrainTileTest;
 
@@ -33,9 +34,19 @@ class TerrainTile
 
     /// Evaluates the elevation at the given coordinate
     ///    @param coordinate
-    ///    @return elevation
+    ///    @return elevation, NaN outside the tile
     double elevation(const QGeoCoordinate &coordinate) const;
 
+    /// Bilinearly interpolates the elevations at count coordinates, NaN for those outside the tile
+    ///    @param latitudes
+    ///    @param longitudes
+    ///    @param[out] elevations
+    ///    @param count
+    void elevations(const double *latitudes, const double *longitudes, double *elevations, qsizetype count) const;
+
+    /// Bytes held by the tile, used to bound the tile cache
+    qint64 memorySize() const { return static_cast<qint64>(sizeof(TerrainTile)) + (_isValid ? (static_cast<qint64>(_tileInfo.gridSizeLat) * _tileInfo.gridSizeLon * static_cast<qint64>(sizeof(int16_t))) : 0); }
+
     /// Accessor for the minimum elevation of the tile
     ///    @return minimum elevation
     double minElevation() const { return (_isValid ? static_cast<double>(_tileInfo.minElevation) : qQNaN()); }
@@ -57,9 +68,19 @@ class TerrainTile
     } Q_PACKED;
 
 private:
+    /// Bilinear elevation at fractional grid position, rows are latitude and columns longitude
+    double _interpolate(double row, double column) const;
+    void _elevationsScalar(const double *latitudes, const double *longitudes, double *elevations, qsizetype count) const;
+
+    struct AlignedDeleter {
+        void operator()(int16_t *data) const { qFreeAligned(data); }
+    };
+
     TileInfo_t _tileInfo{};
-    QList<QList<int16_t>> _elevationData;   ///< 2D elevation data array
+    std::unique_ptr<int16_t[], AlignedDeleter> _elevationData;  ///< Row major grid, gridSizeLat rows of gridSizeLon
     double _cellSizeLat = 0.0;              ///< data grid size in latitude direction
     double _cellSizeLon = 0.0;              ///< data grid size in longitude direction
     bool _isValid = false;                  ///< data loaded is valid
+
+    static constexpr size_t kGridAlignment = 64;    ///< Cache line
 };
@@ -0,0 +1,394 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileCache.h"
+#include "TerrainTile.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QtEndian>
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TerrainTileCacheLog, "qgc.terrain.terraintilecache")
+
+TerrainTileCache::TerrainTileCache(qint64 maxBytes)
+    : _maxBytes(maxBytes)
+{
+    // qCDebug(TerrainTileCacheLog) << Q_FUNC_INFO << this;
+}
+
+TerrainTileCache::~TerrainTileCache()
+{
+    qCDebug(TerrainTileCacheLog) << "hits:" << _hits.load() << "misses:" << _misses.load() << "evictions:" << _evictions.load();
+}
+
+quint64 TerrainTileCache::tileKey(int mapId, int x, int y, int z)
+{
+    return ((static_cast<quint64>(mapId) & 0xffff) << 48) | ((static_cast<quint64>(z) & 0xff) << 40)
+         | ((static_cast<quint64>(x) & 0xfffff) << 20) | (static_cast<quint64>(y) & 0xfffff);
+}
+
+TerrainTileCache::Shard &TerrainTileCache::_shard(quint64 key) const
+{
+    // Neighbouring tiles differ in the low bits, mixing spreads them over the shards
+    const quint64 hash = key * 0x9e3779b97f4a7c15ULL;
+    return _shards[hash >> 60];
+}
+
+std::shared_ptr<const TerrainTile> TerrainTileCache::find(quint64 key) const
+{
+    const Shard &shard = _shard(key);
+    QReadLocker locker(&shard.lock);
+
+    const auto it = shard.entries.constFind(key);
+    if (it == shard.entries.constEnd()) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    it.value()->lastUsed.store(_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    return it.value()->tile;
+}
+
+void TerrainTileCache::insert(quint64 key, const std::shared_ptr<const TerrainTile> &tile)
+{
+    if (!tile) {
+        return;
+    }
+
+    Shard &shard = _shard(key);
+    QWriteLocker locker(&shard.lock);
+
+    std::shared_ptr<Entry> &entry = shard.entries[key];
+    if (entry) {
+        shard.bytes -= entry->bytes;
+    } else {
+        entry = std::make_shared<Entry>();
+    }
+    entry->tile = tile;
+    entry->bytes = tile->memorySize();
+    entry->lastUsed.store(_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    shard.bytes += entry->bytes;
+
+    _evict(shard, _maxBytes.load(std::memory_order_relaxed) / static_cast<qint64>(_shards.size()));
+}
+
+void TerrainTileCache::_evict(Shard &shard, qint64 maxBytes)
+{
+    // A shard holds a few hundred tiles at most, a scan for the oldest is cheaper than keeping an ordered list up to date on every hit
+    while ((shard.bytes > maxBytes) && (shard.entries.size() > 1)) {
+        auto oldest = shard.entries.begin();
+        quint64 oldestUsed = oldest.value()->lastUsed.load(std::memory_order_relaxed);
+        for (auto it = shard.entries.begin(); it != shard.entries.end(); ++it) {
+            const quint64 lastUsed = it.value()->lastUsed.load(std::memory_order_relaxed);
+            if (lastUsed < oldestUsed) {
+                oldest = it;
+                oldestUsed = lastUsed;
+            }
+        }
+
+        shard.bytes -= oldest.value()->bytes;
+        (void) shard.entries.erase(oldest);
+        _evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void TerrainTileCache::clear()
+{
+    for (Shard &shard : _shards) {
+        QWriteLocker locker(&shard.lock);
+        shard.entries.clear();
+        shard.bytes = 0;
+    }
+}
+
+void TerrainTileCache::setMaxBytes(qint64 maxBytes)
+{
+    _maxBytes.store(maxBytes, std::memory_order_relaxed);
+
+    for (Shard &shard : _shards) {
+        QWriteLocker locker(&shard.lock);
+        _evict(shard, maxBytes / static_cast<qint64>(_shards.size()));
+    }
+}
+
+qint64 TerrainTileCache::bytes() const
+{
+    qint64 total = 0;
+    for (const Shard &shard : _shards) {
+        QReadLocker locker(&shard.lock);
+        total += shard.bytes;
+    }
+    return total;
+}
+
+qsizetype TerrainTileCache::count() const
+{
+    qsizetype total = 0;
+    for (const Shard &shard : _shards) {
+        QReadLocker locker(&shard.lock);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+TerrainTileCache::Stats TerrainTileCache::stats() const
+{
+    Stats result;
+    result.hits = _hits.load(std::memory_order_relaxed);
+    result.misses = _misses.load(std::memory_order_relaxed);
+    result.evictions = _evictions.load(std::memory_order_relaxed);
+    return result;
+}
+
+/*===========================================================================*/
+
+TerrainTileDiskCache::TerrainTileDiskCache()
+{
+    // qCDebug(TerrainTileCacheLog) << Q_FUNC_INFO << this;
+}
+
+TerrainTileDiskCache::~TerrainTileDiskCache()
+{
+    close();
+}
+
+bool TerrainTileDiskCache::open(const QString &path)
+{
+    close();
+
+    QWriteLocker locker(&_lock);
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadWrite)) {
+        qCWarning(TerrainTileCacheLog) << "Failed to open" << path << _file.errorString();
+        return false;
+    }
+
+    if (!_scan()) {
+        qCWarning(TerrainTileCacheLog) << "Failed to map" << path << _file.errorString();
+        _unmap();
+        _file.close();
+        return false;
+    }
+
+    qCDebug(TerrainTileCacheLog) << "Opened" << path << "tiles:" << _records.size() << "bytes:" << _size;
+    return true;
+}
+
+bool TerrainTileDiskCache::_scan()
+{
+    const qint64 fileSize = _file.size();
+    if ((fileSize < static_cast<qint64>(sizeof(kMagic))) || (_file.read(sizeof(kMagic)) != QByteArray::fromRawData(kMagic, sizeof(kMagic)))) {
+        if (fileSize > 0) {
+            qCWarning(TerrainTileCacheLog) << "Discarding unknown file" << _file.fileName();
+        }
+        if (!_file.resize(0) || !_file.seek(0) || (_file.write(kMagic, sizeof(kMagic)) != static_cast<qint64>(sizeof(kMagic))) || !_file.flush()) {
+            return false;
+        }
+        _size = sizeof(kMagic);
+        return _grow(0);
+    }
+
+    _size = sizeof(kMagic);
+    _writeChunk = _file.map(0, fileSize);
+    if (!_writeChunk) {
+        return false;
+    }
+    _mappings.append(_writeChunk);
+    _writeChunkStart = 0;
+    _writeChunkEnd = fileSize;
+
+    // Unused space at the end of the last chunk reads as a zero length record
+    while ((_size + kRecordHeaderSize) <= fileSize) {
+        const uchar *const header = _writeChunk + _size;
+        const quint64 key = qFromLittleEndian<quint64>(header);
+        const quint32 length = qFromLittleEndian<quint32>(header + 8);
+        const quint16 checksum = qFromLittleEndian<quint16>(header + 12);
+        if ((length == 0) || ((_size + kRecordHeaderSize + length) > fileSize)) {
+            break;
+        }
+
+        Record record;
+        record.data = header + kRecordHeaderSize;
+        record.length = length;
+        record.checksum = checksum;
+        _records.insert(key, record);
+        _size += kRecordHeaderSize + length;
+    }
+
+    if (_size < fileSize) {
+        qCDebug(TerrainTileCacheLog) << "Reusing" << (fileSize - _size) << "bytes past the last tile";
+        (void) memset(_writeChunk + _size, 0, fileSize - _size);
+    }
+
+    return true;
+}
+
+bool TerrainTileDiskCache::_grow(qint64 bytes)
+{
+    const qint64 required = kRecordHeaderSize + bytes;
+    if (_writeChunk && ((_size + required) <= _writeChunkEnd)) {
+        return true;
+    }
+
+    // The new chunk starts at the end of the records, the unused end of the previous one is mapped twice
+    const qint64 chunkSize = qMax(kChunkSize, required);
+    const qint64 chunkEnd = _size + chunkSize;
+    if ((chunkEnd > _file.size()) && !_file.resize(chunkEnd)) {
+        return false;
+    }
+
+    uchar *const chunk = _file.map(_size, chunkSize);
+    if (!chunk) {
+        return false;
+    }
+    _mappings.append(chunk);
+    _writeChunk = chunk;
+    _writeChunkStart = _size;
+    _writeChunkEnd = chunkEnd;
+    return true;
+}
+
+void TerrainTileDiskCache::_unmap()
+{
+    for (uchar *mapping : std::as_const(_mappings)) {
+        (void) _file.unmap(mapping);
+    }
+    _mappings.clear();
+    _writeChunk = nullptr;
+    _writeChunkStart = 0;
+    _writeChunkEnd = 0;
+}
+
+void TerrainTileDiskCache::close()
+{
+    QWriteLocker locker(&_lock);
+
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    _unmap();
+    // The unused end of the last chunk is not kept
+    (void) _file.resize(_size);
+    _file.close();
+
+    _records.clear();
+    _size = 0;
+}
+
+bool TerrainTileDiskCache::isOpen() const
+{
+    QReadLocker locker(&_lock);
+    return _file.isOpen();
+}
+
+QByteArray TerrainTileDiskCache::find(quint64 key)
+{
+    const uchar *damaged = nullptr;
+    {
+        QReadLocker locker(&_lock);
+
+        const auto it = _records.constFind(key);
+        if (it == _records.constEnd()) {
+            return QByteArray();
+        }
+
+        // Copied out of the mapping, which goes away on close or clear
+        const QByteArray data(reinterpret_cast<const char*>(it->data), it->length);
+        if (qChecksum(data) == it->checksum) {
+            return data;
+        }
+        damaged = it->data;
+    }
+
+    // Records written just before a crash may not have reached the disk in full
+    qCWarning(TerrainTileCacheLog) << "Stored tile failed its checksum" << Qt::hex << key;
+
+    QWriteLocker locker(&_lock);
+    // Unless the tile was saved again in the meantime, it is downloaded again
+    const auto it = _records.find(key);
+    if ((it != _records.end()) && (it->data == damaged)) {
+        (void) _records.erase(it);
+    }
+
+    return QByteArray();
+}
+
+bool TerrainTileDiskCache::insert(quint64 key, const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    QWriteLocker locker(&_lock);
+
+    if (!_file.isOpen() || ((_size + kRecordHeaderSize + data.size()) > kMaxSize)) {
+        return false;
+    }
+
+    if (!_grow(data.size())) {
+        qCWarning(TerrainTileCacheLog) << "Failed to grow" << _file.fileName() << _file.errorString();
+        return false;
+    }
+
+    uchar *const header = _writeChunk + (_size - _writeChunkStart);
+    Record record;
+    record.data = header + kRecordHeaderSize;
+    record.length = static_cast<quint32>(data.size());
+    record.checksum = qChecksum(data);
+
+    // Data first, a header is only seen once the tile behind it is complete
+    (void) memcpy(header + kRecordHeaderSize, data.constData(), data.size());
+    qToLittleEndian<quint64>(key, header);
+    qToLittleEndian<quint16>(record.checksum, header + 12);
+    qToLittleEndian<quint16>(0, header + 14);
+    qToLittleEndian<quint32>(record.length, header + 8);
+
+    // An earlier record of the same tile is left in the file, unreachable
+    _records.insert(key, record);
+    _size += kRecordHeaderSize + data.size();
+    return true;
+}
+
+bool TerrainTileDiskCache::contains(quint64 key) const
+{
+    QReadLocker locker(&_lock);
+    return _records.contains(key);
+}
+
+void TerrainTileDiskCache::clear()
+{
+    QWriteLocker locker(&_lock);
+
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    _unmap();
+    _records.clear();
+    _size = sizeof(kMagic);
+    if (!_file.resize(_size) || !_grow(0)) {
+        qCWarning(TerrainTileCacheLog) << "Failed to clear" << _file.fileName() << _file.errorString();
+    }
+}
+
+qsizetype TerrainTileDiskCache::count() const
+{
+    QReadLocker locker(&_lock);
+    return _records.size();
+}
+
+qint64 TerrainTileDiskCache::size() const
+{
+    QReadLocker locker(&_lock);
+    return _size;
+}
@@ -0,0 +1,134 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QReadWriteLock>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+class TerrainTile;
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainTileCacheLog)
+
+/// Memory bounded cache of decoded terrain tiles, least recently used tiles are evicted first.
+/// Tiles are spread over shards by key, a lookup only takes its shard's lock for reading and
+/// records the use with an atomic stamp, so concurrent lookups don't serialize.
+class TerrainTileCache
+{
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+    };
+
+    explicit TerrainTileCache(qint64 maxBytes = kDefaultMaxBytes);
+    ~TerrainTileCache();
+
+    static quint64 tileKey(int mapId, int x, int y, int z);
+
+    /// @return nullptr if the tile is not cached
+    std::shared_ptr<const TerrainTile> find(quint64 key) const;
+    /// Evicts least recently used tiles once the cache is over its limit
+    void insert(quint64 key, const std::shared_ptr<const TerrainTile> &tile);
+    void clear();
+
+    void setMaxBytes(qint64 maxBytes);
+    qint64 maxBytes() const { return _maxBytes; }
+    qint64 bytes() const;
+    qsizetype count() const;
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const TerrainTile> tile;
+        qint64 bytes = 0;
+        mutable std::atomic<quint64> lastUsed = 0;
+    };
+
+    struct Shard {
+        mutable QReadWriteLock lock;
+        QHash<quint64, std::shared_ptr<Entry>> entries;
+        qint64 bytes = 0;
+    };
+
+    Shard &_shard(quint64 key) const;
+    void _evict(Shard &shard, qint64 maxBytes);
+
+    mutable std::array<Shard, 16> _shards;
+    std::atomic<qint64> _maxBytes;
+    mutable std::atomic<quint64> _clock = 0;
+    mutable std::atomic<quint64> _hits = 0;
+    mutable std::atomic<quint64> _misses = 0;
+    std::atomic<quint64> _evictions = 0;
+
+    static constexpr qint64 kDefaultMaxBytes = 64 * 1024 * 1024;
+};
+
+/*===========================================================================*/
+
+/// Persistent store of serialized terrain tiles. Records are appended to a memory mapped file
+/// that grows in chunks, so tiles saved before a restart are read back without parsing or network access.
+class TerrainTileDiskCache
+{
+public:
+    TerrainTileDiskCache();
+    ~TerrainTileDiskCache();
+
+    /// Creates the file if needed, a damaged tail left by a crash is cut off
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const;
+
+    /// Copy of the serialized tile, a tile which fails its checksum is dropped
+    /// @return empty if the tile is not stored or fails its checksum
+    QByteArray find(quint64 key);
+    /// @return false once the file reached its size limit
+    bool insert(quint64 key, const QByteArray &data);
+    bool contains(quint64 key) const;
+    /// Drops every stored tile
+    void clear();
+
+    qsizetype count() const;
+    qint64 size() const;
+
+private:
+    struct Record {
+        const uchar *data = nullptr;
+        quint32 length = 0;
+        quint16 checksum = 0;
+    };
+
+    bool _scan();
+    /// Maps at least bytes past the end of the records, the caller holds the write lock
+    bool _grow(qint64 bytes);
+    void _unmap();
+
+    mutable QReadWriteLock _lock;
+    QFile _file;
+    QHash<quint64, Record> _records;
+    /// Chunks may overlap, earlier ones stay mapped so tiles handed out remain valid
+    QList<uchar*> _mappings;
+    uchar *_writeChunk = nullptr;       ///< Mapping the next record is written to
+    qint64 _writeChunkStart = 0;        ///< File offset of _writeChunk
+    qint64 _writeChunkEnd = 0;
+    qint64 _size = 0;                   ///< End of the last record
+
+    static constexpr char kMagic[8] = { 'Q', 'G', 'C', 'T', 'E', 'R', 'R', '1' };
+    static constexpr qint64 kRecordHeaderSize = 16;         ///< Key, length, checksum and padding
+    static constexpr qint64 kChunkSize = 4 * 1024 * 1024;
+    static constexpr qint64 kMaxSize = 512 * 1024 * 1024;   ///< Full stores take no more tiles
+};
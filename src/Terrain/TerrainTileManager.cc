@@ -10,6 +10,7 @@
 #include "TerrainTileManager.h"
 #include "TerrainTile.h"
 #include "TerrainTileCopernicus.h"
+#include "QGeoFileTileCacheQGC.h"
 #include "QGeoTileFetcherQGC.h"
 #include "QGeoMapReplyQGC.h"
 #include "QGCMapUrlEngine.h"
@@ -18,11 +19,17 @@
 #include "FlightMapSettings.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QDir>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
 #include <QtLocation/private/qgeotilespec_p.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkRequest>
 
+#include <atomic>
+
 QGC_LOGGING_CATEGORY(TerrainTileManagerLog, "qgc.terrain.terraintilemanager")
 
 Q_GLOBAL_STATIC(TerrainTileManager, _terrainTileManager)
@@ -47,8 +54,6 @@ TerrainTileManager::TerrainTileManager(QObject *parent)
 
 TerrainTileManager::~TerrainTileManager()
 {
-    qDeleteAll(_tiles);
-
     qCDebug(TerrainTileManagerLog) << this;
 }
 
@@ -56,50 +61,167 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>
 {
     error = false;
 
-    const QString elevationProviderName = SettingsManager::instance()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
-    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(elevationProviderName);
-    for (const QGeoCoordinate &coordinate: coordinates) {
-        const QString tileHash = UrlFactory::getTileHash(
-            provider->getMapName(),
-            provider->long2tileX(coordinate.longitude(), 1),
-            provider->lat2tileY(coordinate.latitude(), 1),
-            1
-        );
-        qCDebug(TerrainTileManagerLog) << "hash:coordinate" << tileHash << coordinate;
-
-        TerrainTile* const tile = _getCachedTile(tileHash);
-        if (tile) {
-            const double elevation = tile->elevation(coordinate);
-            if (qIsNaN(elevation)) {
-                error = true;
-                qCWarning(TerrainTileManagerLog) << "Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainTileManagerLog) << "returning elevation from tile cache" << elevation;
-            }
-            altitudes.push_back(elevation);
-        } else if (_state != TerrainQuery::State::Downloading) {
-            QGeoTileSpec spec;
-            spec.setX(provider->long2tileX(coordinate.longitude(), 1));
-            spec.setY(provider->lat2tileY(coordinate.latitude(), 1));
-            spec.setZoom(1);
-            spec.setMapId(provider->getMapId());
-            const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
-            QGeoTiledMapReplyQGC *reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
-            (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
-            if (reply->init()) {
-                _state = TerrainQuery::State::Downloading;
-            } else {
-                reply->deleteLater();
+    const SharedMapProvider provider = _elevationProvider();
+
+    const qsizetype count = coordinates.count();
+    QList<double> latitudes(count);
+    QList<double> longitudes(count);
+    for (qsizetype i = 0; i < count; i++) {
+        latitudes[i] = coordinates[i].latitude();
+        longitudes[i] = coordinates[i].longitude();
+    }
+
+    const qsizetype first = altitudes.count();
+    altitudes.resize(first + count);
+
+    QPoint missingTile;
+    if (!_cachedAltitudes(*provider, _diskCache(), latitudes.constData(), longitudes.constData(), altitudes.data() + first, count, missingTile)) {
+        altitudes.resize(first);
+        _requestTile(*provider, missingTile);
+        return false;
+    }
+
+    for (qsizetype i = first; i < altitudes.count(); i++) {
+        if (qIsNaN(altitudes[i])) {
+            error = true;
+            qCWarning(TerrainTileManagerLog) << "Internal Error: missing elevation in tile cache" << coordinates[i - first];
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool TerrainTileManager::getPathProfile(const QList<QGeoCoordinate> &polyPath, TerrainPathProfile &profile, bool &error)
+{
+    error = false;
+
+    const SharedMapProvider provider = _elevationProvider();
+    TerrainTileDiskCache *const savedTiles = _diskCache();
+
+    profile = TerrainPathProfile::layout(polyPath, TerrainTileCopernicus::kTileValueSpacingMeters);
+    const qsizetype count = profile.heights.count();
+    if (count == 0) {
+        return true;
+    }
+
+    // Pointers are taken up front, the tasks write to separate parts of the buffers
+    QList<double> latitudes(count);
+    QList<double> longitudes(count);
+    double *const lat = latitudes.data();
+    double *const lon = longitudes.data();
+    double *const heights = profile.heights.data();
+    const TerrainPathProfile::Segment *const segments = profile.segments.constData();
+
+    // Runs of whole segments with about the same number of heights
+    const qsizetype taskSize = qMax(kMinPathProfileTaskSize, count / (QThreadPool::globalInstance()->maxThreadCount() * 4));
+    QList<TerrainPathProfile::Task> tasks = profile.tasks(taskSize);
+
+    QMutex missingMutex;
+    std::atomic<bool> missing = false;
+    QPoint missingTile;
+
+    // Samples are laid out and looked up in one go
+    const auto sampleSegments = [&](const TerrainPathProfile::Task &task) {
+        if (missing.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        for (qsizetype i = task.firstSegment; i < task.endSegment; i++) {
+            const qsizetype first = segments[i].first;
+            TerrainPathProfile::segmentCoordinates(polyPath[i], polyPath[i + 1], segments[i].count, lat + first, lon + first);
+        }
+
+        const qsizetype first = segments[task.firstSegment].first;
+        const qsizetype end = segments[task.endSegment - 1].first + segments[task.endSegment - 1].count;
+        QPoint tile;
+        if (!_cachedAltitudes(*provider, savedTiles, lat + first, lon + first, heights + first, end - first, tile)) {
+            QMutexLocker locker(&missingMutex);
+            if (!missing.exchange(true)) {
+                missingTile = tile;
             }
-            return false;
-        } else {
+        }
+    };
+
+    if (tasks.count() > 1) {
+        QtConcurrent::blockingMap(tasks, sampleSegments);
+    } else {
+        sampleSegments(tasks.first());
+    }
+
+    if (missing) {
+        _requestTile(*provider, missingTile);
+        return false;
+    }
+
+    qCDebug(TerrainTileManagerLog) << "profile segments:heights:tasks" << profile.segments.count() << count << tasks.count();
+
+    for (qsizetype i = 0; i < count; i++) {
+        if (qIsNaN(heights[i])) {
+            error = true;
+            qCWarning(TerrainTileManagerLog) << "Internal Error: missing elevation in tile cache" << QGeoCoordinate(lat[i], lon[i]);
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool TerrainTileManager::_cachedAltitudes(const MapProvider &provider, TerrainTileDiskCache *savedTiles, const double *latitudes, const double *longitudes, double *altitudes, qsizetype count, QPoint &missingTile)
+{
+    // Neighbouring coordinates mostly share a tile, each run of them is sampled in one batch
+    qsizetype runStart = 0;
+    while (runStart < count) {
+        const int tileX = provider.long2tileX(longitudes[runStart], 1);
+        const int tileY = provider.lat2tileY(latitudes[runStart], 1);
+        qsizetype runEnd = runStart + 1;
+        while ((runEnd < count) && (provider.long2tileX(longitudes[runEnd], 1) == tileX) && (provider.lat2tileY(latitudes[runEnd], 1) == tileY)) {
+            runEnd++;
+        }
+
+        const quint64 tileKey = TerrainTileCache::tileKey(provider.getMapId(), tileX, tileY, 1);
+        qCDebug(TerrainTileManagerLog) << "tile:coordinates" << tileX << tileY << (runEnd - runStart);
+
+        const std::shared_ptr<const TerrainTile> tile = _getCachedTile(tileKey, savedTiles);
+        if (!tile) {
+            missingTile = QPoint(tileX, tileY);
             return false;
         }
+
+        tile->elevations(latitudes + runStart, longitudes + runStart, altitudes + runStart, runEnd - runStart);
+        runStart = runEnd;
     }
 
     return true;
 }
 
+void TerrainTileManager::_requestTile(const MapProvider &provider, const QPoint &tile)
+{
+    if (_state == TerrainQuery::State::Downloading) {
+        return;
+    }
+
+    QGeoTileSpec spec;
+    spec.setX(tile.x());
+    spec.setY(tile.y());
+    spec.setZoom(1);
+    spec.setMapId(provider.getMapId());
+    const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
+    QGeoTiledMapReplyQGC *reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
+    (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
+    if (reply->init()) {
+        _state = TerrainQuery::State::Downloading;
+    } else {
+        reply->deleteLater();
+    }
+}
+
+SharedMapProvider TerrainTileManager::_elevationProvider()
+{
+    const QString elevationProviderName = SettingsManager::instance()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
+    return UrlFactory::getMapProviderFromProviderType(elevationProviderName);
+}
+
 void TerrainTileManager::addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates)
 {
     qCDebug(TerrainTileManagerLog) << "count" << coordinates.count();
@@ -166,30 +288,51 @@ void TerrainTileManager::addPathQuery(TerrainQueryInterface *terrainQueryInterfa
     terrainQueryInterface->signalPathHeights((coordinates.count() == altitudes.count()), distanceBetween, finalDistanceBetween, altitudes);
 }
 
+void TerrainTileManager::addPolyPathQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &polyPath)
+{
+    qCDebug(TerrainTileManagerLog) << "count" << polyPath.count();
+
+    bool error;
+    TerrainPathProfile profile;
+    if (!getPathProfile(polyPath, profile, error)) {
+        qCDebug(TerrainTileManagerLog) << "queue count" << _requestQueue.count();
+        const QueuedRequestInfo_t queuedRequestInfo = {
+            terrainQueryInterface,
+            TerrainQuery::QueryMode::QueryModePolyPath,
+            0,
+            0,
+            polyPath
+        };
+        _requestQueue.enqueue(queuedRequestInfo);
+        return;
+    }
+
+    if (error) {
+        qCWarning(TerrainTileManagerLog) << "signalling failure due to internal error";
+        terrainQueryInterface->signalPolyPathHeights(false, TerrainPathProfile());
+        return;
+    }
+
+    qCDebug(TerrainTileManagerLog) << "all altitudes taken from cached data";
+    terrainQueryInterface->signalPolyPathHeights(true, profile);
+}
+
 QList<QGeoCoordinate> TerrainTileManager::_pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween)
 {
-    const double lat = fromCoord.latitude();
-    const double lon = fromCoord.longitude();
-    const int steps = qCeil(toCoord.distanceTo(fromCoord) / TerrainTileCopernicus::kTileValueSpacingMeters); // TODO: get spacing from terrainQueryInterface
-    const double latDiff = toCoord.latitude() - lat;
-    const double lonDiff = toCoord.longitude() - lon;
+    // Laid out the same way as each segment of a poly path query
+    const TerrainPathProfile profile = TerrainPathProfile::layout({ fromCoord, toCoord }, TerrainTileCopernicus::kTileValueSpacingMeters); // TODO: get spacing from terrainQueryInterface
+    const TerrainPathProfile::Segment &segment = profile.segments.first();
+    distanceBetween = segment.distanceBetween;
+    finalDistanceBetween = segment.finalDistanceBetween;
 
-    QList<QGeoCoordinate> coordinates;
-    if (steps == 0) {
-        (void) coordinates.append(fromCoord);
-        (void) coordinates.append(toCoord);
-        distanceBetween = finalDistanceBetween = coordinates[0].distanceTo(coordinates[1]);
-    } else {
-        for (int i = 0; i <= steps; i++) {
-            const double latStep = lat + ((latDiff * static_cast<double>(i)) / static_cast<double>(steps));
-            const double lonStep = lon + ((lonDiff * static_cast<double>(i)) / static_cast<double>(steps));
-            (void) coordinates.append(QGeoCoordinate(latStep, lonStep));
-        }
+    QList<double> latitudes(segment.count);
+    QList<double> longitudes(segment.count);
+    TerrainPathProfile::segmentCoordinates(fromCoord, toCoord, segment.count, latitudes.data(), longitudes.data());
 
-        // We always have one too many and we always want the last one to be the endpoint
-        coordinates.last() = toCoord;
-        distanceBetween = coordinates[0].distanceTo(coordinates[1]);
-        finalDistanceBetween = coordinates[coordinates.count() - 2].distanceTo(coordinates.last());
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(segment.count);
+    for (qsizetype i = 0; i < segment.count; i++) {
+        (void) coordinates.append(QGeoCoordinate(latitudes[i], longitudes[i]));
     }
 
     qCDebug(TerrainTileManagerLog) << "fromCoord:toCoord:distanceBetween:finalDisanceBetween:coordCount" << fromCoord << toCoord << distanceBetween << finalDistanceBetween << coordinates.count();
@@ -209,6 +352,9 @@ void TerrainTileManager::_tileFailed()
         case TerrainQuery::QueryMode::QueryModePath:
             requestInfo.terrainQueryInterface->signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
             break;
+        case TerrainQuery::QueryMode::QueryModePolyPath:
+            requestInfo.terrainQueryInterface->signalPolyPathHeights(false, TerrainPathProfile());
+            break;
         default:
             continue;
         }
@@ -245,14 +391,30 @@ void TerrainTileManager::_terrainDone()
 
     qCDebug(TerrainTileManagerLog) << "Received some bytes of terrain data:" << responseBytes.size();
 
-    const QString hash = UrlFactory::getTileHash(UrlFactory::getProviderTypeFromQtMapId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
-    _cacheTile(responseBytes, hash);
+    _cacheTile(responseBytes, TerrainTileCache::tileKey(spec.mapId(), spec.x(), spec.y(), spec.zoom()));
 
     for (qsizetype i = _requestQueue.count() - 1; i >= 0; i--) {
         bool error;
         QList<double> altitudes;
         QueuedRequestInfo_t &requestInfo = _requestQueue[i];
 
+        if (requestInfo.queryMode == TerrainQuery::QueryMode::QueryModePolyPath) {
+            TerrainPathProfile profile;
+            if (!getPathProfile(requestInfo.coordinates, profile, error)) {
+                continue;
+            }
+
+            if (error) {
+                qCWarning(TerrainTileManagerLog) << "signalling failure due to internal error";
+                requestInfo.terrainQueryInterface->signalPolyPathHeights(false, TerrainPathProfile());
+            } else {
+                qCDebug(TerrainTileManagerLog) << "All altitudes taken from cached data";
+                requestInfo.terrainQueryInterface->signalPolyPathHeights(true, profile);
+            }
+            _requestQueue.removeAt(i);
+            continue;
+        }
+
         if (!getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
             continue;
         }
@@ -286,39 +448,77 @@ void TerrainTileManager::_terrainDone()
     }
 }
 
-void TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
+void TerrainTileManager::_cacheTile(const QByteArray &data, quint64 key)
 {
-    TerrainTile* const terrainTile = new TerrainTile(data);
-    if (terrainTile->isValid()) {
-        _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            (void) _tiles.insert(hash, terrainTile);
-        } else {
-            delete terrainTile;
-        }
-        _tilesMutex.unlock();
-    } else {
-        delete terrainTile;
+    const std::shared_ptr<const TerrainTile> terrainTile = std::make_shared<const TerrainTile>(data);
+    if (!terrainTile->isValid()) {
         qCWarning(TerrainTileManagerLog) << "Received invalid tile";
+        return;
+    }
+
+    _tiles.insert(key, terrainTile);
+
+    TerrainTileDiskCache *const savedTiles = _diskCache();
+    if (savedTiles && !savedTiles->contains(key)) {
+        (void) savedTiles->insert(key, data);
     }
 }
 
-TerrainTile *TerrainTileManager::_getCachedTile(const QString &hash)
+std::shared_ptr<const TerrainTile> TerrainTileManager::_getCachedTile(quint64 key, TerrainTileDiskCache *savedTiles)
 {
-    _tilesMutex.lock();
-    if (!_tiles.contains(hash)) {
-        _tilesMutex.unlock();
+    std::shared_ptr<const TerrainTile> tile = _tiles.find(key);
+    if (tile) {
+        return tile;
+    }
+
+    if (!savedTiles) {
         return nullptr;
     }
 
-    TerrainTile* const tile = _tiles[hash];
+    const QByteArray data = savedTiles->find(key);
+    if (data.isEmpty()) {
+        return nullptr;
+    }
 
+    tile = std::make_shared<const TerrainTile>(data);
     if (!tile->isValid()) {
-        _tilesMutex.unlock();
         return nullptr;
     }
 
-    _tilesMutex.unlock();
-
+    _tiles.insert(key, tile);
     return tile;
 }
+
+bool TerrainTileManager::openDiskCache(const QString &path)
+{
+    QMutexLocker locker(&_savedTilesMutex);
+
+    _savedTiles.close();
+    _savedTilesFailed = !_savedTiles.open(path);
+    return !_savedTilesFailed;
+}
+
+TerrainTileDiskCache *TerrainTileManager::_diskCache()
+{
+    // Opened on first use, the map cache location is only set once the map engine is up
+    QMutexLocker locker(&_savedTilesMutex);
+
+    if (_savedTiles.isOpen()) {
+        return &_savedTiles;
+    }
+    if (_savedTilesFailed) {
+        return nullptr;
+    }
+
+    const QString cachePath = QGeoFileTileCacheQGC::getCachePath();
+    if (cachePath.isEmpty()) {
+        return nullptr;
+    }
+
+    if (!_savedTiles.open(QDir(cachePath).filePath(kSavedTilesFileName))) {
+        _savedTilesFailed = true;
+        return nullptr;
+    }
+
+    return &_savedTiles;
+}
@@ -10,13 +10,16 @@
 #pragma once
 
 #include "TerrainQueryInterface.h"
+#include "TerrainTileCache.h"
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
+#include <QtCore/QPoint>
 #include <QtCore/QQueue>
 #include <QtPositioning/QGeoCoordinate>
 
+class MapProvider;
 class TerrainTile;
 class QNetworkAccessManager;
 class UnitTestTerrainQuery;
@@ -39,8 +42,22 @@ class TerrainTileManager : public QObject
     ///     @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
     bool getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error);
 
+    /// Either returns the heights along every segment of polyPath from cache or queues database request.
+    /// Segments are sampled across the global thread pool.
+    ///     @param[out] error true: profile not returned due to error, false: profile returned
+    ///     @return true: profile returned (check error as well), false: database query queued (profile not returned)
+    bool getPathProfile(const QList<QGeoCoordinate> &polyPath, TerrainPathProfile &profile, bool &error);
+
     void addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates);
     void addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint);
+    void addPolyPathQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &polyPath);
+
+    /// Decoded tiles kept across restarts, nullptr until the map cache location is known
+    TerrainTileDiskCache *diskCache() { return _diskCache(); }
+    /// Uses the tiles saved at path instead of the ones in the map cache location
+    bool openDiskCache(const QString &path);
+
+    static constexpr qsizetype kMinPathProfileTaskSize = 2048;     ///< Heights, smaller profiles are sampled on the calling thread
 
 private slots:
     void _terrainDone();
@@ -49,22 +66,36 @@ private slots:
     /// Returns a list of individual coordinates along the requested path spaced according to the terrain tile value spacing
     static QList<QGeoCoordinate> _pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween);
     void _tileFailed();
-    void _cacheTile(const QByteArray &data, const QString &hash);
-    TerrainTile *_getCachedTile(const QString &hash);
+    void _cacheTile(const QByteArray &data, quint64 key);
+    /// Looks in memory first, then in the tiles saved to disk. Safe to call from worker threads.
+    std::shared_ptr<const TerrainTile> _getCachedTile(quint64 key, TerrainTileDiskCache *savedTiles);
+    /// Samples count coordinates from cached tiles only, safe to call from worker threads
+    ///     @param[out] missingTile first tile which is not cached
+    ///     @return false: a tile is not cached
+    bool _cachedAltitudes(const MapProvider &provider, TerrainTileDiskCache *savedTiles, const double *latitudes, const double *longitudes, double *altitudes, qsizetype count, QPoint &missingTile);
+    /// Starts downloading tile unless a download is already in progress
+    void _requestTile(const MapProvider &provider, const QPoint &tile);
+    static std::shared_ptr<const MapProvider> _elevationProvider();
+    /// Opened once the map cache location is known, nullptr until then
+    TerrainTileDiskCache *_diskCache();
 
     struct QueuedRequestInfo_t {
         TerrainQueryInterface *terrainQueryInterface;
         TerrainQuery::QueryMode queryMode;
         double distanceBetween;                         ///< Distance between each returned height
         double finalDistanceBetween;                    ///< Distance between for final height
-        QList<QGeoCoordinate> coordinates;
+        QList<QGeoCoordinate> coordinates;            ///< Segment end points for QueryModePolyPath
     };
 
     QQueue<QueuedRequestInfo_t> _requestQueue;
     TerrainQuery::State _state = TerrainQuery::State::Idle;
 
-    QMutex _tilesMutex;
-    QHash<QString, TerrainTile*> _tiles;
+    TerrainTileCache _tiles;
+    TerrainTileDiskCache _savedTiles;
+    QMutex _savedTilesMutex;                ///< Guards opening _savedTiles and _savedTilesFailed
+    bool _savedTilesFailed = false;
+
+    static constexpr const char *kSavedTilesFileName = "TerrainTiles.bin";
 
     QNetworkAccessManager *_networkManager = nullptr;
 };
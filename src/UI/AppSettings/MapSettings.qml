@@ -133,6 +133,13 @@ Item {
                 }
             }
 
+            LabelledButton {
+                label:      qsTr("Open Map Archive")
+                buttonText: qsTr("Open")
+                enabled:    !_currentlyImportOrExporting
+                onClicked:  archiveDialogComponent.createObject(mainWindow).open()
+            }
+
             LabelledButton {
                 label:      qsTr("Export Map Tiles")
                 buttonText: qsTr("Export")
@@ -301,6 +308,53 @@ Item {
             }
         }
 
+        QGCFileDialog {
+            id:             archiveFileDialog
+            title:          qsTr("Open Map Archive")
+            nameFilters:    [ qsTr("Map Archives (*.mbtiles *.pmtiles)") ]
+
+            property string mapType
+
+            onAcceptedForLoad: (file) => {
+                close()
+                _mapEngineManager.mountArchive(file, mapType)
+            }
+        }
+
+        Component {
+            id: archiveDialogComponent
+
+            QGCPopupDialog {
+                title:      qsTr("Open Map Archive")
+                buttons:    Dialog.Ok | Dialog.Cancel
+
+                onAccepted: {
+                    close()
+                    archiveFileDialog.mapType = archiveMapCombo.currentText
+                    archiveFileDialog.openForLoad()
+                }
+
+                ColumnLayout {
+                    spacing: ScreenTools.defaultFontPixelWidth / 2
+
+                    QGCLabel { text: qsTr("Tiles in the archive are shown for map type:") }
+
+                    QGCComboBox {
+                        id:                 archiveMapCombo
+                        Layout.fillWidth:   true
+                        model:              _mapEngineManager.mapList
+
+                        Component.onCompleted: {
+                            var index = find(_mapProviderFact.rawValue + " " + _mapTypeFact.rawValue)
+                            if (index !== -1) {
+                                currentIndex = index
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
         Component {
             id: errorDialogComponent
 
@@ -96,4 +96,48 @@ bool inflateGzipFile(const QString &gzippedFileName, const QString &decompressed
     return true;
 }
 
+bool inflateGzipData(const QByteArray &gzippedData, QByteArray &decompressedData)
+{
+    decompressedData.clear();
+
+    z_stream strm;
+    strm.zalloc = nullptr;
+    strm.zfree = nullptr;
+    strm.opaque = nullptr;
+    strm.avail_in = static_cast<unsigned>(gzippedData.size());
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(gzippedData.constData()));
+
+    // 32 selects gzip or zlib from the header
+    int ret = inflateInit2(&strm, 32 + MAX_WBITS);
+    if (ret != Z_OK) {
+        qCWarning(QGCZlibLog) << "inflateInit2 failed:" << ret;
+        return false;
+    }
+
+    constexpr int cBuffer = 1024 * 16;
+    unsigned char outputBuffer[cBuffer];
+    do {
+        strm.avail_out = cBuffer;
+        strm.next_out = outputBuffer;
+
+        ret = inflate(&strm, Z_NO_FLUSH);
+        if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR || ret == Z_NEED_DICT) {
+            qCWarning(QGCZlibLog) << "inflate failed:" << ret;
+            inflateEnd(&strm);
+            return false;
+        }
+
+        decompressedData.append(reinterpret_cast<char*>(outputBuffer), cBuffer - strm.avail_out);
+    } while ((ret != Z_STREAM_END) && ((strm.avail_in > 0) || (strm.avail_out == 0)));
+
+    inflateEnd(&strm);
+
+    if (ret != Z_STREAM_END) {
+        qCWarning(QGCZlibLog) << "inflate did not reach stream end:" << ret;
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace QGCZlib
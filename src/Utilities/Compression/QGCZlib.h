@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QString>
 #include <QtCore/QLoggingCategory>
 
@@ -21,4 +22,10 @@ namespace QGCZlib
     ///     @param decompressedFilename Fully qualified path to for file to decompress to
     /// @return bool Success
     bool inflateGzipFile(const QString &gzippedFileName, const QString &decompressedFilename);
+
+    /// Decompresses gzip or zlib data held in memory
+    ///     @param gzippedData          Compressed bytes
+    ///     @param decompressedData     Receives the decompressed bytes
+    /// @return bool Success
+    bool inflateGzipData(const QByteArray &gzippedData, QByteArray &decompressedData);
 }
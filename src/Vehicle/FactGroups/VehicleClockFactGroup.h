@@ -25,6 +25,9 @@ class VehicleClockFactGroup : public FactGroup
     Fact *currentUTCTime() { return &_currentUTCTimeFact; }
     Fact *currentDate() { return &_currentDateFact; }
 
+    // Overrides from FactGroup
+    QList<uint32_t> handledMessageIds() const final { return {}; }
+
 private slots:
     void _updateAllValues() final;
 
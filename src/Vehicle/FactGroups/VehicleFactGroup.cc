@@ -52,6 +52,23 @@ VehicleFactGroup::VehicleFactGroup(QObject *parent)
     _hobbsFact.setRawValue(QStringLiteral("0000:00:00"));
 }
 
+QList<uint32_t> VehicleFactGroup::handledMessageIds() const
+{
+    QList<uint32_t> messageIds = {
+        MAVLINK_MSG_ID_ATTITUDE,
+        MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+        MAVLINK_MSG_ID_ALTITUDE,
+        MAVLINK_MSG_ID_VFR_HUD,
+        MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+        MAVLINK_MSG_ID_RAW_IMU
+    };
+#ifndef QGC_NO_ARDUPILOT_DIALECT
+    messageIds.append(MAVLINK_MSG_ID_RANGEFINDER);
+#endif
+
+    return messageIds;
+}
+
 void VehicleFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     switch (message.msgid) {
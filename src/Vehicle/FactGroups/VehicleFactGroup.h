@@ -80,6 +80,7 @@ class VehicleFactGroup : public FactGroup
     Fact *imuTemp() { return &_imuTempFact; }
 
     void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) override;
+    QList<uint32_t> handledMessageIds() const override;
 
 protected:
     void _handleAttitude(Vehicle *vehicle, const mavlink_message_t &message);
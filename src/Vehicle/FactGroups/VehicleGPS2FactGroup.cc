@@ -13,6 +13,11 @@
 
 #include <QtPositioning/QGeoCoordinate>
 
+QList<uint32_t> VehicleGPS2FactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_GPS2_RAW };
+}
+
 void VehicleGPS2FactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
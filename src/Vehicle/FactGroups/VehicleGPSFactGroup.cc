@@ -35,6 +35,15 @@ VehicleGPSFactGroup::VehicleGPSFactGroup(QObject *parent)
     _yawFact.setRawValue(std::numeric_limits<int16_t>::quiet_NaN());
 }
 
+QList<uint32_t> VehicleGPSFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_GPS_RAW_INT,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2
+    };
+}
+
 void VehicleGPSFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -39,6 +39,7 @@ class VehicleGPSFactGroup : public FactGroup
 
     // Overrides from FactGroup
     void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) override;
+    QList<uint32_t> handledMessageIds() const override;
 
 protected:
     void _handleGpsRawInt(const mavlink_message_t &message);
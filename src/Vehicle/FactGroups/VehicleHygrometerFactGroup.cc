@@ -22,6 +22,11 @@ VehicleHygrometerFactGroup::VehicleHygrometerFactGroup(QObject *parent)
     _hygroIDFact.setRawValue(std::numeric_limits<unsigned int>::quiet_NaN());
 }
 
+QList<uint32_t> VehicleHygrometerFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_HYGROMETER_SENSOR };
+}
+
 void VehicleHygrometerFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -28,6 +28,11 @@ VehicleLocalPositionFactGroup::VehicleLocalPositionFactGroup(QObject *parent)
     _vzFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleLocalPositionFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_LOCAL_POSITION_NED };
+}
+
 void VehicleLocalPositionFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -24,6 +24,11 @@ VehicleRPMFactGroup::VehicleRPMFactGroup(QObject *parent)
     _rpm4Fact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleRPMFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_RAW_RPM };
+}
+
 void VehicleRPMFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -30,6 +30,11 @@ VehicleSetpointFactGroup::VehicleSetpointFactGroup(QObject *parent)
     _yawRateFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleSetpointFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_ATTITUDE_TARGET };
+}
+
 void VehicleSetpointFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
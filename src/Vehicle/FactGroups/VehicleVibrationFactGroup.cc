@@ -25,6 +25,11 @@ VehicleVibrationFactGroup::VehicleVibrationFactGroup(QObject *parent)
     _zAxisFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleVibrationFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_VIBRATION };
+}
+
 void VehicleVibrationFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
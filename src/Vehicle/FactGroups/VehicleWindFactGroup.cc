@@ -24,6 +24,20 @@ VehicleWindFactGroup::VehicleWindFactGroup(QObject *parent)
     _verticalSpeedFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleWindFactGroup::handledMessageIds() const
+{
+    QList<uint32_t> messageIds = {
+        MAVLINK_MSG_ID_WIND_COV,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2
+    };
+#ifndef QGC_NO_ARDUPILOT_DIALECT
+    messageIds.append(MAVLINK_MSG_ID_WIND);
+#endif
+
+    return messageIds;
+}
+
 void VehicleWindFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
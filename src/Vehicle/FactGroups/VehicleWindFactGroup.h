@@ -27,6 +27,7 @@ class VehicleWindFactGroup : public FactGroup
 
     // Overrides from FactGroup
     void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) final;
+    QList<uint32_t> handledMessageIds() const final;
 
 private:
     void _handleHighLatency(const mavlink_message_t &message);
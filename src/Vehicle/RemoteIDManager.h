@@ -57,7 +57,7 @@ class RemoteIDManager : public QObject
     bool    emergencyDeclared   (void) const { return _emergencyDeclared;}
     bool    operatorIDGood      (void) const { return _operatorIDGood; }
 
-    void mavlinkMessageReceived (mavlink_message_t& message);
+    void mavlinkMessageReceived (const mavlink_message_t& message);
 
     enum LocationTypes {
         TAKEOFF,
@@ -87,7 +87,7 @@ private slots:
     void _checkGCSBasicID();
 
 private:
-    void _handleArmStatus(mavlink_message_t& message);
+    void _handleArmStatus(const mavlink_message_t& message);
 
     // Self ID
     void        _sendSelfIDMsg ();
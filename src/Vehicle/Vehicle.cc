@@ -67,6 +67,7 @@
 #endif
 
 #include <QtCore/QDateTime>
+#include <QtCore/QPointer>
 
 QGC_LOGGING_CATEGORY(VehicleLog, "VehicleLog")
 
@@ -122,7 +123,7 @@ Vehicle::Vehicle(LinkInterface*             link,
 
     qCDebug(VehicleLog) << "Link started with Mavlink " << (MAVLinkProtocol::instance()->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
+    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messagesReceived,       this, &Vehicle::_mavlinkMessagesReceived);
     connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
@@ -344,6 +345,8 @@ void Vehicle::_commonInit()
         }
     }
 
+    _setupMessageDispatch();
+
     _flightDistanceFact.setRawValue(0);
     _flightTimeFact.setRawValue(0);
     _flightTimeUpdater.setInterval(1000);
@@ -368,6 +371,8 @@ Vehicle::~Vehicle()
 {
     qCDebug(VehicleLog) << "~Vehicle" << this;
 
+    _messageDispatcher.logStats();
+
     delete _missionManager;
     _missionManager = nullptr;
 
@@ -375,6 +380,57 @@ Vehicle::~Vehicle()
     _autopilotPlugin = nullptr;
 }
 
+void Vehicle::_setupMessageDispatch()
+{
+    // Subscription order matches the order in which messages were previously handed out
+    _messageDispatcher.subscribe(QStringLiteral("FTPManager"), { MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL }, [this](const mavlink_message_t &message) {
+        _ftpManager->_mavlinkMessageReceived(message);
+    });
+    _messageDispatcher.subscribe(QStringLiteral("ParameterManager"), { MAVLINK_MSG_ID_PARAM_VALUE }, [this](const mavlink_message_t &message) {
+        _parameterManager->mavlinkMessageReceived(message);
+    });
+    _messageDispatcher.subscribe(QStringLiteral("ImageProtocolManager"), { MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE, MAVLINK_MSG_ID_ENCAPSULATED_DATA }, [this](const mavlink_message_t &message) {
+        (void) QMetaObject::invokeMethod(_imageProtocolManager, "mavlinkMessageReceived", Qt::AutoConnection, message);
+    });
+    _messageDispatcher.subscribe(QStringLiteral("RemoteIDManager"), { MAVLINK_MSG_ID_OPEN_DRONE_ID_ARM_STATUS }, [this](const mavlink_message_t &message) {
+        _remoteIDManager->mavlinkMessageReceived(message);
+    });
+    _messageDispatcher.subscribe(QStringLiteral("WaitForMavlinkMessage"), { MAVLinkMessageDispatcher::kAnyMessageId }, [this](const mavlink_message_t &message) {
+        _waitForMavlinkMessageMessageReceivedHandler(message);
+    });
+
+    // Handle creation of dynamic fact group lists
+    _messageDispatcher.subscribe(QStringLiteral("BatteryFactGroupListModel"), { MAVLINK_MSG_ID_HIGH_LATENCY, MAVLINK_MSG_ID_HIGH_LATENCY2, MAVLINK_MSG_ID_BATTERY_STATUS }, [this](const mavlink_message_t &message) {
+        _batteryFactGroupListModel.handleMessageForFactGroupCreation(this, message);
+    });
+    _messageDispatcher.subscribe(QStringLiteral("EscStatusFactGroupListModel"), { MAVLINK_MSG_ID_ESC_INFO, MAVLINK_MSG_ID_ESC_STATUS }, [this](const mavlink_message_t &message) {
+        _escStatusFactGroupListModel.handleMessageForFactGroupCreation(this, message);
+    });
+
+    // Let the fact groups take a whack at the mavlink traffic. FactGroups added later on, such as the dynamic
+    // battery and esc groups, are subscribed as they show up and receive the message which created them.
+    _subscribeFactGroups();
+    (void) connect(this, &FactGroup::factGroupNamesChanged, this, &Vehicle::_subscribeFactGroups);
+}
+
+void Vehicle::_subscribeFactGroups()
+{
+    for (auto it = factGroups().keyValueBegin(); it != factGroups().keyValueEnd(); ++it) {
+        FactGroup *const factGroup = it->second;
+        if (_dispatchedFactGroups.contains(factGroup)) {
+            continue;
+        }
+        (void) _dispatchedFactGroups.insert(factGroup);
+
+        const QPointer<FactGroup> factGroupPtr(factGroup);
+        _messageDispatcher.subscribe(it->first, factGroup->handledMessageIds(), [this, factGroupPtr](const mavlink_message_t &message) {
+            if (factGroupPtr) {
+                factGroupPtr->handleMessage(this, message);
+            }
+        });
+    }
+}
+
 void Vehicle::_deleteCameraManager()
 {
     if(_cameraManager) {
@@ -436,6 +492,26 @@ void Vehicle::resetCounters()
     _heardFrom          = false;
 }
 
+void Vehicle::_mavlinkMessagesReceived(LinkInterface* link, uint8_t sysid, const QList<mavlink_message_t>& messages)
+{
+    if (sysid != _id && sysid != 0) {
+        // Another vehicle's batch. Only RADIO_STATUS coming from a link we are using is of interest.
+        if (!_vehicleLinkManager->containsLink(link)) {
+            return;
+        }
+        for (const mavlink_message_t& message : messages) {
+            if (message.msgid == MAVLINK_MSG_ID_RADIO_STATUS) {
+                _mavlinkMessageReceived(link, message);
+            }
+        }
+        return;
+    }
+
+    for (const mavlink_message_t& message : messages) {
+        _mavlinkMessageReceived(link, message);
+    }
+}
+
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
     // If the link is already running at Mavlink V2 set our max proto version to it.
@@ -494,23 +570,9 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     if (!_terrainProtocolHandler->mavlinkMessageReceived(message)) {
         return;
     }
-    _ftpManager->_mavlinkMessageReceived(message);
-    _parameterManager->mavlinkMessageReceived(message);
-    (void) QMetaObject::invokeMethod(_imageProtocolManager, "mavlinkMessageReceived", Qt::AutoConnection, message);
-    _remoteIDManager->mavlinkMessageReceived(message);
-
-    _waitForMavlinkMessageMessageReceivedHandler(message);
-
-    // Handle creation of dynamic fact group lists
-    _batteryFactGroupListModel.handleMessageForFactGroupCreation(this, message);
-    _escStatusFactGroupListModel.handleMessageForFactGroupCreation(this, message);
-
-    // Let the fact groups take a whack at the mavlink traffic
-    for (FactGroup* factGroup : factGroups()) {
-        factGroup->handleMessage(this, message);
-    }
 
-    this->handleMessage(this, message);
+    // Only the components and FactGroups which handle this message id are called
+    _messageDispatcher.dispatch(message);
 
     switch (message.msgid) {
     case MAVLINK_MSG_ID_HOME_POSITION:
@@ -12,6 +12,7 @@
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QTime>
 #include <QtCore/QTimer>
@@ -20,6 +21,7 @@
 #include <QtQmlIntegration/QtQmlIntegration>
 
 #include "HealthAndArmingCheckReport.h"
+#include "MAVLinkMessageDispatcher.h"
 #include "MAVLinkStreamConfig.h"
 #include "QGCMapCircle.h"
 #include "QGCMAVLink.h"
@@ -918,6 +920,7 @@ public slots:
     void logData                        (uint32_t ofs, uint16_t id, uint8_t count, const uint8_t* data);
 
 private slots:
+    void _mavlinkMessagesReceived           (LinkInterface* link, uint8_t sysid, const QList<mavlink_message_t>& messages);
     void _mavlinkMessageReceived            (LinkInterface* link, mavlink_message_t message);
     void _sendMessageMultipleNext           ();
     void _parametersReady                   (bool parametersReady);
@@ -986,6 +989,8 @@ private slots:
     void _handleMavlinkLoggingDataAcked (mavlink_message_t& message);
     void _ackMavlinkLogData             (uint16_t sequence);
     void _commonInit                    ();
+    void _setupMessageDispatch          ();
+    void _subscribeFactGroups           ();
     void _setupAutoDisarmSignalling     ();
     void _setCapabilities               (uint64_t capabilityBits);
     void _updateArmed                   (bool armed);
@@ -1275,6 +1280,10 @@ private slots:
     BatteryFactGroupListModel       _batteryFactGroupListModel;
     EscStatusFactGroupListModel     _escStatusFactGroupListModel;
 
+    // Routes incoming messages to the components and FactGroups which handle them
+    MAVLinkMessageDispatcher        _messageDispatcher;
+    QSet<FactGroup*>                _dispatchedFactGroups;
+
     TerrainProtocolHandler* _terrainProtocolHandler = nullptr;
 
     MissionManager*                 _missionManager             = nullptr;
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkChartSeriesStoreTest.h"
+#include "MAVLinkChartSeriesStore.h"
+
+#include <QtCore/QtMath>
+#include <QtTest/QTest>
+
+void MAVLinkChartSeriesStoreTest::_testWrap()
+{
+    MAVLinkChartSeriesStore store(10);
+    QVERIFY(store.isEmpty());
+
+    for (int i = 0; i < 25; i++) {
+        store.append(i, i * 2);
+    }
+
+    QCOMPARE(store.count(), 10);
+    for (int i = 0; i < store.count(); i++) {
+        QCOMPARE(store.timestamp(i), static_cast<qreal>(15 + i));
+        QCOMPARE(store.value(i), static_cast<qreal>((15 + i) * 2));
+    }
+
+    store.clear();
+    QVERIFY(store.isEmpty());
+}
+
+void MAVLinkChartSeriesStoreTest::_testValueRange()
+{
+    MAVLinkChartSeriesStore store(4);
+
+    qreal min = 0;
+    qreal max = 0;
+    QVERIFY(!store.valueRange(min, max));
+
+    store.append(0, 100);
+    store.append(1, -5);
+    store.append(2, 3);
+    QVERIFY(store.valueRange(min, max));
+    QCOMPARE(min, static_cast<qreal>(-5));
+    QCOMPARE(max, static_cast<qreal>(100));
+
+    // The 100 sample is overwritten
+    store.append(3, 1);
+    store.append(4, 2);
+    QVERIFY(store.valueRange(min, max));
+    QCOMPARE(min, static_cast<qreal>(-5));
+    QCOMPARE(max, static_cast<qreal>(3));
+}
+
+void MAVLinkChartSeriesStoreTest::_testDecimateRaw()
+{
+    MAVLinkChartSeriesStore store(100);
+    for (int i = 0; i < 100; i++) {
+        store.append(i, i);
+    }
+
+    // Window [40, 60] plus one sample on either side, few enough to pass through unchanged
+    QList<QPointF> points;
+    store.decimate(40, 60, 100, points);
+    QCOMPARE(points.count(), 22);
+    QCOMPARE(points.first(), QPointF(39, 39));
+    QCOMPARE(points.last(), QPointF(60, 60));
+
+    store.decimate(200, 300, 100, points);
+    QCOMPARE(points.count(), 1);
+    QCOMPARE(points.first(), QPointF(99, 99));
+}
+
+void MAVLinkChartSeriesStoreTest::_testDecimateMinMax()
+{
+    MAVLinkChartSeriesStore store(10000);
+    for (int i = 0; i < 10000; i++) {
+        store.append(i, qSin(i * 0.01) + ((i == 5000) ? 50 : 0) - ((i == 7000) ? 50 : 0));
+    }
+
+    constexpr int pixelWidth = 100;
+    QList<QPointF> points;
+    store.decimate(0, 10000, pixelWidth, points);
+    QVERIFY(points.count() <= (2 * (pixelWidth + 1)));
+
+    // Spikes survive decimation and points stay in time order
+    qreal min = 0;
+    qreal max = 0;
+    for (qsizetype i = 0; i < points.count(); i++) {
+        min = qMin(min, points[i].y());
+        max = qMax(max, points[i].y());
+        if (i > 0) {
+            QVERIFY(points[i].x() > points[i - 1].x());
+        }
+    }
+    QVERIFY(max > 49);
+    QVERIFY(min < -49);
+}
+
+void MAVLinkChartSeriesStoreTest::_benchmarkDecimate()
+{
+    // 1 minute at 100Hz, drawn into a typical plot width
+    MAVLinkChartSeriesStore store;
+    for (int i = 0; i < store.capacity(); i++) {
+        store.append(i * 10, qSin(i * 0.01));
+    }
+
+    QList<QPointF> points;
+    QBENCHMARK {
+        store.decimate(0, store.capacity() * 10, 800, points);
+    }
+    QVERIFY(!points.isEmpty());
+}
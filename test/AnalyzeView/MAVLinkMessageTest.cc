@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageTest.h"
+#include "MAVLinkMessage.h"
+#include "MAVLinkMessageField.h"
+#include "QmlObjectListModel.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+
+mavlink_message_t _attitude(uint32_t timeBootMs, float roll)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_attitude_pack(1, MAV_COMP_ID_AUTOPILOT1, &message, timeBootMs, roll, -0.25f, 1.5f, 0.f, 0.125f, -2.f);
+    return message;
+}
+
+} // namespace
+
+QGCMAVLinkMessageField *MAVLinkMessageTest::_field(const QGCMAVLinkMessage &message, const QString &name)
+{
+    for (int i = 0; i < message.fields()->count(); i++) {
+        QGCMAVLinkMessageField *const field = qobject_cast<QGCMAVLinkMessageField*>(message.fields()->get(i));
+        if (field && (field->name() == name)) {
+            return field;
+        }
+    }
+
+    return nullptr;
+}
+
+void MAVLinkMessageTest::_testDecodeOnlyWhenShown()
+{
+    QGCMAVLinkMessage message(_attitude(100, 0.5f));
+
+    // Nothing is decoded for a message which is not being looked at
+    message.update(_attitude(200, 0.75f));
+    message.refresh();
+    QCOMPARE(message.count(), static_cast<quint64>(2));
+    QCOMPARE(message.fields()->count(), 0);
+
+    // Selecting decodes the latest message right away
+    message.setSelected(true);
+    QCOMPARE(message.fields()->count(), static_cast<int>(mavlink_get_message_info_by_id(MAVLINK_MSG_ID_ATTITUDE)->num_fields));
+    QGCMAVLinkMessageField *const timeField = _field(message, QStringLiteral("time_boot_ms"));
+    QGCMAVLinkMessageField *const rollField = _field(message, QStringLiteral("roll"));
+    QVERIFY(timeField);
+    QVERIFY(rollField);
+    QCOMPARE(timeField->value(), QStringLiteral("200"));
+    QCOMPARE(rollField->value(), QString::number(0.75));
+
+    // Messages between two refreshes only keep the raw message, the refresh decodes the last one
+    QSignalSpy timeSpy(timeField, &QGCMAVLinkMessageField::valueChanged);
+    for (uint32_t timeBootMs = 300; timeBootMs <= 1000; timeBootMs += 100) {
+        message.update(_attitude(timeBootMs, 0.75f));
+    }
+    QCOMPARE(timeSpy.count(), 0);
+    QCOMPARE(timeField->value(), QStringLiteral("200"));
+
+    message.refresh();
+    QCOMPARE(timeSpy.count(), 1);
+    QCOMPARE(timeField->value(), QStringLiteral("1000"));
+
+    // No new message, nothing to decode
+    message.refresh();
+    QCOMPARE(timeSpy.count(), 1);
+
+    // Once deselected the fields keep their last values
+    message.setSelected(false);
+    message.update(_attitude(1100, 0.75f));
+    message.refresh();
+    QCOMPARE(timeSpy.count(), 1);
+    QCOMPARE(timeField->value(), QStringLiteral("1000"));
+    QCOMPARE(message.count(), static_cast<quint64>(11));
+}
+
+void MAVLinkMessageTest::_testMatchesEagerDecode()
+{
+    const QList<mavlink_message_t> messages = [] {
+        QList<mavlink_message_t> list;
+
+        mavlink_message_t message{};
+        (void) mavlink_msg_statustext_pack(1, MAV_COMP_ID_AUTOPILOT1, &message, MAV_SEVERITY_INFO, "first", 1, 0);
+        list.append(message);
+        (void) mavlink_msg_statustext_pack(1, MAV_COMP_ID_AUTOPILOT1, &message, MAV_SEVERITY_WARNING, "second", 2, 1);
+        list.append(message);
+        (void) mavlink_msg_statustext_pack(1, MAV_COMP_ID_AUTOPILOT1, &message, MAV_SEVERITY_CRITICAL, "third", 3, 2);
+        list.append(message);
+
+        return list;
+    }();
+
+    // Shown while the messages come in, decoded at each refresh
+    QGCMAVLinkMessage lazy(messages.first());
+    lazy.setSelected(true);
+    for (qsizetype i = 1; i < messages.count(); i++) {
+        lazy.update(messages[i]);
+    }
+    lazy.refresh();
+
+    // Decoded straight from the last message, as every message used to be
+    QGCMAVLinkMessage eager(messages.constLast());
+    eager.setSelected(true);
+
+    QCOMPARE(lazy.fields()->count(), eager.fields()->count());
+    for (int i = 0; i < eager.fields()->count(); i++) {
+        const QGCMAVLinkMessageField *const lazyField = qobject_cast<QGCMAVLinkMessageField*>(lazy.fields()->get(i));
+        const QGCMAVLinkMessageField *const eagerField = qobject_cast<QGCMAVLinkMessageField*>(eager.fields()->get(i));
+        QVERIFY(lazyField);
+        QVERIFY(eagerField);
+        QCOMPARE(lazyField->name(), eagerField->name());
+        QCOMPARE(lazyField->value(), eagerField->value());
+    }
+
+    QCOMPARE(_field(lazy, QStringLiteral("text"))->value(), QStringLiteral("third"));
+    QCOMPARE(_field(lazy, QStringLiteral("severity"))->value(), QString::number(MAV_SEVERITY_CRITICAL));
+    QCOMPARE(_field(lazy, QStringLiteral("id"))->value(), QStringLiteral("3"));
+}
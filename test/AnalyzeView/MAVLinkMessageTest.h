@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCMAVLinkMessage;
+class QGCMAVLinkMessageField;
+
+class MAVLinkMessageTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testDecodeOnlyWhenShown();
+    void _testMatchesEagerDecode();
+
+private:
+    static QGCMAVLinkMessageField *_field(const QGCMAVLinkMessage &message, const QString &name);
+};
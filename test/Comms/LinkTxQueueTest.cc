@@ -0,0 +1,365 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkTxQueueTest.h"
+#include "LinkInterface.h"
+#include "LinkTxQueue.h"
+#include "MockConfiguration.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <atomic>
+
+namespace {
+    constexpr int kTimeoutMSecs = 10000;
+    constexpr int kCapacity = static_cast<int>(LinkTxQueue::kDefaultCapacity);
+
+    /// Records what the queue hands to the link, drained on txWorker's thread if set
+    class TestLink : public LinkInterface
+    {
+    public:
+        explicit TestLink(SharedLinkConfigurationPtr &config)
+            : LinkInterface(config)
+        {}
+
+        void disconnect() override {}
+        bool isConnected() const override { return true; }
+
+        void setTxFlushLatency(int msecs) { _setTxFlushLatency(msecs); }
+
+        QByteArray written() const
+        {
+            QMutexLocker lock(&_mutex);
+            return _written;
+        }
+
+        QSet<QThread*> writeThreads() const
+        {
+            QMutexLocker lock(&_mutex);
+            return _writeThreads;
+        }
+
+        bool waitForWritten(qsizetype size) const
+        {
+            const QDeadlineTimer deadline(kTimeoutMSecs);
+            while ((written().size() < size) && !deadline.hasExpired()) {
+                QThread::msleep(1);
+            }
+            return (written().size() == size);
+        }
+
+        QObject *txWorker = nullptr;
+        QSemaphore *firstWriteGate = nullptr;   ///< The first link write waits for it
+
+    private:
+        bool _connect() override { return true; }
+        QObject *_txContext() override { return (txWorker ? txWorker : this); }
+
+        void _writeBytes(const QByteArray &bytes) override
+        {
+            if (firstWriteGate && !_gateWaited.exchange(true)) {
+                firstWriteGate->acquire();
+            }
+            QMutexLocker lock(&_mutex);
+            _written += bytes;
+            _writeThreads.insert(QThread::currentThread());
+        }
+
+        mutable QMutex _mutex;
+        QByteArray _written;
+        QSet<QThread*> _writeThreads;
+        std::atomic_bool _gateWaited = false;
+    };
+
+    QByteArray _numberedWrite(int index)
+    {
+        QByteArray write(20, static_cast<char>(index));
+        write[0] = static_cast<char>(index >> 8);
+        return write;
+    }
+}
+
+void LinkTxQueueTest::_testCoalesce()
+{
+    LinkTxQueue queue(16);
+
+    QByteArray expected;
+    for (int i = 0; i < 10; i++) {
+        const QByteArray write(i + 1, static_cast<char>('a' + i));
+        QVERIFY(queue.push(write.constData(), write.size()));
+        expected += write;
+    }
+
+    QByteArray buffer;
+    QCOMPARE(queue.drain(buffer, 1024), 10);
+    QCOMPARE(buffer, expected);
+
+    QByteArray empty;
+    QCOMPARE(queue.drain(empty, 1024), 0);
+    QVERIFY(empty.isEmpty());
+
+    const LinkTxQueue::Stats stats = queue.stats();
+    QCOMPARE(stats.writesQueued, static_cast<uint64_t>(10));
+    QCOMPARE(stats.linkWrites, static_cast<uint64_t>(1));
+    QCOMPARE(stats.depth, static_cast<uint32_t>(0));
+    QCOMPARE(stats.maxDepth, static_cast<uint32_t>(10));
+}
+
+void LinkTxQueueTest::_testMaxWriteSize()
+{
+    LinkTxQueue queue(16);
+
+    const QByteArray write(100, 'x');
+    for (int i = 0; i < 5; i++) {
+        QVERIFY(queue.push(write.constData(), write.size()));
+    }
+
+    // Writes are never split, so 250 bytes only takes two of them
+    QByteArray buffer;
+    QCOMPARE(queue.drain(buffer, 250), 2);
+    QCOMPARE(buffer.size(), 200);
+
+    buffer.clear();
+    QCOMPARE(queue.drain(buffer, 250), 2);
+    buffer.clear();
+    QCOMPARE(queue.drain(buffer, 250), 1);
+    QCOMPARE(buffer.size(), 100);
+}
+
+void LinkTxQueueTest::_testLargeWrite()
+{
+    LinkTxQueue queue(16);
+
+    QByteArray large(LinkTxQueue::kSlotDataSize * 3 + 7, Qt::Uninitialized);
+    for (qsizetype i = 0; i < large.size(); i++) {
+        large[i] = static_cast<char>(i);
+    }
+    const QByteArray small(10, 's');
+
+    QVERIFY(queue.push(small.constData(), small.size()));
+    QVERIFY(queue.push(large.constData(), large.size()));
+    QVERIFY(queue.push(small.constData(), small.size()));
+
+    // Larger than the max write size, still drained once it's at the front
+    QByteArray buffer;
+    QCOMPARE(queue.drain(buffer, 100), 1);
+    QCOMPARE(buffer, small);
+    buffer.clear();
+    QCOMPARE(queue.drain(buffer, 100), 1);
+    QCOMPARE(buffer, large);
+    buffer.clear();
+    QCOMPARE(queue.drain(buffer, 100), 1);
+    QCOMPARE(buffer, small);
+}
+
+void LinkTxQueueTest::_testFull()
+{
+    LinkTxQueue queue(4);
+
+    const QByteArray write(10, 'x');
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(queue.push(write.constData(), write.size()));
+    }
+    QVERIFY(!queue.push(write.constData(), write.size()));
+    QCOMPARE(queue.stats().writesDropped, static_cast<uint64_t>(1));
+
+    // Space is reused once drained
+    QByteArray buffer;
+    QCOMPARE(queue.drain(buffer, 1024), 4);
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(queue.push(write.constData(), write.size()));
+    }
+}
+
+void LinkTxQueueTest::_testConcurrentProducers()
+{
+    constexpr int producerCount = 4;
+    constexpr int writesPerProducer = 20000;
+    LinkTxQueue queue(256);
+
+    // Each write is a producer id followed by a per producer sequence number
+    QList<QThread*> producers;
+    for (int producer = 0; producer < producerCount; producer++) {
+        producers.append(QThread::create([&queue, producer]() {
+            for (int seq = 0; seq < writesPerProducer; seq++) {
+                const int write[2] = { producer, seq };
+                while (!queue.push(reinterpret_cast<const char*>(write), sizeof(write))) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }));
+        producers.last()->start();
+    }
+
+    int nextSeq[producerCount]{};
+    int received = 0;
+    while (received < (producerCount * writesPerProducer)) {
+        QByteArray buffer;
+        const int writes = queue.drain(buffer, 4096);
+        QCOMPARE(buffer.size(), static_cast<qsizetype>(writes * 2 * sizeof(int)));
+
+        const int *const values = reinterpret_cast<const int*>(buffer.constData());
+        for (int i = 0; i < writes; i++) {
+            const int producer = values[i * 2];
+            QCOMPARE(values[(i * 2) + 1], nextSeq[producer]);
+            nextSeq[producer]++;
+        }
+        received += writes;
+    }
+
+    for (QThread *producer : producers) {
+        QVERIFY(producer->wait());
+        delete producer;
+    }
+
+    QCOMPARE(queue.stats().writesQueued, static_cast<uint64_t>(producerCount * writesPerProducer));
+}
+
+void LinkTxQueueTest::_testLinkTxThread()
+{
+    QThread txThread;
+    QObject txWorker;
+    txWorker.moveToThread(&txThread);
+    txThread.start();
+
+    {
+        SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkTxQueueTest"));
+        TestLink link(config);
+        link.txWorker = &txWorker;
+
+        QByteArray expected;
+        for (int i = 0; i < 10; i++) {
+            const QByteArray write = _numberedWrite(i);
+            link.writeBytesThreadSafe(write.constData(), write.size());
+            expected += write;
+        }
+
+        // Drained on the thread owning the transport, without a hop through this one
+        QVERIFY(link.waitForWritten(expected.size()));
+        QCOMPARE(link.written(), expected);
+        QCOMPARE(link.writeThreads(), QSet<QThread*>{ &txThread });
+
+        txThread.quit();
+        QVERIFY(txThread.wait());
+    }
+
+}
+
+void LinkTxQueueTest::_testLinkOverflowOnTxThread()
+{
+    SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkTxQueueTest"));
+    TestLink link(config);
+    // Nothing is flushed by the event loop during the test
+    link.setTxFlushLatency(60 * 1000);
+
+    QByteArray expected;
+    for (int i = 0; i < (kCapacity * 4); i++) {
+        const QByteArray write = _numberedWrite(i);
+        link.writeBytesThreadSafe(write.constData(), write.size());
+        expected += write;
+    }
+
+    // Each time the queue was full it was written out synchronously instead of dropping the write
+    const LinkTxQueue::Stats stats = link.txQueueStats();
+    QCOMPARE(stats.writesDropped, static_cast<uint64_t>(0));
+    QCOMPARE(stats.writesQueued, static_cast<uint64_t>(kCapacity * 4));
+    QCOMPARE(stats.depth, static_cast<uint32_t>(kCapacity));
+    QCOMPARE(link.written(), expected.left(expected.size() / 4 * 3));
+}
+
+void LinkTxQueueTest::_testLinkBackpressure()
+{
+    QThread txThread;
+    QObject txWorker;
+    txWorker.moveToThread(&txThread);
+    txThread.start();
+
+    {
+        SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkTxQueueTest"));
+        TestLink link(config);
+        QSemaphore gate;
+        link.txWorker = &txWorker;
+        link.firstWriteGate = &gate;
+
+        QThread *const producer = QThread::create([&link]() {
+            for (int i = 0; i < (kCapacity * 4); i++) {
+                const QByteArray write = _numberedWrite(i);
+                link.writeBytesThreadSafe(write.constData(), write.size());
+            }
+        });
+        producer->start();
+
+        // The link is stuck in its first write until the producer has filled the queue
+        const QDeadlineTimer deadline(kTimeoutMSecs);
+        while ((link.txQueueStats().depth < static_cast<uint32_t>(kCapacity)) && !deadline.hasExpired()) {
+            QThread::yieldCurrentThread();
+        }
+        QCOMPARE(link.txQueueStats().depth, static_cast<uint32_t>(kCapacity));
+        gate.release();
+
+        QVERIFY(producer->wait(kTimeoutMSecs));
+        delete producer;
+
+        QByteArray expected;
+        for (int i = 0; i < (kCapacity * 4); i++) {
+            expected += _numberedWrite(i);
+        }
+        QVERIFY(link.waitForWritten(expected.size()));
+        QCOMPARE(link.written(), expected);
+        QCOMPARE(link.txQueueStats().writesDropped, static_cast<uint64_t>(0));
+
+        txThread.quit();
+        QVERIFY(txThread.wait());
+    }
+
+}
+
+void LinkTxQueueTest::_testLinkGuiThreadNoWait()
+{
+    QThread txThread;
+    QObject txWorker;
+    txWorker.moveToThread(&txThread);
+    txThread.start();
+
+    {
+        SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkTxQueueTest"));
+        TestLink link(config);
+        QSemaphore gate;
+        link.txWorker = &txWorker;
+        link.firstWriteGate = &gate;
+
+        // The link is stuck in its first write, the GUI thread must drop rather than wait for room
+        const int writeCount = kCapacity * 4;
+        QElapsedTimer writeTimer;
+        writeTimer.start();
+        for (int i = 0; i < writeCount; i++) {
+            const QByteArray write = _numberedWrite(i);
+            link.writeBytesThreadSafe(write.constData(), write.size());
+        }
+        const qint64 writeMSecs = writeTimer.elapsed();
+
+        const LinkTxQueue::Stats stats = link.txQueueStats();
+        QVERIFY(stats.writesDropped > 0);
+        QCOMPARE(stats.writesQueued + stats.writesDropped, static_cast<uint64_t>(writeCount));
+        // Waiting on a full queue would have taken at least a second
+        QVERIFY2(writeMSecs < 1000, qPrintable(QString::number(writeMSecs)));
+
+        gate.release();
+        QVERIFY(link.waitForWritten(static_cast<qsizetype>(stats.writesQueued) * _numberedWrite(0).size()));
+
+        txThread.quit();
+        QVERIFY(txThread.wait());
+    }
+}
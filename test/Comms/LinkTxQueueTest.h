@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class LinkTxQueueTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testCoalesce();
+    void _testMaxWriteSize();
+    void _testLargeWrite();
+    void _testFull();
+    void _testConcurrentProducers();
+    void _testLinkTxThread();
+    void _testLinkOverflowOnTxThread();
+    void _testLinkBackpressure();
+    void _testLinkGuiThreadNoWait();
+};
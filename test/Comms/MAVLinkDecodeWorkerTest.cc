@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkDecodeWorkerTest.h"
+#include "LinkManager.h"
+#include "MAVLinkSigning.h"
+
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+void MAVLinkDecodeWorkerTest::init()
+{
+    UnitTest::init();
+
+    // Other tests may have left signing enabled on the channel
+    (void) MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(_parseChannel), QByteArrayView(), nullptr);
+    mavlink_reset_channel_status(_parseChannel);
+    mavlink_reset_channel_status(_packChannel);
+
+    _decodedCount = 0;
+    _decodeThread = new QThread(this);
+    _worker = new MAVLinkDecodeWorker();
+    _worker->setBatchInterval(0);
+    (void) _worker->moveToThread(_decodeThread);
+    (void) connect(_decodeThread, &QThread::finished, _worker, &QObject::deleteLater);
+    (void) connect(_worker, &MAVLinkDecodeWorker::framesDecoded, this, [this](const QList<MAVLinkDecodeWorker::DecodedBatch> &batches) {
+        for (const MAVLinkDecodeWorker::DecodedBatch &batch : batches) {
+            _decodedCount += batch.messages.count();
+        }
+    }, Qt::QueuedConnection);
+    _decodeThread->start();
+}
+
+void MAVLinkDecodeWorkerTest::cleanup()
+{
+    _decodeThread->quit();
+    QVERIFY(_decodeThread->wait(1000));
+    delete _decodeThread;
+    _decodeThread = nullptr;
+    _worker = nullptr;
+
+    UnitTest::cleanup();
+}
+
+QByteArray MAVLinkDecodeWorkerTest::_buildChunk(int count)
+{
+    QByteArray chunk;
+    for (int i = 0; i < count; i++) {
+        mavlink_message_t message;
+        (void) mavlink_msg_attitude_pack_chan(200, MAV_COMP_ID_ONBOARD_COMPUTER, _packChannel, &message, i, 0.1f, 0.2f, 0.3f, 0.f, 0.f, 0.f);
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+        (void) chunk.append(reinterpret_cast<const char*>(buffer), len);
+    }
+
+    return chunk;
+}
+
+void MAVLinkDecodeWorkerTest::_receiveBytes(const QByteArray &chunk, const MAVLinkDecodeWorker::ForwardTargets &forwardTargets, const MAVLinkDecodeWorker::SigningSnapshot &signing)
+{
+    (void) QMetaObject::invokeMethod(_worker, [worker = _worker, chunk, forwardTargets, signing]() {
+        worker->receiveBytes(WeakLinkInterfacePtr(), _parseChannel, chunk, forwardTargets, signing);
+    }, Qt::QueuedConnection);
+}
+
+void MAVLinkDecodeWorkerTest::_testForwardingLinkRemoved()
+{
+    constexpr int chunkCount = 200;
+    constexpr int framesPerChunk = 100;
+
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    MAVLinkDecodeWorker::ForwardTargets forwardTargets;
+    forwardTargets.forwardingLink = LinkManager::instance()->sharedLinkInterfacePointerForLink(_mockLink);
+    QVERIFY(!forwardTargets.forwardingLink.expired());
+
+    QThread *destroyedOnThread = nullptr;
+    (void) connect(_mockLink, &QObject::destroyed, this, [&destroyedOnThread]() {
+        destroyedOnThread = QThread::currentThread();
+    }, Qt::DirectConnection);
+
+    const QByteArray chunk = _buildChunk(framesPerChunk);
+    for (int i = 0; i < chunkCount; i++) {
+        _receiveBytes(chunk, forwardTargets, MAVLinkDecodeWorker::SigningSnapshot());
+    }
+
+    // Remove the link while the worker is still forwarding to it
+    _disconnectMockLink();
+
+    QTRY_VERIFY_WITH_TIMEOUT(forwardTargets.forwardingLink.expired(), 10000);
+    QCOMPARE(destroyedOnThread, QThread::currentThread());
+
+    // Decoding carries on without the link
+    QTRY_COMPARE_WITH_TIMEOUT(_decodedCount, chunkCount * framesPerChunk, 10000);
+}
+
+void MAVLinkDecodeWorkerTest::_testSigningSnapshot()
+{
+    const QByteArray chunk = _buildChunk(10);
+
+    // Signing set up after the snapshot was taken must not affect the chunk the snapshot came with
+    const MAVLinkDecodeWorker::SigningSnapshot unsignedSnapshot = MAVLinkDecodeWorker::signingSnapshot(_parseChannel);
+    QVERIFY(!unsignedSnapshot.enabled);
+    QVERIFY(MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(_parseChannel), "secret_key", MAVLinkSigning::insecureConnectionAccceptUnsignedCallback));
+    _receiveBytes(chunk, MAVLinkDecodeWorker::ForwardTargets(), unsignedSnapshot);
+    QTRY_COMPARE(_decodedCount, 10);
+
+    // Unsigned frames are rejected once a snapshot with signing arrives
+    const MAVLinkDecodeWorker::SigningSnapshot signedSnapshot = MAVLinkDecodeWorker::signingSnapshot(_parseChannel);
+    QVERIFY(signedSnapshot.enabled);
+    QVERIFY(MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(_parseChannel), QByteArrayView(), nullptr));
+    _receiveBytes(chunk, MAVLinkDecodeWorker::ForwardTargets(), signedSnapshot);
+    (void) QMetaObject::invokeMethod(_worker, [worker = _worker]() { worker->flush(); }, Qt::BlockingQueuedConnection);
+    QCoreApplication::processEvents();
+    QCOMPARE(_decodedCount, 10);
+}
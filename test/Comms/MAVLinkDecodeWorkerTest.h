@@ -0,0 +1,40 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MAVLinkDecodeWorker.h"
+#include "UnitTest.h"
+
+class QThread;
+
+class MAVLinkDecodeWorkerTest : public UnitTest
+{
+    Q_OBJECT
+
+protected:
+    void init() final;
+    void cleanup() final;
+
+private slots:
+    void _testForwardingLinkRemoved();
+    void _testSigningSnapshot();
+
+private:
+    static QByteArray _buildChunk(int count);
+    void _receiveBytes(const QByteArray &chunk, const MAVLinkDecodeWorker::ForwardTargets &forwardTargets, const MAVLinkDecodeWorker::SigningSnapshot &signing);
+
+    QThread *_decodeThread = nullptr;
+    MAVLinkDecodeWorker *_worker = nullptr;
+    int _decodedCount = 0;
+
+    static constexpr uint8_t _parseChannel = MAVLINK_COMM_13;
+    static constexpr uint8_t _packChannel = MAVLINK_COMM_15;
+    static constexpr uint8_t _signingChannel = MAVLINK_COMM_12;
+};
@@ -0,0 +1,118 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriterTest.h"
+#include "MAVLinkLogWriter.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QSemaphore>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+void MAVLinkLogWriterTest::init()
+{
+    UnitTest::init();
+
+    _writer = new MAVLinkLogWriter();
+    _writerThread = new QThread(this);
+    (void) _writer->moveToThread(_writerThread);
+    (void) connect(_writerThread, &QThread::finished, _writer, &QObject::deleteLater);
+    _writerThread->start();
+}
+
+void MAVLinkLogWriterTest::cleanup()
+{
+    _writer->close();
+    _writerThread->quit();
+    (void) _writerThread->wait(1000);
+    delete _writerThread;
+    _writerThread = nullptr;
+    _writer = nullptr;
+
+    UnitTest::cleanup();
+}
+
+mavlink_message_t MAVLinkLogWriterTest::_heartbeat(uint8_t seq)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_15, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    message.seq = seq;
+    return message;
+}
+
+void MAVLinkLogWriterTest::_testWriteRecords()
+{
+    const QTemporaryDir tmpDir;
+    const QString fileName = tmpDir.filePath(QStringLiteral("test.tlog"));
+    QVERIFY(_writer->open(fileName));
+
+    constexpr int messageCount = 5000;
+    qsizetype expectedSize = 0;
+    for (int i = 0; i < messageCount; i++) {
+        const mavlink_message_t message = _heartbeat(static_cast<uint8_t>(i));
+        _writer->appendMessage(message);
+        expectedSize += sizeof(quint64) + MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len;
+    }
+
+    const QByteArray sent(100, 'x');
+    _writer->appendBytes(sent);
+    expectedSize += sizeof(quint64) + sent.size();
+
+    // Larger than a page, written as a record of its own
+    const QByteArray large(MAVLinkLogWriter::kPageSize + 1, 'y');
+    _writer->appendBytes(large);
+    expectedSize += sizeof(quint64) + large.size();
+
+    _writer->close();
+
+    const MAVLinkLogWriter::Stats stats = _writer->stats();
+    QCOMPARE(stats.recordsLogged, static_cast<uint64_t>(messageCount + 2));
+    QCOMPARE(stats.recordsDropped, static_cast<uint64_t>(0));
+    QCOMPARE(stats.bytesWritten, static_cast<uint64_t>(expectedSize));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+    QCOMPARE(contents.size(), expectedSize);
+
+    // First record: big endian timestamp followed by the frame
+    const quint64 timestamp = qFromBigEndian<quint64>(contents.constData());
+    QVERIFY(timestamp > 0);
+    QCOMPARE(static_cast<uint8_t>(contents.at(sizeof(quint64))), static_cast<uint8_t>(MAVLINK_STX));
+    QVERIFY(contents.endsWith(large));
+}
+
+void MAVLinkLogWriterTest::_testDropWhenStorageStalls()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(_writer->open(tmpDir.filePath(QStringLiteral("stall.tlog"))));
+
+    // Stall the writer thread so no page is returned to the pool
+    QSemaphore release;
+    (void) QMetaObject::invokeMethod(_writer, [&release]() { release.acquire(); }, Qt::QueuedConnection);
+
+    const mavlink_message_t message = _heartbeat(0);
+    const qsizetype recordSize = sizeof(quint64) + MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len;
+    const int appendCount = static_cast<int>(((MAVLinkLogWriter::kPageSize / recordSize) + 1) * (MAVLinkLogWriter::kPageCount + 2));
+    for (int i = 0; i < appendCount; i++) {
+        _writer->appendMessage(message);
+    }
+
+    MAVLinkLogWriter::Stats stats = _writer->stats();
+    QVERIFY(stats.recordsDropped > 0);
+    QCOMPARE(stats.recordsLogged + stats.recordsDropped, static_cast<uint64_t>(appendCount));
+
+    release.release();
+    _writer->close();
+
+    stats = _writer->stats();
+    QCOMPARE(stats.bytesWritten, stats.recordsLogged * static_cast<uint64_t>(recordSize));
+}
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MAVLinkLogWriter;
+class QThread;
+
+class MAVLinkLogWriterTest : public UnitTest
+{
+    Q_OBJECT
+
+protected:
+    void init() final;
+    void cleanup() final;
+
+private slots:
+    void _testWriteRecords();
+    void _testDropWhenStorageStalls();
+
+private:
+    static mavlink_message_t _heartbeat(uint8_t seq);
+
+    MAVLinkLogWriter *_writer = nullptr;
+    QThread *_writerThread = nullptr;
+};
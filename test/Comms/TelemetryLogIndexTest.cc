@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogIndexTest.h"
+#include "TelemetryLogIndex.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+QByteArray TelemetryLogIndexTest::_createLog(int recordCount)
+{
+    QByteArray log;
+    for (int i = 0; i < recordCount; i++) {
+        mavlink_message_t message{};
+        if (i % 2) {
+            (void) mavlink_msg_system_time_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_15, &message, 0, static_cast<uint32_t>(i));
+        } else {
+            (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_15, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+        }
+
+        uint8_t record[sizeof(quint64) + MAVLINK_MAX_PACKET_LEN];
+        qToBigEndian(kStartTimeUSecs + (i * kRecordIntervalUSecs), record);
+        const uint16_t length = mavlink_msg_to_send_buffer(record + sizeof(quint64), &message);
+        (void) log.append(reinterpret_cast<const char*>(record), sizeof(quint64) + length);
+
+        if (i == (recordCount / 2)) {
+            // Garbage between records must be skipped
+            (void) log.append("garbage");
+        }
+    }
+
+    return log;
+}
+
+void TelemetryLogIndexTest::_testBuild()
+{
+    constexpr int recordCount = 1000;
+    const QByteArray log = _createLog(recordCount);
+    const uchar *const data = reinterpret_cast<const uchar*>(log.constData());
+
+    TelemetryLogIndex index;
+    index.build(data, log.size());
+
+    QCOMPARE(index.recordCount(), static_cast<quint64>(recordCount));
+    QCOMPARE(index.startTimeUSecs(), kStartTimeUSecs);
+    QCOMPARE(index.durationUSecs(), static_cast<quint64>((recordCount - 1) * kRecordIntervalUSecs));
+    QCOMPARE(index.messageCounts().value(MAVLINK_MSG_ID_HEARTBEAT), static_cast<quint64>(recordCount / 2));
+    QCOMPARE(index.messageCounts().value(MAVLINK_MSG_ID_SYSTEM_TIME), static_cast<quint64>(recordCount / 2));
+
+    TelemetryLogIndex::Record last;
+    QVERIFY(TelemetryLogIndex::readRecord(data, log.size(), index.lastRecordOffset(), last));
+    QCOMPARE(last.timestampUSecs, index.endTimeUSecs());
+    QCOMPARE(last.nextOffset(), static_cast<qint64>(log.size()));
+}
+
+void TelemetryLogIndexTest::_testSeek()
+{
+    constexpr int recordCount = 1000;
+    const QByteArray log = _createLog(recordCount);
+    const uchar *const data = reinterpret_cast<const uchar*>(log.constData());
+
+    TelemetryLogIndex index;
+    index.build(data, log.size());
+
+    for (const quint64 targetUSecs : { kStartTimeUSecs, kStartTimeUSecs + 2345678, index.endTimeUSecs() }) {
+        TelemetryLogIndex::Record record;
+        QVERIFY(TelemetryLogIndex::readRecord(data, log.size(), index.offsetForTime(targetUSecs), record));
+        QVERIFY(record.timestampUSecs <= targetUSecs);
+        QVERIFY((targetUSecs - record.timestampUSecs) < (TelemetryLogIndex::kEntryIntervalUSecs + kRecordIntervalUSecs));
+    }
+}
+
+void TelemetryLogIndexTest::_testSaveLoad()
+{
+    const QByteArray log = _createLog(500);
+    const uchar *const data = reinterpret_cast<const uchar*>(log.constData());
+
+    TelemetryLogIndex index;
+    index.build(data, log.size());
+
+    const QTemporaryDir tmpDir;
+    const QString fileName = TelemetryLogIndex::indexFileName(tmpDir.filePath(QStringLiteral("test.tlog")));
+    QVERIFY(index.save(fileName));
+
+    TelemetryLogIndex loaded;
+    QVERIFY(loaded.load(fileName, data, log.size()));
+    QCOMPARE(loaded.recordCount(), index.recordCount());
+    QCOMPARE(loaded.startTimeUSecs(), index.startTimeUSecs());
+    QCOMPARE(loaded.endTimeUSecs(), index.endTimeUSecs());
+    QCOMPARE(loaded.messageCounts(), index.messageCounts());
+    QCOMPARE(loaded.offsetForTime(kStartTimeUSecs + 1234567), index.offsetForTime(kStartTimeUSecs + 1234567));
+
+    // An index for a different log is rejected
+    const QByteArray other = _createLog(400);
+    QVERIFY(!loaded.load(fileName, reinterpret_cast<const uchar*>(other.constData()), other.size()));
+    QVERIFY(loaded.isEmpty());
+}
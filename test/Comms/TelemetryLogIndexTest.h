@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TelemetryLogIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testBuild();
+    void _testSeek();
+    void _testSaveLoad();
+
+private:
+    /// Log of heartbeats and system times, one record every kRecordIntervalUSecs
+    static QByteArray _createLog(int recordCount);
+
+    static constexpr quint64 kStartTimeUSecs = 1700000000ULL * 1000 * 1000;
+    static constexpr quint64 kRecordIntervalUSecs = 10 * 1000;
+};
@@ -0,0 +1,242 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPBatchIOTest.h"
+#include "UDPBatchIO.h"
+#include "UDPLink.h"
+
+#include <QtNetwork/QNetworkDatagram>
+#include <QtNetwork/QUdpSocket>
+#include <QtTest/QTest>
+
+namespace {
+    // Kept small enough that a burst never overflows the receive buffer
+    constexpr int kBurstSize = 64;
+    constexpr int kTargetCount = 30;
+
+    QByteArray _datagram(int index)
+    {
+        return QByteArray(32 + (index % 200), static_cast<char>(index));
+    }
+
+    void _sendBurst(QUdpSocket &sender, quint16 port)
+    {
+        for (int i = 0; i < kBurstSize; i++) {
+            (void) sender.writeDatagram(_datagram(i), QHostAddress::LocalHost, port);
+        }
+    }
+}
+
+void UDPBatchIOTest::_testReceiveBatch()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched datagram I/O not supported on this platform");
+    }
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    UDPBatchIO batchIO(16);
+    QCOMPARE(batchIO.receive(receiver.socketDescriptor()), 0);
+
+    constexpr int count = 40;
+    for (int i = 0; i < count; i++) {
+        QCOMPARE(sender.writeDatagram(_datagram(i), QHostAddress::LocalHost, receiver.localPort()), _datagram(i).size());
+    }
+
+    int received = 0;
+    while (received < count) {
+        const int batch = batchIO.receive(receiver.socketDescriptor());
+        QVERIFY(batch > 0);
+        QVERIFY(batch <= batchIO.batchSize());
+        for (int i = 0; i < batch; i++) {
+            const UDPBatchIO::Datagram &datagram = batchIO.datagram(i);
+            QCOMPARE(QByteArray(datagram.data, datagram.size), _datagram(received + i));
+            QCOMPARE(datagram.senderAddress, QHostAddress(QHostAddress::LocalHost));
+            QCOMPARE(datagram.senderPort, sender.localPort());
+        }
+        received += batch;
+    }
+
+    QCOMPARE(batchIO.receive(receiver.socketDescriptor()), 0);
+    QCOMPARE(batchIO.stats().datagramsReceived, static_cast<uint64_t>(count));
+    QCOMPARE(batchIO.stats().datagramsTruncated, static_cast<uint64_t>(0));
+}
+
+void UDPBatchIOTest::_testSendBatch()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched datagram I/O not supported on this platform");
+    }
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    // More targets than the batch size so the send is split
+    QList<std::shared_ptr<QUdpSocket>> receivers;
+    QList<std::shared_ptr<UDPClient>> targets;
+    for (int i = 0; i < 5; i++) {
+        const std::shared_ptr<QUdpSocket> receiver = std::make_shared<QUdpSocket>();
+        QVERIFY(receiver->bind(QHostAddress::LocalHost, 0));
+        receivers.append(receiver);
+        targets.append(std::make_shared<UDPClient>(QHostAddress(QHostAddress::LocalHost), receiver->localPort()));
+    }
+
+    UDPBatchIO batchIO(2);
+    const QByteArray data = _datagram(7);
+    QCOMPARE(batchIO.send(sender, data, targets), static_cast<int>(targets.size()));
+
+    for (const std::shared_ptr<QUdpSocket> &receiver : receivers) {
+        QVERIFY(receiver->waitForReadyRead(1000) || receiver->hasPendingDatagrams());
+        const QNetworkDatagram datagram = receiver->receiveDatagram();
+        QCOMPARE(datagram.data(), data);
+        QCOMPARE(datagram.senderPort(), static_cast<int>(sender.localPort()));
+    }
+
+    QCOMPARE(batchIO.stats().sendCalls, static_cast<uint64_t>(3));
+    QCOMPARE(batchIO.stats().datagramsSent, static_cast<uint64_t>(targets.size()));
+    QCOMPARE(batchIO.stats().sendErrors, static_cast<uint64_t>(0));
+}
+
+void UDPBatchIOTest::_testSendIPv6Target()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched datagram I/O not supported on this platform");
+    }
+
+    QUdpSocket receiver6;
+    if (!receiver6.bind(QHostAddress::LocalHostIPv6, 0)) {
+        QSKIP("IPv6 loopback not available");
+    }
+    QUdpSocket receiver4;
+    QVERIFY(receiver4.bind(QHostAddress::LocalHost, 0));
+    // Dual stack so it can reach both
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::Any, 0));
+
+    const QList<std::shared_ptr<UDPClient>> targets = {
+        std::make_shared<UDPClient>(QHostAddress(QHostAddress::LocalHostIPv6), receiver6.localPort()),
+        std::make_shared<UDPClient>(QHostAddress(QHostAddress::LocalHost), receiver4.localPort()),
+    };
+
+    UDPBatchIO batchIO;
+    const QByteArray data = _datagram(9);
+    QCOMPARE(batchIO.send(sender, data, targets), static_cast<int>(targets.size()));
+
+    for (QUdpSocket *const receiver : { &receiver6, &receiver4 }) {
+        QVERIFY(receiver->waitForReadyRead(1000) || receiver->hasPendingDatagrams());
+        const QNetworkDatagram datagram = receiver->receiveDatagram();
+        QCOMPARE(datagram.data(), data);
+        QCOMPARE(datagram.senderPort(), static_cast<int>(sender.localPort()));
+    }
+
+    // One write for the IPv6 target, one batch for the IPv4 one
+    QCOMPARE(batchIO.stats().sendCalls, static_cast<uint64_t>(2));
+    QCOMPARE(batchIO.stats().datagramsSent, static_cast<uint64_t>(targets.size()));
+    QCOMPARE(batchIO.stats().sendErrors, static_cast<uint64_t>(0));
+}
+
+void UDPBatchIOTest::_benchmarkReceiveDatagram()
+{
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    int received = 0;
+    QBENCHMARK {
+        _sendBurst(sender, receiver.localPort());
+        received = 0;
+        while (receiver.hasPendingDatagrams()) {
+            if (!receiver.receiveDatagram().isNull()) {
+                received++;
+            }
+        }
+    }
+    QCOMPARE(received, kBurstSize);
+}
+
+void UDPBatchIOTest::_benchmarkReceiveBatch()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched datagram I/O not supported on this platform");
+    }
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    UDPBatchIO batchIO;
+    int received = 0;
+    QBENCHMARK {
+        _sendBurst(sender, receiver.localPort());
+        received = 0;
+        int count = 0;
+        while ((count = batchIO.receive(receiver.socketDescriptor())) > 0) {
+            received += count;
+        }
+    }
+    QCOMPARE(received, kBurstSize);
+}
+
+void UDPBatchIOTest::_benchmarkWriteDatagram()
+{
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    // Receivers are never read, datagrams beyond their receive buffer are dropped by the kernel
+    QList<std::shared_ptr<QUdpSocket>> receivers;
+    for (int i = 0; i < kTargetCount; i++) {
+        const std::shared_ptr<QUdpSocket> receiver = std::make_shared<QUdpSocket>();
+        QVERIFY(receiver->bind(QHostAddress::LocalHost, 0));
+        receivers.append(receiver);
+    }
+
+    const QByteArray data = _datagram(0);
+    int sent = 0;
+    QBENCHMARK {
+        sent = 0;
+        for (const std::shared_ptr<QUdpSocket> &receiver : std::as_const(receivers)) {
+            if (sender.writeDatagram(data, QHostAddress::LocalHost, receiver->localPort()) == data.size()) {
+                sent++;
+            }
+        }
+    }
+    QCOMPARE(sent, kTargetCount);
+}
+
+void UDPBatchIOTest::_benchmarkSendBatch()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched datagram I/O not supported on this platform");
+    }
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    QList<std::shared_ptr<QUdpSocket>> receivers;
+    QList<std::shared_ptr<UDPClient>> targets;
+    for (int i = 0; i < kTargetCount; i++) {
+        const std::shared_ptr<QUdpSocket> receiver = std::make_shared<QUdpSocket>();
+        QVERIFY(receiver->bind(QHostAddress::LocalHost, 0));
+        receivers.append(receiver);
+        targets.append(std::make_shared<UDPClient>(QHostAddress(QHostAddress::LocalHost), receiver->localPort()));
+    }
+
+    UDPBatchIO batchIO;
+    const QByteArray data = _datagram(0);
+    int sent = 0;
+    QBENCHMARK {
+        sent = batchIO.send(sender, data, targets);
+    }
+    QCOMPARE(sent, kTargetCount);
+}
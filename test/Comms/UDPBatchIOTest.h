@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class UDPBatchIOTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testReceiveBatch();
+    void _testSendBatch();
+    void _testSendIPv6Target();
+    void _benchmarkReceiveDatagram();
+    void _benchmarkReceiveBatch();
+    void _benchmarkWriteDatagram();
+    void _benchmarkSendBatch();
+};
@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCacheTest.h"
+#include "ParameterCache.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+namespace {
+    QList<ParameterCache::Param> _params()
+    {
+        // Not in name order, the cache sorts them
+        return {
+            { QStringLiteral("SYS_AUTOSTART"), FactMetaData::valueTypeInt32, QVariant(4001) },
+            { QStringLiteral("BAT1_V_CHARGED"), FactMetaData::valueTypeFloat, QVariant(4.05f) },
+            { QStringLiteral("MAV_TYPE"), FactMetaData::valueTypeUint8, QVariant(2) },
+            { QStringLiteral("CAL_ACC0_ID"), FactMetaData::valueTypeUint32, QVariant(4294967295u) },
+            { QStringLiteral("COM_RC_LOSS_T"), FactMetaData::valueTypeInt16, QVariant(-12) },
+            { QStringLiteral("EKF2_GPS_DELAY"), FactMetaData::valueTypeDouble, QVariant(110.5) },
+        };
+    }
+}
+
+void ParameterCacheTest::_testWriteRead()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("1_1.v3"));
+
+    const QList<ParameterCache::Param> params = _params();
+    QVERIFY(ParameterCache::write(path, 0xdeadbeef, params));
+
+    ParameterCache cache;
+    QVERIFY(cache.open(path));
+    QCOMPARE(cache.hash(), static_cast<quint32>(0xdeadbeef));
+    QCOMPARE(cache.count(), static_cast<int>(params.size()));
+
+    for (int index = 1; index < cache.count(); index++) {
+        QVERIFY(cache.name(index - 1) < cache.name(index));
+    }
+
+    for (const ParameterCache::Param &param : params) {
+        const int index = cache.indexOf(param.name);
+        QVERIFY(index >= 0);
+        QCOMPARE(cache.name(index), param.name);
+        QCOMPARE(cache.type(index), param.type);
+        QCOMPARE(ParameterCache::valueBytes(param.type, cache.value(index)), ParameterCache::valueBytes(param.type, param.value));
+    }
+    QCOMPARE(cache.value(cache.indexOf(QStringLiteral("SYS_AUTOSTART"))).toInt(), 4001);
+    QCOMPARE(cache.value(cache.indexOf(QStringLiteral("COM_RC_LOSS_T"))).toInt(), -12);
+    QCOMPARE(cache.value(cache.indexOf(QStringLiteral("CAL_ACC0_ID"))).toUInt(), 4294967295u);
+    QCOMPARE(cache.value(cache.indexOf(QStringLiteral("BAT1_V_CHARGED"))).toFloat(), 4.05f);
+
+    QCOMPARE(cache.indexOf(QStringLiteral("AAA")), -1);
+    QCOMPARE(cache.indexOf(QStringLiteral("MAV_TYP")), -1);
+    QCOMPARE(cache.indexOf(QStringLiteral("ZZZ")), -1);
+
+    cache.close();
+    QVERIFY(ParameterCache::write(path, 1, params.mid(0, 2)));
+    QVERIFY(cache.open(path));
+    QCOMPARE(cache.hash(), static_cast<quint32>(1));
+    QCOMPARE(cache.count(), 2);
+}
+
+void ParameterCacheTest::_testValueBytes()
+{
+    QCOMPARE(ParameterCache::valueBytes(FactMetaData::valueTypeUint8, QVariant(200)), QByteArray("\xc8", 1));
+    QCOMPARE(ParameterCache::valueBytes(FactMetaData::valueTypeInt16, QVariant(-2)), QByteArray("\xfe\xff", 2));
+    QCOMPARE(ParameterCache::valueBytes(FactMetaData::valueTypeInt32, QVariant(0x01020304)), QByteArray("\x04\x03\x02\x01", 4));
+    QCOMPARE(ParameterCache::valueBytes(FactMetaData::valueTypeFloat, QVariant(1.0f)), QByteArray("\x00\x00\x80\x3f", 4));
+    QVERIFY(ParameterCache::valueBytes(FactMetaData::valueTypeString, QVariant(QStringLiteral("x"))).isEmpty());
+}
+
+void ParameterCacheTest::_testDamaged()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("1_1.v3"));
+
+    ParameterCache cache;
+    QVERIFY(!cache.open(path));
+    QVERIFY(!cache.isOpen());
+
+    QVERIFY(ParameterCache::write(path, 1, _params()));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 size = file.size();
+    QVERIFY(file.resize(size - 1));
+    file.close();
+    QVERIFY(!cache.open(path));
+
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QVERIFY(file.write(QByteArray(64, 'x')) == 64);
+    file.close();
+    QVERIFY(!cache.open(path));
+}
@@ -12,11 +12,21 @@
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 #include "ParameterManager.h"
+#include "ParameterCache.h"
 #include "MockLinkFTP.h"
+#include "QGC.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSet>
+#include <QtCore/QtEndian>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 /// Test failure modes which should still lead to param load success
 void ParameterManagerTest::_noFailureWorker(MockConfiguration::FailureMode_t failureMode)
 {
@@ -131,6 +141,259 @@ void ParameterManagerTest::_requestListMissingParamFail(void)
     QCOMPARE(vehicle->parameterManager()->missingParameters(), true);
 }
 
+// MockLink loses a tenth of the PARAM_VALUE messages and is slow to answer PARAM_REQUEST_READ. All parameters
+// should still load, the time it took is reported.
+void ParameterManagerTest::_lossyLinkBenchmark(void)
+{
+    Q_ASSERT(!_mockLink);
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    _mockLink = MockLink::startPX4MockLink(false);
+    _mockLink->setParamLinkQuality(0.1, 50);
+
+    MultiVehicleManager* vehicleMgr = MultiVehicleManager::instance();
+    QVERIFY(vehicleMgr);
+
+    // Wait for the Vehicle to get created
+    QSignalSpy spyVehicle(vehicleMgr, SIGNAL(activeVehicleAvailableChanged(bool)));
+    QSignalSpy spyParamsReady(vehicleMgr, SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+    QCOMPARE(spyVehicle.wait(5000), true);
+
+    Vehicle* vehicle = vehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+
+    if (spyParamsReady.count() == 0) {
+        QCOMPARE(spyParamsReady.wait(60000), true);
+    }
+    QCOMPARE(vehicle->parameterManager()->missingParameters(), false);
+
+    qDebug() << "Parameters loaded over lossy link in" << loadTimer.elapsed() << "msecs";
+}
+
+void ParameterManagerTest::_lazyFactBenchmark(void)
+{
+    // The first vehicle also loads the metadata which is kept for the vehicles after it
+    FactLoadStats_t warmup;
+    _factLoad(false, warmup);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    FactLoadStats_t lazy;
+    _factLoad(false, lazy);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    FactLoadStats_t eager;
+    _factLoad(true, eager);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // Only the params used so far have a Fact, the others stay in the parameter tables
+    QVERIFY(lazy.paramCount > 0);
+    QCOMPARE(eager.paramCount, lazy.paramCount);
+    QVERIFY(lazy.factCount < lazy.paramCount);
+    QVERIFY(lazy.tableBytes > 0);
+    QCOMPARE(eager.factCount, eager.paramCount);
+    QCOMPARE(eager.tableBytes, static_cast<qint64>(0));
+
+    qDebug() << "Params:" << lazy.paramCount << "facts created - tables:" << lazy.factCount << "eager:" << eager.factCount;
+    qDebug() << "Connect msecs - tables:" << lazy.connectMsecs << "eager:" << eager.connectMsecs << "difference:" << (eager.connectMsecs - lazy.connectMsecs);
+
+    if ((lazy.heapBytes < 0) || (eager.heapBytes < 0)) {
+        qDebug() << "Vehicle heap not measured, parameter tables:" << lazy.tableBytes << "bytes";
+        return;
+    }
+
+    const qint64 heapSaved = eager.heapBytes - lazy.heapBytes;
+    qDebug() << "Vehicle heap bytes - tables:" << lazy.heapBytes << "eager:" << eager.heapBytes << "difference:" << heapSaved
+             << "per param:" << (heapSaved / lazy.paramCount) << "parameter tables:" << lazy.tableBytes;
+    QVERIFY(heapSaved > 0);
+}
+
+void ParameterManagerTest::_factLoad(bool eagerFacts, FactLoadStats_t &stats)
+{
+    ParameterManager::_eagerFacts = eagerFacts;
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    Vehicle* vehicle = _connectPX4(0);
+    stats.connectMsecs = loadTimer.elapsed();
+    ParameterManager::_eagerFacts = false;
+    QVERIFY(vehicle);
+
+    ParameterManager* parameterManager = vehicle->parameterManager();
+    for (const int componentId: parameterManager->componentIds()) {
+        stats.paramCount += static_cast<int>(parameterManager->parameterNames(componentId).count());
+    }
+    stats.factCount = static_cast<int>(parameterManager->findChildren<Fact*>(QString(), Qt::FindDirectChildrenOnly).count());
+    for (const ParameterTable &paramTable: parameterManager->_mapCompId2ParamTable) {
+        stats.tableBytes += paramTable.memoryUsage();
+    }
+
+    if (!eagerFacts) {
+        // Asking for a param creates its Fact once
+        const QString paramName = parameterManager->parameterNames(vehicle->defaultComponentId()).constLast();
+        Fact* fact = parameterManager->getParameter(ParameterManager::defaultComponentId, paramName);
+        QCOMPARE(fact->name(), paramName);
+        QCOMPARE(parameterManager->getParameter(ParameterManager::defaultComponentId, paramName), fact);
+        QCOMPARE(static_cast<int>(parameterManager->parameterNames(vehicle->defaultComponentId()).count(paramName)), 1);
+    }
+
+    // What the vehicle frees is what it held, everything else on the heap is the same for both runs
+    const qint64 connectedHeap = _heapInUse();
+    _disconnectMockLink();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    if (connectedHeap >= 0) {
+        stats.heapBytes = connectedHeap - _heapInUse();
+    }
+}
+
+qint64 ParameterManagerTest::_heapInUse()
+{
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    return static_cast<qint64>(mallinfo2().uordblks);
+#endif
+#endif
+    return -1;
+}
+
+Vehicle* ParameterManagerTest::_connectPX4(quint32 hashCheck)
+{
+    Q_ASSERT(!_mockLink);
+    MultiVehicleManager* vehicleMgr = MultiVehicleManager::instance();
+    QSignalSpy spyVehicle(vehicleMgr, SIGNAL(activeVehicleAvailableChanged(bool)));
+    QSignalSpy spyParamsReady(vehicleMgr, SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+
+    _mockLink = MockLink::startPX4MockLink(false);
+    if (hashCheck != 0) {
+        _mockLink->setParamHashCheck(hashCheck);
+    }
+
+    if (!spyVehicle.wait(5000) || !vehicleMgr->activeVehicle()) {
+        return nullptr;
+    }
+    if ((spyParamsReady.count() == 0) && !spyParamsReady.wait(10000)) {
+        return nullptr;
+    }
+
+    return vehicleMgr->activeVehicle();
+}
+
+quint32 ParameterManagerTest::_px4ParamHash(Vehicle* vehicle, int componentId)
+{
+    ParameterManager* parameterManager = vehicle->parameterManager();
+    quint32 hash = 0;
+
+    // Name and little endian value of every non volatile param, in name order
+    for (const QString &paramName: parameterManager->parameterNames(componentId)) {
+        const Fact* fact = parameterManager->getParameter(componentId, paramName);
+        if (fact->metaData()->volatileValue()) {
+            continue;
+        }
+
+        const QVariant value = fact->rawValue();
+        QByteArray valueBytes;
+        switch (fact->type()) {
+        case FactMetaData::valueTypeUint8:
+        case FactMetaData::valueTypeInt8:
+            valueBytes.append(static_cast<char>(value.toInt()));
+            break;
+        case FactMetaData::valueTypeUint16:
+        case FactMetaData::valueTypeInt16:
+            valueBytes.resize(2);
+            qToLittleEndian<quint16>(static_cast<quint16>(value.toInt()), valueBytes.data());
+            break;
+        case FactMetaData::valueTypeFloat:
+            valueBytes.resize(4);
+            qToLittleEndian<float>(value.toFloat(), valueBytes.data());
+            break;
+        default:
+            valueBytes.resize(4);
+            qToLittleEndian<quint32>(static_cast<quint32>(value.toLongLong()), valueBytes.data());
+            break;
+        }
+
+        const QByteArray nameBytes = paramName.toLatin1();
+        hash = QGC::crc32(reinterpret_cast<const quint8 *>(nameBytes.constData()), nameBytes.size(), hash);
+        hash = QGC::crc32(reinterpret_cast<const quint8 *>(valueBytes.constData()), valueBytes.size(), hash);
+    }
+
+    return hash;
+}
+
+// The cache written after a download carries the hash PX4 reports for the same parameters
+void ParameterManagerTest::_cacheHash(void)
+{
+    Vehicle* vehicle = _connectPX4(0);
+    QVERIFY(vehicle);
+
+    const int componentId = vehicle->defaultComponentId();
+    ParameterCache cache;
+    QVERIFY(cache.open(ParameterManager::parameterCacheFile(vehicle->id(), componentId)));
+    QCOMPARE(cache.count(), static_cast<int>(vehicle->parameterManager()->parameterNames(componentId).count()));
+    QCOMPARE(cache.hash(), _px4ParamHash(vehicle, componentId));
+}
+
+// Parameters taken from the cache get their Fact on first use
+void ParameterManagerTest::_cachedParams(void)
+{
+    Vehicle* vehicle = _connectPX4(0);
+    QVERIFY(vehicle);
+    const int componentId = vehicle->defaultComponentId();
+    const quint32 hash = _px4ParamHash(vehicle, componentId);
+    const QString cacheFile = ParameterManager::parameterCacheFile(vehicle->id(), componentId);
+    _disconnectMockLink();
+
+    vehicle = _connectPX4(hash);
+    QVERIFY(vehicle);
+    QVERIFY(_mockLink->paramHashCheckAcked());
+
+    ParameterCache cache;
+    QVERIFY(cache.open(cacheFile));
+    QStringList cachedNames;
+    for (int index = 0; index < cache.count(); index++) {
+        cachedNames.append(cache.name(index));
+    }
+
+    // Names of params with and without a Fact come back merged in name order
+    ParameterManager* parameterManager = vehicle->parameterManager();
+    QCOMPARE(parameterManager->parameterNames(componentId), cachedNames);
+
+    QSet<QString> factNames;
+    for (const Fact* fact: parameterManager->findChildren<Fact*>(QString(), Qt::FindDirectChildrenOnly)) {
+        if (fact->componentId() == componentId) {
+            factNames.insert(fact->name());
+        }
+    }
+    QVERIFY(factNames.count() < cachedNames.count());
+
+    QString paramName;
+    for (const QString &cachedName: cachedNames) {
+        if (!factNames.contains(cachedName)) {
+            paramName = cachedName;
+            break;
+        }
+    }
+    QVERIFY(!paramName.isEmpty());
+
+    // Looking a param up does not create its Fact, asking for it does, once
+    const qsizetype factCount = parameterManager->findChildren<Fact*>(QString(), Qt::FindDirectChildrenOnly).count();
+    QVERIFY(parameterManager->parameterExists(componentId, paramName));
+    QCOMPARE(parameterManager->findChildren<Fact*>(QString(), Qt::FindDirectChildrenOnly).count(), factCount);
+
+    Fact* fact = parameterManager->getParameter(componentId, paramName);
+    QCOMPARE(fact->name(), paramName);
+    QCOMPARE(fact->componentId(), componentId);
+    QCOMPARE(fact->rawValue().toDouble(), cache.value(cache.indexOf(paramName)).toDouble());
+    QCOMPARE(parameterManager->findChildren<Fact*>(QString(), Qt::FindDirectChildrenOnly).count(), factCount + 1);
+    QCOMPARE(parameterManager->getParameter(componentId, paramName), fact);
+    QCOMPARE(parameterManager->findChildren<Fact*>(QString(), Qt::FindDirectChildrenOnly).count(), factCount + 1);
+    QCOMPARE(parameterManager->parameterNames(componentId), cachedNames);
+}
+
 #if 0
 void ParameterManagerTest::_FTPnoFailure()
 {
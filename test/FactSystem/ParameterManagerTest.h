@@ -12,6 +12,8 @@
 #include "UnitTest.h"
 #include "MockConfiguration.h"
 
+class Vehicle;
+
 class ParameterManagerTest : public UnitTest
 {
     Q_OBJECT
@@ -21,10 +23,32 @@ private slots:
     void _requestListNoResponse(void);
     void _requestListMissingParamSuccess(void);
     void _requestListMissingParamFail(void);
+    void _lossyLinkBenchmark(void);
+    void _lazyFactBenchmark(void);
+    void _cacheHash(void);
+    void _cachedParams(void);
     // void _FTPnoFailure(void);
     // void _FTPChangeParam(void);
 
 
 private:
+    struct FactLoadStats_t {
+        qint64  connectMsecs = 0;
+        int     paramCount = 0;
+        int     factCount = 0;
+        qint64  tableBytes = 0;     ///< Allocated by the parameter tables
+        qint64  heapBytes = -1;     ///< Heap released when the vehicle goes away, -1 if the allocator can't tell
+    };
+
     void _noFailureWorker(MockConfiguration::FailureMode_t failureMode);
+    /// Connects a PX4 MockLink, collects the load stats and disconnects again
+    ///     @param eagerFacts true: create a Fact for every param on load, false: use the parameter tables
+    void _factLoad(bool eagerFacts, FactLoadStats_t &stats);
+    /// Heap bytes in use, -1 if the allocator can't tell
+    static qint64 _heapInUse();
+    /// Connects a PX4 MockLink and waits for its parameters
+    ///     @param hashCheck hash sent as _HASH_CHECK, 0 for none
+    Vehicle* _connectPX4(quint32 hashCheck);
+    /// Parameter set hash of the component computed the way PX4 does for _HASH_CHECK
+    static quint32 _px4ParamHash(Vehicle* vehicle, int componentId);
 };
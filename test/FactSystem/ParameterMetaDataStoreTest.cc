@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataStoreTest.h"
+#include "ParameterMetaDataStore.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+namespace {
+    ParameterMetaDataStore::Entry _entry(const QString &key, int number)
+    {
+        ParameterMetaDataStore::Entry entry;
+        entry.key = key;
+        entry.name = key.section('/', -1);
+        entry.fields[ParameterMetaDataStore::FieldType] = QStringLiteral("FLOAT");
+        entry.fields[ParameterMetaDataStore::FieldCategory] = QStringLiteral("Standard");
+        entry.fields[ParameterMetaDataStore::FieldShortDescription] = QStringLiteral("Parameter %1").arg(number);
+        entry.fields[ParameterMetaDataStore::FieldMin] = QString::number(-number);
+        entry.fields[ParameterMetaDataStore::FieldMax] = QString::number(number);
+        if (number % 3 == 0) {
+            entry.flags = ParameterMetaDataStore::FlagRebootRequired | ParameterMetaDataStore::FlagReadOnly;
+            entry.values = { { QStringLiteral("0"), QStringLiteral("Disabled") }, { QString::number(number), QStringLiteral("Value %1").arg(number) } };
+        }
+        if (number % 5 == 0) {
+            entry.bitmask = { { QStringLiteral("0"), QStringLiteral("First") }, { QStringLiteral("3"), QStringLiteral("Fourth") } };
+        }
+        return entry;
+    }
+
+    QList<ParameterMetaDataStore::Entry> _entries(int count)
+    {
+        QList<ParameterMetaDataStore::Entry> entries;
+        for (int i = 0; i < count; i++) {
+            entries.append(_entry(QStringLiteral("ArduCopter/PARAM_%1").arg(i), i));
+        }
+        return entries;
+    }
+
+    void _verifyEntry(const ParameterMetaDataStore &store, const ParameterMetaDataStore::Entry &expected)
+    {
+        const int index = store.indexOf(expected.key);
+        QVERIFY(index >= 0);
+        QCOMPARE(store.key(index), expected.key);
+
+        const ParameterMetaDataStore::Entry entry = store.entry(index);
+        QCOMPARE(entry.key, expected.key);
+        QCOMPARE(entry.name, expected.name);
+        for (int field = 0; field < ParameterMetaDataStore::FieldCount; field++) {
+            QCOMPARE(entry.fields[field], expected.fields[field]);
+        }
+        QCOMPARE(entry.flags, expected.flags);
+        QCOMPARE(entry.values, expected.values);
+        QCOMPARE(entry.bitmask, expected.bitmask);
+    }
+}
+
+void ParameterMetaDataStoreTest::_testCompileLoad()
+{
+    const QList<ParameterMetaDataStore::Entry> entries = _entries(1000);
+    const QByteArray blob = ParameterMetaDataStore::compile(entries);
+    QVERIFY(!blob.isEmpty());
+
+    ParameterMetaDataStore store;
+    QVERIFY(store.load(blob));
+    QCOMPARE(store.count(), static_cast<int>(entries.size()));
+
+    for (const ParameterMetaDataStore::Entry &entry : entries) {
+        _verifyEntry(store, entry);
+    }
+
+    QCOMPARE(store.indexOf(QStringLiteral("ArduCopter/PARAM_1000")), -1);
+    QCOMPARE(store.indexOf(QStringLiteral("ArduPlane/PARAM_1")), -1);
+    QCOMPARE(store.indexOf(QString()), -1);
+    QVERIFY(store.key(-1).isEmpty());
+    QVERIFY(store.entry(store.count()).key.isEmpty());
+}
+
+void ParameterMetaDataStoreTest::_testDuplicates()
+{
+    QList<ParameterMetaDataStore::Entry> entries = _entries(10);
+    ParameterMetaDataStore::Entry duplicate;
+    duplicate.key = entries[4].key;
+    duplicate.fields[ParameterMetaDataStore::FieldType] = QStringLiteral("INT32");
+    entries.append(duplicate);
+
+    ParameterMetaDataStore store;
+    QVERIFY(store.load(ParameterMetaDataStore::compile(entries)));
+    QCOMPARE(store.count(), 10);
+    _verifyEntry(store, duplicate);
+    _verifyEntry(store, entries[5]);
+}
+
+void ParameterMetaDataStoreTest::_testSaveOpen()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("cache/apm.pdef.bin"));
+
+    const QList<ParameterMetaDataStore::Entry> entries = _entries(50);
+    const QByteArray blob = ParameterMetaDataStore::compile(entries);
+    QVERIFY(ParameterMetaDataStore::save(path, blob));
+
+    ParameterMetaDataStore store;
+    QVERIFY(store.open(path));
+    QVERIFY(store.isOpen());
+    for (const ParameterMetaDataStore::Entry &entry : entries) {
+        _verifyEntry(store, entry);
+    }
+    store.close();
+    QVERIFY(!store.isOpen());
+    QCOMPARE(store.indexOf(entries.first().key), -1);
+
+    QVERIFY(!store.open(tmpDir.filePath(QStringLiteral("missing.bin"))));
+
+    // Truncated
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(blob.left(blob.size() - 1)) == (blob.size() - 1));
+    file.close();
+    QVERIFY(!store.open(path));
+
+    // Not a compiled file
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(QByteArray(256, 'x')) == 256);
+    file.close();
+    QVERIFY(!store.open(path));
+}
+
+void ParameterMetaDataStoreTest::_testEmpty()
+{
+    ParameterMetaDataStore store;
+    QVERIFY(store.load(ParameterMetaDataStore::compile(QList<ParameterMetaDataStore::Entry>())));
+    QCOMPARE(store.count(), 0);
+    QCOMPARE(store.indexOf(QStringLiteral("PARAM")), -1);
+
+    const QString first = ParameterMetaDataStore::compiledPath(QStringLiteral(":/FirmwarePlugin/APM/APMParameterFactMetaData.Copter.4.5.xml"));
+    QVERIFY(first.endsWith(QStringLiteral(".bin")));
+    QCOMPARE(ParameterMetaDataStore::compiledPath(QStringLiteral(":/FirmwarePlugin/APM/APMParameterFactMetaData.Copter.4.5.xml")), first);
+    QVERIFY(ParameterMetaDataStore::compiledPath(QStringLiteral(":/FirmwarePlugin/APM/APMParameterFactMetaData.Plane.4.5.xml")) != first);
+}
@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterTableTest.h"
+#include "Fact.h"
+#include "ParameterTable.h"
+
+#include <QtTest/QTest>
+
+void ParameterTableTest::_testSetLookup()
+{
+    ParameterTable table;
+    QVERIFY(table.isEmpty());
+
+    // Not in name order, the table sorts them
+    QVERIFY(table.set(QStringLiteral("SYS_AUTOSTART"), FactMetaData::valueTypeInt32, QVariant(4001)));
+    QVERIFY(table.set(QStringLiteral("BAT1_V_CHARGED"), FactMetaData::valueTypeFloat, QVariant(4.05f)));
+    QVERIFY(table.set(QStringLiteral("MAV_TYPE"), FactMetaData::valueTypeUint8, QVariant(2)));
+    QVERIFY(table.set(QStringLiteral("CAL_ACC0_ID"), FactMetaData::valueTypeUint32, QVariant(4294967295u)));
+    QVERIFY(table.set(QStringLiteral("COM_RC_LOSS_T"), FactMetaData::valueTypeInt16, QVariant(-12)));
+    QVERIFY(table.set(QStringLiteral("EKF2_GPS_DELAY"), FactMetaData::valueTypeDouble, QVariant(110.5)));
+    QVERIFY(table.set(QStringLiteral("SENS_BOARD_X_OFF"), FactMetaData::valueTypeFloat, QVariant(-0.5f)));
+    QCOMPARE(table.count(), 7);
+
+    const QStringList names = table.names();
+    QCOMPARE(static_cast<int>(names.count()), 7);
+    for (int index = 1; index < names.count(); index++) {
+        QVERIFY(names[index - 1] < names[index]);
+        QCOMPARE(table.name(index), names[index]);
+    }
+
+    QCOMPARE(table.type(table.indexOf(QStringLiteral("MAV_TYPE"))), FactMetaData::valueTypeUint8);
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("SYS_AUTOSTART"))), QVariant(4001));
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("COM_RC_LOSS_T"))), QVariant(-12));
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("CAL_ACC0_ID"))), QVariant(4294967295u));
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("BAT1_V_CHARGED"))), QVariant(4.05f));
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("EKF2_GPS_DELAY"))), QVariant(110.5));
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("SENS_BOARD_X_OFF"))), QVariant(-0.5f));
+
+    QCOMPARE(table.indexOf(QStringLiteral("AAA")), -1);
+    QCOMPARE(table.indexOf(QStringLiteral("MAV_TYP")), -1);
+    QCOMPARE(table.indexOf(QStringLiteral("MAV_TYPE_")), -1);
+    QCOMPARE(table.indexOf(QStringLiteral("ZZZ")), -1);
+
+    // Updates replace the value in place
+    QVERIFY(table.set(QStringLiteral("SYS_AUTOSTART"), FactMetaData::valueTypeInt32, QVariant(-1)));
+    QVERIFY(table.set(QStringLiteral("MAV_TYPE"), FactMetaData::valueTypeUint16, QVariant(65535)));
+    QCOMPARE(table.count(), 7);
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("SYS_AUTOSTART"))), QVariant(-1));
+    QCOMPARE(table.type(table.indexOf(QStringLiteral("MAV_TYPE"))), FactMetaData::valueTypeUint16);
+    QCOMPARE(table.value(table.indexOf(QStringLiteral("MAV_TYPE"))), QVariant(65535));
+}
+
+void ParameterTableTest::_testRemove()
+{
+    ParameterTable table;
+    for (int index = 0; index < 10; index++) {
+        QVERIFY(table.set(QStringLiteral("PARAM_%1").arg(index), FactMetaData::valueTypeInt32, QVariant(index)));
+    }
+
+    table.remove(table.indexOf(QStringLiteral("PARAM_0")));
+    table.remove(table.indexOf(QStringLiteral("PARAM_5")));
+    table.remove(table.indexOf(QStringLiteral("PARAM_9")));
+    table.remove(-1);
+    table.remove(table.count());
+    QCOMPARE(table.count(), 7);
+
+    for (int index = 0; index < 10; index++) {
+        const int tableIndex = table.indexOf(QStringLiteral("PARAM_%1").arg(index));
+        if ((index == 0) || (index == 5) || (index == 9)) {
+            QCOMPARE(tableIndex, -1);
+        } else {
+            QVERIFY(tableIndex >= 0);
+            QCOMPARE(table.value(tableIndex), QVariant(index));
+        }
+    }
+
+    table.clear();
+    QVERIFY(table.isEmpty());
+    QCOMPARE(table.indexOf(QStringLiteral("PARAM_1")), -1);
+}
+
+void ParameterTableTest::_testRejected()
+{
+    ParameterTable table;
+
+    // Exactly the length of a MAVLink param_id still fits
+    QVERIFY(table.set(QStringLiteral("ABCDEFGHIJKLMNOP"), FactMetaData::valueTypeInt32, QVariant(1)));
+    QCOMPARE(table.name(table.indexOf(QStringLiteral("ABCDEFGHIJKLMNOP"))), QStringLiteral("ABCDEFGHIJKLMNOP"));
+
+    QVERIFY(!table.set(QStringLiteral("ABCDEFGHIJKLMNOPQ"), FactMetaData::valueTypeInt32, QVariant(1)));
+    QVERIFY(!table.set(QString(), FactMetaData::valueTypeInt32, QVariant(1)));
+    QVERIFY(!table.set(QStringLiteral("PARAM_€"), FactMetaData::valueTypeInt32, QVariant(1)));
+    QVERIFY(!table.set(QStringLiteral("PARAM_STRING"), FactMetaData::valueTypeString, QVariant(QStringLiteral("x"))));
+    QCOMPARE(table.count(), 1);
+    QCOMPARE(table.indexOf(QStringLiteral("ABCDEFGHIJKLMNOPQ")), -1);
+}
+
+void ParameterTableTest::_testMemory()
+{
+    constexpr int paramCount = 1000;
+
+    ParameterTable table;
+    table.reserve(paramCount);
+    for (int index = 0; index < paramCount; index++) {
+        QVERIFY(table.set(QStringLiteral("PARAM_%1").arg(index, 4, 10, QLatin1Char('0')), FactMetaData::valueTypeFloat, QVariant(static_cast<float>(index))));
+    }
+    QCOMPARE(table.count(), paramCount);
+
+    const qsizetype bytesPerParam = ParameterTable::kNameSize + 1 + ParameterTable::kValueSize;
+    QVERIFY(table.memoryUsage() >= (paramCount * bytesPerParam));
+    QVERIFY(table.memoryUsage() < (2 * paramCount * bytesPerParam));
+
+    // The Fact object alone, without its private QObject data, name, value and connections, is already larger
+    QVERIFY(static_cast<qsizetype>(sizeof(Fact)) > bytesPerParam);
+    qDebug() << "Table bytes per param:" << bytesPerParam << "sizeof(Fact):" << sizeof(Fact);
+}
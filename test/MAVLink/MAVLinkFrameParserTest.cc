@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameParserTest.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkSigning.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+void MAVLinkFrameParserTest::init()
+{
+    UnitTest::init();
+
+    // Other tests may have left signing enabled on these channels
+    for (const uint8_t channel : {_parseChannel, _packChannel}) {
+        (void) MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(channel), QByteArrayView(), nullptr);
+        mavlink_reset_channel_status(channel);
+    }
+}
+
+QByteArray MAVLinkFrameParserTest::_buildStream(int count, bool tlogTimestamps)
+{
+    QByteArray stream;
+    quint64 timestamp = 1700000000000000ULL;
+
+    for (int i = 0; i < count; i++) {
+        mavlink_message_t message;
+        switch (i % 3) {
+        case 0:
+            (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+            break;
+        case 1:
+            (void) mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, i, 0.1f * i, 0.2f, 0.3f, 0.f, 0.f, 0.f);
+            break;
+        default:
+            (void) mavlink_msg_global_position_int_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, i, 473977418 + i, 85455938, 488000, 10000, 0, 0, 0, UINT16_MAX);
+            break;
+        }
+
+        if (tlogTimestamps) {
+            uint8_t bytes[sizeof(quint64)];
+            qToBigEndian(timestamp, bytes);
+            (void) stream.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+            timestamp += 10000;
+        }
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+        (void) stream.append(reinterpret_cast<const char*>(buffer), len);
+    }
+
+    return stream;
+}
+
+QByteArray MAVLinkFrameParserTest::_benchmarkTlog()
+{
+    const QString tlogFile = qEnvironmentVariable("QGC_BENCHMARK_TLOG");
+    if (!tlogFile.isEmpty()) {
+        QFile file(tlogFile);
+        if (file.open(QIODevice::ReadOnly)) {
+            return file.readAll();
+        }
+        qWarning() << "Unable to open" << tlogFile << file.errorString();
+    }
+
+    return _buildStream(100000, true);
+}
+
+void MAVLinkFrameParserTest::_testParseFrames()
+{
+    const QByteArray stream = _buildStream(30, false);
+
+    MAVLinkFrameParser parser(_parseChannel);
+    QList<mavlink_message_t> frames;
+    QCOMPARE(parser.parse(stream, frames), 30);
+    QCOMPARE(parser.pendingBytes(), 0);
+    QCOMPARE(parser.stats().framesOk, static_cast<uint64_t>(30));
+    QCOMPARE(parser.stats().badCrc, static_cast<uint64_t>(0));
+
+    for (qsizetype i = 0; i < frames.size(); i++) {
+        const mavlink_message_t &message = frames[i];
+        QCOMPARE(message.sysid, static_cast<uint8_t>(1));
+        QCOMPARE(message.compid, static_cast<uint8_t>(MAV_COMP_ID_AUTOPILOT1));
+        QCOMPARE(message.seq, static_cast<uint8_t>(i));
+        if (message.msgid == MAVLINK_MSG_ID_ATTITUDE) {
+            QCOMPARE(mavlink_msg_attitude_get_time_boot_ms(&message), static_cast<uint32_t>(i));
+        }
+    }
+    QCOMPARE(static_cast<uint32_t>(frames[0].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(static_cast<uint32_t>(frames[1].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_ATTITUDE));
+    QCOMPARE(static_cast<uint32_t>(frames[2].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_GLOBAL_POSITION_INT));
+
+    // Trailing zero bytes are truncated on the wire and must be zero filled again
+    QVERIFY(frames[1].len < MAVLINK_MSG_ID_ATTITUDE_LEN);
+    QCOMPARE(mavlink_msg_attitude_get_yawspeed(&frames[1]), 0.f);
+}
+
+void MAVLinkFrameParserTest::_testParseSplitFrames()
+{
+    const QByteArray stream = _buildStream(12, true);
+
+    for (const qsizetype chunkSize : {1, 7, 13, 64, 300}) {
+        MAVLinkFrameParser parser(_parseChannel);
+        QList<mavlink_message_t> frames;
+        for (qsizetype offset = 0; offset < stream.size(); offset += chunkSize) {
+            (void) parser.parse(QByteArrayView(stream).sliced(offset, qMin(chunkSize, stream.size() - offset)), frames);
+        }
+        QCOMPARE(frames.size(), 12);
+        QCOMPARE(parser.pendingBytes(), 0);
+        for (qsizetype i = 0; i < frames.size(); i++) {
+            QCOMPARE(frames[i].seq, static_cast<uint8_t>(i));
+        }
+    }
+}
+
+void MAVLinkFrameParserTest::_testParseMavlink1()
+{
+    mavlink_status_t *const packStatus = mavlink_get_channel_status(_packChannel);
+    packStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    const QByteArray stream = _buildStream(3, false);
+    packStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+    MAVLinkFrameParser parser(_parseChannel);
+    QList<mavlink_message_t> frames;
+    QCOMPARE(parser.parse(stream, frames), 3);
+    QCOMPARE(frames[0].magic, static_cast<uint8_t>(MAVLINK_STX_MAVLINK1));
+    QCOMPARE(static_cast<uint32_t>(frames[2].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_GLOBAL_POSITION_INT));
+    QCOMPARE(mavlink_msg_global_position_int_get_lat(&frames[2]), 473977418 + 2);
+    QCOMPARE(mavlink_get_channel_status(_parseChannel)->packet_rx_success_count, static_cast<uint16_t>(3));
+}
+
+void MAVLinkFrameParserTest::_testResync()
+{
+    QByteArray good = _buildStream(2, false);
+    QByteArray corrupt = _buildStream(1, false);
+    corrupt[corrupt.size() - 1] = static_cast<char>(corrupt.at(corrupt.size() - 1) ^ 0xFF);
+
+    QByteArray stream;
+    (void) stream.append("\x00\x12\xFD\x03", 4);   // garbage including a false STX
+    (void) stream.append(corrupt);
+    (void) stream.append(good);
+
+    MAVLinkFrameParser parser(_parseChannel);
+    QList<mavlink_message_t> frames;
+    QCOMPARE(parser.parse(stream, frames), 2);
+    QVERIFY(parser.stats().badCrc >= 1);
+    QVERIFY(parser.stats().bytesDiscarded > 0);
+}
+
+void MAVLinkFrameParserTest::_benchmarkParseChar()
+{
+    const QByteArray tlog = _benchmarkTlog();
+
+    qsizetype count = 0;
+    QBENCHMARK {
+        mavlink_reset_channel_status(_parseChannel);
+        count = 0;
+        for (const char byte : tlog) {
+            mavlink_message_t message;
+            mavlink_status_t status;
+            if (mavlink_parse_char(_parseChannel, static_cast<uint8_t>(byte), &message, &status) == MAVLINK_FRAMING_OK) {
+                count++;
+            }
+        }
+    }
+    QVERIFY(count > 0);
+}
+
+void MAVLinkFrameParserTest::_benchmarkFrameParser()
+{
+    const QByteArray tlog = _benchmarkTlog();
+    // Simulate link sized reads
+    constexpr qsizetype chunkSize = 4096;
+
+    qsizetype count = 0;
+    QBENCHMARK {
+        MAVLinkFrameParser parser(_parseChannel);
+        QList<mavlink_message_t> frames;
+        count = 0;
+        for (qsizetype offset = 0; offset < tlog.size(); offset += chunkSize) {
+            frames.clear();
+            count += parser.parse(QByteArrayView(tlog).sliced(offset, qMin(chunkSize, tlog.size() - offset)), frames);
+        }
+    }
+    QVERIFY(count > 0);
+}
@@ -0,0 +1,39 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MAVLinkFrameParserTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkFrameParserTest() = default;
+
+protected:
+    void init() final;
+
+private slots:
+    void _testParseFrames();
+    void _testParseSplitFrames();
+    void _testParseMavlink1();
+    void _testResync();
+    void _benchmarkParseChar();
+    void _benchmarkFrameParser();
+
+private:
+    /// Returns the contents of the tlog pointed to by QGC_BENCHMARK_TLOG, or a synthesized tlog otherwise
+    static QByteArray _benchmarkTlog();
+    static QByteArray _buildStream(int count, bool tlogTimestamps);
+
+    static constexpr uint8_t _parseChannel = MAVLINK_COMM_14;
+    static constexpr uint8_t _packChannel = MAVLINK_COMM_15;
+};
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageDispatcherTest.h"
+#include "MAVLinkMessageDispatcher.h"
+
+#include <QtTest/QTest>
+
+mavlink_message_t MAVLinkMessageDispatcherTest::_message(uint32_t msgid)
+{
+    mavlink_message_t message{};
+    message.msgid = msgid;
+    return message;
+}
+
+void MAVLinkMessageDispatcherTest::_testDispatchByMessageId()
+{
+    MAVLinkMessageDispatcher dispatcher;
+
+    int heartbeatCount = 0;
+    int attitudeCount = 0;
+    int anyCount = 0;
+    int noneCount = 0;
+    dispatcher.subscribe(QStringLiteral("heartbeat"), { MAVLINK_MSG_ID_HEARTBEAT }, [&heartbeatCount](const mavlink_message_t &) { heartbeatCount++; });
+    dispatcher.subscribe(QStringLiteral("attitude"), { MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_ATTITUDE_QUATERNION }, [&attitudeCount](const mavlink_message_t &) { attitudeCount++; });
+    dispatcher.subscribe(QStringLiteral("any"), { MAVLinkMessageDispatcher::kAnyMessageId }, [&anyCount](const mavlink_message_t &) { anyCount++; });
+    dispatcher.subscribe(QStringLiteral("none"), {}, [&noneCount](const mavlink_message_t &) { noneCount++; });
+
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_HEARTBEAT));
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_ATTITUDE));
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_ATTITUDE_QUATERNION));
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_VFR_HUD));
+
+    QCOMPARE(heartbeatCount, 1);
+    QCOMPARE(attitudeCount, 2);
+    QCOMPARE(anyCount, 4);
+    QCOMPARE(noneCount, 0);
+
+    QVERIFY(dispatcher.hasHandlers(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(dispatcher.stats().size(), 3);
+}
+
+void MAVLinkMessageDispatcherTest::_testSubscriptionOrder()
+{
+    MAVLinkMessageDispatcher dispatcher;
+
+    QStringList calls;
+    for (const QString &name : { QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c") }) {
+        const uint32_t msgid = (name == QStringLiteral("b")) ? MAVLinkMessageDispatcher::kAnyMessageId : MAVLINK_MSG_ID_HEARTBEAT;
+        dispatcher.subscribe(name, { msgid }, [&calls, name](const mavlink_message_t &) { calls.append(name); });
+    }
+
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(calls, QStringList({ QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c") }));
+}
+
+void MAVLinkMessageDispatcherTest::_testSubscribeDuringDispatch()
+{
+    MAVLinkMessageDispatcher dispatcher;
+
+    int lateCount = 0;
+    bool subscribed = false;
+    dispatcher.subscribe(QStringLiteral("creator"), { MAVLINK_MSG_ID_BATTERY_STATUS }, [&](const mavlink_message_t &) {
+        if (!subscribed) {
+            subscribed = true;
+            dispatcher.subscribe(QStringLiteral("late"), { MAVLINK_MSG_ID_BATTERY_STATUS }, [&lateCount](const mavlink_message_t &) { lateCount++; });
+        }
+    });
+
+    // The handler subscribed during dispatch receives the message which triggered its creation
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_BATTERY_STATUS));
+    QCOMPARE(lateCount, 1);
+
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_BATTERY_STATUS));
+    QCOMPARE(lateCount, 2);
+}
+
+void MAVLinkMessageDispatcherTest::_testStats()
+{
+    MAVLinkMessageDispatcher dispatcher;
+
+    dispatcher.subscribe(QStringLiteral("heartbeat"), { MAVLINK_MSG_ID_HEARTBEAT }, [](const mavlink_message_t &) {});
+
+    for (int i = 0; i < 5; i++) {
+        dispatcher.dispatch(_message(MAVLINK_MSG_ID_HEARTBEAT));
+        dispatcher.dispatch(_message(MAVLINK_MSG_ID_ATTITUDE));
+    }
+
+    QList<MAVLinkMessageDispatcher::HandlerStats> stats = dispatcher.stats();
+    QCOMPARE(stats.size(), 1);
+    QCOMPARE(stats[0].name, QStringLiteral("heartbeat"));
+    QCOMPARE(stats[0].invocations, static_cast<uint64_t>(5));
+    QVERIFY(stats[0].elapsedNSecs >= 0);
+
+    dispatcher.resetStats();
+    stats = dispatcher.stats();
+    QCOMPARE(stats[0].invocations, static_cast<uint64_t>(0));
+    QCOMPARE(stats[0].elapsedNSecs, static_cast<qint64>(0));
+}
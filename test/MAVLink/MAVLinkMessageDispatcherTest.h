@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MAVLinkMessageDispatcherTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkMessageDispatcherTest() = default;
+
+private slots:
+    void _testDispatchByMessageId();
+    void _testSubscriptionOrder();
+    void _testSubscribeDuringDispatch();
+    void _testStats();
+
+private:
+    static mavlink_message_t _message(uint32_t msgid);
+};
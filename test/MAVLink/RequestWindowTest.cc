@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "RequestWindowTest.h"
+#include "RequestWindow.h"
+
+#include <QtTest/QTest>
+
+namespace {
+    constexpr int kComponentId = 1;
+
+    /// Fills the window and answers every request after rttMs
+    /// @return the time the last response came in
+    qint64 _roundTrip(RequestWindow &window, int &nextIndex, qint64 nowMs, qint64 rttMs)
+    {
+        QList<int> indices;
+        while (window.available() > 0) {
+            window.sent(kComponentId, nextIndex, false, nowMs);
+            indices.append(nextIndex++);
+        }
+        for (const int index : indices) {
+            (void) window.received(kComponentId, index, nowMs + rttMs);
+        }
+        return nowMs + rttMs;
+    }
+}
+
+void RequestWindowTest::_testGrowth()
+{
+    RequestWindow window;
+    QCOMPARE(window.window(), RequestWindow::kInitialWindow);
+    QCOMPARE(window.timeoutMs(), RequestWindow::kInitialTimeoutMs);
+    QCOMPARE(window.nextExpiryMs(), static_cast<qint64>(-1));
+
+    // Slow start doubles the window every round trip on a clean link
+    int nextIndex = 0;
+    qint64 nowMs = _roundTrip(window, nextIndex, 0, 50);
+    QCOMPARE(window.window(), 2 * RequestWindow::kInitialWindow);
+    QCOMPARE(window.srttMs(), 50.);
+    nowMs = _roundTrip(window, nextIndex, nowMs, 50);
+    QCOMPARE(window.window(), 4 * RequestWindow::kInitialWindow);
+
+    for (int i = 0; i < 10; i++) {
+        nowMs = _roundTrip(window, nextIndex, nowMs, 50);
+    }
+    QCOMPARE(window.window(), RequestWindow::kMaxWindow);
+    QCOMPARE(window.inFlight(), 0);
+
+    // Responses which weren't asked for don't count
+    QVERIFY(!window.received(kComponentId, 0, nowMs));
+}
+
+void RequestWindowTest::_testTimeout()
+{
+    RequestWindow window;
+    window.addRttSample(200);
+    QCOMPARE(window.timeoutMs(), 600);      // srtt + 4 * srtt / 2
+    QCOMPARE(window.streamStallMs(), 1200);
+
+    window.sent(kComponentId, 7, false, 1000);
+    window.sent(kComponentId, 8, false, 1100);
+    QVERIFY(window.isInFlight(kComponentId, 7));
+    QCOMPARE(window.nextExpiryMs(), static_cast<qint64>(1600));
+
+    QVERIFY(window.expire(1599).isEmpty());
+    const QList<RequestWindow::Request> expired = window.expire(1600);
+    QCOMPARE(expired.count(), 1);
+    QCOMPARE(expired.first().componentId, kComponentId);
+    QCOMPARE(expired.first().index, 7);
+    QVERIFY(!window.isInFlight(kComponentId, 7));
+    QVERIFY(window.lossRate() > 0);
+
+    // Timeouts back off until the link answers again
+    QCOMPARE(window.timeoutMs(), 1200);
+    QVERIFY(window.received(kComponentId, 8, 1300));
+    QVERIFY(window.timeoutMs() < 1200);
+
+    // Timeouts stay within bounds
+    window.reset();
+    window.addRttSample(1);
+    QCOMPARE(window.timeoutMs(), RequestWindow::kMinTimeoutMs);
+    window.addRttSample(10000);
+    QCOMPARE(window.timeoutMs(), RequestWindow::kMaxTimeoutMs);
+}
+
+void RequestWindowTest::_testNoiseLoss()
+{
+    RequestWindow window;
+    int nextIndex = 0;
+    qint64 nowMs = 0;
+    for (int i = 0; i < 3; i++) {
+        nowMs = _roundTrip(window, nextIndex, nowMs, 50);
+    }
+    const int grownWindow = window.window();
+
+    // Losses while the round trip time is at its floor are only resent
+    window.sent(kComponentId, nextIndex++, false, nowMs);
+    window.sent(kComponentId, nextIndex++, false, nowMs);
+    QCOMPARE(window.expire(nowMs + RequestWindow::kMaxTimeoutMs).count(), 2);
+    QCOMPARE(window.window(), grownWindow);
+}
+
+void RequestWindowTest::_testCongestion()
+{
+    RequestWindow window;
+    int nextIndex = 0;
+    qint64 nowMs = 0;
+    for (int i = 0; i < 3; i++) {
+        nowMs = _roundTrip(window, nextIndex, nowMs, 50);
+    }
+    const int grownWindow = window.window();
+
+    // Requests queue up in the link, the round trip time climbs and the window gives way
+    for (int i = 0; i < 3; i++) {
+        nowMs = _roundTrip(window, nextIndex, nowMs, 400);
+    }
+    const int congestedWindow = window.window();
+    QVERIFY(congestedWindow < grownWindow);
+
+    // Loss on a backed up link halves the window, once per round trip
+    window.sent(kComponentId, nextIndex++, false, nowMs);
+    window.sent(kComponentId, nextIndex++, true, nowMs);
+    QCOMPARE(window.expire(nowMs + RequestWindow::kMaxTimeoutMs).count(), 2);
+    QCOMPARE(window.window(), qMax(RequestWindow::kMinWindow, congestedWindow / 2));
+    window.sent(kComponentId, nextIndex++, false, nowMs);
+    QCOMPARE(window.expire(nowMs + RequestWindow::kMaxTimeoutMs + 1).count(), 1);
+    QCOMPARE(window.window(), qMax(RequestWindow::kMinWindow, congestedWindow / 2));
+}
+
+void RequestWindowTest::_testComponents()
+{
+    RequestWindow window;
+
+    // The same index of different components are different requests
+    window.sent(1, 5, false, 0);
+    window.sent(154, 5, false, 0);
+    QCOMPARE(window.inFlight(), 2);
+    QCOMPARE(window.available(), RequestWindow::kInitialWindow - 2);
+
+    window.cancel(1);
+    QVERIFY(!window.isInFlight(1, 5));
+    QVERIFY(window.isInFlight(154, 5));
+    QVERIFY(window.received(154, 5, 10));
+    QCOMPARE(window.inFlight(), 0);
+}
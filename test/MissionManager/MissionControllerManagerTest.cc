@@ -28,9 +28,16 @@ void MissionControllerManagerTest::cleanup(void)
     UnitTest::cleanup();
 }
 
-void MissionControllerManagerTest::_initForFirmwareType(MAV_AUTOPILOT firmwareType)
+void MissionControllerManagerTest::_initForFirmwareType(MAV_AUTOPILOT firmwareType, bool ftpCapability)
 {
-    _connectMockLink(firmwareType);
+    if (ftpCapability) {
+        MockConfiguration *const mockConfig = new MockConfiguration(QStringLiteral("FTP MockLink"));
+        mockConfig->setFirmwareType(firmwareType);
+        mockConfig->setFtpCapability(true);
+        _connectMockLink(mockConfig);
+    } else {
+        _connectMockLink(firmwareType);
+    }
     
     // Wait for the Mission Manager to finish it's initial load
     
@@ -10,8 +10,10 @@
 
 #include "MissionManagerTest.h"
 #include "MissionManager.h"
+#include "MockLinkFTP.h"
 #include "MultiSignalSpy.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
@@ -355,3 +357,88 @@ void MissionManagerTest::_testErrorAckFailureStrings(void)
     }
 
 }
+
+void MissionManagerTest::_writeBenchmarkItems(void)
+{
+    QList<MissionItem*> missionItems;
+
+    // Editor has a home position item on the front, so we do the same
+    for (int i=0; i<=_benchmarkItemCount; i++) {
+        missionItems.append(new MissionItem(i, MAV_CMD_NAV_WAYPOINT, MAV_FRAME_GLOBAL_RELATIVE_ALT, 0, 0, 0, 0, 47.3769 + (i * 1e-4), 8.549444, 50, true, false, this));
+    }
+
+    _missionManager->writeMissionItems(missionItems);
+    _multiSpyMissionManager->waitForSignalByIndex(sendCompleteSignalIndex, _benchmarkSignalWaitTime);
+    QCOMPARE(_multiSpyMissionManager->checkSignalByMask(sendCompleteSignalMask), true);
+    QCOMPARE(_multiSpyMissionManager->pullBoolFromSignalIndex(sendCompleteSignalIndex), false);
+    _multiSpyMissionManager->clearAllSignals();
+}
+
+void MissionManagerTest::_readBenchmarkItems(const char* readType)
+{
+    _mockLink->resetMissionReadCounts();
+    _mockLink->mockLinkFTP()->resetMissionFileOpenCount();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    _missionManager->loadFromVehicle();
+    _multiSpyMissionManager->waitForSignalByIndex(newMissionItemsAvailableSignalIndex, _benchmarkSignalWaitTime);
+    const qint64 elapsedMs = qMax<qint64>(timer.elapsed(), 1);
+
+    QCOMPARE(_multiSpyMissionManager->checkSignalByMask(newMissionItemsAvailableSignalMask), true);
+    QCOMPARE(_multiSpyMissionManager->getSpyByIndex(errorSignalIndex)->count(), 0);
+    QVERIFY(!_missionManager->inProgress());
+    _multiSpyMissionManager->clearAllSignals();
+
+    int expectedCount = _benchmarkItemCount;
+    if (_mockLink->getFirmwareType() == MAV_AUTOPILOT_ARDUPILOTMEGA) {
+        // Home position at position 0 comes from vehicle
+        expectedCount++;
+    }
+
+    const QList<MissionItem*>& missionItems = _missionManager->missionItems();
+    QCOMPARE(missionItems.count(), expectedCount);
+    for (int i=0; i<missionItems.count(); i++) {
+        QCOMPARE(missionItems[i]->sequenceNumber(), i);
+    }
+
+    qCDebug(UnitTestLog) << readType << "read of" << expectedCount << "items with loss:latency" << _benchmarkLossRate << _benchmarkLatencyMsecs
+                         << "took" << elapsedMs << "msecs," << (expectedCount * 1000.0) / elapsedMs << "items/sec";
+}
+
+void MissionManagerTest::_testReadBenchmarkPX4(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+    _writeBenchmarkItems();
+
+    _mockLink->setMissionLinkQuality(_benchmarkLossRate, _benchmarkLatencyMsecs);
+    _readBenchmarkItems("Sequential");
+    QVERIFY(_mockLink->missionReadRequestCount() >= _benchmarkItemCount);
+    QCOMPARE(_mockLink->maxMissionReadResponsesPending(), 1);
+    QCOMPARE(_mockLink->mockLinkFTP()->missionFileOpenCount(), 0);
+}
+
+void MissionManagerTest::_testReadBenchmarkAPM(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_ARDUPILOTMEGA);
+    _writeBenchmarkItems();
+
+    _mockLink->setMissionLinkQuality(_benchmarkLossRate, _benchmarkLatencyMsecs);
+    _readBenchmarkItems("Pipelined");
+    QVERIFY(_mockLink->missionReadRequestCount() > _benchmarkItemCount);
+    QVERIFY(_mockLink->maxMissionReadResponsesPending() > 1);
+    QCOMPARE(_mockLink->mockLinkFTP()->missionFileOpenCount(), 0);
+}
+
+void MissionManagerTest::_testReadBenchmarkFTP(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_ARDUPILOTMEGA, true /* ftpCapability */);
+    _writeBenchmarkItems();
+
+    _mockLink->setMissionLinkQuality(_benchmarkLossRate, _benchmarkLatencyMsecs);
+    _mockLink->mockLinkFTP()->enableMissionFiles(true);
+    _readBenchmarkItems("FTP");
+    QCOMPARE(_mockLink->missionReadRequestCount(), 0);
+    QCOMPARE(_mockLink->mockLinkFTP()->missionFileOpenCount(), 1);
+}
@@ -24,6 +24,9 @@ private slots:
     void _testReadFailureHandlingPX4(void);
     //void _testReadFailureHandlingAPM(void);
     //void _testErrorAckFailureStrings(void);
+    void _testReadBenchmarkPX4(void);
+    void _testReadBenchmarkAPM(void);
+    void _testReadBenchmarkFTP(void);
 
 private:
     void _testWriteFailureHandlingPX4(void);
@@ -35,7 +38,14 @@ private slots:
     void _writeItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail);
     void _testWriteFailureHandlingWorker(void);
     void _testReadFailureHandlingWorker(void);
+    void _writeBenchmarkItems(void);
+    void _readBenchmarkItems(const char* readType);
     
     static const TestCase_t _rgTestCases[];
     static const size_t     _cTestCases;
+
+    static constexpr int    _benchmarkItemCount =       200;
+    static constexpr double _benchmarkLossRate =        0.1;
+    static constexpr int    _benchmarkLatencyMsecs =    20;
+    static constexpr int    _benchmarkSignalWaitTime =  60000;
 };
@@ -11,8 +11,12 @@
 #include "MultiSignalSpyV2.h"
 #include "MissionManager.h"
 #include "PlanMasterController.h"
+#include "SimpleMissionItem.h"
 #include "Vehicle.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
 #include <QtTest/QTest>
 
 PlanMasterControllerTest::PlanMasterControllerTest(void)
@@ -79,3 +83,67 @@ void PlanMasterControllerTest::_testActiveVehicleChanged(void) {
     // we make sure it does.
     QVERIFY(spyMissionManager.checkOnlySignalByMask(missionManagerErrorSignalMask));
 }
+
+void PlanMasterControllerTest::_verifyLargePlanEditorFacts(void)
+{
+    QmlObjectListModel* visualItems = _masterController->missionController()->visualItems();
+    QCOMPARE(visualItems->count(), _largePlanItemCount + 1);
+
+    // Editor facts are only built for the item being edited
+    for (int i=1; i<visualItems->count(); i++) {
+        SimpleMissionItem* simpleItem = visualItems->value<SimpleMissionItem*>(i);
+        QVERIFY(simpleItem);
+        QCOMPARE(simpleItem->isCurrentItem(), false);
+        QCOMPARE(simpleItem->textFieldFacts()->count(), 0);
+        QCOMPARE(simpleItem->comboboxFacts()->count(), 0);
+    }
+
+    SimpleMissionItem* simpleItem = visualItems->value<SimpleMissionItem*>(1);
+    _masterController->missionController()->setCurrentPlanViewSeqNum(simpleItem->sequenceNumber(), true);
+    QVERIFY(simpleItem->isCurrentItem());
+    QVERIFY(simpleItem->textFieldFacts()->count() != 0);
+
+    _masterController->missionController()->setCurrentPlanViewSeqNum(0, true);
+    QCOMPARE(simpleItem->textFieldFacts()->count(), 0);
+}
+
+void PlanMasterControllerTest::_testLargePlanLoadSave(void)
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    // ArduPilot style text file, planned home position followed by the waypoints
+    const QString waypointsFile = tmpDir.filePath(QStringLiteral("LargePlan.waypoints"));
+    {
+        QFile file(waypointsFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream stream(&file);
+        stream << "QGC WPL 110\n";
+        stream << "0\t1\t0\t16\t0\t0\t0\t0\t47.3769\t8.549444\t400\t1\n";
+        for (int i=1; i<=_largePlanItemCount; i++) {
+            stream << QStringLiteral("%1\t0\t3\t16\t0\t0\t0\t0\t%2\t8.549444\t50\t1\n").arg(i).arg(47.3769 + (i * 1e-5), 0, 'f', 7);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    _masterController->loadFromFile(waypointsFile);
+    qCDebug(UnitTestLog) << "Load of" << _largePlanItemCount << "item text file took" << timer.elapsed() << "msecs";
+    _verifyLargePlanEditorFacts();
+
+    timer.restart();
+    const QByteArray planBytes = _masterController->saveToJson().toJson();
+    qCDebug(UnitTestLog) << "Save of" << _largePlanItemCount << "item plan took" << timer.elapsed() << "msecs";
+
+    const QString planFile = tmpDir.filePath(QStringLiteral("LargePlan.plan"));
+    {
+        QFile file(planFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QCOMPARE(file.write(planBytes), planBytes.size());
+    }
+
+    timer.restart();
+    _masterController->loadFromFile(planFile);
+    qCDebug(UnitTestLog) << "Load of" << _largePlanItemCount << "item plan took" << timer.elapsed() << "msecs";
+    _verifyLargePlanEditorFacts();
+}
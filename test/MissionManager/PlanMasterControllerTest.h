@@ -27,7 +27,12 @@ private slots:
     void _testMissionFileLoad(void);
     void _testMissionPlannerFileLoad(void);
     void _testActiveVehicleChanged(void);
+    void _testLargePlanLoadSave(void);
 
 private:
+    void _verifyLargePlanEditorFacts(void);
+
     PlanMasterController*   _masterController;
+
+    static constexpr int _largePlanItemCount = 10000;
 };
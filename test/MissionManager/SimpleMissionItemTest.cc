@@ -175,6 +175,11 @@ void SimpleMissionItemTest::_testEditorFactsWorker(QGCMAVLink::VehicleClass_t ve
         missionFlightStatus.gimbalPitch     = qQNaN();
         simpleMissionItem.setMissionFlightStatus(missionFlightStatus);
 
+        // Editor facts are only built for the item being edited
+        QCOMPARE(simpleMissionItem.textFieldFacts()->count(), 0);
+        QCOMPARE(simpleMissionItem.nanFacts()->count(), 0);
+        simpleMissionItem.setIsCurrentItem(true);
+
         // Validate that the fact values are correctly returned
 
         int foundTextFieldCount = 0;
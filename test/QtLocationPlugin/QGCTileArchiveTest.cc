@@ -0,0 +1,259 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileArchiveTest.h"
+#include "QGCTileArchive.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtTest/QTest>
+
+namespace {
+    const QByteArray kTileA = QByteArrayLiteral("tile z0");
+    const QByteArray kTileB = QByteArrayLiteral("tile z1 0/0");
+    const QByteArray kTileC = QByteArrayLiteral("tile z1 0/1 and 1/1");
+
+    bool _createMBTiles(const QString &path, const QString &format)
+    {
+        bool result = false;
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", QStringLiteral("QGCTileArchiveTest"));
+            db.setDatabaseName(path);
+            if (db.open()) {
+                QSqlQuery query(db);
+                result = query.exec("CREATE TABLE metadata (name TEXT, value TEXT)")
+                    && query.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)")
+                    && query.exec("INSERT INTO metadata VALUES ('name', 'Test Area')")
+                    && query.exec(QStringLiteral("INSERT INTO metadata VALUES ('format', '%1')").arg(format))
+                    && query.exec("INSERT INTO metadata VALUES ('bounds', '-10.5,-20.25,30,40')");
+
+                struct Tile {
+                    int z;
+                    int x;
+                    int row;        ///< Counted from the bottom
+                    QByteArray data;
+                };
+                const QList<Tile> tiles = {
+                    { 0, 0, 0, kTileA },
+                    { 1, 0, 1, kTileB },
+                    { 1, 0, 0, kTileC },
+                };
+                result = result && query.prepare("INSERT INTO tiles VALUES (?, ?, ?, ?)");
+                for (const Tile &tile : tiles) {
+                    query.addBindValue(tile.z);
+                    query.addBindValue(tile.x);
+                    query.addBindValue(tile.row);
+                    query.addBindValue(tile.data);
+                    result = result && query.exec();
+                }
+            }
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(QStringLiteral("QGCTileArchiveTest"));
+        return result;
+    }
+
+    void _appendVarint(QByteArray &data, quint64 value)
+    {
+        while (value >= 0x80) {
+            data.append(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        data.append(static_cast<char>(value));
+    }
+
+    struct Entry {
+        quint64 tileId;
+        quint64 offset;
+        quint64 length;
+        quint64 runLength;
+    };
+
+    QByteArray _directory(const QList<Entry> &entries, bool compressed)
+    {
+        QByteArray data;
+        _appendVarint(data, entries.size());
+        quint64 lastId = 0;
+        for (const Entry &entry : entries) {
+            _appendVarint(data, entry.tileId - lastId);
+            lastId = entry.tileId;
+        }
+        for (const Entry &entry : entries) {
+            _appendVarint(data, entry.runLength);
+        }
+        for (const Entry &entry : entries) {
+            _appendVarint(data, entry.length);
+        }
+        for (qsizetype i = 0; i < entries.size(); i++) {
+            const bool contiguous = (i > 0) && (entries[i].offset == (entries[i - 1].offset + entries[i - 1].length));
+            _appendVarint(data, contiguous ? 0 : (entries[i].offset + 1));
+        }
+
+        // A zlib stream without the length qCompress puts in front
+        return compressed ? qCompress(data).mid(4) : data;
+    }
+
+    template<typename T>
+    void _put(QByteArray &data, int offset, T value)
+    {
+        qToLittleEndian<T>(value, data.data() + offset);
+    }
+
+    /// Tiles A, B and C, C is stored once and shared by two tiles through a run length
+    bool _createPMTiles(const QString &path, bool leaves, bool compressed)
+    {
+        // Tile IDs z0 = 0, z1 x0 y0 = 1, x0 y1 = 2, x1 y1 = 3, x1 y0 = 4
+        const QList<Entry> entries = {
+            { 0, 0, static_cast<quint64>(kTileA.size()), 1 },
+            { 1, static_cast<quint64>(kTileA.size()), static_cast<quint64>(kTileB.size()), 1 },
+            { 2, static_cast<quint64>(kTileA.size() + kTileB.size()), static_cast<quint64>(kTileC.size()), 2 },
+        };
+        const QByteArray tileData = kTileA + kTileB + kTileC;
+
+        QByteArray root;
+        QByteArray leafData;
+        if (leaves) {
+            leafData = _directory(entries, compressed);
+            root = _directory({ { 0, 0, static_cast<quint64>(leafData.size()), 0 } }, compressed);
+        } else {
+            root = _directory(entries, compressed);
+        }
+        const QByteArray metadataJson = QByteArrayLiteral("{\"name\":\"Test Area\"}");
+        const QByteArray metadata = compressed ? qCompress(metadataJson).mid(4) : metadataJson;
+
+        QByteArray header(127, '\0');
+        (void) header.replace(0, 7, "PMTiles");
+        header[7] = 3;
+        const quint64 rootOffset = 127;
+        const quint64 metadataOffset = rootOffset + root.size();
+        const quint64 leafOffset = metadataOffset + metadata.size();
+        const quint64 tileDataOffset = leafOffset + leafData.size();
+        _put<quint64>(header, 8, rootOffset);
+        _put<quint64>(header, 16, root.size());
+        _put<quint64>(header, 24, metadataOffset);
+        _put<quint64>(header, 32, metadata.size());
+        _put<quint64>(header, 40, leafOffset);
+        _put<quint64>(header, 48, leafData.size());
+        _put<quint64>(header, 56, tileDataOffset);
+        _put<quint64>(header, 64, tileData.size());
+        _put<quint64>(header, 72, 4);
+        _put<quint64>(header, 80, 3);
+        _put<quint64>(header, 88, 3);
+        header[96] = 1;                         // Clustered
+        header[97] = compressed ? 2 : 1;        // Directories gzip or none
+        header[98] = 1;                         // Tiles uncompressed
+        header[99] = 2;                         // png
+        header[100] = 0;
+        header[101] = 1;
+        _put<qint32>(header, 102, -105000000);
+        _put<qint32>(header, 106, -202500000);
+        _put<qint32>(header, 110, 300000000);
+        _put<qint32>(header, 114, 400000000);
+
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        const QByteArray contents = header + root + metadata + leafData + tileData;
+        return (file.write(contents) == contents.size());
+    }
+
+    void _verifyTiles(const QGCTileArchive &archive)
+    {
+        QCOMPARE(archive.info().name, QStringLiteral("Test Area"));
+        QCOMPARE(archive.info().tileFormat, QStringLiteral("png"));
+        QCOMPARE(archive.info().minZoom, 0);
+        QCOMPARE(archive.info().maxZoom, 1);
+        QCOMPARE(archive.info().west, -10.5);
+        QCOMPARE(archive.info().south, -20.25);
+        QCOMPARE(archive.info().east, 30.);
+        QCOMPARE(archive.info().north, 40.);
+
+        QCOMPARE(archive.tile(0, 0, 0), kTileA);
+        QCOMPARE(archive.tile(0, 0, 1), kTileB);
+        QCOMPARE(archive.tile(0, 1, 1), kTileC);
+        QVERIFY(archive.tile(1, 0, 1).isEmpty());
+        QVERIFY(archive.tile(0, 0, 2).isEmpty());
+        QVERIFY(archive.tile(2, 0, 1).isEmpty());
+    }
+}
+
+void QGCTileArchiveTest::_testMBTiles()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("test.mbtiles"));
+    QVERIFY(_createMBTiles(path, QStringLiteral("png")));
+
+    const std::unique_ptr<QGCTileArchive> archive = QGCTileArchive::open(path);
+    QVERIFY(archive);
+    QCOMPARE(archive->format(), QGCTileArchive::Format::MBTiles);
+    QCOMPARE(archive->info().tileCount, static_cast<quint64>(3));
+    _verifyTiles(*archive);
+
+    // Unmount closes the per-thread readers without waiting for the archive to be destroyed
+    const auto archiveConnections = []() {
+        return QSqlDatabase::connectionNames().filter(QStringLiteral("QGCTileArchive_"));
+    };
+    QVERIFY(!archiveConnections().isEmpty());
+    archive->close();
+    QVERIFY(archiveConnections().isEmpty());
+    QVERIFY(archive->tile(0, 0, 0).isEmpty());
+    QVERIFY(archiveConnections().isEmpty());
+
+    // Vector tiles can't be drawn
+    const QString vectorPath = tmpDir.filePath(QStringLiteral("vector.mbtiles"));
+    QVERIFY(_createMBTiles(vectorPath, QStringLiteral("pbf")));
+    QVERIFY(!QGCTileArchive::open(vectorPath));
+}
+
+void QGCTileArchiveTest::_testPMTiles()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("test.pmtiles"));
+    QVERIFY(_createPMTiles(path, false, false));
+
+    const std::unique_ptr<QGCTileArchive> archive = QGCTileArchive::open(path);
+    QVERIFY(archive);
+    QCOMPARE(archive->format(), QGCTileArchive::Format::PMTiles);
+    QCOMPARE(archive->info().tileCount, static_cast<quint64>(4));
+    _verifyTiles(*archive);
+    QCOMPARE(archive->tile(1, 1, 1), kTileC);
+}
+
+void QGCTileArchiveTest::_testPMTilesLeaves()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("leaves.pmtiles"));
+    QVERIFY(_createPMTiles(path, true, true));
+
+    const std::unique_ptr<QGCTileArchive> archive = QGCTileArchive::open(path);
+    QVERIFY(archive);
+    _verifyTiles(*archive);
+    QCOMPARE(archive->tile(1, 1, 1), kTileC);
+}
+
+void QGCTileArchiveTest::_testNotAnArchive()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("test.pmtiles"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(QByteArray(256, 'x')) == 256);
+    file.close();
+
+    QVERIFY(!QGCTileArchive::open(path));
+    QVERIFY(!QGCTileArchive::open(tmpDir.filePath(QStringLiteral("missing.mbtiles"))));
+}
@@ -0,0 +1,96 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileCacheTestHelper.h"
+#include "QGCMapTasks.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCTileCacheWorker.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QSemaphore>
+
+#include <atomic>
+
+namespace QGCTileCacheTestHelper
+{
+
+QString mapType()
+{
+    return UrlFactory::getProviderTypes().constFirst();
+}
+
+QString tileHash(int index)
+{
+    return UrlFactory::getTileHash(mapType(), 1000 + (index % kTilesPerRow), 2000 + (index / kTilesPerRow), 12);
+}
+
+QByteArray tileImage(int index)
+{
+    return QByteArray(1024 + (index % 64), static_cast<char>(index));
+}
+
+bool startWorker(QGCCacheWorker &worker, const QString &databasePath)
+{
+    worker.setDatabaseFile(databasePath);
+    (void) worker.enqueueTask(new QGCMapTask(QGCMapTask::TaskType::taskInit));
+
+    const QDeadlineTimer deadline(kTimeoutMSecs);
+    while (!worker.isValid() && !deadline.hasExpired()) {
+        QThread::msleep(1);
+    }
+
+    return worker.isValid();
+}
+
+void stopWorker(QGCCacheWorker &worker)
+{
+    worker.stop();
+    (void) worker.wait();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+bool saveTiles(QGCCacheWorker &worker, int count, int first)
+{
+    for (int i = first; i < (first + count); i++) {
+        QGCCacheTile *const tile = new QGCCacheTile(tileHash(i), tileImage(i), QStringLiteral("png"), mapType());
+        (void) worker.enqueueTask(new QGCSaveTileTask(tile));
+    }
+
+    // Tasks run in order, once the last tile can be fetched all of them are saved
+    return (fetchTiles(worker, 1, first + count - 1) == 1);
+}
+
+int fetchTiles(QGCCacheWorker &worker, int count, int first)
+{
+    QSemaphore done;
+    std::atomic_int found = 0;
+    for (int i = first; i < (first + count); i++) {
+        const QString hash = tileHash(i);
+        QGCFetchTileTask *const task = new QGCFetchTileTask(hash);
+        (void) QObject::connect(task, &QGCFetchTileTask::tileFetched, task, [&done, &found, hash, i](QGCCacheTile *tile) {
+            if ((tile->hash == hash) && (tile->img == tileImage(i))) {
+                found++;
+            }
+            delete tile;
+            done.release();
+        }, Qt::DirectConnection);
+        (void) QObject::connect(task, &QGCMapTask::error, task, [&done]() {
+            done.release();
+        }, Qt::DirectConnection);
+        (void) worker.enqueueTask(task);
+    }
+
+    (void) done.tryAcquire(count, kTimeoutMSecs);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    return found;
+}
+
+} // namespace QGCTileCacheTestHelper
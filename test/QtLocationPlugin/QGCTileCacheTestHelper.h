@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+class QGCCacheWorker;
+
+/// Tiles and cache worker steps shared by the tile cache tests
+namespace QGCTileCacheTestHelper
+{
+    constexpr int kTilesPerRow = 32;
+    constexpr int kTimeoutMSecs = 10000;
+
+    QString mapType();
+    /// Tiles are laid out kTilesPerRow wide at zoom 12
+    QString tileHash(int index);
+    QByteArray tileImage(int index);
+
+    bool startWorker(QGCCacheWorker &worker, const QString &databasePath);
+    void stopWorker(QGCCacheWorker &worker);
+    /// Saves tiles first to first + count - 1 and waits until they are written
+    bool saveTiles(QGCCacheWorker &worker, int count, int first = 0);
+    /// Fetches tiles first to first + count - 1 and waits for the results
+    ///     @return Number of tiles found with the saved image
+    int fetchTiles(QGCCacheWorker &worker, int count, int first = 0);
+}
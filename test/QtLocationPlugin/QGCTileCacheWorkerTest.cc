@@ -0,0 +1,303 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileCacheWorkerTest.h"
+#include "QGCCachedTileSet.h"
+#include "QGCMapTasks.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCTileCacheTestHelper.h"
+#include "QGCTileCacheWorker.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSet>
+#include <QtCore/QTemporaryDir>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtTest/QTest>
+
+#include <limits>
+
+using namespace QGCTileCacheTestHelper;
+
+namespace {
+    constexpr int kTileCount = 512;
+    constexpr const char *kTestSession = "QGCTileCacheWorkerTestSession";
+}
+
+qint64 QGCTileCacheWorkerTest::_downloadList(QGCCacheWorker &worker, quint64 setID, int count, qint64 afterRowID, QStringList &hashes)
+{
+    QSemaphore done;
+    qint64 lastRowID = -1;
+    hashes.clear();
+    QGCGetTileDownloadListTask *const task = new QGCGetTileDownloadListTask(setID, count, afterRowID);
+    (void) connect(task, &QGCGetTileDownloadListTask::tileListFetched, task, [&done, &lastRowID, &hashes](QQueue<QGCTile*> tiles, qint64 rowID) {
+        for (QGCTile *tile : tiles) {
+            hashes.append(tile->hash);
+            delete tile;
+        }
+        lastRowID = rowID;
+        done.release();
+    }, Qt::DirectConnection);
+    (void) worker.enqueueTask(task);
+
+    (void) done.tryAcquire(1, kTimeoutMSecs);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    return lastRowID;
+}
+
+void QGCTileCacheWorkerTest::_testTileKey()
+{
+    QCOMPARE(QGCCacheWorker::tileKey(0, 0, 0, 0), static_cast<quint64>(0));
+
+    // Largest coordinates at the deepest zoom stay positive as an SQLite integer
+    const int maxCoord = (1 << 23) - 1;
+    const quint64 maxKey = QGCCacheWorker::tileKey(4095, maxCoord, maxCoord, 23);
+    QVERIFY(maxKey <= static_cast<quint64>(std::numeric_limits<qint64>::max()));
+
+    QSet<quint64> keys;
+    for (int provider = 1; provider <= 2; provider++) {
+        for (int z = 0; z <= 23; z += 23) {
+            for (int x = 0; x <= maxCoord; x += maxCoord) {
+                for (int y = 0; y <= maxCoord; y += maxCoord) {
+                    keys.insert(QGCCacheWorker::tileKey(provider, x, y, z));
+                }
+            }
+        }
+    }
+    QCOMPARE(keys.size(), 16);
+}
+
+void QGCTileCacheWorkerTest::_testSaveFetch()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    QGCCacheWorker worker;
+    QVERIFY(startWorker(worker, tmpDir.filePath(QStringLiteral("qgcMapCache.db"))));
+
+    QCOMPARE(fetchTiles(worker, 1), 0);
+    QVERIFY(saveTiles(worker, kTileCount));
+    QCOMPARE(fetchTiles(worker, kTileCount), kTileCount);
+
+    stopWorker(worker);
+}
+
+void QGCTileCacheWorkerTest::_testMigration()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+
+    // Cache written before tiles were keyed by integer
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kTestSession);
+        db.setDatabaseName(databasePath);
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec("CREATE TABLE Tiles (tileID INTEGER PRIMARY KEY NOT NULL, hash TEXT NOT NULL UNIQUE, format TEXT NOT NULL, tile BLOB NULL, size INTEGER, type INTEGER, date INTEGER DEFAULT 0)"));
+        QVERIFY(query.exec("CREATE INDEX hash ON Tiles ( hash, size, type )"));
+        QVERIFY(query.exec("CREATE TABLE TileSets (setID INTEGER PRIMARY KEY NOT NULL, name TEXT NOT NULL UNIQUE, typeStr TEXT, topleftLat REAL DEFAULT 0.0, topleftLon REAL DEFAULT 0.0, bottomRightLat REAL DEFAULT 0.0, bottomRightLon REAL DEFAULT 0.0, minZoom INTEGER DEFAULT 3, maxZoom INTEGER DEFAULT 3, type INTEGER DEFAULT -1, numTiles INTEGER DEFAULT 0, defaultSet INTEGER DEFAULT 0, date INTEGER DEFAULT 0)"));
+        QVERIFY(query.exec("CREATE TABLE SetTiles (setID INTEGER, tileID INTEGER)"));
+        QVERIFY(query.exec("CREATE TABLE TilesDownload (setID INTEGER, hash TEXT NOT NULL UNIQUE, type INTEGER, x INTEGER, y INTEGER, z INTEGER, state INTEGER DEFAULT 0)"));
+        QVERIFY(query.exec("INSERT INTO TileSets(name, defaultSet) VALUES('Default Tile Set', 1)"));
+
+        QVERIFY(db.transaction());
+        QVERIFY(query.prepare("INSERT INTO Tiles(hash, format, tile, size, type) VALUES(?, ?, ?, ?, ?)"));
+        for (int i = 0; i < kTileCount; i++) {
+            query.bindValue(0, tileHash(i));
+            query.bindValue(1, QStringLiteral("png"));
+            query.bindValue(2, tileImage(i));
+            query.bindValue(3, tileImage(i).size());
+            query.bindValue(4, 1);
+            QVERIFY(query.exec());
+        }
+        QVERIFY(query.exec("INSERT INTO SetTiles(setID, tileID) SELECT 1, tileID FROM Tiles"));
+        QVERIFY(db.commit());
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(kTestSession);
+
+    QGCCacheWorker worker;
+    QVERIFY(startWorker(worker, databasePath));
+    QCOMPARE(fetchTiles(worker, kTileCount), kTileCount);
+    stopWorker(worker);
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kTestSession);
+        db.setDatabaseName(databasePath);
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec("PRAGMA user_version") && query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+        QVERIFY(query.exec("SELECT COUNT(*) FROM TileProviders") && query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+        QVERIFY(query.exec("SELECT COUNT(*) FROM SetTiles") && query.next());
+        QCOMPARE(query.value(0).toInt(), kTileCount);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(kTestSession);
+}
+
+void QGCTileCacheWorkerTest::_testMigrationFailure()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+
+    // Old tiles without the TilesDownload table the migration expects
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kTestSession);
+        db.setDatabaseName(databasePath);
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec("CREATE TABLE Tiles (tileID INTEGER PRIMARY KEY NOT NULL, hash TEXT NOT NULL UNIQUE, format TEXT NOT NULL, tile BLOB NULL, size INTEGER, type INTEGER, date INTEGER DEFAULT 0)"));
+        QVERIFY(query.exec("INSERT INTO Tiles(hash, format, tile, size, type) VALUES('1', 'png', NULL, 0, 1)"));
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(kTestSession);
+
+    // Starts over with an empty cache
+    QGCCacheWorker worker;
+    QVERIFY(startWorker(worker, databasePath));
+    QVERIFY(saveTiles(worker, 8));
+    QCOMPARE(fetchTiles(worker, 8), 8);
+    stopWorker(worker);
+
+    // The old one is kept as it was
+    const QStringList backups = QDir(tmpDir.path()).entryList({ QStringLiteral("qgcMapCache.db.*.bak") }, QDir::Files);
+    QCOMPARE(backups.count(), 1);
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kTestSession);
+        db.setDatabaseName(tmpDir.filePath(backups.first()));
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec("SELECT COUNT(*) FROM Tiles WHERE hash = '1'") && query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+        QVERIFY(query.exec("PRAGMA user_version") && query.next());
+        QCOMPARE(query.value(0).toInt(), 0);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(kTestSession);
+}
+
+void QGCTileCacheWorkerTest::_testDownloadResume()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+
+    QGCCacheWorker worker;
+    QVERIFY(startWorker(worker, databasePath));
+
+    QGCCachedTileSet *const set = new QGCCachedTileSet(QStringLiteral("Download"));
+    set->setType(mapType());
+    set->setMapTypeStr(mapType());
+    set->setTopleftLat(47.2);
+    set->setTopleftLon(8.2);
+    set->setBottomRightLat(47.0);
+    set->setBottomRightLon(8.5);
+    set->setMinZoom(14);
+    set->setMaxZoom(14);
+    const QGCTileSet tileCount = UrlFactory::getTileCount(14, 8.2, 47.2, 8.5, 47.0, mapType());
+    const int total = static_cast<int>(tileCount.tileCount);
+    QVERIFY(total > 32);
+
+    QSemaphore created;
+    QGCCreateTileSetTask *const createTask = new QGCCreateTileSetTask(set);
+    (void) connect(createTask, &QGCCreateTileSetTask::tileSetSaved, createTask, [&created]() {
+        created.release();
+    }, Qt::DirectConnection);
+    (void) worker.enqueueTask(createTask);
+    QVERIFY(created.tryAcquire(1, kTimeoutMSecs));
+    const quint64 setID = set->id();
+    delete set;
+
+    // Download the first batch, the list continues after it without tiles being marked
+    QStringList firstHashes;
+    const qint64 rowID = _downloadList(worker, setID, 16, 0, firstHashes);
+    QCOMPARE(firstHashes.size(), 16);
+    for (const QString &hash : std::as_const(firstHashes)) {
+        QGCCacheTile *const tile = new QGCCacheTile(hash, tileImage(0), QStringLiteral("png"), mapType(), setID);
+        (void) worker.enqueueTask(new QGCSaveTileTask(tile));
+    }
+
+    QStringList nextHashes;
+    (void) _downloadList(worker, setID, total, rowID, nextHashes);
+    QCOMPARE(nextHashes.size(), total - 16);
+    stopWorker(worker);
+
+    // Restarted from the beginning only the tiles not saved yet are left
+    QGCCacheWorker restarted;
+    QVERIFY(startWorker(restarted, databasePath));
+    QStringList resumedHashes;
+    (void) _downloadList(restarted, setID, total, 0, resumedHashes);
+    QCOMPARE(resumedHashes, nextHashes);
+    stopWorker(restarted);
+}
+
+void QGCTileCacheWorkerTest::_benchmarkColdRead()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+
+    {
+        QGCCacheWorker worker;
+        QVERIFY(startWorker(worker, databasePath));
+        QVERIFY(saveTiles(worker, kTileCount));
+        stopWorker(worker);
+    }
+
+    // Includes opening the database and preparing statements
+    QBENCHMARK {
+        QGCCacheWorker worker;
+        QVERIFY(startWorker(worker, databasePath));
+        QCOMPARE(fetchTiles(worker, kTileCount), kTileCount);
+        stopWorker(worker);
+    }
+}
+
+void QGCTileCacheWorkerTest::_benchmarkWarmRead()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    QGCCacheWorker worker;
+    QVERIFY(startWorker(worker, tmpDir.filePath(QStringLiteral("qgcMapCache.db"))));
+    QVERIFY(saveTiles(worker, kTileCount));
+    QCOMPARE(fetchTiles(worker, kTileCount), kTileCount);
+
+    QBENCHMARK {
+        (void) fetchTiles(worker, kTileCount);
+    }
+
+    stopWorker(worker);
+}
+
+void QGCTileCacheWorkerTest::_benchmarkSave()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    QGCCacheWorker worker;
+    QVERIFY(startWorker(worker, tmpDir.filePath(QStringLiteral("qgcMapCache.db"))));
+
+    int first = 0;
+    QBENCHMARK {
+        QVERIFY(saveTiles(worker, kTileCount, first));
+        first += kTileCount;
+    }
+
+    QCOMPARE(fetchTiles(worker, first), first);
+
+    stopWorker(worker);
+}
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCCacheWorker;
+
+class QGCTileCacheWorkerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testTileKey();
+    void _testSaveFetch();
+    void _testMigration();
+    void _testMigrationFailure();
+    void _testDownloadResume();
+    void _benchmarkColdRead();
+    void _benchmarkWarmRead();
+    void _benchmarkSave();
+
+private:
+    /// Lists pending tiles of a set after afterRowID
+    ///     @return Row id to continue the list from
+    static qint64 _downloadList(QGCCacheWorker &worker, quint64 setID, int count, qint64 afterRowID, QStringList &hashes);
+};
@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileDownloaderTest.h"
+#include "QGCTile.h"
+#include "QGCTileDownloader.h"
+#include "TestHttpServer.h"
+
+#include <QtTest/QTest>
+
+#include <functional>
+
+namespace {
+    constexpr int kTimeoutMSecs = 20000;
+
+    QString _path(int x, int y, int z)
+    {
+        return QStringLiteral("/%1/%2/%3").arg(z).arg(x).arg(y);
+    }
+
+    QByteArray _tileData(const QString &path)
+    {
+        return (QByteArrayLiteral("tile") + path.toUtf8()).repeated(64);
+    }
+
+    /// Stand-in for a tile provider, serves /z/x/y
+    ///     @param policy HTTP status of a request, attempt counts the earlier requests of the same path
+    TestHttpServer::Handler _tileHandler(const std::function<int(const QString &path, int attempt)> &policy = nullptr)
+    {
+        return [policy](const QString &path, int attempt) {
+            TestHttpServer::Response_t response;
+            response.status = policy ? policy(path, attempt) : 200;
+            response.contentType = "image/png";
+            if (response.status == 200) {
+                response.body = _tileData(path);
+            } else if (response.status == 503) {
+                response.headers.append({ "retry-after", "0" });
+            }
+            return response;
+        };
+    }
+
+    /// Row by row, tile hashes are their paths
+    QList<QGCTile*> _tiles(int width, int height, int z)
+    {
+        QList<QGCTile*> tiles;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                QGCTile *const tile = new QGCTile;
+                tile->x = x;
+                tile->y = y;
+                tile->z = z;
+                tile->hash = _path(x, y, z);
+                tiles.append(tile);
+            }
+        }
+        return tiles;
+    }
+
+    struct Results {
+        QStringList downloaded;
+        QStringList failed;
+        int corrupt = 0;
+    };
+
+    /// @param http2 true: requests go to an HTTP/2 server without TLS, whose tile data doesn't depend on the path
+    void _setup(QGCTileDownloader &downloader, const TestHttpServer &server, Results &results, bool http2 = false)
+    {
+        const QString baseUrl = server.url(QString());
+        downloader.setRequestFactory([baseUrl, http2](const QGCTile &tile) {
+            QNetworkRequest request(QUrl(baseUrl + _path(tile.x, tile.y, tile.z)));
+            if (http2) {
+                request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+            }
+            return request;
+        });
+        (void) QObject::connect(&downloader, &QGCTileDownloader::tileDownloaded, &downloader, [&results, http2](const QString &hash, const QByteArray &data) {
+            results.downloaded.append(hash);
+            if (data != _tileData(http2 ? QString() : hash)) {
+                results.corrupt++;
+            }
+        });
+        (void) QObject::connect(&downloader, &QGCTileDownloader::tileFailed, &downloader, [&results](const QString &hash) {
+            results.failed.append(hash);
+        });
+    }
+}
+
+void QGCTileDownloaderTest::_testDownload()
+{
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    server.setHandler(_tileHandler());
+    server.setDelay(5);
+
+    QGCTileDownloader downloader;
+    Results results;
+    _setup(downloader, server, results);
+    downloader.setConcurrency(2);
+
+    downloader.enqueue(_tiles(16, 8, 10));
+    QTRY_VERIFY_WITH_TIMEOUT(downloader.isIdle(), kTimeoutMSecs);
+
+    QCOMPARE(results.downloaded.size(), 16 * 8);
+    QCOMPARE(results.failed.size(), 0);
+    QCOMPARE(results.corrupt, 0);
+    QCOMPARE(downloader.stats().downloaded, static_cast<uint64_t>(16 * 8));
+
+    // Quick replies raise the limit, up to what an HTTP/1.1 provider takes
+    QVERIFY(downloader.concurrency() > 2);
+    QVERIFY(server.maxInFlight() <= 6);
+    QVERIFY(!downloader.http2());
+}
+
+void QGCTileDownloaderTest::_testZOrder()
+{
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    server.setHandler(_tileHandler());
+
+    QGCTileDownloader downloader;
+    Results results;
+    _setup(downloader, server, results);
+    downloader.setConcurrency(1, 1, 1);
+
+    downloader.enqueue(_tiles(4, 4, 2));
+    QTRY_VERIFY_WITH_TIMEOUT(downloader.isIdle(), kTimeoutMSecs);
+
+    const QStringList expected = {
+        _path(0, 0, 2), _path(1, 0, 2), _path(0, 1, 2), _path(1, 1, 2),
+        _path(2, 0, 2), _path(3, 0, 2), _path(2, 1, 2), _path(3, 1, 2),
+        _path(0, 2, 2), _path(1, 2, 2), _path(0, 3, 2), _path(1, 3, 2),
+        _path(2, 2, 2), _path(3, 2, 2), _path(2, 3, 2), _path(3, 3, 2),
+    };
+    QCOMPARE(server.requests(), expected);
+    QCOMPARE(results.downloaded, expected);
+}
+
+void QGCTileDownloaderTest::_testRetry()
+{
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    // Every tile is throttled once
+    server.setHandler(_tileHandler([](const QString &, int attempt) {
+        return (attempt == 0) ? 503 : 200;
+    }));
+
+    QGCTileDownloader downloader;
+    Results results;
+    _setup(downloader, server, results);
+
+    downloader.enqueue(_tiles(8, 8, 10));
+    QTRY_VERIFY_WITH_TIMEOUT(downloader.isIdle(), kTimeoutMSecs);
+
+    QCOMPARE(results.downloaded.size(), 64);
+    QCOMPARE(results.failed.size(), 0);
+    QCOMPARE(results.corrupt, 0);
+    QCOMPARE(downloader.stats().retried, static_cast<uint64_t>(64));
+    QCOMPARE(server.requests().size(), 128);
+}
+
+void QGCTileDownloaderTest::_testFailure()
+{
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    server.setDelay(60);
+    // Missing tiles fail at once, a provider that stays overloaded is given up on
+    server.setHandler(_tileHandler([](const QString &path, int) {
+        return path.endsWith(QStringLiteral("/0")) ? 404 : 503;
+    }));
+
+    QGCTileDownloader downloader;
+    Results results;
+    _setup(downloader, server, results);
+    downloader.setConcurrency(6, 1, 6);
+
+    downloader.enqueue(_tiles(4, 4, 10));
+    QTRY_VERIFY_WITH_TIMEOUT(downloader.isIdle(), kTimeoutMSecs);
+
+    QCOMPARE(results.downloaded.size(), 0);
+    QCOMPARE(results.failed.size(), 16);
+    QCOMPARE(downloader.stats().retried, static_cast<uint64_t>(12 * 4));
+    QCOMPARE(server.requests().count(_path(1, 0, 10)), 1);
+    QCOMPARE(server.requests().count(_path(1, 1, 10)), 5);
+    QVERIFY(downloader.concurrency() < 6);
+}
+
+void QGCTileDownloaderTest::_testHttp2()
+{
+    TestHttpServer server;
+    server.setHttp2(true);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    server.setHandler(_tileHandler());
+    server.setDelay(5);
+
+    QGCTileDownloader downloader;
+    Results results;
+    _setup(downloader, server, results, true /* http2 */);
+    downloader.setConcurrency(4);
+
+    downloader.enqueue(_tiles(16, 16, 10));
+    QTRY_VERIFY_WITH_TIMEOUT(downloader.isIdle(), kTimeoutMSecs);
+
+    QCOMPARE(results.downloaded.size(), 16 * 16);
+    QCOMPARE(results.failed.size(), 0);
+    QCOMPARE(results.corrupt, 0);
+    QVERIFY(downloader.http2());
+    QCOMPARE(downloader.stats().http2, static_cast<uint64_t>(16 * 16));
+
+    // Multiplexed requests aren't held to the HTTP/1.1 connection count
+    QVERIFY(downloader.concurrency() > 6);
+    QVERIFY(server.maxInFlight() > 6);
+}
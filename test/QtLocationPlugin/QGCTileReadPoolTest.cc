@@ -0,0 +1,286 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileReadPoolTest.h"
+#include "QGCMapTasks.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCTileCacheTestHelper.h"
+#include "QGCTileCacheWorker.h"
+#include "QGCTileReadPool.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <atomic>
+
+using namespace QGCTileCacheTestHelper;
+
+namespace {
+    constexpr int kTileCount = 512;
+
+    struct FetchResults {
+        QSemaphore done;
+        std::atomic_int found = 0;
+        QMutex mutex;
+        QStringList order;      ///< Hashes in the order they were answered
+    };
+
+    QGCFetchTileTask *_fetchTask(int index, FetchResults &results)
+    {
+        const QString hash = tileHash(index);
+        QGCFetchTileTask *const task = new QGCFetchTileTask(hash);
+        (void) QObject::connect(task, &QGCFetchTileTask::tileFetched, task, [&results, hash, index](QGCCacheTile *tile) {
+            if ((tile->hash == hash) && (tile->img == tileImage(index))) {
+                results.found++;
+            }
+            delete tile;
+            {
+                QMutexLocker lock(&results.mutex);
+                results.order.append(hash);
+            }
+            results.done.release();
+        }, Qt::DirectConnection);
+        (void) QObject::connect(task, &QGCMapTask::error, task, [&results, hash]() {
+            {
+                QMutexLocker lock(&results.mutex);
+                results.order.append(hash);
+            }
+            results.done.release();
+        }, Qt::DirectConnection);
+        return task;
+    }
+
+    bool _createCache(const QString &databasePath)
+    {
+        QGCCacheWorker worker;
+        const bool saved = startWorker(worker, databasePath) && saveTiles(worker, kTileCount);
+        stopWorker(worker);
+        return saved;
+    }
+}
+
+void QGCTileReadPoolTest::_testFetch()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+    QVERIFY(_createCache(databasePath));
+
+    QGCTileReadPool pool;
+    pool.start(databasePath);
+    QVERIFY(pool.isRunning());
+
+    FetchResults results;
+    for (int i = 0; i < kTileCount; i++) {
+        pool.enqueueTask(_fetchTask(i, results));
+    }
+    // Not in the cache
+    pool.enqueueTask(_fetchTask(kTileCount, results));
+
+    QVERIFY(results.done.tryAcquire(kTileCount + 1, kTimeoutMSecs));
+    QCOMPARE(results.found.load(), kTileCount);
+    QCOMPARE(pool.stats().fetched, static_cast<uint64_t>(kTileCount));
+    QCOMPARE(pool.stats().missed, static_cast<uint64_t>(1));
+
+    pool.stop();
+    QVERIFY(!pool.isRunning());
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void QGCTileReadPoolTest::_testViewportPriority()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+    QVERIFY(_createCache(databasePath));
+
+    // Viewport centered on tile 272, queued before the reader starts so the whole queue is ordered
+    constexpr int center = (8 * kTilesPerRow) + 16;
+    QGCTileReadPool pool;
+    pool.setViewport(UrlFactory::hashFromProviderType(mapType()), 12, 1000 + 16 + 0.5, 2000 + 8 + 0.5);
+
+    FetchResults results;
+    const QList<int> queued = { 0, center + 2, kTileCount - 1, center, center + 1 };
+    for (const int index : queued) {
+        pool.enqueueTask(_fetchTask(index, results));
+    }
+
+    pool.start(databasePath, 1);
+    QVERIFY(results.done.tryAcquire(queued.size(), kTimeoutMSecs));
+
+    const QStringList expected = { tileHash(center), tileHash(center + 1), tileHash(center + 2), tileHash(kTileCount - 1), tileHash(0) };
+    QCOMPARE(results.order, expected);
+
+    pool.stop();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void QGCTileReadPoolTest::_testCancel()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+    QVERIFY(_createCache(databasePath));
+
+    QGCTileReadPool pool;
+    FetchResults results;
+    for (int i = 0; i < kTileCount; i++) {
+        QGCFetchTileTask *const task = _fetchTask(i, results);
+        // Scrolled out of view before it was read
+        if ((i % 2) == 0) {
+            task->cancel();
+        }
+        pool.enqueueTask(task);
+    }
+
+    pool.start(databasePath);
+    QVERIFY(results.done.tryAcquire(kTileCount / 2, kTimeoutMSecs));
+
+    const QDeadlineTimer deadline(kTimeoutMSecs);
+    while ((pool.stats().cancelled < static_cast<uint64_t>(kTileCount / 2)) && !deadline.hasExpired()) {
+        QThread::msleep(1);
+    }
+    QCOMPARE(pool.stats().cancelled, static_cast<uint64_t>(kTileCount / 2));
+    QCOMPARE(results.found.load(), kTileCount / 2);
+    QCOMPARE(results.done.available(), 0);
+
+    pool.stop();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void QGCTileReadPoolTest::_testReadWhileWriting()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+
+    QGCCacheWorker worker;
+    QVERIFY(startWorker(worker, databasePath));
+    QVERIFY(saveTiles(worker, kTileCount));
+
+    QGCTileReadPool pool;
+    pool.start(databasePath);
+
+    // Readers are not held up by the writer
+    FetchResults results;
+    for (int i = kTileCount; i < (kTileCount * 4); i++) {
+        QGCCacheTile *const tile = new QGCCacheTile(tileHash(i), tileImage(i), QStringLiteral("png"), mapType());
+        (void) worker.enqueueTask(new QGCSaveTileTask(tile));
+    }
+    for (int i = 0; i < kTileCount; i++) {
+        pool.enqueueTask(_fetchTask(i, results));
+    }
+    QVERIFY(results.done.tryAcquire(kTileCount, kTimeoutMSecs));
+    QCOMPARE(results.found.load(), kTileCount);
+
+    // Tiles written since the readers connected are seen by them
+    QVERIFY(saveTiles(worker, 1, kTileCount * 4));
+    FetchResults newResults;
+    pool.enqueueTask(_fetchTask(kTileCount * 4, newResults));
+    QVERIFY(newResults.done.tryAcquire(1, kTimeoutMSecs));
+    QCOMPARE(newResults.found.load(), 1);
+
+    pool.stop();
+    stopWorker(worker);
+}
+
+void QGCTileReadPoolTest::_testImportReplace()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+    const QString importPath = tmpDir.filePath(QStringLiteral("import.db"));
+
+    {
+        QGCCacheWorker worker;
+        QVERIFY(startWorker(worker, importPath));
+        QVERIFY(saveTiles(worker, kTileCount, kTileCount));
+        stopWorker(worker);
+    }
+
+    QGCTileReadPool pool;
+    QGCCacheWorker worker;
+    worker.setReadPool(&pool);
+    QVERIFY(startWorker(worker, databasePath));
+    QVERIFY(saveTiles(worker, kTileCount));
+    pool.start(databasePath);
+
+    FetchResults results;
+    for (int i = 0; i < kTileCount; i++) {
+        pool.enqueueTask(_fetchTask(i, results));
+    }
+    QVERIFY(results.done.tryAcquire(kTileCount, kTimeoutMSecs));
+    QCOMPARE(results.found.load(), kTileCount);
+
+    QSemaphore imported;
+    QGCImportTileTask *const importTask = new QGCImportTileTask(importPath, true);
+    (void) connect(importTask, &QGCImportTileTask::actionProgress, importTask, [&imported](int percentage) {
+        if (percentage == 100) {
+            imported.release();
+        }
+    }, Qt::DirectConnection);
+    (void) worker.enqueueTask(importTask);
+    QVERIFY(imported.tryAcquire(1, kTimeoutMSecs));
+
+    // Readers reconnected to the replaced file
+    FetchResults importedResults;
+    for (int i = kTileCount; i < (kTileCount * 2); i++) {
+        pool.enqueueTask(_fetchTask(i, importedResults));
+    }
+    QVERIFY(importedResults.done.tryAcquire(kTileCount, kTimeoutMSecs));
+    QCOMPARE(importedResults.found.load(), kTileCount);
+    QCOMPARE(fetchTiles(worker, kTileCount, kTileCount), kTileCount);
+
+    // Nothing of the old database is left, neither in the file nor in its WAL
+    FetchResults oldResults;
+    for (int i = 0; i < kTileCount; i++) {
+        pool.enqueueTask(_fetchTask(i, oldResults));
+    }
+    QVERIFY(oldResults.done.tryAcquire(kTileCount, kTimeoutMSecs));
+    QCOMPARE(oldResults.found.load(), 0);
+
+    pool.stop();
+    stopWorker(worker);
+}
+
+void QGCTileReadPoolTest::_benchmark(int readerCount)
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString databasePath = tmpDir.filePath(QStringLiteral("qgcMapCache.db"));
+    QVERIFY(_createCache(databasePath));
+
+    QGCTileReadPool pool;
+    pool.start(databasePath, readerCount);
+
+    QBENCHMARK {
+        FetchResults results;
+        for (int i = 0; i < kTileCount; i++) {
+            pool.enqueueTask(_fetchTask(i, results));
+        }
+        QVERIFY(results.done.tryAcquire(kTileCount, kTimeoutMSecs));
+    }
+
+    pool.stop();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void QGCTileReadPoolTest::_benchmarkOneReader()
+{
+    _benchmark(1);
+}
+
+void QGCTileReadPoolTest::_benchmarkFourReaders()
+{
+    _benchmark(4);
+}
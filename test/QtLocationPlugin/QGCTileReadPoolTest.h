@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCTileReadPoolTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testFetch();
+    void _testViewportPriority();
+    void _testCancel();
+    void _testReadWhileWriting();
+    void _testImportReplace();
+    void _benchmarkOneReader();
+    void _benchmarkFourReaders();
+
+private:
+    void _benchmark(int readerCount);
+};
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainPathProfileTest.h"
+#include "TerrainPathProfile.h"
+#include "TerrainQueryInterface.h"
+#include "TerrainTestTiles.h"
+#include "TerrainTileCache.h"
+#include "TerrainTileManager.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+    constexpr double kSpacing = 30.;
+    const QGeoCoordinate kStart(47.3977, 8.5456);
+}
+
+void TerrainPathProfileTest::_testLayout()
+{
+    QVERIFY(TerrainPathProfile::layout({}, kSpacing).segments.isEmpty());
+    QVERIFY(TerrainPathProfile::layout({ kStart }, kSpacing).heights.isEmpty());
+
+    const QList<QGeoCoordinate> polyPath = {
+        kStart,
+        kStart.atDistanceAndAzimuth(100., 90.),
+        kStart.atDistanceAndAzimuth(100., 90.),     // Zero length
+        kStart.atDistanceAndAzimuth(1000., 45.),
+    };
+    const TerrainPathProfile profile = TerrainPathProfile::layout(polyPath, kSpacing);
+    QCOMPARE(profile.segments.count(), polyPath.count() - 1);
+
+    qsizetype first = 0;
+    for (qsizetype i = 0; i < profile.segments.count(); i++) {
+        const TerrainPathProfile::Segment &segment = profile.segments[i];
+        QCOMPARE(segment.first, first);
+        QVERIFY(segment.count >= 2);
+        // At most one spacing apart, the last step makes up the rest
+        QVERIFY(segment.distanceBetween <= (kSpacing + 0.01));
+        QVERIFY(segment.finalDistanceBetween <= (kSpacing + 0.01));
+        first += segment.count;
+    }
+    QCOMPARE(profile.heights.count(), first);
+    QVERIFY(qIsNaN(profile.heights.first()));
+
+    QCOMPARE(profile.segments[0].count, static_cast<qsizetype>(5));
+    QCOMPARE(profile.segments[1].count, static_cast<qsizetype>(2));
+    QCOMPARE(profile.segments[1].distanceBetween, 0.);
+}
+
+void TerrainPathProfileTest::_testSegmentCoordinates()
+{
+    const QGeoCoordinate end = kStart.atDistanceAndAzimuth(250., 30.);
+    const TerrainPathProfile profile = TerrainPathProfile::layout({ kStart, end }, kSpacing);
+    const qsizetype count = profile.segments.first().count;
+
+    QList<double> latitudes(count);
+    QList<double> longitudes(count);
+    TerrainPathProfile::segmentCoordinates(kStart, end, count, latitudes.data(), longitudes.data());
+
+    QCOMPARE(latitudes.first(), kStart.latitude());
+    QCOMPARE(longitudes.first(), kStart.longitude());
+    QCOMPARE(latitudes.last(), end.latitude());
+    QCOMPARE(longitudes.last(), end.longitude());
+
+    const QGeoCoordinate second(latitudes[1], longitudes[1]);
+    QVERIFY(qAbs(kStart.distanceTo(second) - profile.segments.first().distanceBetween) < 0.001);
+    const QGeoCoordinate secondLast(latitudes[count - 2], longitudes[count - 2]);
+    QVERIFY(qAbs(secondLast.distanceTo(end) - profile.segments.first().finalDistanceBetween) < 0.001);
+}
+
+void TerrainPathProfileTest::_testTasks()
+{
+    TerrainPathProfile profile;
+    const QList<qsizetype> counts = { 5, 2, 2, 3 };
+    qsizetype first = 0;
+    for (const qsizetype count : counts) {
+        TerrainPathProfile::Segment segment;
+        segment.first = first;
+        segment.count = count;
+        profile.segments.append(segment);
+        first += count;
+    }
+
+    // Whole segments only, the last task takes what is left
+    const QList<TerrainPathProfile::Task> tasks = profile.tasks(4);
+    QCOMPARE(tasks.count(), 3);
+    QCOMPARE(tasks[0].firstSegment, static_cast<qsizetype>(0));
+    QCOMPARE(tasks[0].endSegment, static_cast<qsizetype>(1));
+    QCOMPARE(tasks[1].firstSegment, static_cast<qsizetype>(1));
+    QCOMPARE(tasks[1].endSegment, static_cast<qsizetype>(3));
+    QCOMPARE(tasks[2].firstSegment, static_cast<qsizetype>(3));
+    QCOMPARE(tasks[2].endSegment, static_cast<qsizetype>(4));
+
+    QCOMPARE(profile.tasks(first).count(), 1);
+    QCOMPARE(profile.tasks(first + 1).count(), 1);
+    QVERIFY(TerrainPathProfile().tasks(4).isEmpty());
+}
+
+void TerrainPathProfileTest::_testParallelProfile()
+{
+    // Back and forth over a few tiles, enough heights to be split across the thread pool
+    QList<QGeoCoordinate> polyPath;
+    for (int i = 0; i < 80; i++) {
+        polyPath.append(kStart.atDistanceAndAzimuth((i % 2) ? 2500. : 0., 60.).atDistanceAndAzimuth(i * 10., 150.));
+    }
+
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    TerrainTileManager manager;
+    QVERIFY(manager.openDiskCache(tmpDir.filePath(QStringLiteral("TerrainTiles.bin"))));
+    for (const QPoint &tile : TerrainTestTiles::tilesAround(polyPath)) {
+        QVERIFY(TerrainTestTiles::insertTile(*manager.diskCache(), tile));
+    }
+
+    TerrainPathProfile profile;
+    bool error = true;
+    QVERIFY(manager.getPathProfile(polyPath, profile, error));
+    QVERIFY(!error);
+    QVERIFY(profile.tasks(TerrainTileManager::kMinPathProfileTaskSize).count() > 1);
+    QCOMPARE(profile.segments.count(), polyPath.count() - 1);
+
+    // Same heights as looking up every coordinate on its own
+    for (qsizetype i = 0; i < profile.segments.count(); i++) {
+        const qsizetype count = profile.segments[i].count;
+        QList<double> latitudes(count);
+        QList<double> longitudes(count);
+        TerrainPathProfile::segmentCoordinates(polyPath[i], polyPath[i + 1], count, latitudes.data(), longitudes.data());
+        QList<QGeoCoordinate> coordinates;
+        for (qsizetype j = 0; j < count; j++) {
+            coordinates.append(QGeoCoordinate(latitudes[j], longitudes[j]));
+        }
+
+        QList<double> altitudes;
+        QVERIFY(manager.getAltitudesForCoordinates(coordinates, altitudes, error));
+        QVERIFY(!error);
+        QCOMPARE(profile.segmentHeightList(i), altitudes);
+    }
+}
+
+void TerrainPathProfileTest::_testMissingTile()
+{
+    const QList<QGeoCoordinate> polyPath = { kStart, kStart.atDistanceAndAzimuth(3000., 90.) };
+    const QList<QPoint> tiles = TerrainTestTiles::tilesAround(polyPath);
+    QVERIFY(tiles.count() > 1);
+
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    TerrainTileManager manager;
+    QVERIFY(manager.openDiskCache(tmpDir.filePath(QStringLiteral("TerrainTiles.bin"))));
+    for (qsizetype i = 1; i < tiles.count(); i++) {
+        QVERIFY(TerrainTestTiles::insertTile(*manager.diskCache(), tiles[i]));
+    }
+
+    // The query waits for the tile to be downloaded
+    TerrainOfflineQuery query;
+    QSignalSpy polyPathSpy(&query, &TerrainQueryInterface::polyPathHeightsReceived);
+    manager.addPolyPathQuery(&query, polyPath);
+    QCOMPARE(polyPathSpy.count(), 0);
+
+    TerrainPathProfile profile;
+    bool error = true;
+    QVERIFY(!manager.getPathProfile(polyPath, profile, error));
+    QVERIFY(!error);
+
+    QVERIFY(TerrainTestTiles::insertTile(*manager.diskCache(), tiles.first()));
+    QVERIFY(manager.getPathProfile(polyPath, profile, error));
+    QVERIFY(!error);
+    for (const double height : profile.heights) {
+        QVERIFY(!qIsNaN(height));
+    }
+}
+
+void TerrainPathProfileTest::_testMatchesPathQuery()
+{
+    const QList<QGeoCoordinate> polyPath = {
+        kStart,
+        kStart.atDistanceAndAzimuth(1500., 90.),
+        kStart.atDistanceAndAzimuth(1500., 90.),     // Zero length
+        kStart.atDistanceAndAzimuth(2500., 30.),
+        kStart.atDistanceAndAzimuth(40., 200.),
+    };
+
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    TerrainTileManager manager;
+    QVERIFY(manager.openDiskCache(tmpDir.filePath(QStringLiteral("TerrainTiles.bin"))));
+    for (const QPoint &tile : TerrainTestTiles::tilesAround(polyPath)) {
+        QVERIFY(TerrainTestTiles::insertTile(*manager.diskCache(), tile));
+    }
+
+    TerrainOfflineQuery polyPathQuery;
+    QSignalSpy polyPathSpy(&polyPathQuery, &TerrainQueryInterface::polyPathHeightsReceived);
+    manager.addPolyPathQuery(&polyPathQuery, polyPath);
+    QCOMPARE(polyPathSpy.count(), 1);
+    QVERIFY(polyPathSpy.first()[0].toBool());
+    const TerrainPathProfile profile = polyPathSpy.first()[1].value<TerrainPathProfile>();
+    QCOMPARE(profile.segments.count(), polyPath.count() - 1);
+
+    // Each segment matches a path query between its end points
+    for (qsizetype i = 0; i < profile.segments.count(); i++) {
+        TerrainOfflineQuery pathQuery;
+        QSignalSpy pathSpy(&pathQuery, &TerrainQueryInterface::pathHeightsReceived);
+        manager.addPathQuery(&pathQuery, polyPath[i], polyPath[i + 1]);
+        QCOMPARE(pathSpy.count(), 1);
+        QVERIFY(pathSpy.first()[0].toBool());
+        QCOMPARE(pathSpy.first()[1].toDouble(), profile.segments[i].distanceBetween);
+        QCOMPARE(pathSpy.first()[2].toDouble(), profile.segments[i].finalDistanceBetween);
+        QCOMPARE(pathSpy.first()[3].value<QList<double>>(), profile.segmentHeightList(i));
+    }
+}
@@ -0,0 +1,165 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainRegionDownloadTest.h"
+#include "TerrainRegionDownload.h"
+#include "TerrainTestTiles.h"
+#include "TerrainTile.h"
+#include "TerrainTileCache.h"
+#include "ElevationMapProvider.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCTile.h"
+#include "TestHttpServer.h"
+
+#include <QtCore/QSet>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtMath>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+    constexpr int kTimeoutMSecs = 20000;
+
+    /// Stand-in for the Copernicus terrain server, serves /x/y with TerrainTestTiles
+    ///     @param missing Paths answered with 404
+    TestHttpServer::Handler _terrainHandler(const QSet<QString> &missing)
+    {
+        return [&missing](const QString &path, int) {
+            TestHttpServer::Response_t response;
+            const QStringList parts = path.split('/', Qt::SkipEmptyParts);
+            if (!missing.contains(path) && (parts.count() == 2)) {
+                response.status = 200;
+                response.body = TerrainTestTiles::tileJson(parts[0].toInt(), parts[1].toInt());
+            }
+            response.contentType = "application/json";
+            return response;
+        };
+    }
+
+    void _setup(TerrainRegionDownload &download, const TestHttpServer &server, TerrainTileDiskCache &diskCache)
+    {
+        const QString baseUrl = server.url(QString());
+        download.setDiskCache(&diskCache);
+        download.setRequestFactory([baseUrl](const QGCTile &tile) {
+            return QNetworkRequest(QUrl(baseUrl + QStringLiteral("/%1/%2").arg(tile.x).arg(tile.y)));
+        });
+    }
+
+    /// Triangle over a few dozen tiles near Zurich
+    const QList<QGeoCoordinate> kTriangle = {
+        QGeoCoordinate(47.3005, 8.5005),
+        QGeoCoordinate(47.3005, 8.5597),
+        QGeoCoordinate(47.3597, 8.5005),
+    };
+}
+
+void TerrainRegionDownloadTest::_testTilesForPolygon()
+{
+    QVERIFY(TerrainRegionDownload::tilesForPolygon({ kTriangle[0], kTriangle[1] }).isEmpty());
+
+    // Inside a single tile
+    const QList<QPoint> single = TerrainRegionDownload::tilesForPolygon({
+        QGeoCoordinate(47.3012, 8.5012), QGeoCoordinate(47.3012, 8.5018), QGeoCoordinate(47.3018, 8.5012)
+    });
+    QCOMPARE(single.count(), 1);
+    QCOMPARE(single.first(), QPoint(qFloor((8.5012 + 180.0) / 0.01), qFloor((47.3012 + 90.0) / 0.01)));
+
+    // Six rows of six down to one tile, the corner away from the right angle is left out
+    const QList<QPoint> tiles = TerrainRegionDownload::tilesForPolygon(kTriangle);
+    QCOMPARE(tiles.count(), 6 + 6 + 5 + 4 + 3 + 2);
+    QSet<qint64> unique;
+    for (const QPoint &tile : tiles) {
+        unique.insert((static_cast<qint64>(tile.x()) << 32) | tile.y());
+    }
+    QCOMPARE(unique.count(), tiles.count());
+
+    const QPoint southWest = single.first();
+    QVERIFY(tiles.contains(southWest));
+    QVERIFY(tiles.contains(southWest + QPoint(5, 0)));
+    QVERIFY(tiles.contains(southWest + QPoint(0, 5)));
+    QVERIFY(!tiles.contains(southWest + QPoint(5, 5)));
+}
+
+void TerrainRegionDownloadTest::_testDownload()
+{
+    const QSet<QString> missing;
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    server.setHandler(_terrainHandler(missing));
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    TerrainTileDiskCache diskCache;
+    QVERIFY(diskCache.open(tmpDir.filePath(QStringLiteral("TerrainTiles.bin"))));
+
+    TerrainRegionDownload download;
+    _setup(download, server, diskCache);
+    QSignalSpy finishedSpy(&download, &TerrainRegionDownload::finished);
+
+    QVERIFY(download.start(kTriangle));
+    QVERIFY(download.isRunning());
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, kTimeoutMSecs);
+    QCOMPARE(finishedSpy.first().first().toBool(), true);
+
+    const int tileCount = download.tileCount();
+    QCOMPARE(download.savedCount(), tileCount);
+    QCOMPARE(download.failedCount(), 0);
+    QCOMPARE(diskCache.count(), static_cast<qsizetype>(tileCount));
+
+    // Stored as elevation grids which terrain queries read directly
+    const QPoint tile = TerrainRegionDownload::tilesForPolygon(kTriangle).first();
+    const int mapId = UrlFactory::getQtMapIdFromProviderType(CopernicusElevationProvider::kProviderKey);
+    const QByteArray data = diskCache.find(TerrainTileCache::tileKey(mapId, tile.x(), tile.y(), 1));
+    QVERIFY(!data.isEmpty());
+    const TerrainTile terrainTile(data);
+    QVERIFY(terrainTile.isValid());
+    QCOMPARE(terrainTile.avgElevation(), static_cast<double>(TerrainTestTiles::elevation(tile.x(), tile.y())));
+
+    // Everything is stored already
+    const qsizetype requestCount = server.requests().count();
+    finishedSpy.clear();
+    QVERIFY(download.start(kTriangle));
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.first().first().toBool(), true);
+    QCOMPARE(download.skippedCount(), tileCount);
+    QCOMPARE(server.requests().count(), requestCount);
+}
+
+void TerrainRegionDownloadTest::_testFailure()
+{
+    const QList<QPoint> tiles = TerrainRegionDownload::tilesForPolygon(kTriangle);
+
+    QSet<QString> missing = { QStringLiteral("/%1/%2").arg(tiles[3].x()).arg(tiles[3].y()) };
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    server.setHandler(_terrainHandler(missing));
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    TerrainTileDiskCache diskCache;
+    QVERIFY(diskCache.open(tmpDir.filePath(QStringLiteral("TerrainTiles.bin"))));
+
+    TerrainRegionDownload download;
+    _setup(download, server, diskCache);
+    QSignalSpy finishedSpy(&download, &TerrainRegionDownload::finished);
+
+    QVERIFY(download.start(kTriangle));
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, kTimeoutMSecs);
+    QCOMPARE(finishedSpy.first().first().toBool(), false);
+    QCOMPARE(download.failedCount(), 1);
+    QCOMPARE(download.savedCount(), tiles.count() - 1);
+
+    // A second run only fetches the missing tile
+    missing.clear();
+    const qsizetype requestCount = server.requests().count();
+    finishedSpy.clear();
+    QVERIFY(download.start(kTriangle));
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, kTimeoutMSecs);
+    QCOMPARE(finishedSpy.first().first().toBool(), true);
+    QCOMPARE(download.savedCount(), 1);
+    QCOMPARE(server.requests().count(), requestCount + 1);
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTestTiles.h"
+#include "TerrainTileCache.h"
+#include "TerrainTileCopernicus.h"
+#include "ElevationMapProvider.h"
+#include "QGCMapUrlEngine.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+namespace TerrainTestTiles
+{
+
+int elevation(int x, int y)
+{
+    return ((x + y) % 1000);
+}
+
+QByteArray tileJson(int x, int y)
+{
+    return tileJson(x, y, elevation(x, y));
+}
+
+QByteArray tileJson(int x, int y, int value)
+{
+    const double south = (y * TerrainTileCopernicus::kTileSizeDegrees) - 90.0;
+    const double west = (x * TerrainTileCopernicus::kTileSizeDegrees) - 180.0;
+
+    QJsonArray row;
+    for (int i = 0; i < kGridSize; i++) {
+        row.append(value);
+    }
+    QJsonArray carpet;
+    for (int i = 0; i < kGridSize; i++) {
+        carpet.append(row);
+    }
+
+    QJsonObject bounds;
+    bounds["sw"] = QJsonArray{ south, west };
+    bounds["ne"] = QJsonArray{ south + TerrainTileCopernicus::kTileSizeDegrees, west + TerrainTileCopernicus::kTileSizeDegrees };
+    QJsonObject stats;
+    stats["min"] = value;
+    stats["max"] = value;
+    stats["avg"] = value;
+    QJsonObject data;
+    data["bounds"] = bounds;
+    data["stats"] = stats;
+    data["carpet"] = carpet;
+    QJsonObject root;
+    root["status"] = "success";
+    root["data"] = data;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QPoint tileAt(const QGeoCoordinate &coordinate)
+{
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(CopernicusElevationProvider::kProviderKey);
+    return QPoint(provider->long2tileX(coordinate.longitude(), 1), provider->lat2tileY(coordinate.latitude(), 1));
+}
+
+QList<QPoint> tilesAround(const QList<QGeoCoordinate> &coordinates)
+{
+    QList<QPoint> tiles;
+    if (coordinates.isEmpty()) {
+        return tiles;
+    }
+
+    QPoint southWest = tileAt(coordinates.first());
+    QPoint northEast = southWest;
+    for (const QGeoCoordinate &coordinate : coordinates) {
+        const QPoint tile = tileAt(coordinate);
+        southWest = QPoint(qMin(southWest.x(), tile.x()), qMin(southWest.y(), tile.y()));
+        northEast = QPoint(qMax(northEast.x(), tile.x()), qMax(northEast.y(), tile.y()));
+    }
+
+    for (int x = southWest.x(); x <= northEast.x(); x++) {
+        for (int y = southWest.y(); y <= northEast.y(); y++) {
+            tiles.append(QPoint(x, y));
+        }
+    }
+
+    return tiles;
+}
+
+bool insertTile(TerrainTileDiskCache &diskCache, const QPoint &tile)
+{
+    const QByteArray data = TerrainTileCopernicus::serializeFromData(tileJson(tile.x(), tile.y()));
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    const int mapId = UrlFactory::getQtMapIdFromProviderType(CopernicusElevationProvider::kProviderKey);
+    return diskCache.insert(TerrainTileCache::tileKey(mapId, tile.x(), tile.y(), 1), data);
+}
+
+} // namespace TerrainTestTiles
@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QPoint>
+#include <QtPositioning/QGeoCoordinate>
+
+class TerrainTileDiskCache;
+
+/// Copernicus terrain tiles for tests. Every value of a tile is elevation(x, y).
+namespace TerrainTestTiles
+{
+    constexpr int kGridSize = 36;       ///< 1 arc-second values over a 0.01 degree tile
+
+    int elevation(int x, int y);
+    /// Tile as returned by the Copernicus terrain server
+    QByteArray tileJson(int x, int y);
+    /// Tile with every value set to value
+    QByteArray tileJson(int x, int y, int value);
+    /// Copernicus tile containing coordinate
+    QPoint tileAt(const QGeoCoordinate &coordinate);
+    /// Every tile of the box spanned by coordinates
+    QList<QPoint> tilesAround(const QList<QGeoCoordinate> &coordinates);
+    /// Stores tile the way the terrain tile manager expects to find it
+    bool insertTile(TerrainTileDiskCache &diskCache, const QPoint &tile);
+} // namespace TerrainTestTiles
@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileCacheTest.h"
+#include "TerrainTestTiles.h"
+#include "TerrainTile.h"
+#include "TerrainTileCache.h"
+#include "TerrainTileCopernicus.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtTest/QTest>
+
+namespace {
+    /// Copernicus tile from 47.00,8.00 to 47.01,8.01
+    constexpr int kTileX = 18800;
+    constexpr int kTileY = 13700;
+
+    /// Serialized tile with every elevation set to value
+    QByteArray _serialize(int value)
+    {
+        return TerrainTileCopernicus::serializeFromData(TerrainTestTiles::tileJson(kTileX, kTileY, value));
+    }
+}
+
+void TerrainTileCacheTest::_testTileKey()
+{
+    const quint64 key = TerrainTileCache::tileKey(1, 2, 3, 1);
+    QVERIFY(key != TerrainTileCache::tileKey(1, 3, 2, 1));
+    QVERIFY(key != TerrainTileCache::tileKey(2, 2, 3, 1));
+    QVERIFY(key != TerrainTileCache::tileKey(1, 2, 3, 2));
+    QCOMPARE(key, TerrainTileCache::tileKey(1, 2, 3, 1));
+}
+
+void TerrainTileCacheTest::_testEviction()
+{
+    const std::shared_ptr<const TerrainTile> tile = std::make_shared<const TerrainTile>(_serialize(1));
+    QVERIFY(tile->isValid());
+
+    // Room for two tiles in each of the sixteen shards
+    TerrainTileCache cache(tile->memorySize() * 2 * 16);
+    const auto tileKey = [](int i) {
+        return TerrainTileCache::tileKey(1, i, 0, 1);
+    };
+
+    for (int i = 0; i < 200; i++) {
+        cache.insert(tileKey(i), tile);
+        // The first tile stays in use
+        QVERIFY(cache.find(tileKey(0)));
+    }
+
+    QVERIFY(cache.bytes() <= cache.maxBytes());
+    QVERIFY(cache.count() <= (2 * 16));
+    QVERIFY(cache.stats().evictions > 0);
+    QVERIFY(cache.find(tileKey(0)));
+    QVERIFY(cache.find(tileKey(199)));
+    QVERIFY(!cache.find(tileKey(1)));
+
+    const quint64 misses = cache.stats().misses;
+    QVERIFY(!cache.find(TerrainTileCache::tileKey(2, 0, 0, 1)));
+    QCOMPARE(cache.stats().misses, misses + 1);
+
+    cache.setMaxBytes(0);
+    QVERIFY(cache.count() <= 16);
+
+    cache.clear();
+    QCOMPARE(cache.count(), static_cast<qsizetype>(0));
+    QCOMPARE(cache.bytes(), static_cast<qint64>(0));
+}
+
+void TerrainTileCacheTest::_testDiskCache()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("TerrainTiles.bin"));
+
+    constexpr int kTileCount = 300;
+    {
+        TerrainTileDiskCache cache;
+        QVERIFY(cache.open(path));
+        QCOMPARE(cache.count(), static_cast<qsizetype>(0));
+        for (int i = 0; i < kTileCount; i++) {
+            QVERIFY(cache.insert(TerrainTileCache::tileKey(1, i, i, 1), _serialize(static_cast<int16_t>(i))));
+        }
+        QCOMPARE(cache.count(), static_cast<qsizetype>(kTileCount));
+        QCOMPARE(cache.find(TerrainTileCache::tileKey(1, 7, 7, 1)), _serialize(7));
+        QVERIFY(cache.find(TerrainTileCache::tileKey(1, 7, 8, 1)).isEmpty());
+
+        // Tiles found are not tied to the file
+        const QByteArray data = cache.find(TerrainTileCache::tileKey(1, 9, 9, 1));
+        cache.close();
+        QCOMPARE(data, _serialize(9));
+    }
+
+    // Tiles survive a restart
+    TerrainTileDiskCache cache;
+    QVERIFY(cache.open(path));
+    QCOMPARE(cache.count(), static_cast<qsizetype>(kTileCount));
+    for (int i = 0; i < kTileCount; i += 17) {
+        const QByteArray data = cache.find(TerrainTileCache::tileKey(1, i, i, 1));
+        QCOMPARE(data, _serialize(static_cast<int16_t>(i)));
+        const TerrainTile tile(data);
+        QVERIFY(tile.isValid());
+        QCOMPARE(tile.elevation(QGeoCoordinate(47.005, 8.005)), static_cast<double>(i));
+    }
+
+    // Replacing a tile keeps the latest one
+    QVERIFY(cache.insert(TerrainTileCache::tileKey(1, 3, 3, 1), _serialize(1000)));
+    QCOMPARE(cache.count(), static_cast<qsizetype>(kTileCount));
+    QCOMPARE(cache.find(TerrainTileCache::tileKey(1, 3, 3, 1)), _serialize(1000));
+
+    cache.clear();
+    QCOMPARE(cache.count(), static_cast<qsizetype>(0));
+    QVERIFY(cache.insert(TerrainTileCache::tileKey(1, 3, 3, 1), _serialize(5)));
+    cache.close();
+    QVERIFY(cache.open(path));
+    QCOMPARE(cache.count(), static_cast<qsizetype>(1));
+}
+
+void TerrainTileCacheTest::_testDiskCacheDamaged()
+{
+    const QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("TerrainTiles.bin"));
+    const QByteArray tileData = _serialize(42);
+
+    {
+        TerrainTileDiskCache cache;
+        QVERIFY(cache.open(path));
+        QVERIFY(cache.insert(TerrainTileCache::tileKey(1, 0, 0, 1), tileData));
+        QVERIFY(cache.insert(TerrainTileCache::tileKey(1, 1, 0, 1), tileData));
+        QVERIFY(cache.insert(TerrainTileCache::tileKey(1, 2, 0, 1), tileData));
+    }
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 recordSize = file.size() / 3;
+    // Flip a byte of the first tile and cut the last one short, as a crash could
+    QVERIFY(file.seek(recordSize - 1));
+    QVERIFY(file.write("x", 1) == 1);
+    QVERIFY(file.resize(file.size() - 10));
+    file.close();
+
+    TerrainTileDiskCache cache;
+    QVERIFY(cache.open(path));
+    QCOMPARE(cache.count(), static_cast<qsizetype>(2));
+    QVERIFY(cache.contains(TerrainTileCache::tileKey(1, 0, 0, 1)));
+    QVERIFY(cache.find(TerrainTileCache::tileKey(1, 0, 0, 1)).isEmpty());
+    // Found damaged, so it is downloaded again
+    QVERIFY(!cache.contains(TerrainTileCache::tileKey(1, 0, 0, 1)));
+    QCOMPARE(cache.count(), static_cast<qsizetype>(1));
+    QCOMPARE(cache.find(TerrainTileCache::tileKey(1, 1, 0, 1)), tileData);
+    QVERIFY(!cache.contains(TerrainTileCache::tileKey(1, 2, 0, 1)));
+
+    // The cut off tile is saved again in its place
+    QVERIFY(cache.insert(TerrainTileCache::tileKey(1, 2, 0, 1), tileData));
+    cache.close();
+    QVERIFY(cache.open(path));
+    // The damaged tile is still in the file until it is saved again
+    QCOMPARE(cache.count(), static_cast<qsizetype>(3));
+    QCOMPARE(cache.find(TerrainTileCache::tileKey(1, 2, 0, 1)), tileData);
+
+    // Anything else is started over
+    cache.close();
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QVERIFY(file.write(QByteArray(64, 'x')) == 64);
+    file.close();
+    QVERIFY(cache.open(path));
+    QCOMPARE(cache.count(), static_cast<qsizetype>(0));
+}
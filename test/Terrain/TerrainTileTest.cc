@@ -10,4 +10,121 @@
 #include "TerrainTileTest.h"
 #include "TerrainTile.h"
 
+#include <QtCore/QRandomGenerator>
+#include <QtPositioning/QGeoCoordinate>
 #include <QtTest/QTest>
+
+namespace {
+    constexpr double kSwLat = 47.0;
+    constexpr double kSwLon = 8.0;
+    constexpr double kTileSize = 0.01;
+    constexpr int kGridSize = 37;
+}
+
+QByteArray TerrainTileTest::_serialize(int gridSizeLat, int gridSizeLon)
+{
+    TerrainTile::TileInfo_t tileInfo{};
+    tileInfo.swLat = kSwLat;
+    tileInfo.swLon = kSwLon;
+    tileInfo.neLat = kSwLat + kTileSize;
+    tileInfo.neLon = kSwLon + kTileSize;
+    tileInfo.minElevation = 0;
+    tileInfo.maxElevation = 1000;
+    tileInfo.avgElevation = 500;
+    tileInfo.gridSizeLat = static_cast<int16_t>(gridSizeLat);
+    tileInfo.gridSizeLon = static_cast<int16_t>(gridSizeLon);
+
+    QByteArray result(reinterpret_cast<const char*>(&tileInfo), sizeof(tileInfo));
+    for (int row = 0; row < gridSizeLat; row++) {
+        for (int column = 0; column < gridSizeLon; column++) {
+            const int16_t value = _value(row, column);
+            result.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+    return result;
+}
+
+void TerrainTileTest::_testInvalid()
+{
+    QByteArray data = _serialize(kGridSize, kGridSize);
+    data.chop(2);
+    const TerrainTile tile(data);
+    QVERIFY(!tile.isValid());
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(kSwLat, kSwLon))));
+
+    const TerrainTile emptyTile(_serialize(0, kGridSize));
+    QVERIFY(!emptyTile.isValid());
+}
+
+void TerrainTileTest::_testElevation()
+{
+    const TerrainTile tile(_serialize(kGridSize, kGridSize));
+    QVERIFY(tile.isValid());
+
+    const double cellSize = kTileSize / kGridSize;
+    const auto cellCenter = [cellSize](double row, double column) {
+        return QGeoCoordinate(kSwLat + ((row + 0.5) * cellSize), kSwLon + ((column + 0.5) * cellSize));
+    };
+
+    // Values sit at the cell centers
+    QVERIFY(qAbs(tile.elevation(cellCenter(5, 7)) - _value(5, 7)) < 1e-6);
+    QVERIFY(qAbs(tile.elevation(cellCenter(36, 0)) - _value(36, 0)) < 1e-6);
+
+    // Bilinear in between
+    const double expected = (_value(5, 7) + _value(5, 8) + _value(6, 7) + _value(6, 8)) / 4.0;
+    QVERIFY(qAbs(tile.elevation(cellCenter(5.5, 7.5)) - expected) < 1e-6);
+
+    // Edges hold the outermost values
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(kSwLat, kSwLon)) - _value(0, 0)) < 1e-6);
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(kSwLat + kTileSize, kSwLon + kTileSize)) - _value(36, 36)) < 1e-6);
+
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(kSwLat - 0.001, kSwLon))));
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(kSwLat, kSwLon + kTileSize + 0.001))));
+}
+
+void TerrainTileTest::_testElevations()
+{
+    const TerrainTile tile(_serialize(kGridSize, kGridSize));
+    QVERIFY(tile.isValid());
+
+    // An odd count runs the vector loop and its scalar tail, some coordinates fall outside the tile
+    constexpr int count = 1001;
+    QList<double> latitudes(count);
+    QList<double> longitudes(count);
+    for (int i = 0; i < count; i++) {
+        latitudes[i] = kSwLat - 0.001 + (QRandomGenerator::global()->generateDouble() * (kTileSize + 0.002));
+        longitudes[i] = kSwLon - 0.001 + (QRandomGenerator::global()->generateDouble() * (kTileSize + 0.002));
+    }
+    latitudes[3] = qQNaN();
+
+    QList<double> elevations(count);
+    tile.elevations(latitudes.constData(), longitudes.constData(), elevations.data(), count);
+
+    for (int i = 0; i < count; i++) {
+        const double single = tile.elevation(QGeoCoordinate(latitudes[i], longitudes[i]));
+        const bool inside = (latitudes[i] >= kSwLat) && (latitudes[i] <= (kSwLat + kTileSize)) && (longitudes[i] >= kSwLon) && (longitudes[i] <= (kSwLon + kTileSize));
+        QCOMPARE(qIsNaN(elevations[i]), !inside);
+        if (inside) {
+            QVERIFY(qAbs(elevations[i] - single) < 1e-9);
+            QVERIFY((elevations[i] >= 0) && (elevations[i] <= 1000));
+        }
+    }
+}
+
+void TerrainTileTest::_benchmarkElevations()
+{
+    const TerrainTile tile(_serialize(kGridSize, kGridSize));
+
+    constexpr int count = 50000;
+    QList<double> latitudes(count);
+    QList<double> longitudes(count);
+    for (int i = 0; i < count; i++) {
+        latitudes[i] = kSwLat + (QRandomGenerator::global()->generateDouble() * kTileSize);
+        longitudes[i] = kSwLon + (QRandomGenerator::global()->generateDouble() * kTileSize);
+    }
+
+    QList<double> elevations(count);
+    QBENCHMARK {
+        tile.elevations(latitudes.constData(), longitudes.constData(), elevations.data(), count);
+    }
+}
@@ -16,4 +16,12 @@ class TerrainTileTest : public UnitTest
     Q_OBJECT
 
 private slots:
+    void _testInvalid();
+    void _testElevation();
+    void _testElevations();
+    void _benchmarkElevations();
+
+private:
+    static QByteArray _serialize(int gridSizeLat, int gridSizeLon);
+    static int16_t _value(int row, int column) { return static_cast<int16_t>((row * 10) + (column * 3) + ((row * column) % 7)); }
 };
@@ -19,6 +19,8 @@
 // #include "GeoTagControllerTest.h"
 // #include "MavlinkLogTest.h"
 #include "LogDownloadTest.h"
+#include "MAVLinkChartSeriesStoreTest.h"
+#include "MAVLinkMessageTest.h"
 #include "PX4LogParserTest.h"
 // #include "ULogParserTest.h"
 
@@ -29,12 +31,20 @@
 #include "QGCCameraManagerTest.h"
 
 // Comms
+#include "LinkTxQueueTest.h"
+#include "MAVLinkDecodeWorkerTest.h"
+#include "MAVLinkLogWriterTest.h"
 #include "QGCSerialPortInfoTest.h"
+#include "TelemetryLogIndexTest.h"
+#include "UDPBatchIOTest.h"
 
 // FactSystem
 #include "FactSystemTestGeneric.h"
 #include "FactSystemTestPX4.h"
+#include "ParameterCacheTest.h"
 #include "ParameterManagerTest.h"
+#include "ParameterMetaDataStoreTest.h"
+#include "ParameterTableTest.h"
 
 // FollowMe
 #include "FollowMeTest.h"
@@ -43,6 +53,9 @@
 #include "GpsTest.h"
 
 // MAVLink
+#include "MAVLinkFrameParserTest.h"
+#include "MAVLinkMessageDispatcherTest.h"
+#include "RequestWindowTest.h"
 #include "StatusTextHandlerTest.h"
 #include "SigningTest.h"
 
@@ -76,8 +89,17 @@
 
 // QmlControls
 
+// QtLocationPlugin
+#include "QGCTileArchiveTest.h"
+#include "QGCTileCacheWorkerTest.h"
+#include "QGCTileDownloaderTest.h"
+#include "QGCTileReadPoolTest.h"
+
 // Terrain
+#include "TerrainPathProfileTest.h"
 #include "TerrainQueryTest.h"
+#include "TerrainRegionDownloadTest.h"
+#include "TerrainTileCacheTest.h"
 #include "TerrainTileTest.h"
 
 // UI
@@ -124,6 +146,8 @@ int QGCUnitTest::runTests(bool stress, const QStringList& unitTests)
     // UT_REGISTER_TEST(GeoTagControllerTest)
     // UT_REGISTER_TEST(MavlinkLogTest)
     UT_REGISTER_TEST(LogDownloadTest)
+    UT_REGISTER_TEST(MAVLinkChartSeriesStoreTest)
+    UT_REGISTER_TEST(MAVLinkMessageTest)
     UT_REGISTER_TEST(PX4LogParserTest)
     // UT_REGISTER_TEST(ULogParserTest)
 
@@ -134,12 +158,20 @@ int QGCUnitTest::runTests(bool stress, const QStringList& unitTests)
     UT_REGISTER_TEST(QGCCameraManagerTest)
 
     // Comms
+    UT_REGISTER_TEST(LinkTxQueueTest)
+    UT_REGISTER_TEST(MAVLinkDecodeWorkerTest)
+    UT_REGISTER_TEST(MAVLinkLogWriterTest)
     UT_REGISTER_TEST(QGCSerialPortInfoTest)
+    UT_REGISTER_TEST(TelemetryLogIndexTest)
+    UT_REGISTER_TEST(UDPBatchIOTest)
 
     // FactSystem
     UT_REGISTER_TEST(FactSystemTestGeneric)
     UT_REGISTER_TEST(FactSystemTestPX4)
+    UT_REGISTER_TEST(ParameterCacheTest)
     UT_REGISTER_TEST(ParameterManagerTest)
+    UT_REGISTER_TEST(ParameterMetaDataStoreTest)
+    UT_REGISTER_TEST(ParameterTableTest)
 
     // FollowMe
     UT_REGISTER_TEST(FollowMeTest)
@@ -148,6 +180,9 @@ int QGCUnitTest::runTests(bool stress, const QStringList& unitTests)
     // UT_REGISTER_TEST(GpsTest)
 
     // MAVLink
+    UT_REGISTER_TEST(MAVLinkFrameParserTest)
+    UT_REGISTER_TEST(MAVLinkMessageDispatcherTest)
+    UT_REGISTER_TEST(RequestWindowTest)
     UT_REGISTER_TEST(StatusTextHandlerTest)
     UT_REGISTER_TEST(SigningTest)
 
@@ -179,8 +214,17 @@ int QGCUnitTest::runTests(bool stress, const QStringList& unitTests)
 
     // QmlControls
 
+    // QtLocationPlugin
+    UT_REGISTER_TEST(QGCTileArchiveTest)
+    UT_REGISTER_TEST(QGCTileCacheWorkerTest)
+    UT_REGISTER_TEST(QGCTileDownloaderTest)
+    UT_REGISTER_TEST(QGCTileReadPoolTest)
+
     // Terrain
+    UT_REGISTER_TEST(TerrainPathProfileTest)
     UT_REGISTER_TEST(TerrainQueryTest)
+    UT_REGISTER_TEST(TerrainRegionDownloadTest)
+    UT_REGISTER_TEST(TerrainTileCacheTest)
     UT_REGISTER_TEST(TerrainTileTest)
 
     // UI
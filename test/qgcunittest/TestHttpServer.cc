@@ -0,0 +1,237 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TestHttpServer.h"
+
+#include <QtCore/QTimer>
+#include <QtCore/QtEndian>
+#include <QtNetwork/QTcpSocket>
+
+namespace {
+    // RFC 9113
+    constexpr const char *kHttp2Preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+    constexpr int kHttp2FrameHeaderSize = 9;
+    constexpr quint8 kHttp2FrameData = 0x0;
+    constexpr quint8 kHttp2FrameHeaders = 0x1;
+    constexpr quint8 kHttp2FrameSettings = 0x4;
+    constexpr quint8 kHttp2FlagEndStream = 0x1;
+    constexpr quint8 kHttp2FlagAck = 0x1;
+    constexpr quint8 kHttp2FlagEndHeaders = 0x4;
+
+    // RFC 7541 static table
+    constexpr int kHpackStatus = 8;
+    constexpr int kHpackContentLength = 28;
+    constexpr int kHpackContentType = 31;
+
+    void _hpackInteger(QByteArray &block, quint8 prefix, int prefixBits, int value)
+    {
+        const int max = (1 << prefixBits) - 1;
+        if (value < max) {
+            block.append(static_cast<char>(prefix | value));
+            return;
+        }
+
+        block.append(static_cast<char>(prefix | max));
+        value -= max;
+        while (value >= 128) {
+            block.append(static_cast<char>((value % 128) + 128));
+            value /= 128;
+        }
+        block.append(static_cast<char>(value));
+    }
+
+    void _hpackString(QByteArray &block, const QByteArray &string)
+    {
+        _hpackInteger(block, 0x00, 7, static_cast<int>(string.size()));
+        block.append(string);
+    }
+
+    /// Literal header field without indexing, nameIndex 0 sends the name as well
+    void _hpackLiteral(QByteArray &block, int nameIndex, const QByteArray &name, const QByteArray &value)
+    {
+        _hpackInteger(block, 0x00, 4, nameIndex);
+        if (nameIndex == 0) {
+            _hpackString(block, name);
+        }
+        _hpackString(block, value);
+    }
+}
+
+TestHttpServer::TestHttpServer(QObject *parent)
+    : QTcpServer(parent)
+{
+    (void) connect(this, &QTcpServer::newConnection, this, &TestHttpServer::_newConnection);
+}
+
+QString TestHttpServer::url(const QString &path) const
+{
+    return QStringLiteral("http://127.0.0.1:%1%2").arg(serverPort()).arg(path);
+}
+
+void TestHttpServer::_newConnection()
+{
+    while (QTcpSocket *const socket = nextPendingConnection()) {
+        (void) connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            if (_http2) {
+                _readHttp2(socket);
+            } else {
+                _read(socket);
+            }
+        });
+        (void) connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            (void) _buffers.remove(socket);
+            (void) _http2Started.remove(socket);
+            socket->deleteLater();
+        });
+
+        if (_http2) {
+            // The server preface is a SETTINGS frame, the defaults will do
+            _writeFrame(socket, kHttp2FrameSettings, 0, 0, QByteArray());
+        }
+    }
+}
+
+void TestHttpServer::_read(QTcpSocket *socket)
+{
+    QByteArray &buffer = _buffers[socket];
+    buffer.append(socket->readAll());
+
+    // Requests are all GETs, a blank line ends each of them
+    qsizetype end = buffer.indexOf("\r\n\r\n");
+    while (end >= 0) {
+        const QByteArray header = buffer.left(end);
+        buffer.remove(0, end + 4);
+        end = buffer.indexOf("\r\n\r\n");
+
+        _request(socket, QString::fromLatin1(header.left(header.indexOf("\r\n")).split(' ').value(1)), 0);
+    }
+}
+
+void TestHttpServer::_readHttp2(QTcpSocket *socket)
+{
+    QByteArray &buffer = _buffers[socket];
+    buffer.append(socket->readAll());
+
+    if (!_http2Started.contains(socket)) {
+        const QByteArray preface(kHttp2Preface);
+        if (buffer.size() < preface.size()) {
+            return;
+        }
+        if (!buffer.startsWith(preface)) {
+            socket->abort();
+            return;
+        }
+        buffer.remove(0, preface.size());
+        _http2Started.insert(socket);
+    }
+
+    while (buffer.size() >= kHttp2FrameHeaderSize) {
+        const uchar *const header = reinterpret_cast<const uchar*>(buffer.constData());
+        const qsizetype length = (header[0] << 16) | (header[1] << 8) | header[2];
+        if (buffer.size() < (kHttp2FrameHeaderSize + length)) {
+            break;
+        }
+
+        const quint8 type = header[3];
+        const quint8 flags = header[4];
+        const quint32 streamId = qFromBigEndian<quint32>(header + 5) & 0x7fffffff;
+        buffer.remove(0, kHttp2FrameHeaderSize + length);
+
+        switch (type) {
+        case kHttp2FrameSettings:
+            if (!(flags & kHttp2FlagAck)) {
+                _writeFrame(socket, kHttp2FrameSettings, kHttp2FlagAck, 0, QByteArray());
+            }
+            break;
+        case kHttp2FrameHeaders:
+            _request(socket, QString(), streamId);
+            break;
+        default:
+            // Window updates, pings and priorities don't matter for the small responses of tests
+            break;
+        }
+    }
+}
+
+void TestHttpServer::_request(QTcpSocket *socket, const QString &path, quint32 streamId)
+{
+    _requests.append(path);
+    const Response_t response = _handler ? _handler(path, _attempts[path]++) : Response_t();
+
+    _inFlight++;
+    _maxInFlight = qMax(_maxInFlight, _inFlight);
+    QTimer::singleShot(_delay, socket, [this, socket, streamId, response]() {
+        _inFlight--;
+        if (_http2) {
+            _respondHttp2(socket, streamId, response);
+        } else {
+            _respond(socket, response);
+        }
+    });
+}
+
+void TestHttpServer::_respond(QTcpSocket *socket, const Response_t &response)
+{
+    QByteArray reply = "HTTP/1.1 " + QByteArray::number(response.status);
+    switch (response.status) {
+    case 200:
+        reply += " OK";
+        break;
+    case 404:
+        reply += " Not Found";
+        break;
+    default:
+        reply += " Error";
+        break;
+    }
+    reply += "\r\n";
+
+    reply += "Content-Type: " + response.contentType + "\r\n";
+    reply += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    for (const std::pair<QByteArray, QByteArray> &field : response.headers) {
+        reply += field.first + ": " + field.second + "\r\n";
+    }
+    reply += "\r\n" + response.body;
+
+    (void) socket->write(reply);
+}
+
+void TestHttpServer::_respondHttp2(QTcpSocket *socket, quint32 streamId, const Response_t &response)
+{
+    QByteArray block;
+    _hpackLiteral(block, kHpackStatus, QByteArray(), QByteArray::number(response.status));
+    _hpackLiteral(block, kHpackContentType, QByteArray(), response.contentType);
+    _hpackLiteral(block, kHpackContentLength, QByteArray(), QByteArray::number(response.body.size()));
+    for (const std::pair<QByteArray, QByteArray> &field : response.headers) {
+        _hpackLiteral(block, 0, field.first, field.second);
+    }
+
+    if (response.body.isEmpty()) {
+        _writeFrame(socket, kHttp2FrameHeaders, kHttp2FlagEndHeaders | kHttp2FlagEndStream, streamId, block);
+    } else {
+        // Bodies of tests fit the default 16 kB frame
+        _writeFrame(socket, kHttp2FrameHeaders, kHttp2FlagEndHeaders, streamId, block);
+        _writeFrame(socket, kHttp2FrameData, kHttp2FlagEndStream, streamId, response.body);
+    }
+}
+
+void TestHttpServer::_writeFrame(QTcpSocket *socket, quint8 type, quint8 flags, quint32 streamId, const QByteArray &payload)
+{
+    QByteArray frame(kHttp2FrameHeaderSize, Qt::Uninitialized);
+    const qsizetype length = payload.size();
+    frame[0] = static_cast<char>((length >> 16) & 0xff);
+    frame[1] = static_cast<char>((length >> 8) & 0xff);
+    frame[2] = static_cast<char>(length & 0xff);
+    frame[3] = static_cast<char>(type);
+    frame[4] = static_cast<char>(flags);
+    qToBigEndian<quint32>(streamId, frame.data() + 5);
+    frame.append(payload);
+
+    (void) socket->write(frame);
+}
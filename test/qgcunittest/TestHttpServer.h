@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtNetwork/QTcpServer>
+
+#include <functional>
+#include <utility>
+
+class QTcpSocket;
+
+/// Stand-in for a web server in tests of code which downloads over HTTP. Listen on
+/// QHostAddress::LocalHost and point the code under test at url().
+class TestHttpServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    struct Response_t {
+        int status = 404;
+        QByteArray body;
+        QByteArray contentType = "application/octet-stream";
+        QList<std::pair<QByteArray, QByteArray>> headers;   ///< Additional header fields, lower case names
+    };
+
+    /// Answers a request, attempt counts the earlier requests of the same path
+    using Handler = std::function<Response_t(const QString &path, int attempt)>;
+
+    explicit TestHttpServer(QObject *parent = nullptr);
+
+    /// Without a handler every request is answered with 404
+    void setHandler(const Handler &handler) { _handler = handler; }
+    /// Responses are held back for msecs, the requests count as in flight meanwhile
+    void setDelay(int msecs) { _delay = msecs; }
+    /// true: speak HTTP/2 without TLS to clients which know it in advance, such as QNetworkRequest::Http2DirectAttribute
+    /// requests. Request headers are not decoded, the handler is called with an empty path.
+    void setHttp2(bool http2) { _http2 = http2; }
+
+    /// @return Url of path on this server
+    QString url(const QString &path) const;
+
+    const QStringList &requests() const { return _requests; }   ///< Paths in the order they were requested
+    int maxInFlight() const { return _maxInFlight; }
+
+private slots:
+    void _newConnection();
+
+private:
+    void _read(QTcpSocket *socket);
+    void _readHttp2(QTcpSocket *socket);
+    void _request(QTcpSocket *socket, const QString &path, quint32 streamId);
+    void _respond(QTcpSocket *socket, const Response_t &response);
+    void _respondHttp2(QTcpSocket *socket, quint32 streamId, const Response_t &response);
+    static void _writeFrame(QTcpSocket *socket, quint8 type, quint8 flags, quint32 streamId, const QByteArray &payload);
+
+    Handler _handler;
+    int _delay = 0;
+    bool _http2 = false;
+    int _inFlight = 0;
+    int _maxInFlight = 0;
+    QStringList _requests;
+    QHash<QTcpSocket*, QByteArray> _buffers;
+    QSet<QTcpSocket*> _http2Started;                ///< Sockets past the HTTP/2 connection preface
+    QHash<QString, int> _attempts;
+};
@@ -126,12 +126,28 @@ void UnitTest::_connectMockLink(MAV_AUTOPILOT autopilot, MockConfiguration::Fail
         break;
     }
 
+    _waitForMockLinkVehicle(spyVehicle, autopilot != MAV_AUTOPILOT_INVALID);
+}
+
+void UnitTest::_connectMockLink(MockConfiguration *mockConfig)
+{
+    Q_ASSERT(!_mockLink);
+
+    QSignalSpy spyVehicle(MultiVehicleManager::instance(), &MultiVehicleManager::activeVehicleChanged);
+
+    _mockLink = MockLink::startMockLink(mockConfig);
+
+    _waitForMockLinkVehicle(spyVehicle, true);
+}
+
+void UnitTest::_waitForMockLinkVehicle(QSignalSpy &spyVehicle, bool initialConnect)
+{
     // Wait for the Vehicle to get created
     QCOMPARE(spyVehicle.wait(10000), true);
     _vehicle = MultiVehicleManager::instance()->activeVehicle();
     QVERIFY(_vehicle);
 
-    if (autopilot != MAV_AUTOPILOT_INVALID) {
+    if (initialConnect) {
         // Wait for initial connect sequence to complete
         QSignalSpy spyPlan(_vehicle, &Vehicle::initialConnectComplete);
         QCOMPARE(spyPlan.wait(30000), true);
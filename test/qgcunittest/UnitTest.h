@@ -25,6 +25,7 @@ class Vehicle;
 class Fact;
 class LinkInterface;
 class MissionItem;
+class QSignalSpy;
 
 class UnitTest : public QObject
 {
@@ -73,6 +74,8 @@ protected slots:
 protected:
     void _connectMockLink(MAV_AUTOPILOT autopilot = MAV_AUTOPILOT_PX4, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     void _connectMockLinkNoInitialConnectSequence() { _connectMockLink(MAV_AUTOPILOT_INVALID); }
+    /// Connects a MockLink set up by the test, for options such as MockConfiguration::setFtpCapability. Takes ownership of mockConfig.
+    void _connectMockLink(MockConfiguration *mockConfig);
     void _disconnectMockLink();
     static void _missionItemsEqual(const MissionItem &actual, const MissionItem &expected);
 
@@ -84,6 +87,7 @@ private slots:
 
 private:
     void _unitTestCalled() { _unitTestRun = true; }
+    void _waitForMockLinkVehicle(QSignalSpy &spyVehicle, bool initialConnect);
 
     /// @brief Returns the list of unit tests.
     static QList<UnitTest*> &_testList();